@@ -60,7 +60,8 @@ enum class StructType
     D3D12DeviceExtendedDesc,
     D3D12ExperimentalFeaturesDesc,
     SlangSessionExtendedDesc,
-    RayTracingValidationDesc
+    RayTracingValidationDesc,
+    CPUDeviceExtendedDesc
 };
 
 // TODO: Implementation or backend or something else?
@@ -486,6 +487,10 @@ struct BufferDesc
 
     bool isShared = false;
 
+    /// Offset in bytes into the memory referenced by the native handle passed to `createBufferFromNativeHandle`.
+    /// The CPU device uses this to create buffers over a region of a file.
+    Offset nativeHandleOffset = 0;
+
     /// The name of the buffer for debugging purposes.
     const char* label = nullptr;
 };
@@ -1200,10 +1205,26 @@ struct RenderPipelineDesc
     BlendDesc blend;
 };
 
+/// Order in which the CPU device executes the work groups of a dispatch.
+enum class CPUGroupOrder
+{
+    /// Groups are executed in raster order.
+    Linear,
+    /// Groups are executed in tiles of 4x4 groups, tiles are executed in raster order.
+    Tiled,
+    /// Tiles are executed along a Morton (Z-order) curve.
+    Morton,
+    /// Tiles are executed along a Hilbert curve.
+    Hilbert,
+};
+
 struct ComputePipelineDesc
 {
     IShaderProgram* program = nullptr;
     void* d3d12RootSignatureOverride = nullptr;
+    /// Order in which work groups are executed. Only used by the CPU device.
+    /// Kernels that access neighboring texels from neighboring groups benefit from a tiled order.
+    CPUGroupOrder cpuGroupOrder = CPUGroupOrder::Linear;
 };
 
 struct RayTracingPipelineFlags
@@ -1799,6 +1820,23 @@ public:
     virtual SLANG_NO_THROW void SLANG_MCALL ensureInternalDescriptorHeapsBound() = 0;
 };
 
+/// Command buffer of devices that record commands and replay them on the host (CPU, CUDA, D3D11).
+/// Supports bundles: command buffers that are recorded once and executed many times by other command buffers.
+class ICommandBufferImmediate : public ICommandBuffer
+{
+    SLANG_COM_INTERFACE(0x5edeb011, 0x114b, 0x48e2, {0x99, 0x50, 0xd6, 0xc0, 0x42, 0x08, 0x42, 0xd3});
+
+public:
+    /// Make this command buffer a bundle. Must be called before any commands are encoded.
+    /// A bundle is not submitted to a queue. Once closed, it is executed by reference from other
+    /// command buffers with `executeBundle`, and keeps its commands until it is released.
+    virtual SLANG_NO_THROW Result SLANG_MCALL beginBundle() = 0;
+
+    /// Execute the commands of a closed bundle at the current point of this command buffer.
+    /// The pipeline and bindings set by the bundle stay in effect for the following commands.
+    virtual SLANG_NO_THROW Result SLANG_MCALL executeBundle(ICommandBuffer* bundle) = 0;
+};
+
 class ICommandQueue : public ISlangUnknown
 {
     SLANG_COM_INTERFACE(0xc530a6bd, 0x6d1b, 0x475f, {0x9a, 0x71, 0xc2, 0x06, 0x67, 0x1f, 0x59, 0xc3});
@@ -1861,6 +1899,9 @@ public:
         GfxCount srvDescriptorCount;
         GfxCount constantBufferDescriptorCount;
         GfxCount accelerationStructureDescriptorCount;
+        // Initial size of the staging buffer pages that constant buffers, uploads and readbacks are sub-allocated
+        // from. Pages grow when a heap needs more than one page between two resets. 0 selects the default (16MB).
+        Size stagingBufferPageSize;
     };
 
     // Waits until GPU commands issued before last call to `finish()` has been completed, and resets
@@ -2061,6 +2102,100 @@ enum class DebugMessageSource
     Driver,
     Slang
 };
+
+struct DeviceMemoryStats
+{
+    /// Number of bytes currently allocated for resources.
+    uint64_t bytesLive = 0;
+    /// Highest number of bytes allocated for resources at any time.
+    uint64_t bytesPeak = 0;
+    /// Number of bytes of freed memory retained for reuse.
+    uint64_t bytesPooled = 0;
+    /// Number of allocations made.
+    uint64_t allocationCount = 0;
+    /// Number of allocations small enough to be served from pools.
+    uint64_t poolAllocationCount = 0;
+    /// Number of allocations served by reusing pooled memory.
+    uint64_t poolHitCount = 0;
+    /// Number of bytes allocated from the system or driver, including pooled memory.
+    uint64_t bytesReserved = 0;
+    /// Number of memory allocations currently made from the driver (Vulkan only).
+    uint64_t deviceAllocationCount = 0;
+    /// Size of the largest contiguous range of pooled memory (Vulkan only).
+    /// Pooled memory is fragmented if this is much smaller than `bytesPooled`.
+    uint64_t bytesLargestPooledRange = 0;
+    /// Number of bytes of memory the device can allocate, or 0 if unknown (Vulkan only).
+    uint64_t bytesBudget = 0;
+};
+
+/// Statistics of the staging buffers that transient resource heaps use for constant buffers, uploads and readbacks.
+struct StagingMemoryStats
+{
+    /// Number of bytes in staging buffers currently held by transient resource heaps.
+    uint64_t bytesInUse = 0;
+    /// Highest value of `bytesInUse` at any time.
+    uint64_t bytesInUsePeak = 0;
+    /// Number of bytes in staging buffers retained for reuse.
+    uint64_t bytesPooled = 0;
+    /// Highest number of bytes allocated from a single transient resource heap between two resets.
+    uint64_t bytesPerResetPeak = 0;
+    /// Number of staging buffers created.
+    uint64_t bufferCreationCount = 0;
+    /// Number of staging buffers reused from the pool instead of being created.
+    uint64_t bufferReuseCount = 0;
+};
+
+/// Statistics of the descriptor pools that transient resource heaps allocate descriptor sets from.
+struct DescriptorPoolStats
+{
+    /// Number of descriptor pools currently allocated.
+    uint64_t poolCount = 0;
+    /// Number of descriptor pools created.
+    uint64_t poolCreationCount = 0;
+    /// Number of descriptor sets the current pools can hold.
+    uint64_t setCapacity = 0;
+    /// Number of descriptor sets allocated from the current pools, either in use or kept for reuse.
+    uint64_t setCount = 0;
+    /// Number of descriptor sets used by transient resource heaps since they were last reset.
+    uint64_t setsInUse = 0;
+    /// Number of descriptor sets allocated from a pool.
+    uint64_t setAllocationCount = 0;
+    /// Number of descriptor sets reused after a transient resource heap was reset, instead of being allocated.
+    uint64_t setReuseCount = 0;
+};
+
+/// Number of times an operation ran and how long it took, in nanoseconds.
+struct ShaderCompilationStat
+{
+    uint64_t count = 0;
+    uint64_t totalTime = 0;
+    uint64_t maxTime = 0;
+};
+
+struct ShaderCompilationStats
+{
+    /// Linking of shader programs from their global scope and entry points.
+    ShaderCompilationStat programLinking;
+    /// Generation of target code for entry points by Slang, excluding code read from the persistent shader cache.
+    ShaderCompilationStat entryPointCodeGeneration;
+    /// Queries of the persistent shader cache that found the entry point code.
+    ShaderCompilationStat persistentCacheHits;
+    /// Queries of the persistent shader cache that did not find the entry point code.
+    ShaderCompilationStat persistentCacheMisses;
+    /// Writes of generated entry point code to the persistent shader cache.
+    ShaderCompilationStat persistentCacheWrites;
+    /// Specializations of pipelines to the types bound to their shader objects, including code generation.
+    ShaderCompilationStat pipelineSpecialization;
+    /// Creation of native pipeline state objects.
+    /// Not recorded by devices without native pipeline objects (CPU, CUDA, D3D11).
+    ShaderCompilationStat pipelineCreation;
+    /// Number of draws and dispatches that found their specialized pipeline in the cache.
+    uint64_t specializedPipelineCacheHitCount = 0;
+    /// Number of draws and dispatches that had to specialize their pipeline.
+    /// With async pipeline specialization, retries while the specialization is pending are not counted.
+    uint64_t specializedPipelineCacheMissCount = 0;
+};
+
 class IDebugCallback
 {
 public:
@@ -2124,6 +2259,16 @@ public:
         // Interface to persistent shader cache.
         IPersistentShaderCache* persistentShaderCache = nullptr;
 
+        // Specialize pipelines for new combinations of shader object types on a background thread.
+        // Draws and dispatches that need a specialization that is not ready yet are skipped and return
+        // SLANG_E_PENDING. The Slang session of the device is used by the background thread, so programs
+        // must not be loaded into it while specializations are pending.
+        bool asyncPipelineSpecialization = false;
+
+        // Load the driver's pipeline cache from `persistentShaderCache` when the device is created, and allow
+        // `savePipelineCache` to write it back. Only supported by Vulkan.
+        bool persistentPipelineCache = false;
+
         GfxCount extendedDescCount = 0;
         void** extendedDescs = nullptr;
     };
@@ -2460,6 +2605,49 @@ public:
         ShaderObjectContainerType container,
         IShaderObject** outObject
     ) = 0;
+
+    /// Get statistics of the memory allocated for resources by the device.
+    /// Returns SLANG_E_NOT_AVAILABLE if the device does not track its allocations.
+    virtual SLANG_NO_THROW Result SLANG_MCALL getMemoryStats(DeviceMemoryStats* outStats) = 0;
+
+    /// Get statistics of shader compilation and caching since the device was created or the statistics were reset.
+    virtual SLANG_NO_THROW Result SLANG_MCALL getShaderCompilationStats(ShaderCompilationStats* outStats) = 0;
+
+    /// Reset the shader compilation statistics to zero, for example to measure them per frame.
+    virtual SLANG_NO_THROW Result SLANG_MCALL resetShaderCompilationStats() = 0;
+
+    /// Get statistics of the staging buffers shared by the transient resource heaps of the device.
+    /// Devices without staging buffers (CPU, CUDA, D3D11) report all zeros.
+    virtual SLANG_NO_THROW Result SLANG_MCALL getStagingMemoryStats(StagingMemoryStats* outStats) = 0;
+
+    /// Get statistics of the descriptor pools of the device's transient resource heaps.
+    /// Returns SLANG_E_NOT_AVAILABLE if the device does not use descriptor pools (only Vulkan does).
+    virtual SLANG_NO_THROW Result SLANG_MCALL getDescriptorPoolStats(DescriptorPoolStats* outStats) = 0;
+
+    /// Write the driver's pipeline cache to `IDevice::Desc::persistentShaderCache`, so that devices created later
+    /// can skip compiling pipelines that were already created. The cache is not written when the device is
+    /// destroyed, call this before releasing the device. Returns SLANG_E_NOT_AVAILABLE if
+    /// `IDevice::Desc::persistentPipelineCache` is not enabled, the device has no persistent shader cache or does not
+    /// support pipeline caches (only Vulkan does).
+    virtual SLANG_NO_THROW Result SLANG_MCALL savePipelineCache() = 0;
+
+    /// Wait until all pipeline specializations queued on the background thread finished.
+    /// `timeout` is in nanoseconds, can be set to `kTimeoutInfinite`.
+    /// Returns SLANG_E_TIME_OUT if specializations are still pending after `timeout`.
+    /// Returns SLANG_OK immediately if `IDevice::Desc::asyncPipelineSpecialization` is not enabled.
+    virtual SLANG_NO_THROW Result SLANG_MCALL waitForPipelineSpecializations(uint64_t timeout = kTimeoutInfinite) = 0;
+
+    /// Write the combinations of shader object types `pipeline` has been specialized for to a manifest.
+    /// Types are stored by name, so the manifest can be loaded by another process.
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    exportPipelineSpecializations(IPipeline* pipeline, ISlangBlob** outManifest) = 0;
+
+    /// Specialize `pipeline` for all type combinations in a manifest written by `exportPipelineSpecializations`.
+    /// With async pipeline specialization, the specializations are queued on the background thread and
+    /// `waitForPipelineSpecializations` waits for them. Otherwise they are created before returning.
+    /// Types that no longer exist in the pipeline's program are skipped.
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    prewarmPipelineSpecializations(IPipeline* pipeline, const void* manifest, Size manifestSize) = 0;
 };
 
 class IPersistentShaderCache : public ISlangUnknown
@@ -2471,6 +2659,17 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL queryCache(ISlangBlob* key, ISlangBlob** outData) = 0;
 };
 
+struct PersistentShaderCacheDesc
+{
+    // Path of the cache's pack file. The file is created if it doesn't exist.
+    // The same file can be used by multiple caches and processes at the same time.
+    const char* path = nullptr;
+
+    // Maximum size of the pack file in bytes. Writing an entry that doesn't fit evicts the least
+    // recently used entries.
+    uint64_t maxSize = 256 * 1024 * 1024;
+};
+
 class IPipelineCreationAPIDispatcher : public ISlangUnknown
 {
     SLANG_COM_INTERFACE(0x8d7aa89d, 0x07f1, 0x4e21, {0xbc, 0xd2, 0x9a, 0x71, 0xc7, 0x95, 0xba, 0x91});
@@ -2519,6 +2718,11 @@ extern "C"
     /// Given a type returns a function that can construct it, or nullptr if there isn't one
     SLANG_RHI_API SlangResult SLANG_MCALL rhiCreateDevice(const IDevice::Desc* desc, IDevice** outDevice);
 
+    /// Creates a persistent shader cache stored in a memory-mapped pack file.
+    /// Data returned by `queryCache` points into the mapping and stays valid while the blob is alive.
+    SLANG_RHI_API SlangResult SLANG_MCALL
+    rhiCreatePersistentShaderCache(const PersistentShaderCacheDesc* desc, IPersistentShaderCache** outCache);
+
     /// Reports current set of live objects in rhi.
     /// Currently this only calls D3D's ReportLiveObjects.
     SLANG_RHI_API SlangResult SLANG_MCALL rhiReportLiveObjects();
@@ -2576,4 +2780,34 @@ struct RayTracingValidationDesc
     bool enableRaytracingValidation = false;
 };
 
+enum class CPUTextureLayout
+{
+    /// Texels are stored in rows.
+    Linear,
+    /// 2D and 3D textures are stored in 8x8 texel tiles, with texels in Morton order inside a tile.
+    /// Improves cache locality of kernels that access 2D neighborhoods of texels.
+    Tiled,
+};
+
+struct CPUDeviceExtendedDesc
+{
+    StructType structType = StructType::CPUDeviceExtendedDesc;
+    /// Number of worker threads used to execute compute dispatches.
+    /// 0 uses one thread per hardware thread, 1 executes dispatches on the submitting thread only.
+    uint32_t workerThreadCount = 0;
+    /// Directory used to cache compiled kernel shared libraries across runs.
+    /// If set, kernels are compiled to shared libraries that are stored under their entry point hash
+    /// and loaded directly from this directory on subsequent runs. The compiled libraries are also
+    /// passed through the device's persistent shader cache if one is set.
+    /// If null, kernels are compiled to host-callable code in memory.
+    const char* kernelCachePath = nullptr;
+    /// Alignment in bytes of the memory allocated for buffers and textures. Must be a power of two.
+    uint32_t memoryAlignment = 64;
+    /// Back large buffers and textures with huge pages (Linux only).
+    /// Explicit huge pages are used if available, transparent huge pages otherwise.
+    bool useHugePages = false;
+    /// Memory layout of textures created by the device.
+    CPUTextureLayout textureLayout = CPUTextureLayout::Linear;
+};
+
 } // namespace rhi
@@ -6,6 +6,9 @@
 
 #include "core/common.h"
 
+#include <initializer_list>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace rhi {
@@ -30,204 +33,279 @@ enum class CommandName
     UploadBufferData,
     CopyBuffer,
     WriteTimestamp,
+    ExecuteBundle,
 };
 
 const uint8_t kMaxCommandOperands = 5;
 
+/// A command in the command stream of a `CommandWriter`.
+/// The objects referenced by the command and its data are stored right after it in the stream.
 struct Command
 {
     CommandName name;
+    // Number of object pointers following the command.
+    uint32_t objectCount;
+    // Size of the command including its objects and data, which is the offset to the next command.
+    uint32_t size;
     uint32_t operands[kMaxCommandOperands];
-    Command() = default;
-    Command(CommandName inName, uint32_t op)
-        : name(inName)
-    {
-        operands[0] = op;
-    }
-    Command(CommandName inName, uint32_t op1, uint32_t op2)
-        : name(inName)
+
+    template<typename T>
+    T* getObject(uint32_t index) const
     {
-        operands[0] = op1;
-        operands[1] = op2;
+        return static_cast<T*>(reinterpret_cast<RefObject* const*>(this + 1)[index]);
     }
-    Command(CommandName inName, uint32_t op1, uint32_t op2, uint32_t op3)
-        : name(inName)
+
+    template<typename T>
+    T* getData() const
     {
-        operands[0] = op1;
-        operands[1] = op2;
-        operands[2] = op3;
+        return reinterpret_cast<T*>(
+            const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(this + 1) + objectCount * sizeof(RefObject*))
+        );
     }
-    Command(CommandName inName, uint32_t op1, uint32_t op2, uint32_t op3, uint32_t op4)
-        : name(inName)
+};
+
+/// A block of memory that commands are bump-allocated from.
+struct CommandChunk
+{
+    static constexpr size_t kSize = 64 * 1024;
+
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity;
+    size_t used;
+};
+
+/// Free chunks shared by the command writers of a transient heap.
+/// Immediate command buffers are created for every submission, so they take the chunks released by the
+/// command buffers before them instead of allocating new ones. Only chunks of the default size are pooled.
+class CommandChunkPool : public RefObject
+{
+public:
+    static constexpr size_t kMaxFreeChunks = 64;
+
+    /// Take a free chunk. Returns false if the pool is empty.
+    bool acquire(CommandChunk& outChunk)
     {
-        operands[0] = op1;
-        operands[1] = op2;
-        operands[2] = op3;
-        operands[3] = op4;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeChunks.empty())
+            return false;
+        outChunk = std::move(m_freeChunks.back());
+        m_freeChunks.pop_back();
+        return true;
     }
-    Command(CommandName inName, uint32_t op1, uint32_t op2, uint32_t op3, uint32_t op4, uint32_t op5)
-        : name(inName)
+
+    /// Return a chunk to the pool. The chunk is freed if the pool is full.
+    void release(CommandChunk&& chunk)
     {
-        operands[0] = op1;
-        operands[1] = op2;
-        operands[2] = op3;
-        operands[3] = op4;
-        operands[4] = op5;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeChunks.size() < kMaxFreeChunks)
+            m_freeChunks.push_back(std::move(chunk));
     }
+
+private:
+    std::mutex m_mutex;
+    std::vector<CommandChunk> m_freeChunks;
 };
 
+/// Records commands into a stream of chunks that are bump-allocated, so recording does not allocate once the
+/// writer, or the chunk pool it takes chunks from, has grown to the size of a typical command buffer.
+/// Objects referenced by commands are stored as raw pointers and retained once per writer
+/// through a deduplicating set, instead of once per reference.
 class CommandWriter
 {
 public:
-    std::vector<Command> m_commands;
-    std::vector<RefPtr<RefObject>> m_objects;
-    std::vector<uint8_t> m_data;
+    static constexpr size_t kChunkSize = CommandChunk::kSize;
+    static constexpr size_t kCommandAlignment = 8;
+
+    /// Iterates the recorded commands in order.
+    class Iterator
+    {
+    public:
+        Iterator(const CommandWriter* writer, size_t chunkIndex)
+            : m_writer(writer)
+            , m_chunkIndex(chunkIndex)
+        {
+            skipFinishedChunks();
+        }
+
+        const Command& operator*() const
+        {
+            return *reinterpret_cast<const Command*>(m_writer->m_chunks[m_chunkIndex].data.get() + m_offset);
+        }
+
+        Iterator& operator++()
+        {
+            m_offset += (**this).size;
+            skipFinishedChunks();
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return m_chunkIndex != other.m_chunkIndex || m_offset != other.m_offset;
+        }
+
+    private:
+        void skipFinishedChunks()
+        {
+            size_t endChunkIndex = m_writer->getEndChunkIndex();
+            while (m_chunkIndex < endChunkIndex && m_offset == m_writer->m_chunks[m_chunkIndex].used)
+            {
+                m_chunkIndex++;
+                m_offset = 0;
+            }
+        }
+
+        const CommandWriter* m_writer;
+        size_t m_chunkIndex;
+        size_t m_offset = 0;
+    };
+
+    struct CommandRange
+    {
+        const CommandWriter* writer;
+        Iterator begin() const { return Iterator(writer, 0); }
+        Iterator end() const { return Iterator(writer, writer->getEndChunkIndex()); }
+    };
+
     bool m_hasWriteTimestamps = false;
 
 public:
-    void clear()
-    {
-        m_commands.clear();
-        for (auto& obj : m_objects)
-            obj = nullptr;
-        m_objects.clear();
-        m_data.clear();
-        m_hasWriteTimestamps = false;
-    }
+    CommandWriter() = default;
+    CommandWriter(const CommandWriter&) = delete;
+    CommandWriter& operator=(const CommandWriter&) = delete;
 
-    // Copies user data into `m_data` buffer and returns the offset to retrieve the data.
-    Offset encodeData(const void* data, Size size)
+    ~CommandWriter()
     {
-        Offset offset = (Offset)m_data.size();
-        m_data.resize(m_data.size() + size);
-        memcpy(m_data.data() + offset, data, size);
-        return offset;
+        releaseChunks();
+        releaseObjects();
     }
 
-    Offset encodeObject(RefObject* obj)
+    /// Take new chunks from `pool` and return them to it when the writer is cleared or destroyed.
+    void setChunkPool(CommandChunkPool* pool) { m_chunkPool = pool; }
+
+    /// Remove all commands and release the referenced objects.
+    /// Chunks go back to the chunk pool, or are kept for the next commands if there is none.
+    /// Chunks allocated for oversized commands are freed.
+    void clear()
     {
-        Offset offset = (Offset)m_objects.size();
-        m_objects.push_back(obj);
-        return offset;
+        releaseChunks();
+        releaseObjects();
+        m_hasWriteTimestamps = false;
     }
 
-    template<typename T>
-    T* getObject(uint32_t offset)
+    CommandRange getCommands() const { return CommandRange{this}; }
+
+    bool isEmpty() const { return m_chunks.empty() || m_chunks[0].used == 0; }
+
+    /// Append a command with room for `objectCount` objects and `dataSize` bytes of data.
+    Command* writeCommand(
+        CommandName name,
+        std::initializer_list<uint32_t> operands,
+        uint32_t objectCount = 0,
+        Size dataSize = 0
+    )
     {
-        return static_cast<T*>(m_objects[offset].Ptr());
+        Size size = sizeof(Command) + objectCount * sizeof(RefObject*) + dataSize;
+        size = (size + kCommandAlignment - 1) & ~(kCommandAlignment - 1);
+        Command* cmd = reinterpret_cast<Command*>(allocate(size));
+        cmd->name = name;
+        cmd->objectCount = objectCount;
+        cmd->size = (uint32_t)size;
+        uint32_t i = 0;
+        for (uint32_t operand : operands)
+            cmd->operands[i++] = operand;
+        return cmd;
     }
 
-    template<typename T>
-    T* getData(Offset offset)
+    /// Store `obj` as object `index` of `cmd`, retaining it until the writer is cleared.
+    void setObject(Command* cmd, uint32_t index, RefObject* obj)
     {
-        return reinterpret_cast<T*>(m_data.data() + offset);
+        reinterpret_cast<RefObject**>(cmd + 1)[index] = obj;
+        retain(obj);
     }
 
     void setPipeline(IPipeline* state)
     {
-        auto offset = encodeObject(static_cast<PipelineBase*>(state));
-        m_commands.push_back(Command(CommandName::SetPipeline, (uint32_t)offset));
+        auto cmd = writeCommand(CommandName::SetPipeline, {}, 1);
+        setObject(cmd, 0, static_cast<PipelineBase*>(state));
     }
 
     void bindRootShaderObject(IShaderObject* object)
     {
-        auto rootOffset = encodeObject(static_cast<ShaderObjectBase*>(object));
-        m_commands.push_back(Command(CommandName::BindRootShaderObject, (uint32_t)rootOffset));
+        auto cmd = writeCommand(CommandName::BindRootShaderObject, {}, 1);
+        setObject(cmd, 0, static_cast<ShaderObjectBase*>(object));
     }
 
     void uploadBufferData(IBuffer* buffer, Offset offset, Size size, void* data)
     {
-        auto bufferOffset = encodeObject(static_cast<Buffer*>(buffer));
-        auto dataOffset = encodeData(data, size);
-        m_commands.push_back(Command(
-            CommandName::UploadBufferData,
-            (uint32_t)bufferOffset,
-            (uint32_t)offset,
-            (uint32_t)size,
-            (uint32_t)dataOffset
-        ));
+        auto cmd = writeCommand(CommandName::UploadBufferData, {(uint32_t)offset, (uint32_t)size}, 1, size);
+        setObject(cmd, 0, static_cast<Buffer*>(buffer));
+        memcpy(cmd->getData<uint8_t>(), data, size);
     }
 
     void copyBuffer(IBuffer* dst, Offset dstOffset, IBuffer* src, Offset srcOffset, Size size)
     {
-        auto dstBuffer = encodeObject(static_cast<Buffer*>(dst));
-        auto srcBuffer = encodeObject(static_cast<Buffer*>(src));
-        m_commands.push_back(Command(
-            CommandName::CopyBuffer,
-            (uint32_t)dstBuffer,
-            (uint32_t)dstOffset,
-            (uint32_t)srcBuffer,
-            (uint32_t)srcOffset,
-            (uint32_t)size
-        ));
+        auto cmd =
+            writeCommand(CommandName::CopyBuffer, {(uint32_t)dstOffset, (uint32_t)srcOffset, (uint32_t)size}, 2);
+        setObject(cmd, 0, static_cast<Buffer*>(dst));
+        setObject(cmd, 1, static_cast<Buffer*>(src));
     }
 
     void setFramebuffer(IFramebuffer* frameBuffer)
     {
-        auto framebufferOffset = encodeObject(static_cast<FramebufferBase*>(frameBuffer));
-        m_commands.push_back(Command(CommandName::SetFramebuffer, (uint32_t)framebufferOffset));
+        auto cmd = writeCommand(CommandName::SetFramebuffer, {}, 1);
+        setObject(cmd, 0, static_cast<FramebufferBase*>(frameBuffer));
     }
 
     void clearFrame(uint32_t colorBufferMask, bool clearDepth, bool clearStencil)
     {
-        m_commands.push_back(Command(CommandName::ClearFrame, colorBufferMask, clearDepth ? 1 : 0, clearStencil ? 1 : 0)
-        );
+        writeCommand(CommandName::ClearFrame, {colorBufferMask, clearDepth ? 1u : 0u, clearStencil ? 1u : 0u});
     }
 
     void setViewports(GfxCount count, const Viewport* viewports)
     {
-        auto offset = encodeData(viewports, sizeof(Viewport) * count);
-        m_commands.push_back(Command(CommandName::SetViewports, (uint32_t)count, (uint32_t)offset));
+        auto cmd = writeCommand(CommandName::SetViewports, {(uint32_t)count}, 0, sizeof(Viewport) * count);
+        memcpy(cmd->getData<Viewport>(), viewports, sizeof(Viewport) * count);
     }
 
     void setScissorRects(GfxCount count, const ScissorRect* scissors)
     {
-        auto offset = encodeData(scissors, sizeof(ScissorRect) * count);
-        m_commands.push_back(Command(CommandName::SetScissorRects, (uint32_t)count, (uint32_t)offset));
+        auto cmd = writeCommand(CommandName::SetScissorRects, {(uint32_t)count}, 0, sizeof(ScissorRect) * count);
+        memcpy(cmd->getData<ScissorRect>(), scissors, sizeof(ScissorRect) * count);
     }
 
     void setPrimitiveTopology(PrimitiveTopology topology)
     {
-        m_commands.push_back(Command(CommandName::SetPrimitiveTopology, (uint32_t)topology));
+        writeCommand(CommandName::SetPrimitiveTopology, {(uint32_t)topology});
     }
 
     void setVertexBuffers(GfxIndex startSlot, GfxCount slotCount, IBuffer* const* buffers, const Offset* offsets)
     {
-        Offset bufferOffset = 0;
-        for (GfxCount i = 0; i < slotCount; i++)
-        {
-            auto offset = encodeObject(static_cast<Buffer*>(buffers[i]));
-            if (i == 0)
-                bufferOffset = offset;
-        }
-        auto offsetsOffset = encodeData(offsets, sizeof(Size) * slotCount);
-        m_commands.push_back(Command(
+        auto cmd = writeCommand(
             CommandName::SetVertexBuffers,
-            (uint32_t)startSlot,
+            {(uint32_t)startSlot, (uint32_t)slotCount},
             (uint32_t)slotCount,
-            (uint32_t)bufferOffset,
-            (uint32_t)offsetsOffset
-        ));
+            sizeof(Offset) * slotCount
+        );
+        for (GfxCount i = 0; i < slotCount; i++)
+            setObject(cmd, (uint32_t)i, static_cast<Buffer*>(buffers[i]));
+        memcpy(cmd->getData<Offset>(), offsets, sizeof(Offset) * slotCount);
     }
 
     void setIndexBuffer(IBuffer* buffer, Format indexFormat, Offset offset)
     {
-        auto bufferOffset = encodeObject(static_cast<Buffer*>(buffer));
-        m_commands.push_back(
-            Command(CommandName::SetIndexBuffer, (uint32_t)bufferOffset, (uint32_t)indexFormat, (uint32_t)offset)
-        );
+        auto cmd = writeCommand(CommandName::SetIndexBuffer, {(uint32_t)indexFormat, (uint32_t)offset}, 1);
+        setObject(cmd, 0, static_cast<Buffer*>(buffer));
     }
 
     void draw(GfxCount vertexCount, GfxIndex startVertex)
     {
-        m_commands.push_back(Command(CommandName::Draw, (uint32_t)vertexCount, (uint32_t)startVertex));
+        writeCommand(CommandName::Draw, {(uint32_t)vertexCount, (uint32_t)startVertex});
     }
 
     void drawIndexed(GfxCount indexCount, GfxIndex startIndex, GfxIndex baseVertex)
     {
-        m_commands.push_back(
-            Command(CommandName::DrawIndexed, (uint32_t)indexCount, (uint32_t)startIndex, (uint32_t)baseVertex)
-        );
+        writeCommand(CommandName::DrawIndexed, {(uint32_t)indexCount, (uint32_t)startIndex, (uint32_t)baseVertex});
     }
 
     void drawInstanced(
@@ -237,13 +315,10 @@ public:
         GfxIndex startInstanceLocation
     )
     {
-        m_commands.push_back(Command(
+        writeCommand(
             CommandName::DrawInstanced,
-            (uint32_t)vertexCount,
-            (uint32_t)instanceCount,
-            (uint32_t)startVertex,
-            (uint32_t)startInstanceLocation
-        ));
+            {(uint32_t)vertexCount, (uint32_t)instanceCount, (uint32_t)startVertex, (uint32_t)startInstanceLocation}
+        );
     }
 
     void drawIndexedInstanced(
@@ -254,31 +329,165 @@ public:
         GfxIndex startInstanceLocation
     )
     {
-        m_commands.push_back(Command(
+        writeCommand(
             CommandName::DrawIndexedInstanced,
-            (uint32_t)indexCount,
-            (uint32_t)instanceCount,
-            (uint32_t)startIndexLocation,
-            (uint32_t)baseVertexLocation,
-            (uint32_t)startInstanceLocation
-        ));
+            {(uint32_t)indexCount,
+             (uint32_t)instanceCount,
+             (uint32_t)startIndexLocation,
+             (uint32_t)baseVertexLocation,
+             (uint32_t)startInstanceLocation}
+        );
     }
 
     void setStencilReference(uint32_t referenceValue)
     {
-        m_commands.push_back(Command(CommandName::SetStencilReference, referenceValue));
+        writeCommand(CommandName::SetStencilReference, {referenceValue});
     }
 
     void dispatchCompute(int x, int y, int z)
     {
-        m_commands.push_back(Command(CommandName::DispatchCompute, (uint32_t)x, (uint32_t)y, (uint32_t)z));
+        writeCommand(CommandName::DispatchCompute, {(uint32_t)x, (uint32_t)y, (uint32_t)z});
     }
 
     void writeTimestamp(IQueryPool* pool, GfxIndex index)
     {
-        auto poolOffset = encodeObject(static_cast<QueryPoolBase*>(pool));
-        m_commands.push_back(Command(CommandName::WriteTimestamp, (uint32_t)poolOffset, (uint32_t)index));
+        auto cmd = writeCommand(CommandName::WriteTimestamp, {(uint32_t)index}, 1);
+        setObject(cmd, 0, static_cast<QueryPoolBase*>(pool));
         m_hasWriteTimestamps = true;
     }
+
+    // `bundle` is the command buffer holding the bundle's commands.
+    void executeBundle(RefObject* bundle)
+    {
+        auto cmd = writeCommand(CommandName::ExecuteBundle, {}, 1);
+        setObject(cmd, 0, bundle);
+    }
+
+private:
+    // Index one past the last chunk holding commands.
+    size_t getEndChunkIndex() const { return m_chunks.empty() ? 0 : m_currentChunk + 1; }
+
+    void* allocate(Size size)
+    {
+        if (!m_chunks.empty())
+        {
+            CommandChunk& chunk = m_chunks[m_currentChunk];
+            if (chunk.capacity - chunk.used >= size)
+            {
+                void* result = chunk.data.get() + chunk.used;
+                chunk.used += size;
+                return result;
+            }
+            // Move on to the next chunk, unless the current one is still empty.
+            if (chunk.used != 0)
+                m_currentChunk++;
+        }
+        // Reuse the next chunk if it is large enough, otherwise insert a new one before it.
+        if (m_currentChunk >= m_chunks.size() || m_chunks[m_currentChunk].capacity < size)
+        {
+            CommandChunk chunk;
+            if (size > kChunkSize || !m_chunkPool || !m_chunkPool->acquire(chunk))
+            {
+                chunk.capacity = std::max(kChunkSize, size);
+                chunk.data.reset(new uint8_t[chunk.capacity]);
+            }
+            chunk.used = 0;
+            m_chunks.insert(m_chunks.begin() + m_currentChunk, std::move(chunk));
+        }
+        CommandChunk& chunk = m_chunks[m_currentChunk];
+        chunk.used = size;
+        return chunk.data.get();
+    }
+
+    void releaseChunks()
+    {
+        size_t keptCount = 0;
+        for (size_t i = 0; i < m_chunks.size(); i++)
+        {
+            CommandChunk& chunk = m_chunks[i];
+            if (chunk.capacity != kChunkSize)
+                continue;
+            chunk.used = 0;
+            if (m_chunkPool)
+            {
+                m_chunkPool->release(std::move(chunk));
+            }
+            else
+            {
+                if (keptCount != i)
+                    m_chunks[keptCount] = std::move(chunk);
+                keptCount++;
+            }
+        }
+        m_chunks.resize(keptCount);
+        m_currentChunk = 0;
+    }
+
+    void retain(RefObject* obj)
+    {
+        // Commands often reference the same object as the previous one, e.g. the root shader object.
+        if (!obj || obj == m_lastRetained)
+            return;
+        m_lastRetained = obj;
+        if ((m_retainedCount + 1) * 2 > m_retainSet.size())
+            growRetainSet();
+        size_t mask = m_retainSet.size() - 1;
+        size_t index = hashObject(obj) & mask;
+        while (m_retainSet[index])
+        {
+            if (m_retainSet[index] == obj)
+                return;
+            index = (index + 1) & mask;
+        }
+        m_retainSet[index] = obj;
+        m_retainedCount++;
+        obj->addReference();
+    }
+
+    void growRetainSet()
+    {
+        std::vector<RefObject*> oldSet(std::max<size_t>(m_retainSet.size() * 2, 64), nullptr);
+        oldSet.swap(m_retainSet);
+        size_t mask = m_retainSet.size() - 1;
+        for (RefObject* obj : oldSet)
+        {
+            if (!obj)
+                continue;
+            size_t index = hashObject(obj) & mask;
+            while (m_retainSet[index])
+                index = (index + 1) & mask;
+            m_retainSet[index] = obj;
+        }
+    }
+
+    void releaseObjects()
+    {
+        if (m_retainedCount == 0)
+            return;
+        for (RefObject*& obj : m_retainSet)
+        {
+            if (obj)
+            {
+                obj->releaseReference();
+                obj = nullptr;
+            }
+        }
+        m_retainedCount = 0;
+        m_lastRetained = nullptr;
+    }
+
+    static size_t hashObject(RefObject* obj)
+    {
+        return size_t((uint64_t(uintptr_t(obj)) * 0x9e3779b97f4a7c15ull) >> 32);
+    }
+
+    std::vector<CommandChunk> m_chunks;
+    size_t m_currentChunk = 0;
+    RefPtr<CommandChunkPool> m_chunkPool;
+
+    // Open-addressing hash set of the retained objects. Its size is a power of two.
+    std::vector<RefObject*> m_retainSet;
+    size_t m_retainedCount = 0;
+    RefObject* m_lastRetained = nullptr;
 };
 } // namespace rhi
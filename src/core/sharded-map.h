@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace rhi {
+
+/// A hash map that can be accessed from multiple threads.
+/// Keys are distributed over a fixed number of shards, each protected by its own reader-writer lock.
+/// Lookups of existing keys only take a shared lock on a single shard, so threads hitting the map
+/// concurrently rarely contend, and threads inserting different keys mostly lock different shards.
+/// Values are returned by copy, so they stay valid if the entry is replaced or the map is cleared.
+template<typename K, typename V, typename Hash = std::hash<K>, size_t ShardCount = 16>
+class ShardedMap
+{
+public:
+    ShardedMap() = default;
+    ShardedMap(const ShardedMap&) = delete;
+    ShardedMap& operator=(const ShardedMap&) = delete;
+
+    /// Find the value for `key`. Returns false if the key is not in the map.
+    bool tryGet(const K& key, V& outValue) const
+    {
+        size_t hash = Hash()(key);
+        const Shard& shard = getShard(hash);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end())
+            return false;
+        outValue = it->second;
+        return true;
+    }
+
+    /// Insert `value` for `key` unless the key is already in the map.
+    /// Returns the value stored in the map, which is the existing value if another thread won the race.
+    V insertOrGet(const K& key, V value)
+    {
+        size_t hash = Hash()(key);
+        Shard& shard = getShard(hash);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto result = shard.map.emplace(key, std::move(value));
+        return result.first->second;
+    }
+
+    /// Return the value for `key`, calling `create()` to make it if the key is not in the map.
+    /// `create` is called at most once per key while holding the shard's lock, so it must be cheap and
+    /// must not access the map. Use `tryGet` and `insertOrGet` for values that are expensive to create.
+    template<typename F>
+    V getOrCreate(const K& key, F&& create)
+    {
+        size_t hash = Hash()(key);
+        Shard& shard = getShard(hash);
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it != shard.map.end())
+                return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end())
+            it = shard.map.emplace(key, create()).first;
+        return it->second;
+    }
+
+    /// Call `func(key, value)` for every entry. Entries inserted concurrently may or may not be visited.
+    /// `func` is called while holding a shard's shared lock, so it must not modify the map.
+    template<typename F>
+    void forEach(F&& func) const
+    {
+        for (const Shard& shard : m_shards)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (const auto& entry : shard.map)
+                func(entry.first, entry.second);
+        }
+    }
+
+    /// Remove all entries.
+    void clear()
+    {
+        for (Shard& shard : m_shards)
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.map.clear();
+        }
+    }
+
+    /// Number of entries. Only a snapshot if other threads modify the map concurrently.
+    size_t size() const
+    {
+        size_t count = 0;
+        for (const Shard& shard : m_shards)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            count += shard.map.size();
+        }
+        return count;
+    }
+
+private:
+    struct Shard
+    {
+        // Keep shards on separate cache lines so locking one shard doesn't slow down the others.
+        alignas(64) mutable std::shared_mutex mutex;
+        std::unordered_map<K, V, Hash> map;
+    };
+
+    Shard& getShard(size_t hash)
+    {
+        // Scramble the hash, pointer keys use the address as hash which has its low bits cleared.
+        return m_shards[((uint64_t(hash) * 0x9e3779b97f4a7c15ull) >> 32) % ShardCount];
+    }
+    const Shard& getShard(size_t hash) const { return const_cast<ShardedMap*>(this)->getShard(hash); }
+
+    std::array<Shard, ShardCount> m_shards;
+};
+
+} // namespace rhi
@@ -4,15 +4,17 @@
 
 #include "assert.h"
 
+#include <atomic>
 #include <type_traits>
 
 namespace rhi {
 
 // Base class for all reference-counted objects
+// The reference count is atomic, so references to an object can be shared between threads.
 class SLANG_RHI_API RefObject
 {
 private:
-    UInt referenceCount;
+    std::atomic<UInt> referenceCount;
 
 public:
     RefObject()
@@ -36,12 +38,13 @@ public:
     UInt releaseReference()
     {
         SLANG_RHI_ASSERT(referenceCount != 0);
-        if (--referenceCount == 0)
+        UInt count = --referenceCount;
+        if (count == 0)
         {
             delete this;
             return 0;
         }
-        return referenceCount;
+        return count;
     }
 
     bool isUniquelyReferenced()
@@ -0,0 +1,167 @@
+#include "thread-pool.h"
+
+#include <algorithm>
+
+namespace rhi {
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    m_workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++)
+        m_workers.push_back(std::make_unique<Worker>());
+    for (uint32_t i = 0; i < threadCount; i++)
+        m_workers[i]->thread = std::thread([this, i]() { workerMain(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers)
+        worker->thread.join();
+}
+
+void ThreadPool::parallelFor(uint32_t count, const std::function<void(uint32_t)>& func)
+{
+    if (count == 0)
+        return;
+    if (count == 1)
+    {
+        func(0);
+        return;
+    }
+
+    Job job;
+    job.func = &func;
+    job.remaining = count;
+
+    // Distribute the tasks round-robin so every worker starts with a local batch.
+    uint32_t workerCount = getThreadCount();
+    uint32_t firstWorker = m_nextWorker.fetch_add(1) % workerCount;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Task task;
+        task.job = &job;
+        task.index = i;
+        push((firstWorker + i) % workerCount, std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wake.notify_all();
+
+    // Help out with tasks of this job until none are left in the queues.
+    for (;;)
+    {
+        Task task;
+        bool found = false;
+        for (uint32_t i = 0; i < workerCount && !found; i++)
+        {
+            Worker& worker = *m_workers[(firstWorker + i) % workerCount];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (!worker.tasks.empty() && worker.tasks.back().job == &job)
+            {
+                task = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+                m_queuedTaskCount--;
+                found = true;
+            }
+        }
+        if (!found)
+            break;
+        run(task);
+    }
+
+    // Wait for tasks still running on worker threads.
+    std::unique_lock<std::mutex> lock(job.mutex);
+    job.finished.wait(lock, [&]() { return job.remaining.load() == 0; });
+}
+
+void ThreadPool::submit(std::function<void()> func)
+{
+    Task task;
+    task.func = std::move(func);
+    push(m_nextWorker.fetch_add(1) % getThreadCount(), std::move(task));
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wake.notify_one();
+}
+
+void ThreadPool::push(uint32_t workerIndex, Task task)
+{
+    Worker& worker = *m_workers[workerIndex];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+    m_queuedTaskCount++;
+}
+
+bool ThreadPool::pop(uint32_t workerIndex, Task& outTask)
+{
+    Worker& worker = *m_workers[workerIndex];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty())
+        return false;
+    outTask = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    m_queuedTaskCount--;
+    return true;
+}
+
+bool ThreadPool::steal(uint32_t thiefIndex, Task& outTask)
+{
+    uint32_t workerCount = getThreadCount();
+    for (uint32_t i = 1; i < workerCount; i++)
+    {
+        Worker& worker = *m_workers[(thiefIndex + i) % workerCount];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty())
+            continue;
+        outTask = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        m_queuedTaskCount--;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(Task& task)
+{
+    if (!task.job)
+    {
+        task.func();
+        return;
+    }
+    Job* job = task.job;
+    (*job->func)(task.index);
+    // The job lives on the stack of the thread waiting in `parallelFor`, so the last
+    // access to it has to happen while holding its mutex.
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (--job->remaining == 0)
+        job->finished.notify_all();
+}
+
+void ThreadPool::workerMain(uint32_t workerIndex)
+{
+    for (;;)
+    {
+        Task task;
+        if (pop(workerIndex, task) || steal(workerIndex, task))
+        {
+            run(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [&]() { return m_stop || m_queuedTaskCount.load() > 0; });
+        if (m_stop)
+            return;
+    }
+}
+
+} // namespace rhi
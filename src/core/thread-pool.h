@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rhi {
+
+/// A persistent pool of worker threads with per-worker task queues.
+/// Each worker pops tasks from the front of its own queue and steals from the
+/// back of other workers' queues when it runs dry, which keeps all workers busy
+/// when chunks of a parallel job have uneven cost.
+class ThreadPool
+{
+public:
+    /// Create a pool with `threadCount` workers.
+    /// If `threadCount` is 0, one worker per hardware thread is created.
+    explicit ThreadPool(uint32_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Number of worker threads owned by the pool.
+    uint32_t getThreadCount() const { return (uint32_t)m_workers.size(); }
+
+    /// Run `func(i)` for every `i` in `[0, count)` and block until all invocations finished.
+    /// The calling thread participates in executing the work.
+    void parallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+    /// Enqueue a detached task. The task runs on one of the worker threads.
+    void submit(std::function<void()> func);
+
+private:
+    struct Job
+    {
+        const std::function<void(uint32_t)>* func = nullptr;
+        std::atomic<uint32_t> remaining{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    struct Task
+    {
+        // Set for tasks that are part of a `parallelFor` job.
+        Job* job = nullptr;
+        uint32_t index = 0;
+        // Set for detached tasks.
+        std::function<void()> func;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void push(uint32_t workerIndex, Task task);
+    bool pop(uint32_t workerIndex, Task& outTask);
+    bool steal(uint32_t thiefIndex, Task& outTask);
+    void run(Task& task);
+    void workerMain(uint32_t workerIndex);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<uint32_t> m_nextWorker{0};
+
+    // Number of tasks that have been queued but not yet picked up.
+    std::atomic<uint32_t> m_queuedTaskCount{0};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+};
+
+} // namespace rhi
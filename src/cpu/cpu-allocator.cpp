@@ -0,0 +1,165 @@
+#include "cpu-allocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#if SLANG_WINDOWS_FAMILY
+#include <malloc.h>
+#endif
+#if SLANG_LINUX_FAMILY
+#include <sys/mman.h>
+#endif
+
+namespace rhi::cpu {
+
+MemoryAllocator::MemoryAllocator(size_t alignment, bool useHugePages)
+    : m_alignment(std::max(alignment, sizeof(void*)))
+    , m_useHugePages(useHugePages)
+{
+    SLANG_RHI_ASSERT((m_alignment & (m_alignment - 1)) == 0);
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+    for (int sizeClass = 0; sizeClass < kSizeClassCount; ++sizeClass)
+    {
+        size_t classSize = size_t(1) << (sizeClass + kMinSizeClassShift);
+        for (void* ptr : m_freeLists[sizeClass])
+            freeSystem(ptr, classSize);
+    }
+}
+
+int MemoryAllocator::getSizeClass(size_t size)
+{
+    if (size > (size_t(1) << kMaxSizeClassShift))
+        return -1;
+    int shift = kMinSizeClassShift;
+    while ((size_t(1) << shift) < size)
+        shift++;
+    return shift - kMinSizeClassShift;
+}
+
+void* MemoryAllocator::allocate(size_t size)
+{
+    int sizeClass = getSizeClass(size);
+    size_t allocationSize = sizeClass >= 0 ? size_t(1) << (sizeClass + kMinSizeClassShift) : size;
+
+    void* ptr = nullptr;
+    if (sizeClass >= 0)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.poolAllocationCount++;
+        auto& freeList = m_freeLists[sizeClass];
+        if (!freeList.empty())
+        {
+            ptr = freeList.back();
+            freeList.pop_back();
+            m_stats.bytesPooled -= allocationSize;
+            m_stats.poolHitCount++;
+        }
+    }
+    if (!ptr)
+    {
+        ptr = allocateSystem(allocationSize);
+        if (!ptr)
+            return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.allocationCount++;
+    m_stats.bytesLive += allocationSize;
+    m_stats.bytesPeak = std::max(m_stats.bytesPeak, m_stats.bytesLive);
+    return ptr;
+}
+
+void MemoryAllocator::free(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    int sizeClass = getSizeClass(size);
+    size_t allocationSize = sizeClass >= 0 ? size_t(1) << (sizeClass + kMinSizeClassShift) : size;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.bytesLive -= allocationSize;
+        if (sizeClass >= 0 && m_stats.bytesPooled + allocationSize <= kMaxPooledBytes)
+        {
+            m_freeLists[sizeClass].push_back(ptr);
+            m_stats.bytesPooled += allocationSize;
+            return;
+        }
+    }
+    freeSystem(ptr, allocationSize);
+}
+
+void MemoryAllocator::getStats(DeviceMemoryStats& outStats)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    outStats = m_stats;
+    outStats.bytesReserved = m_stats.bytesLive + m_stats.bytesPooled;
+}
+
+bool MemoryAllocator::isHugePageAllocation(size_t size) const
+{
+#if SLANG_LINUX_FAMILY
+    // Memory mappings are only page aligned.
+    return m_useHugePages && size >= kHugePageSize && m_alignment <= 4096;
+#else
+    SLANG_UNUSED(size);
+    return false;
+#endif
+}
+
+void* MemoryAllocator::allocateSystem(size_t size)
+{
+#if SLANG_LINUX_FAMILY
+    if (isHugePageAllocation(size))
+    {
+        size_t mappingSize = (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        // Prefer explicit huge pages and fall back to transparent huge pages
+        // if none are reserved on the system.
+        void* ptr = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr == MAP_FAILED)
+        {
+            ptr = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED)
+                return nullptr;
+            madvise(ptr, mappingSize, MADV_HUGEPAGE);
+        }
+        return ptr;
+    }
+#endif
+
+    // Aligned allocation functions require the size to be a multiple of the alignment.
+    size = std::max((size + m_alignment - 1) & ~(m_alignment - 1), m_alignment);
+#if SLANG_WINDOWS_FAMILY
+    return _aligned_malloc(size, m_alignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, m_alignment, size) != 0)
+        return nullptr;
+    return ptr;
+#endif
+}
+
+void MemoryAllocator::freeSystem(void* ptr, size_t size)
+{
+#if SLANG_LINUX_FAMILY
+    if (isHugePageAllocation(size))
+    {
+        size_t mappingSize = (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        munmap(ptr, mappingSize);
+        return;
+    }
+#else
+    SLANG_UNUSED(size);
+#endif
+
+#if SLANG_WINDOWS_FAMILY
+    _aligned_free(ptr);
+#else
+    ::free(ptr);
+#endif
+}
+
+} // namespace rhi::cpu
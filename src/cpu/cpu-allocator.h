@@ -0,0 +1,59 @@
+#pragma once
+
+#include "cpu-base.h"
+
+#include <mutex>
+#include <vector>
+
+namespace rhi::cpu {
+
+/// Allocator for the memory backing CPU buffers and textures.
+///
+/// All allocations are aligned to the configured alignment (64 bytes by default, so that
+/// kernels can use aligned vector loads). Small allocations are rounded up to power of two
+/// size classes and recycled through per-class free lists, which makes the many short-lived
+/// buffers created every frame cheap. Large allocations go straight to the system and can
+/// optionally be backed by transparent or explicit huge pages.
+///
+/// The allocator is shared by the device and all resources allocated from it, so resources
+/// can outlive the device.
+class MemoryAllocator
+{
+public:
+    MemoryAllocator(size_t alignment, bool useHugePages);
+    ~MemoryAllocator();
+
+    /// Allocate `size` bytes. Returns nullptr if out of memory.
+    void* allocate(size_t size);
+    /// Free memory returned by `allocate`. `size` must match the size passed to `allocate`.
+    void free(void* ptr, size_t size);
+
+    void getStats(DeviceMemoryStats& outStats);
+
+    size_t getAlignment() const { return m_alignment; }
+
+private:
+    // Size classes range from 64 B to 1 MB.
+    static const int kMinSizeClassShift = 6;
+    static const int kMaxSizeClassShift = 20;
+    static const int kSizeClassCount = kMaxSizeClassShift - kMinSizeClassShift + 1;
+    // Upper bound of the memory held in free lists.
+    static const size_t kMaxPooledBytes = 64 * 1024 * 1024;
+    // Allocations of at least this size use huge pages if enabled.
+    static const size_t kHugePageSize = 2 * 1024 * 1024;
+
+    static int getSizeClass(size_t size);
+
+    void* allocateSystem(size_t size);
+    void freeSystem(void* ptr, size_t size);
+    bool isHugePageAllocation(size_t size) const;
+
+    size_t m_alignment;
+    bool m_useHugePages;
+
+    std::mutex m_mutex;
+    std::vector<void*> m_freeLists[kSizeClassCount];
+    DeviceMemoryStats m_stats;
+};
+
+} // namespace rhi::cpu
@@ -29,6 +29,8 @@ class RootShaderObjectImpl;
 class ShaderProgramImpl;
 class PipelineImpl;
 class QueryPoolImpl;
+class SamplerImpl;
+class FenceImpl;
 class DeviceImpl;
 
 } // namespace rhi::cpu
@@ -1,20 +1,119 @@
 #include "cpu-buffer.h"
 
+#if SLANG_WINDOWS_FAMILY
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace rhi::cpu {
 
 BufferImpl::~BufferImpl()
 {
-    if (m_data)
+    if (m_fileMapping)
+    {
+#if SLANG_WINDOWS_FAMILY
+        UnmapViewOfFile(m_fileMapping);
+#else
+        munmap(m_fileMapping, m_fileMappingSize);
+#endif
+    }
+    else if (m_data && m_allocator)
     {
-        free(m_data);
+        m_allocator->free(m_data, m_desc.size);
     }
 }
 
-Result BufferImpl::init()
+Result BufferImpl::init(std::shared_ptr<MemoryAllocator> allocator)
 {
-    m_data = malloc(m_desc.size);
+    m_data = allocator->allocate(m_desc.size);
     if (!m_data)
         return SLANG_E_OUT_OF_MEMORY;
+    m_allocator = std::move(allocator);
+    return SLANG_OK;
+}
+
+Result BufferImpl::initFromFile(NativeHandle fileHandle, Offset offset)
+{
+    if (m_desc.size == 0)
+        return SLANG_E_INVALID_ARG;
+
+    // Writes to the buffer must not reach the file, so writable buffers use a private copy-on-write mapping.
+    bool isWritable = m_desc.allowedStates.contains(ResourceState::UnorderedAccess) ||
+                      m_desc.allowedStates.contains(ResourceState::CopyDestination) ||
+                      m_desc.defaultState == ResourceState::UnorderedAccess ||
+                      m_desc.defaultState == ResourceState::CopyDestination;
+
+#if SLANG_WINDOWS_FAMILY
+    if (fileHandle.type != NativeHandleType::Win32)
+        return SLANG_E_INVALID_ARG;
+
+    // Mapping past the end of the file would extend it or fault on access.
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx((HANDLE)fileHandle.value, &fileSize))
+        return SLANG_FAIL;
+    if (uint64_t(offset) + m_desc.size > uint64_t(fileSize.QuadPart))
+        return SLANG_E_INVALID_ARG;
+
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    Offset alignedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+    size_t mappingSize = size_t(offset - alignedOffset) + m_desc.size;
+
+    HANDLE mapping = CreateFileMappingW(
+        (HANDLE)fileHandle.value,
+        nullptr,
+        isWritable ? PAGE_WRITECOPY : PAGE_READONLY,
+        0,
+        0,
+        nullptr
+    );
+    if (!mapping)
+        return SLANG_FAIL;
+    void* view = MapViewOfFile(
+        mapping,
+        isWritable ? FILE_MAP_COPY : FILE_MAP_READ,
+        DWORD(uint64_t(alignedOffset) >> 32),
+        DWORD(alignedOffset & 0xffffffff),
+        mappingSize
+    );
+    // The view keeps the file mapping alive.
+    CloseHandle(mapping);
+    if (!view)
+        return SLANG_FAIL;
+#else
+    if (fileHandle.type != NativeHandleType::FileDescriptor)
+        return SLANG_E_INVALID_ARG;
+
+    // Accessing mapped pages past the end of the file raises SIGBUS.
+    struct stat fileStat;
+    if (fstat(int(fileHandle.value), &fileStat) != 0)
+        return SLANG_FAIL;
+    if (uint64_t(offset) + m_desc.size > uint64_t(fileStat.st_size))
+        return SLANG_E_INVALID_ARG;
+
+    Offset pageSize = Offset(sysconf(_SC_PAGESIZE));
+    Offset alignedOffset = offset - offset % pageSize;
+    size_t mappingSize = size_t(offset - alignedOffset) + m_desc.size;
+
+    // Pages are faulted in lazily when kernels first touch them.
+    void* view = mmap(
+        nullptr,
+        mappingSize,
+        isWritable ? PROT_READ | PROT_WRITE : PROT_READ,
+        MAP_PRIVATE,
+        int(fileHandle.value),
+        off_t(alignedOffset)
+    );
+    if (view == MAP_FAILED)
+        return SLANG_FAIL;
+#endif
+
+    m_fileMapping = view;
+    m_fileMappingSize = mappingSize;
+    m_data = (char*)view + (offset - alignedOffset);
     return SLANG_OK;
 }
 
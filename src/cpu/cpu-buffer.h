@@ -1,7 +1,10 @@
 #pragma once
 
+#include "cpu-allocator.h"
 #include "cpu-base.h"
 
+#include <memory>
+
 namespace rhi::cpu {
 
 class BufferImpl : public Buffer
@@ -14,12 +17,22 @@ public:
 
     ~BufferImpl();
 
-    Result init();
+    Result init(std::shared_ptr<MemoryAllocator> allocator);
+
+    /// Map `m_desc.size` bytes of a file starting at `offset` as the buffer's data.
+    /// The mapping is copy-on-write if the buffer can be written to and read-only otherwise.
+    Result initFromFile(NativeHandle fileHandle, Offset offset);
 
     Result setData(size_t offset, size_t size, void const* data);
 
+    // Null if the buffer does not own its data.
+    std::shared_ptr<MemoryAllocator> m_allocator;
     void* m_data = nullptr;
 
+    // Set if the data is a view of a file mapping.
+    void* m_fileMapping = nullptr;
+    size_t m_fileMappingSize = 0;
+
     virtual SLANG_NO_THROW DeviceAddress SLANG_MCALL getDeviceAddress() override;
 
     virtual SLANG_NO_THROW Result SLANG_MCALL map(MemoryRange* rangeToRead, void** outPointer) override;
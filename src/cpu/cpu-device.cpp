@@ -1,36 +1,234 @@
 #include "cpu-device.h"
 
 #include "cpu-buffer.h"
+#include "cpu-fence.h"
 #include "cpu-pipeline.h"
 #include "cpu-query.h"
 #include "cpu-resource-views.h"
+#include "cpu-sampler.h"
 #include "cpu-shader-object.h"
 #include "cpu-shader-program.h"
 #include "cpu-texture.h"
 
+#include <algorithm>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
 
 namespace rhi::cpu {
 
+// Number of chunks per thread a dispatch is split into. Using more chunks than
+// threads lets idle workers steal work when group costs are uneven.
+static const uint32_t kDispatchChunksPerThread = 4;
+
+// Split a dispatch of `groupCount` groups into chunks that can run in parallel.
+// Chunks are slabs along a single axis, so every chunk is again a box in group space
+// that the host-callable kernel can iterate. We use the outermost axis that provides
+// enough parallelism to keep rows of groups contiguous within a chunk.
+static void computeDispatchChunks(
+    const uint32_t groupCount[3],
+    uint32_t threadCount,
+    uint32_t& outAxis,
+    uint32_t& outChunkSize,
+    uint32_t& outChunkCount
+)
+{
+    uint32_t targetChunkCount = threadCount * kDispatchChunksPerThread;
+    outAxis = 2;
+    while (outAxis > 0 && groupCount[outAxis] < threadCount)
+        outAxis--;
+    uint32_t extent = groupCount[outAxis];
+    outChunkSize = std::max(1u, (extent + targetChunkCount - 1) / targetChunkCount);
+    outChunkCount = extent == 0 ? 0 : (extent + outChunkSize - 1) / outChunkSize;
+}
+
+static void getDispatchChunk(
+    const uint32_t groupCount[3],
+    uint32_t axis,
+    uint32_t chunkSize,
+    uint32_t chunkIndex,
+    slang_prelude::ComputeVaryingInput& outVaryingInput
+)
+{
+    uint32_t start[3] = {0, 0, 0};
+    uint32_t end[3] = {groupCount[0], groupCount[1], groupCount[2]};
+    if (chunkSize > 0)
+    {
+        start[axis] = chunkIndex * chunkSize;
+        end[axis] = std::min(start[axis] + chunkSize, groupCount[axis]);
+    }
+    outVaryingInput.startGroupID.x = start[0];
+    outVaryingInput.startGroupID.y = start[1];
+    outVaryingInput.startGroupID.z = start[2];
+    outVaryingInput.endGroupID.x = end[0];
+    outVaryingInput.endGroupID.y = end[1];
+    outVaryingInput.endGroupID.z = end[2];
+}
+
+// Edge length in groups of the tiles used by the tiled group orders.
+static const uint32_t kGroupTileExtent = 4;
+
+// Gather the even bits of `v` into the low half.
+static uint32_t compactBits(uint32_t v)
+{
+    v &= 0x55555555;
+    v = (v | (v >> 1)) & 0x33333333;
+    v = (v | (v >> 2)) & 0x0f0f0f0f;
+    v = (v | (v >> 4)) & 0x00ff00ff;
+    v = (v | (v >> 8)) & 0x0000ffff;
+    return v;
+}
+
+// Map a distance along a Hilbert curve filling an `n` x `n` grid (`n` is a power of two) to grid coordinates.
+static void getHilbertCoords(uint32_t n, uint32_t index, uint32_t& outX, uint32_t& outY)
+{
+    uint32_t x = 0;
+    uint32_t y = 0;
+    for (uint32_t s = 1; s < n; s *= 2)
+    {
+        uint32_t rx = 1 & (index / 2);
+        uint32_t ry = 1 & (index ^ rx);
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+        x += s * rx;
+        y += s * ry;
+        index /= 4;
+    }
+    outX = x;
+    outY = y;
+}
+
+void DeviceImpl::updateGroupTiles(const uint32_t groupCount[3], CPUGroupOrder order)
+{
+    if (order == m_groupTilesOrder && groupCount[0] == m_groupTilesCount[0] &&
+        groupCount[1] == m_groupTilesCount[1] && groupCount[2] == m_groupTilesCount[2])
+        return;
+    m_groupTilesOrder = order;
+    for (int i = 0; i < 3; i++)
+        m_groupTilesCount[i] = groupCount[i];
+
+    uint32_t tileCountX = (groupCount[0] + kGroupTileExtent - 1) / kGroupTileExtent;
+    uint32_t tileCountY = (groupCount[1] + kGroupTileExtent - 1) / kGroupTileExtent;
+    uint64_t tileCount = uint64_t(tileCountX) * tileCountY;
+
+    // Space filling curves cover a square power of two grid. For very elongated grids most of the
+    // curve lies outside of the dispatch, so these use raster order on the tiles instead.
+    uint32_t curveExtent = 1;
+    while (curveExtent < std::max(tileCountX, tileCountY))
+        curveExtent *= 2;
+    if (uint64_t(curveExtent) * curveExtent > 4 * tileCount)
+        order = CPUGroupOrder::Tiled;
+
+    m_groupTiles.clear();
+    m_groupTiles.reserve(tileCount * groupCount[2]);
+    for (uint32_t z = 0; z < groupCount[2]; z++)
+    {
+        if (order == CPUGroupOrder::Tiled)
+        {
+            for (uint32_t y = 0; y < tileCountY; y++)
+                for (uint32_t x = 0; x < tileCountX; x++)
+                    m_groupTiles.push_back({x, y, z});
+            continue;
+        }
+        for (uint32_t index = 0; index < curveExtent * curveExtent; index++)
+        {
+            uint32_t x, y;
+            if (order == CPUGroupOrder::Morton)
+            {
+                x = compactBits(index);
+                y = compactBits(index >> 1);
+            }
+            else
+            {
+                getHilbertCoords(curveExtent, index, x, y);
+            }
+            if (x < tileCountX && y < tileCountY)
+                m_groupTiles.push_back({x, y, z});
+        }
+    }
+}
+
 DeviceImpl::~DeviceImpl()
 {
+    // Stop the executor thread. All submitted work holds a reference to the device,
+    // so the queue is either empty or the last reference was released by the executor thread itself.
+    if (m_executor)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_executor->mutex);
+            m_executor->stop = true;
+        }
+        m_executor->workAvailable.notify_all();
+        if (isExecutorThread())
+            m_executorThread.detach();
+        else
+            m_executorThread.join();
+    }
+
     m_currentPipeline = nullptr;
     m_currentRootObject = nullptr;
+    m_threadPool.reset();
 }
 
 SLANG_NO_THROW Result SLANG_MCALL DeviceImpl::initialize(const Desc& desc)
 {
+    // Find extended desc.
+    for (GfxIndex i = 0; i < desc.extendedDescCount; i++)
+    {
+        StructType stype;
+        memcpy(&stype, desc.extendedDescs[i], sizeof(stype));
+        switch (stype)
+        {
+        case StructType::CPUDeviceExtendedDesc:
+            memcpy(&m_extendedDesc, desc.extendedDescs[i], sizeof(m_extendedDesc));
+            break;
+        }
+    }
+    if (m_extendedDesc.kernelCachePath)
+    {
+        m_kernelCachePath = m_extendedDesc.kernelCachePath;
+        m_extendedDesc.kernelCachePath = m_kernelCachePath.c_str();
+    }
+
+    // Kernels that are cached on disk need to be compiled to a shared library.
+    // Both targets share the same layout and calling convention.
     SLANG_RETURN_ON_FAIL(slangContext.initialize(
         desc.slang,
         desc.extendedDescCount,
         desc.extendedDescs,
-        SLANG_SHADER_HOST_CALLABLE,
+        m_kernelCachePath.empty() ? SLANG_SHADER_HOST_CALLABLE : SLANG_SHADER_SHARED_LIBRARY,
         "sm_5_1",
         make_array(slang::PreprocessorMacroDesc{"__CPU__", "1"})
     ));
 
     SLANG_RETURN_ON_FAIL(RendererBase::initialize(desc));
 
+    uint32_t memoryAlignment = m_extendedDesc.memoryAlignment;
+    if (memoryAlignment == 0 || (memoryAlignment & (memoryAlignment - 1)) != 0)
+        return SLANG_E_INVALID_ARG;
+    m_allocator = std::make_shared<MemoryAllocator>(memoryAlignment, m_extendedDesc.useHugePages);
+
+    // Create the worker threads for compute dispatches.
+    // The submitting thread takes part in executing a dispatch, so one less worker is needed.
+    {
+        uint32_t threadCount = m_extendedDesc.workerThreadCount;
+        if (threadCount == 0)
+            threadCount = std::thread::hardware_concurrency();
+        if (threadCount > 1)
+            m_threadPool = std::make_unique<ThreadPool>(threadCount - 1);
+    }
+
+    m_executor = std::make_shared<Executor>();
+    m_executorThread = std::thread(executorMain, m_executor);
+
     // Initialize DeviceInfo
     {
         m_info.deviceType = DeviceType::CPU;
@@ -56,18 +254,72 @@ DeviceImpl::createTexture(const TextureDesc& desc, const SubresourceData* initDa
 
     RefPtr<TextureImpl> texture = new TextureImpl(srcDesc);
 
-    SLANG_RETURN_ON_FAIL(texture->init(initData));
+    SLANG_RETURN_ON_FAIL(texture->init(m_allocator, m_extendedDesc.textureLayout, initData));
 
     returnComPtr(outTexture, texture);
     return SLANG_OK;
 }
 
+SLANG_NO_THROW Result SLANG_MCALL
+DeviceImpl::createBufferFromNativeHandle(NativeHandle handle, const BufferDesc& srcDesc, IBuffer** outBuffer)
+{
+    // Buffers can be created directly over a region of a file, without copying its contents.
+    auto desc = fixupBufferDesc(srcDesc);
+    RefPtr<BufferImpl> buffer = new BufferImpl(desc);
+    SLANG_RETURN_ON_FAIL(buffer->initFromFile(handle, desc.nativeHandleOffset));
+    returnComPtr(outBuffer, buffer);
+    return SLANG_OK;
+}
+
+SLANG_NO_THROW Result SLANG_MCALL DeviceImpl::getMemoryStats(DeviceMemoryStats* outStats)
+{
+    m_allocator->getStats(*outStats);
+    return SLANG_OK;
+}
+
+SLANG_NO_THROW Result SLANG_MCALL DeviceImpl::readTexture(
+    ITexture* texture,
+    ResourceState state,
+    ISlangBlob** outBlob,
+    Size* outRowPitch,
+    Size* outPixelSize
+)
+{
+    SLANG_UNUSED(state);
+
+    auto textureImpl = static_cast<TextureImpl*>(texture);
+
+    // Wait for pending dispatches that may write to the texture.
+    waitForGpu();
+
+    // Block compressed textures are read back in their decoded format, other textures in their own format.
+    Format format = textureImpl->getFormat();
+    auto formatInfo = _getFormatInfo(format);
+    if (formatInfo->decodeBlockFunc)
+    {
+        format = formatInfo->decodedFormat;
+        formatInfo = _getFormatInfo(format);
+    }
+    auto& level = textureImpl->m_mipLevels[0];
+    Size rowPitch = Size(level.extents[0]) * formatInfo->texelSize;
+    Size rowCount = Size(level.extents[1]) * level.extents[2];
+    auto blob = OwnedBlob::create(rowPitch * rowCount);
+    SLANG_RETURN_ON_FAIL(textureImpl->readSubresource(0, 0, format, (void*)blob->getBufferPointer(), rowPitch));
+
+    if (outRowPitch)
+        *outRowPitch = rowPitch;
+    if (outPixelSize)
+        *outPixelSize = formatInfo->texelSize;
+    returnComPtr(outBlob, blob);
+    return SLANG_OK;
+}
+
 SLANG_NO_THROW Result SLANG_MCALL
 DeviceImpl::createBuffer(const BufferDesc& descIn, const void* initData, IBuffer** outBuffer)
 {
     auto desc = fixupBufferDesc(descIn);
     RefPtr<BufferImpl> buffer = new BufferImpl(desc);
-    SLANG_RETURN_ON_FAIL(buffer->init());
+    SLANG_RETURN_ON_FAIL(buffer->init(m_allocator));
     if (initData)
     {
         SLANG_RETURN_ON_FAIL(buffer->setData(0, desc.size, initData));
@@ -150,7 +402,7 @@ SLANG_NO_THROW Result SLANG_MCALL DeviceImpl::createShaderProgram(
 )
 {
     RefPtr<ShaderProgramImpl> cpuProgram = new ShaderProgramImpl();
-    cpuProgram->init(desc);
+    cpuProgram->init(this, desc);
     auto slangGlobalScope = cpuProgram->linkedProgram;
     if (slangGlobalScope)
     {
@@ -199,14 +451,157 @@ SLANG_NO_THROW const DeviceInfo& SLANG_MCALL DeviceImpl::getDeviceInfo() const
 
 SLANG_NO_THROW Result SLANG_MCALL DeviceImpl::createSampler(SamplerDesc const& desc, ISampler** outSampler)
 {
-    SLANG_UNUSED(desc);
-    *outSampler = nullptr;
+    RefPtr<SamplerImpl> sampler = new SamplerImpl();
+    sampler->init(desc);
+    returnComPtr(outSampler, sampler);
+    return SLANG_OK;
+}
+
+SLANG_NO_THROW Result SLANG_MCALL DeviceImpl::createFence(const IFence::Desc& desc, IFence** outFence)
+{
+    RefPtr<FenceImpl> fence = new FenceImpl();
+    fence->init(this, desc);
+    returnComPtr(outFence, fence);
+    return SLANG_OK;
+}
+
+SLANG_NO_THROW Result SLANG_MCALL DeviceImpl::waitForFences(
+    GfxCount fenceCount,
+    IFence** fences,
+    uint64_t* fenceValues,
+    bool waitForAll,
+    uint64_t timeout
+)
+{
+    auto isSignaled = [&]()
+    {
+        for (GfxIndex i = 0; i < fenceCount; i++)
+        {
+            bool signaled = static_cast<FenceImpl*>(fences[i])->m_value >= fenceValues[i];
+            if (signaled && !waitForAll)
+                return true;
+            if (!signaled && waitForAll)
+                return false;
+        }
+        return waitForAll || fenceCount == 0;
+    };
+
+    std::unique_lock<std::mutex> lock(m_fenceMutex);
+    if (timeout == kTimeoutInfinite)
+    {
+        m_fenceSignaled.wait(lock, isSignaled);
+        return SLANG_OK;
+    }
+    return m_fenceSignaled.wait_for(lock, std::chrono::nanoseconds(timeout), isSignaled) ? SLANG_OK
+                                                                                          : SLANG_E_TIME_OUT;
+}
+
+void DeviceImpl::executorMain(std::shared_ptr<Executor> executor)
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(executor->mutex);
+            executor->workAvailable.wait(lock, [&]() { return executor->stop || !executor->tasks.empty(); });
+            if (executor->tasks.empty())
+                return;
+            task = std::move(executor->tasks.front());
+            executor->tasks.pop_front();
+            executor->busy = true;
+        }
+        task();
+        {
+            std::lock_guard<std::mutex> lock(executor->mutex);
+            executor->busy = false;
+            if (executor->tasks.empty())
+                executor->idle.notify_all();
+        }
+        // Releasing the task can release the last reference to the device, so only
+        // the shared executor state may be accessed from here on.
+        task = nullptr;
+    }
+}
+
+void DeviceImpl::enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_executor->mutex);
+        m_executor->tasks.push_back(std::move(task));
+    }
+    m_executor->workAvailable.notify_one();
+}
+
+void DeviceImpl::executeCommandBuffers(
+    GfxCount count,
+    ICommandBuffer* const* commandBuffers,
+    IFence* fence,
+    uint64_t valueToSignal
+)
+{
+    // Specialize and compile all kernels on the submitting thread, so that the executor thread
+    // never accesses the Slang session or the device's shader caches.
+    m_preparedPipelines.clear();
+    prepareCommandBuffers(count, commandBuffers);
+
+    RefPtr<DeviceImpl> device = this;
+    std::vector<ComPtr<ICommandBuffer>> commandBufferRefs(commandBuffers, commandBuffers + count);
+    ComPtr<IFence> fenceRef(fence);
+    enqueue(
+        [device,
+         commandBufferRefs = std::move(commandBufferRefs),
+         pipelines = std::move(m_preparedPipelines),
+         fenceRef,
+         valueToSignal]() mutable
+        {
+            device->m_executingPipelines = std::move(pipelines);
+            device->m_executingDispatchIndex = 0;
+            std::vector<ICommandBuffer*> commandBufferPtrs;
+            for (auto& commandBuffer : commandBufferRefs)
+                commandBufferPtrs.push_back(commandBuffer.get());
+            device->ImmediateComputeDeviceBase::executeCommandBuffers(
+                (GfxCount)commandBufferPtrs.size(),
+                commandBufferPtrs.data(),
+                fenceRef,
+                valueToSignal
+            );
+            device->m_executingPipelines.clear();
+        }
+    );
+}
+
+Result DeviceImpl::waitForFenceValuesOnDevice(GfxCount fenceCount, IFence** fences, uint64_t* waitValues)
+{
+    // Work submitted after this call is executed once the executor thread observed the fence values.
+    RefPtr<DeviceImpl> device = this;
+    std::vector<ComPtr<IFence>> fenceRefs(fences, fences + fenceCount);
+    std::vector<uint64_t> values(waitValues, waitValues + fenceCount);
+    enqueue(
+        [device, fenceRefs = std::move(fenceRefs), values = std::move(values)]() mutable
+        {
+            std::vector<IFence*> fencePtrs;
+            for (auto& fence : fenceRefs)
+                fencePtrs.push_back(fence.get());
+            device->waitForFences((GfxCount)fencePtrs.size(), fencePtrs.data(), values.data(), true, kTimeoutInfinite);
+        }
+    );
     return SLANG_OK;
 }
 
+void DeviceImpl::waitForGpu()
+{
+    // Commands replayed on the executor thread (e.g. buffer uploads) map buffers as well.
+    if (!m_executor || isExecutorThread())
+        return;
+    std::unique_lock<std::mutex> lock(m_executor->mutex);
+    m_executor->idle.wait(lock, [&]() { return !m_executor->busy && m_executor->tasks.empty(); });
+}
+
 void* DeviceImpl::map(IBuffer* buffer, MapFlavor flavor)
 {
     SLANG_UNUSED(flavor);
+    // Make sure pending work accessing the buffer has finished.
+    waitForGpu();
     auto bufferImpl = static_cast<BufferImpl*>(buffer);
     return bufferImpl->m_data;
 }
@@ -228,27 +623,123 @@ void DeviceImpl::bindRootShaderObject(IShaderObject* object)
     m_currentRootObject = static_cast<RootShaderObjectImpl*>(object);
 }
 
-void DeviceImpl::dispatchCompute(int x, int y, int z)
+Result DeviceImpl::getComputeFunc(PipelineImpl* pipeline, const char* entryPointName, slang_prelude::ComputeFunc& outFunc)
 {
+    if (pipeline->m_computeFunc)
+    {
+        outFunc = pipeline->m_computeFunc;
+        return SLANG_OK;
+    }
+
+    if (!m_kernelCachePath.empty())
+    {
+        Result result = loadKernelFromCache(pipeline, entryPointName);
+        // Kernels without an entry point hash cannot be cached, compile them in memory instead.
+        if (result != SLANG_E_NOT_AVAILABLE)
+        {
+            SLANG_RETURN_ON_FAIL(result);
+            outFunc = pipeline->m_computeFunc;
+            return SLANG_OK;
+        }
+    }
+
     int entryPointIndex = 0;
     int targetIndex = 0;
 
-    // Specialize the compute kernel based on the shader object bindings.
-    RefPtr<PipelineBase> newPipeline;
-    maybeSpecializePipeline(m_currentPipeline, m_currentRootObject, newPipeline);
-    m_currentPipeline = static_cast<PipelineImpl*>(newPipeline.Ptr());
+    auto program = pipeline->getProgram();
 
-    auto program = m_currentPipeline->getProgram();
-    auto entryPointLayout = m_currentRootObject->getLayout()->getEntryPoint(entryPointIndex);
-    auto entryPointName = entryPointLayout->getEntryPointName();
+    ComPtr<ISlangSharedLibrary> sharedLibrary;
+    ComPtr<ISlangBlob> diagnostics;
+    Result compileResult;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_slangSessionMutex);
+        compileResult = program->slangGlobalScope->getEntryPointHostCallable(
+            entryPointIndex,
+            targetIndex,
+            sharedLibrary.writeRef(),
+            diagnostics.writeRef()
+        );
+    }
+    if (diagnostics)
+    {
+        getDebugCallback()->handleMessage(
+            compileResult == SLANG_OK ? DebugMessageType::Warning : DebugMessageType::Error,
+            DebugMessageSource::Slang,
+            (char*)diagnostics->getBufferPointer()
+        );
+    }
+    SLANG_RETURN_ON_FAIL(compileResult);
 
-    auto entryPointObject = m_currentRootObject->getEntryPoint(entryPointIndex);
+    auto func = (slang_prelude::ComputeFunc)sharedLibrary->findSymbolAddressByName(entryPointName);
+    if (!func)
+        return SLANG_FAIL;
 
-    ComPtr<ISlangSharedLibrary> sharedLibrary;
+    pipeline->m_sharedLibrary = sharedLibrary;
+    pipeline->m_computeFunc = func;
+    outFunc = func;
+    return SLANG_OK;
+}
+
+Result DeviceImpl::loadKernelFromCache(PipelineImpl* pipeline, const char* entryPointName)
+{
+    int entryPointIndex = 0;
+    int targetIndex = 0;
+
+    auto program = pipeline->getProgram()->slangGlobalScope;
+
+    // Name the library after the entry point hash, which covers all state that affects the generated code.
+    ComPtr<ISlangBlob> hashBlob;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_slangSessionMutex);
+        program->getEntryPointHash(entryPointIndex, targetIndex, hashBlob.writeRef());
+    }
+    if (!hashBlob || hashBlob->getBufferSize() == 0)
+        return SLANG_E_NOT_AVAILABLE;
+    static const char kHexDigits[] = "0123456789abcdef";
+    std::string fileName;
+    auto hashBytes = static_cast<const uint8_t*>(hashBlob->getBufferPointer());
+    for (size_t i = 0; i < hashBlob->getBufferSize(); i++)
+    {
+        fileName += kHexDigits[hashBytes[i] >> 4];
+        fileName += kHexDigits[hashBytes[i] & 0xf];
+    }
+#if SLANG_WINDOWS_FAMILY
+    fileName += ".dll";
+#elif SLANG_APPLE_FAMILY
+    fileName += ".dylib";
+#else
+    fileName += ".so";
+#endif
+    std::filesystem::path libraryPath = std::filesystem::path(m_kernelCachePath) / fileName;
+
+    auto loadLibrary = [&]() -> Result
+    {
+        SharedLibraryHandle handle;
+        SLANG_RETURN_ON_FAIL(loadSharedLibrary(libraryPath.string().c_str(), handle));
+        auto func = (slang_prelude::ComputeFunc)findSymbolAddressByName(handle, entryPointName);
+        if (!func)
+        {
+            unloadSharedLibrary(handle);
+            return SLANG_FAIL;
+        }
+        pipeline->m_sharedLibraryHandle = handle;
+        pipeline->m_computeFunc = func;
+        return SLANG_OK;
+    };
+
+    std::error_code ec;
+    if (std::filesystem::exists(libraryPath, ec))
+    {
+        if (SLANG_SUCCEEDED(loadLibrary()))
+            return SLANG_OK;
+        // The cached library is unusable (e.g. truncated), compile it again.
+        std::filesystem::remove(libraryPath, ec);
+    }
+
+    ComPtr<ISlangBlob> code;
     ComPtr<ISlangBlob> diagnostics;
     auto compileResult =
-        program->slangGlobalScope
-            ->getEntryPointHostCallable(entryPointIndex, targetIndex, sharedLibrary.writeRef(), diagnostics.writeRef());
+        getEntryPointCodeFromShaderCache(program, entryPointIndex, targetIndex, code.writeRef(), diagnostics.writeRef());
     if (diagnostics)
     {
         getDebugCallback()->handleMessage(
@@ -257,22 +748,144 @@ void DeviceImpl::dispatchCompute(int x, int y, int z)
             (char*)diagnostics->getBufferPointer()
         );
     }
-    if (SLANG_FAILED(compileResult))
+    SLANG_RETURN_ON_FAIL(compileResult);
+
+    // Write to a uniquely named file first and move it into place afterwards, so that
+    // other processes sharing the cache directory never load a partially written library.
+    std::filesystem::create_directories(libraryPath.parent_path(), ec);
+    std::filesystem::path tempPath = libraryPath;
+    tempPath += "." +
+                std::to_string(
+                    std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                    (size_t)std::chrono::steady_clock::now().time_since_epoch().count()
+                ) +
+                ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary);
+        if (!stream)
+            return SLANG_FAIL;
+        stream.write((const char*)code->getBufferPointer(), code->getBufferSize());
+        if (!stream)
+        {
+            stream.close();
+            std::filesystem::remove(tempPath, ec);
+            return SLANG_FAIL;
+        }
+    }
+    std::filesystem::rename(tempPath, libraryPath, ec);
+    if (ec)
+    {
+        // Another process may have stored the same library in the meantime.
+        std::filesystem::remove(tempPath, ec);
+        if (!std::filesystem::exists(libraryPath, ec))
+            return SLANG_FAIL;
+    }
+
+    return loadLibrary();
+}
+
+void DeviceImpl::prepareDispatchCompute(PipelineBase* pipeline, ShaderObjectBase* rootObject)
+{
+    int entryPointIndex = 0;
+
+    RefPtr<PipelineImpl> preparedPipeline;
+    if (pipeline && rootObject)
+    {
+        // Specialize the compute kernel based on the shader object bindings.
+        // The dispatch is skipped if the specialization failed or is still pending.
+        RefPtr<PipelineBase> newPipeline;
+        if (SLANG_SUCCEEDED(maybeSpecializePipeline(pipeline, rootObject, newPipeline)))
+        {
+            auto entryPointLayout =
+                static_cast<RootShaderObjectImpl*>(rootObject)->getLayout()->getEntryPoint(entryPointIndex);
+            auto entryPointName = entryPointLayout->getEntryPointName();
+
+            auto specializedPipeline = static_cast<PipelineImpl*>(newPipeline.Ptr());
+            slang_prelude::ComputeFunc func = nullptr;
+            if (SLANG_SUCCEEDED(getComputeFunc(specializedPipeline, entryPointName, func)))
+                preparedPipeline = specializedPipeline;
+        }
+    }
+    m_preparedPipelines.push_back(preparedPipeline);
+}
+
+void DeviceImpl::dispatchCompute(int x, int y, int z)
+{
+    int entryPointIndex = 0;
+
+    // The kernel has been specialized and compiled when the command buffer was submitted.
+    if (m_executingDispatchIndex >= m_executingPipelines.size())
+        return;
+    RefPtr<PipelineImpl> pipeline = m_executingPipelines[m_executingDispatchIndex++];
+    if (!pipeline)
         return;
+    m_currentPipeline = pipeline;
 
-    auto func = (slang_prelude::ComputeFunc)sharedLibrary->findSymbolAddressByName(entryPointName);
+    auto entryPointObject = m_currentRootObject->getEntryPoint(entryPointIndex);
 
-    slang_prelude::ComputeVaryingInput varyingInput;
-    varyingInput.startGroupID.x = 0;
-    varyingInput.startGroupID.y = 0;
-    varyingInput.startGroupID.z = 0;
-    varyingInput.endGroupID.x = x;
-    varyingInput.endGroupID.y = y;
-    varyingInput.endGroupID.z = z;
+    slang_prelude::ComputeFunc func = pipeline->m_computeFunc;
 
     auto globalParamsData = m_currentRootObject->getDataBuffer();
     auto entryPointParamsData = entryPointObject->getDataBuffer();
-    func(&varyingInput, entryPointParamsData, globalParamsData);
+
+    uint32_t groupCount[3] = {uint32_t(x), uint32_t(y), uint32_t(z)};
+
+    // Tiled orders execute the dispatch one tile of groups at a time. Every chunk covers a
+    // contiguous run of tiles in execution order, so each thread works on a compact region.
+    CPUGroupOrder groupOrder = pipeline->desc.compute.cpuGroupOrder;
+    if (groupOrder != CPUGroupOrder::Linear && (groupCount[0] > 1 || groupCount[1] > 1))
+    {
+        updateGroupTiles(groupCount, groupOrder);
+        uint32_t tileCount = uint32_t(m_groupTiles.size());
+        uint32_t tileChunkCount = 1;
+        if (m_threadPool)
+            tileChunkCount = std::max(
+                1u,
+                std::min(tileCount, (m_threadPool->getThreadCount() + 1) * kDispatchChunksPerThread)
+            );
+
+        auto runTileChunk = [&](uint32_t chunkIndex)
+        {
+            uint32_t begin = uint32_t(uint64_t(tileCount) * chunkIndex / tileChunkCount);
+            uint32_t end = uint32_t(uint64_t(tileCount) * (chunkIndex + 1) / tileChunkCount);
+            for (uint32_t tileIndex = begin; tileIndex < end; tileIndex++)
+            {
+                const GroupTile& tile = m_groupTiles[tileIndex];
+                slang_prelude::ComputeVaryingInput varyingInput;
+                varyingInput.startGroupID.x = tile.x * kGroupTileExtent;
+                varyingInput.startGroupID.y = tile.y * kGroupTileExtent;
+                varyingInput.startGroupID.z = tile.z;
+                varyingInput.endGroupID.x = std::min(varyingInput.startGroupID.x + kGroupTileExtent, groupCount[0]);
+                varyingInput.endGroupID.y = std::min(varyingInput.startGroupID.y + kGroupTileExtent, groupCount[1]);
+                varyingInput.endGroupID.z = tile.z + 1;
+                func(&varyingInput, entryPointParamsData, globalParamsData);
+            }
+        };
+
+        if (tileChunkCount <= 1)
+            runTileChunk(0);
+        else
+            m_threadPool->parallelFor(tileChunkCount, runTileChunk);
+        return;
+    }
+
+    uint32_t chunkCount = 1;
+    uint32_t chunkAxis = 0;
+    uint32_t chunkSize = 0;
+    if (m_threadPool)
+        computeDispatchChunks(groupCount, m_threadPool->getThreadCount() + 1, chunkAxis, chunkSize, chunkCount);
+
+    auto runChunk = [&](uint32_t chunkIndex)
+    {
+        slang_prelude::ComputeVaryingInput varyingInput;
+        getDispatchChunk(groupCount, chunkAxis, chunkSize, chunkIndex, varyingInput);
+        func(&varyingInput, entryPointParamsData, globalParamsData);
+    };
+
+    if (chunkCount <= 1)
+        runChunk(0);
+    else
+        m_threadPool->parallelFor(chunkCount, runChunk);
 }
 
 void DeviceImpl::copyBuffer(IBuffer* dst, size_t dstOffset, IBuffer* src, size_t srcOffset, size_t size)
@@ -1,9 +1,21 @@
 #pragma once
 
+#include "cpu-allocator.h"
 #include "cpu-base.h"
 #include "cpu-pipeline.h"
 #include "cpu-shader-object.h"
 
+#include "core/thread-pool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace rhi::cpu {
 
 class DeviceImpl : public ImmediateComputeDeviceBase
@@ -19,6 +31,19 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL
     createBuffer(const BufferDesc& descIn, const void* initData, IBuffer** outBuffer) override;
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    createBufferFromNativeHandle(NativeHandle handle, const BufferDesc& srcDesc, IBuffer** outBuffer) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getMemoryStats(DeviceMemoryStats* outStats) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL readTexture(
+        ITexture* texture,
+        ResourceState state,
+        ISlangBlob** outBlob,
+        Size* outRowPitch,
+        Size* outPixelSize
+    ) override;
+
     virtual SLANG_NO_THROW Result SLANG_MCALL
     createTextureView(ITexture* inTexture, IResourceView::Desc const& desc, IResourceView** outView) override;
 
@@ -59,15 +84,85 @@ public:
 
     virtual SLANG_NO_THROW Result SLANG_MCALL createSampler(SamplerDesc const& desc, ISampler** outSampler) override;
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL createFence(const IFence::Desc& desc, IFence** outFence) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    waitForFences(GfxCount fenceCount, IFence** fences, uint64_t* fenceValues, bool waitForAll, uint64_t timeout)
+        override;
+
+    virtual void executeCommandBuffers(
+        GfxCount count,
+        ICommandBuffer* const* commandBuffers,
+        IFence* fence,
+        uint64_t valueToSignal
+    ) override;
+    virtual Result waitForFenceValuesOnDevice(GfxCount fenceCount, IFence** fences, uint64_t* waitValues) override;
+    virtual void prepareDispatchCompute(PipelineBase* pipeline, ShaderObjectBase* rootObject) override;
+
     virtual void submitGpuWork() override {}
-    virtual void waitForGpu() override {}
+    virtual void waitForGpu() override;
     virtual void* map(IBuffer* buffer, MapFlavor flavor) override;
     virtual void unmap(IBuffer* buffer, size_t offsetWritten, size_t sizeWritten) override;
 
+public:
+    // Guards the values of all fences created by this device.
+    std::mutex m_fenceMutex;
+    std::condition_variable m_fenceSignaled;
+
 private:
+    // State shared between the device and the executor thread.
+    struct Executor
+    {
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable idle;
+        std::deque<std::function<void()>> tasks;
+        bool busy = false;
+        bool stop = false;
+    };
+
+    static void executorMain(std::shared_ptr<Executor> executor);
+    void enqueue(std::function<void()> task);
+    bool isExecutorThread() const { return std::this_thread::get_id() == m_executorThread.get_id(); }
+
+    Result getComputeFunc(PipelineImpl* pipeline, const char* entryPointName, slang_prelude::ComputeFunc& outFunc);
+    // Returns SLANG_E_NOT_AVAILABLE if the kernel has no entry point hash and cannot be cached.
+    Result loadKernelFromCache(PipelineImpl* pipeline, const char* entryPointName);
+
     RefPtr<PipelineImpl> m_currentPipeline = nullptr;
     RefPtr<RootShaderObjectImpl> m_currentRootObject = nullptr;
     DeviceInfo m_info;
+    CPUDeviceExtendedDesc m_extendedDesc;
+    std::string m_kernelCachePath;
+
+    // Allocator for the memory of buffers and textures, shared with the resources.
+    std::shared_ptr<MemoryAllocator> m_allocator;
+
+    // Worker threads used to execute compute dispatches. Null if dispatches run on the submitting thread only.
+    std::unique_ptr<ThreadPool> m_threadPool;
+
+    // Submitted command buffers are executed in order on a dedicated executor thread.
+    std::shared_ptr<Executor> m_executor;
+    std::thread m_executorThread;
+
+    // Specialized pipelines for every dispatch of the batch being submitted, resolved on the submitting thread.
+    std::vector<RefPtr<PipelineImpl>> m_preparedPipelines;
+    // Specialized pipelines of the batch being executed and the index of the next dispatch.
+    // Only accessed on the executor thread.
+    std::vector<RefPtr<PipelineImpl>> m_executingPipelines;
+    size_t m_executingDispatchIndex = 0;
+
+    // Tiles of groups in execution order for the last dispatch that used a tiled group order.
+    // Reused while the group counts and the order stay the same. Only accessed on the executor thread.
+    struct GroupTile
+    {
+        uint32_t x, y, z;
+    };
+    std::vector<GroupTile> m_groupTiles;
+    uint32_t m_groupTilesCount[3] = {0, 0, 0};
+    CPUGroupOrder m_groupTilesOrder = CPUGroupOrder::Linear;
+
+    void updateGroupTiles(const uint32_t groupCount[3], CPUGroupOrder order);
 
     virtual void setPipeline(IPipeline* state) override;
 
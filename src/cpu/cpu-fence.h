@@ -0,0 +1,25 @@
+#pragma once
+
+#include "cpu-base.h"
+
+namespace rhi::cpu {
+
+class FenceImpl : public FenceBase
+{
+public:
+    RefPtr<DeviceImpl> m_device;
+    // Guarded by the device's fence mutex.
+    uint64_t m_value = 0;
+
+    void init(DeviceImpl* device, const IFence::Desc& desc);
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getCurrentValue(uint64_t* outValue) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL setCurrentValue(uint64_t value) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getSharedHandle(NativeHandle* outHandle) override;
+};
+
+} // namespace rhi::cpu
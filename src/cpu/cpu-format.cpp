@@ -0,0 +1,783 @@
+#include "cpu-format.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace rhi::cpu {
+
+// Texel conversions are implemented by "texel traits" classes that provide:
+//
+//   using Value = float | uint32_t | int32_t;  // component type of unpacked values
+//   static const uint32_t kTexelSize;          // size of a texel in bytes
+//   static void unpack(const uint8_t* texel, Value out[4]);
+//   static void pack(const Value in[4], uint8_t* texel);
+//
+// The single texel and row functions stored in the format table are instantiated from
+// these. The per-texel code is fully inlined into the row loops, with the channel count
+// known at compile time, which lets the compiler vectorize whole rows of conversions.
+
+template<typename T>
+SLANG_FORCE_INLINE T loadValue(const uint8_t* ptr)
+{
+    T value;
+    memcpy(&value, ptr, sizeof(T));
+    return value;
+}
+
+template<typename T>
+SLANG_FORCE_INLINE void storeValue(uint8_t* ptr, T value)
+{
+    memcpy(ptr, &value, sizeof(T));
+}
+
+template<typename Value>
+SLANG_FORCE_INLINE void setDefaultValues(Value out[4], int firstComponent)
+{
+    for (int i = firstComponent; i < 3; ++i)
+        out[i] = Value(0);
+    if (firstComponent < 4)
+        out[3] = Value(1);
+}
+
+static uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t biasedExponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    // Inf / NaN.
+    if (biasedExponent == 0xff)
+        return uint16_t(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+
+    int32_t exponent = int32_t(biasedExponent) - 127 + 15;
+    if (exponent >= 31)
+        return uint16_t(sign | 0x7c00);
+    if (exponent <= 0)
+    {
+        // Denormal or zero.
+        if (exponent < -10)
+            return uint16_t(sign);
+        mantissa |= 0x800000;
+        uint32_t shift = uint32_t(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1)
+            half++;
+        return uint16_t(sign | half);
+    }
+    uint32_t half = sign | (uint32_t(exponent) << 10) | (mantissa >> 13);
+    // Round to nearest. A carry into the exponent correctly rounds up to the next power of two.
+    if (mantissa & 0x1000)
+        half++;
+    return uint16_t(half);
+}
+
+//
+// Plain channel formats.
+//
+
+template<int N>
+struct FloatTexel
+{
+    using Value = float;
+    static const uint32_t kTexelSize = N * 4;
+    static void unpack(const uint8_t* texel, float out[4])
+    {
+        memcpy(out, texel, N * sizeof(float));
+        setDefaultValues(out, N);
+    }
+    static void pack(const float in[4], uint8_t* texel) { memcpy(texel, in, N * sizeof(float)); }
+};
+
+template<int N>
+struct HalfTexel
+{
+    using Value = float;
+    static const uint32_t kTexelSize = N * 2;
+    static void unpack(const uint8_t* texel, float out[4])
+    {
+        for (int i = 0; i < N; ++i)
+            out[i] = math::halfToFloat(loadValue<uint16_t>(texel + i * 2));
+        setDefaultValues(out, N);
+    }
+    static void pack(const float in[4], uint8_t* texel)
+    {
+        for (int i = 0; i < N; ++i)
+            storeValue<uint16_t>(texel + i * 2, floatToHalf(in[i]));
+    }
+};
+
+template<typename T, int N>
+struct UIntTexel
+{
+    using Value = uint32_t;
+    static const uint32_t kTexelSize = N * sizeof(T);
+    static void unpack(const uint8_t* texel, uint32_t out[4])
+    {
+        for (int i = 0; i < N; ++i)
+            out[i] = loadValue<T>(texel + i * sizeof(T));
+        setDefaultValues(out, N);
+    }
+    static void pack(const uint32_t in[4], uint8_t* texel)
+    {
+        for (int i = 0; i < N; ++i)
+            storeValue<T>(texel + i * sizeof(T), T(std::min<uint32_t>(in[i], std::numeric_limits<T>::max())));
+    }
+};
+
+template<typename T, int N>
+struct SIntTexel
+{
+    using Value = int32_t;
+    static const uint32_t kTexelSize = N * sizeof(T);
+    static void unpack(const uint8_t* texel, int32_t out[4])
+    {
+        for (int i = 0; i < N; ++i)
+            out[i] = loadValue<T>(texel + i * sizeof(T));
+        setDefaultValues(out, N);
+    }
+    static void pack(const int32_t in[4], uint8_t* texel)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            int32_t value =
+                std::clamp<int32_t>(in[i], std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+            storeValue<T>(texel + i * sizeof(T), T(value));
+        }
+    }
+};
+
+template<typename T, int N>
+struct UnormTexel
+{
+    using Value = float;
+    static const uint32_t kTexelSize = N * sizeof(T);
+    static constexpr float kScale = float(std::numeric_limits<T>::max());
+    static void unpack(const uint8_t* texel, float out[4])
+    {
+        for (int i = 0; i < N; ++i)
+            out[i] = float(loadValue<T>(texel + i * sizeof(T))) * (1.0f / kScale);
+        setDefaultValues(out, N);
+    }
+    static void pack(const float in[4], uint8_t* texel)
+    {
+        for (int i = 0; i < N; ++i)
+            storeValue<T>(texel + i * sizeof(T), T(std::clamp(in[i], 0.0f, 1.0f) * kScale + 0.5f));
+    }
+};
+
+template<typename T, int N>
+struct SnormTexel
+{
+    using Value = float;
+    static const uint32_t kTexelSize = N * sizeof(T);
+    static constexpr float kScale = float(std::numeric_limits<T>::max());
+    static void unpack(const uint8_t* texel, float out[4])
+    {
+        // The most negative value maps to -1 as well.
+        for (int i = 0; i < N; ++i)
+            out[i] = std::max(float(loadValue<T>(texel + i * sizeof(T))) * (1.0f / kScale), -1.0f);
+        setDefaultValues(out, N);
+    }
+    static void pack(const float in[4], uint8_t* texel)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            float value = std::clamp(in[i], -1.0f, 1.0f) * kScale;
+            storeValue<T>(texel + i * sizeof(T), T(value >= 0.0f ? value + 0.5f : value - 0.5f));
+        }
+    }
+};
+
+struct SrgbTable
+{
+    SrgbTable()
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            float value = i / 255.0f;
+            values[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+    }
+    float values[256];
+};
+
+static const SrgbTable g_srgbTable;
+
+static SLANG_FORCE_INLINE uint8_t linearToSrgb8(float value)
+{
+    value = std::clamp(value, 0.0f, 1.0f);
+    value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return uint8_t(value * 255.0f + 0.5f);
+}
+
+/// 8-bit sRGB color channels with a linear alpha channel.
+template<int N>
+struct SrgbTexel
+{
+    using Value = float;
+    static const uint32_t kTexelSize = N;
+    static void unpack(const uint8_t* texel, float out[4])
+    {
+        for (int i = 0; i < std::min(N, 3); ++i)
+            out[i] = g_srgbTable.values[texel[i]];
+        if (N == 4)
+            out[3] = texel[3] * (1.0f / 255.0f);
+        setDefaultValues(out, N);
+    }
+    static void pack(const float in[4], uint8_t* texel)
+    {
+        for (int i = 0; i < std::min(N, 3); ++i)
+            texel[i] = linearToSrgb8(in[i]);
+        if (N == 4)
+            texel[3] = uint8_t(std::clamp(in[3], 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+};
+
+/// Adapts 4-channel traits to a BGRA channel order.
+template<typename Base>
+struct BGRATexel
+{
+    using Value = typename Base::Value;
+    static const uint32_t kTexelSize = Base::kTexelSize;
+    static void unpack(const uint8_t* texel, Value out[4])
+    {
+        Base::unpack(texel, out);
+        std::swap(out[0], out[2]);
+    }
+    static void pack(const Value in[4], uint8_t* texel)
+    {
+        Value swizzled[4] = {in[2], in[1], in[0], in[3]};
+        Base::pack(swizzled, texel);
+    }
+};
+
+/// Adapts 4-channel traits to a format with an unused alpha channel.
+template<typename Base>
+struct OpaqueTexel
+{
+    using Value = typename Base::Value;
+    static const uint32_t kTexelSize = Base::kTexelSize;
+    static void unpack(const uint8_t* texel, Value out[4])
+    {
+        Base::unpack(texel, out);
+        out[3] = Value(1);
+    }
+    static void pack(const Value in[4], uint8_t* texel)
+    {
+        Value opaque[4] = {in[0], in[1], in[2], Value(1)};
+        Base::pack(opaque, texel);
+    }
+};
+
+/// Depth formats with a 32-bit float depth followed by 32 bits of stencil or padding.
+struct Depth32PaddedTexel
+{
+    using Value = float;
+    static const uint32_t kTexelSize = 8;
+    static void unpack(const uint8_t* texel, float out[4])
+    {
+        out[0] = loadValue<float>(texel);
+        setDefaultValues(out, 1);
+    }
+    static void pack(const float in[4], uint8_t* texel)
+    {
+        storeValue<float>(texel, in[0]);
+        storeValue<uint32_t>(texel + 4, 0);
+    }
+};
+
+//
+// Packed formats.
+//
+
+/// Packed unorm formats. Shifts and widths of the components are given in RGBA order,
+/// components with a width of 0 are absent.
+template<typename T, int S0, int W0, int S1, int W1, int S2, int W2, int S3, int W3>
+struct PackedUnormTexel
+{
+    using Value = float;
+    static const uint32_t kTexelSize = sizeof(T);
+    static constexpr int kShifts[4] = {S0, S1, S2, S3};
+    static constexpr int kWidths[4] = {W0, W1, W2, W3};
+    static void unpack(const uint8_t* texel, float out[4])
+    {
+        uint32_t bits = loadValue<T>(texel);
+        for (int i = 0; i < 4; ++i)
+        {
+            uint32_t mask = (1u << kWidths[i]) - 1;
+            out[i] = kWidths[i] ? float((bits >> kShifts[i]) & mask) / float(mask) : (i == 3 ? 1.0f : 0.0f);
+        }
+    }
+    static void pack(const float in[4], uint8_t* texel)
+    {
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            uint32_t mask = (1u << kWidths[i]) - 1;
+            if (kWidths[i])
+                bits |= uint32_t(std::clamp(in[i], 0.0f, 1.0f) * float(mask) + 0.5f) << kShifts[i];
+        }
+        storeValue<T>(texel, T(bits));
+    }
+};
+
+struct R10G10B10A2UIntTexel
+{
+    using Value = uint32_t;
+    static const uint32_t kTexelSize = 4;
+    static constexpr int kShifts[4] = {0, 10, 20, 30};
+    static constexpr uint32_t kMasks[4] = {0x3ff, 0x3ff, 0x3ff, 0x3};
+    static void unpack(const uint8_t* texel, uint32_t out[4])
+    {
+        uint32_t bits = loadValue<uint32_t>(texel);
+        for (int i = 0; i < 4; ++i)
+            out[i] = (bits >> kShifts[i]) & kMasks[i];
+    }
+    static void pack(const uint32_t in[4], uint8_t* texel)
+    {
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; ++i)
+            bits |= std::min(in[i], kMasks[i]) << kShifts[i];
+        storeValue<uint32_t>(texel, bits);
+    }
+};
+
+struct R11G11B10FloatTexel
+{
+    using Value = float;
+    static const uint32_t kTexelSize = 4;
+    // The 11 and 10 bit floats share the exponent bias and width of half floats
+    // but have no sign bit and fewer mantissa bits.
+    static void unpack(const uint8_t* texel, float out[4])
+    {
+        uint32_t bits = loadValue<uint32_t>(texel);
+        out[0] = math::halfToFloat(uint16_t((bits & 0x7ff) << 4));
+        out[1] = math::halfToFloat(uint16_t(((bits >> 11) & 0x7ff) << 4));
+        out[2] = math::halfToFloat(uint16_t(((bits >> 22) & 0x3ff) << 5));
+        out[3] = 1.0f;
+    }
+    static void pack(const float in[4], uint8_t* texel)
+    {
+        uint32_t bits = 0;
+        bits |= uint32_t(floatToHalf(std::max(in[0], 0.0f)) >> 4) & 0x7ff;
+        bits |= (uint32_t(floatToHalf(std::max(in[1], 0.0f)) >> 4) & 0x7ff) << 11;
+        bits |= (uint32_t(floatToHalf(std::max(in[2], 0.0f)) >> 5) & 0x3ff) << 22;
+        storeValue<uint32_t>(texel, bits);
+    }
+};
+
+struct R9G9B9E5Texel
+{
+    using Value = float;
+    static const uint32_t kTexelSize = 4;
+    static void unpack(const uint8_t* texel, float out[4])
+    {
+        uint32_t bits = loadValue<uint32_t>(texel);
+        float scale = std::ldexp(1.0f, int(bits >> 27) - 15 - 9);
+        out[0] = float(bits & 0x1ff) * scale;
+        out[1] = float((bits >> 9) & 0x1ff) * scale;
+        out[2] = float((bits >> 18) & 0x1ff) * scale;
+        out[3] = 1.0f;
+    }
+    static void pack(const float in[4], uint8_t* texel)
+    {
+        const float kMaxValue = 65408.0f;
+        float r = std::clamp(in[0], 0.0f, kMaxValue);
+        float g = std::clamp(in[1], 0.0f, kMaxValue);
+        float b = std::clamp(in[2], 0.0f, kMaxValue);
+        float maxComponent = std::max({r, g, b});
+        int exponent = maxComponent > 0.0f ? std::max(-16, int(std::floor(std::log2(maxComponent)))) + 16 : 0;
+        float scale = std::ldexp(1.0f, exponent - 15 - 9);
+        if (uint32_t(maxComponent / scale + 0.5f) == 512)
+        {
+            scale *= 2.0f;
+            exponent++;
+        }
+        uint32_t bits = uint32_t(r / scale + 0.5f) | (uint32_t(g / scale + 0.5f) << 9) |
+                        (uint32_t(b / scale + 0.5f) << 18) | (uint32_t(exponent) << 27);
+        storeValue<uint32_t>(texel, bits);
+    }
+};
+
+//
+// Block compressed formats.
+//
+
+static void decodeBC1Colors(const uint8_t* block, bool allowTransparency, uint8_t outColors[16][4])
+{
+    uint16_t endpoints[2] = {loadValue<uint16_t>(block), loadValue<uint16_t>(block + 2)};
+    uint8_t palette[4][4];
+    for (int i = 0; i < 2; ++i)
+    {
+        uint32_t c = endpoints[i];
+        palette[i][0] = uint8_t(((c >> 11) & 0x1f) * 255 / 31);
+        palette[i][1] = uint8_t(((c >> 5) & 0x3f) * 255 / 63);
+        palette[i][2] = uint8_t((c & 0x1f) * 255 / 31);
+        palette[i][3] = 255;
+    }
+    if (endpoints[0] > endpoints[1] || !allowTransparency)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = uint8_t((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = uint8_t((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        }
+        palette[2][3] = palette[3][3] = 255;
+    }
+    else
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = uint8_t((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;
+    }
+    uint32_t indices = loadValue<uint32_t>(block + 4);
+    for (int i = 0; i < 16; ++i)
+        memcpy(outColors[i], palette[(indices >> (2 * i)) & 3], 4);
+}
+
+static void decodeBC4Channel(const uint8_t* block, bool isSigned, float outValues[16])
+{
+    float palette[8];
+    if (isSigned)
+    {
+        palette[0] = std::max(int8_t(block[0]) / 127.0f, -1.0f);
+        palette[1] = std::max(int8_t(block[1]) / 127.0f, -1.0f);
+    }
+    else
+    {
+        palette[0] = block[0] / 255.0f;
+        palette[1] = block[1] / 255.0f;
+    }
+    bool sixValueMode = isSigned ? int8_t(block[0]) <= int8_t(block[1]) : block[0] <= block[1];
+    if (!sixValueMode)
+    {
+        for (int i = 1; i < 7; ++i)
+            palette[i + 1] = (palette[0] * (7 - i) + palette[1] * i) / 7.0f;
+    }
+    else
+    {
+        for (int i = 1; i < 5; ++i)
+            palette[i + 1] = (palette[0] * (5 - i) + palette[1] * i) / 5.0f;
+        palette[6] = isSigned ? -1.0f : 0.0f;
+        palette[7] = 1.0f;
+    }
+    uint64_t indices = 0;
+    memcpy(&indices, block + 2, 6);
+    for (int i = 0; i < 16; ++i)
+        outValues[i] = palette[(indices >> (3 * i)) & 7];
+}
+
+template<typename T, int N>
+static void storeDecodedBlock(const T values[16][N], void* outData, size_t outRowStride)
+{
+    for (int y = 0; y < 4; ++y)
+        memcpy((uint8_t*)outData + y * outRowStride, values[y * 4], 4 * N * sizeof(T));
+}
+
+static void decodeBC1Block(const void* blockData, void* outData, size_t outRowStride)
+{
+    uint8_t colors[16][4];
+    decodeBC1Colors((const uint8_t*)blockData, true, colors);
+    storeDecodedBlock<uint8_t, 4>(colors, outData, outRowStride);
+}
+
+static void decodeBC2Block(const void* blockData, void* outData, size_t outRowStride)
+{
+    auto block = (const uint8_t*)blockData;
+    uint8_t colors[16][4];
+    decodeBC1Colors(block + 8, false, colors);
+    uint64_t alpha = loadValue<uint64_t>(block);
+    for (int i = 0; i < 16; ++i)
+        colors[i][3] = uint8_t(((alpha >> (4 * i)) & 0xf) * 17);
+    storeDecodedBlock<uint8_t, 4>(colors, outData, outRowStride);
+}
+
+static void decodeBC3Block(const void* blockData, void* outData, size_t outRowStride)
+{
+    auto block = (const uint8_t*)blockData;
+    uint8_t colors[16][4];
+    decodeBC1Colors(block + 8, false, colors);
+    float alpha[16];
+    decodeBC4Channel(block, false, alpha);
+    for (int i = 0; i < 16; ++i)
+        colors[i][3] = uint8_t(alpha[i] * 255.0f + 0.5f);
+    storeDecodedBlock<uint8_t, 4>(colors, outData, outRowStride);
+}
+
+template<bool kSigned>
+static void decodeBC4Block(const void* blockData, void* outData, size_t outRowStride)
+{
+    float values[16][1];
+    decodeBC4Channel((const uint8_t*)blockData, kSigned, &values[0][0]);
+    storeDecodedBlock<float, 1>(values, outData, outRowStride);
+}
+
+template<bool kSigned>
+static void decodeBC5Block(const void* blockData, void* outData, size_t outRowStride)
+{
+    auto block = (const uint8_t*)blockData;
+    float red[16], green[16];
+    decodeBC4Channel(block, kSigned, red);
+    decodeBC4Channel(block + 8, kSigned, green);
+    float values[16][2];
+    for (int i = 0; i < 16; ++i)
+    {
+        values[i][0] = red[i];
+        values[i][1] = green[i];
+    }
+    storeDecodedBlock<float, 2>(values, outData, outRowStride);
+}
+
+//
+// Format table.
+//
+
+template<typename Traits>
+struct IsUnpackedTexel : std::false_type
+{};
+template<int N>
+struct IsUnpackedTexel<FloatTexel<N>> : std::true_type
+{};
+template<int N>
+struct IsUnpackedTexel<UIntTexel<uint32_t, N>> : std::true_type
+{};
+template<int N>
+struct IsUnpackedTexel<SIntTexel<int32_t, N>> : std::true_type
+{};
+
+template<typename Value>
+static constexpr CPUTextureValueType getValueType()
+{
+    return std::is_same_v<Value, float>      ? CPUTextureValueType::Float
+           : std::is_same_v<Value, uint32_t> ? CPUTextureValueType::UInt
+                                             : CPUTextureValueType::SInt;
+}
+
+template<typename Traits>
+static void unpackTexel(void const* texelData, void* outData, size_t outSize)
+{
+    typename Traits::Value temp[4];
+    Traits::unpack((const uint8_t*)texelData, temp);
+    memcpy(outData, temp, std::min(outSize, sizeof(temp)));
+}
+
+template<typename Traits>
+static void unpackRow(void const* texelData, void* outData, size_t count)
+{
+    auto src = (const uint8_t*)texelData;
+    auto dst = (typename Traits::Value*)outData;
+    for (size_t i = 0; i < count; ++i)
+        Traits::unpack(src + i * Traits::kTexelSize, dst + i * 4);
+}
+
+template<typename Traits>
+static void packRow(void const* inData, void* texelData, size_t count)
+{
+    auto src = (const typename Traits::Value*)inData;
+    auto dst = (uint8_t*)texelData;
+    for (size_t i = 0; i < count; ++i)
+        Traits::pack(src + i * 4, dst + i * Traits::kTexelSize);
+}
+
+struct CPUFormatInfoMap
+{
+    CPUFormatInfoMap()
+    {
+        memset(m_infos, 0, sizeof(m_infos));
+
+        setTypeless<UIntTexel<uint32_t, 4>>(Format::R32G32B32A32_TYPELESS);
+        setTypeless<UIntTexel<uint32_t, 3>>(Format::R32G32B32_TYPELESS);
+        setTypeless<UIntTexel<uint32_t, 2>>(Format::R32G32_TYPELESS);
+        setTypeless<UIntTexel<uint32_t, 1>>(Format::R32_TYPELESS);
+        setTypeless<UIntTexel<uint16_t, 4>>(Format::R16G16B16A16_TYPELESS);
+        setTypeless<UIntTexel<uint16_t, 2>>(Format::R16G16_TYPELESS);
+        setTypeless<UIntTexel<uint16_t, 1>>(Format::R16_TYPELESS);
+        setTypeless<UIntTexel<uint8_t, 4>>(Format::R8G8B8A8_TYPELESS);
+        setTypeless<UIntTexel<uint8_t, 2>>(Format::R8G8_TYPELESS);
+        setTypeless<UIntTexel<uint8_t, 1>>(Format::R8_TYPELESS);
+        setTypeless<UIntTexel<uint8_t, 4>>(Format::B8G8R8A8_TYPELESS);
+
+        set<FloatTexel<4>>(Format::R32G32B32A32_FLOAT);
+        set<FloatTexel<3>>(Format::R32G32B32_FLOAT);
+        set<FloatTexel<2>>(Format::R32G32_FLOAT);
+        set<FloatTexel<1>>(Format::R32_FLOAT);
+
+        set<HalfTexel<4>>(Format::R16G16B16A16_FLOAT);
+        set<HalfTexel<2>>(Format::R16G16_FLOAT);
+        set<HalfTexel<1>>(Format::R16_FLOAT);
+
+        set<UIntTexel<uint32_t, 4>>(Format::R32G32B32A32_UINT);
+        set<UIntTexel<uint32_t, 3>>(Format::R32G32B32_UINT);
+        set<UIntTexel<uint32_t, 2>>(Format::R32G32_UINT);
+        set<UIntTexel<uint32_t, 1>>(Format::R32_UINT);
+        set<UIntTexel<uint16_t, 4>>(Format::R16G16B16A16_UINT);
+        set<UIntTexel<uint16_t, 2>>(Format::R16G16_UINT);
+        set<UIntTexel<uint16_t, 1>>(Format::R16_UINT);
+        set<UIntTexel<uint8_t, 4>>(Format::R8G8B8A8_UINT);
+        set<UIntTexel<uint8_t, 2>>(Format::R8G8_UINT);
+        set<UIntTexel<uint8_t, 1>>(Format::R8_UINT);
+
+        set<SIntTexel<int32_t, 4>>(Format::R32G32B32A32_SINT);
+        set<SIntTexel<int32_t, 3>>(Format::R32G32B32_SINT);
+        set<SIntTexel<int32_t, 2>>(Format::R32G32_SINT);
+        set<SIntTexel<int32_t, 1>>(Format::R32_SINT);
+        set<SIntTexel<int16_t, 4>>(Format::R16G16B16A16_SINT);
+        set<SIntTexel<int16_t, 2>>(Format::R16G16_SINT);
+        set<SIntTexel<int16_t, 1>>(Format::R16_SINT);
+        set<SIntTexel<int8_t, 4>>(Format::R8G8B8A8_SINT);
+        set<SIntTexel<int8_t, 2>>(Format::R8G8_SINT);
+        set<SIntTexel<int8_t, 1>>(Format::R8_SINT);
+
+        set<UnormTexel<uint16_t, 4>>(Format::R16G16B16A16_UNORM);
+        set<UnormTexel<uint16_t, 2>>(Format::R16G16_UNORM);
+        set<UnormTexel<uint16_t, 1>>(Format::R16_UNORM);
+
+        set<UnormTexel<uint8_t, 4>>(Format::R8G8B8A8_UNORM);
+        set<SrgbTexel<4>>(Format::R8G8B8A8_UNORM_SRGB);
+        set<UnormTexel<uint8_t, 2>>(Format::R8G8_UNORM);
+        set<UnormTexel<uint8_t, 1>>(Format::R8_UNORM);
+        set<BGRATexel<UnormTexel<uint8_t, 4>>>(Format::B8G8R8A8_UNORM);
+        set<BGRATexel<SrgbTexel<4>>>(Format::B8G8R8A8_UNORM_SRGB);
+        set<OpaqueTexel<BGRATexel<UnormTexel<uint8_t, 4>>>>(Format::B8G8R8X8_UNORM);
+        set<OpaqueTexel<BGRATexel<SrgbTexel<4>>>>(Format::B8G8R8X8_UNORM_SRGB);
+
+        set<SnormTexel<int16_t, 4>>(Format::R16G16B16A16_SNORM);
+        set<SnormTexel<int16_t, 2>>(Format::R16G16_SNORM);
+        set<SnormTexel<int16_t, 1>>(Format::R16_SNORM);
+        set<SnormTexel<int8_t, 4>>(Format::R8G8B8A8_SNORM);
+        set<SnormTexel<int8_t, 2>>(Format::R8G8_SNORM);
+        set<SnormTexel<int8_t, 1>>(Format::R8_SNORM);
+
+        set<FloatTexel<1>>(Format::D32_FLOAT);
+        set<UnormTexel<uint16_t, 1>>(Format::D16_UNORM);
+        set<Depth32PaddedTexel>(Format::D32_FLOAT_S8_UINT);
+        set<Depth32PaddedTexel>(Format::R32_FLOAT_X32_TYPELESS);
+
+        set<PackedUnormTexel<uint16_t, 8, 4, 4, 4, 0, 4, 12, 4>>(Format::B4G4R4A4_UNORM);
+        set<PackedUnormTexel<uint16_t, 11, 5, 5, 6, 0, 5, 0, 0>>(Format::B5G6R5_UNORM);
+        set<PackedUnormTexel<uint16_t, 10, 5, 5, 5, 0, 5, 15, 1>>(Format::B5G5R5A1_UNORM);
+
+        set<R9G9B9E5Texel>(Format::R9G9B9E5_SHAREDEXP);
+        setTypeless<R10G10B10A2UIntTexel>(Format::R10G10B10A2_TYPELESS);
+        set<PackedUnormTexel<uint32_t, 0, 10, 10, 10, 20, 10, 30, 2>>(Format::R10G10B10A2_UNORM);
+        set<R10G10B10A2UIntTexel>(Format::R10G10B10A2_UINT);
+        set<R11G11B10FloatTexel>(Format::R11G11B10_FLOAT);
+
+        // BC6H and BC7 are not supported.
+        setBlock(Format::BC1_UNORM, 8, &decodeBC1Block, Format::R8G8B8A8_UNORM);
+        setBlock(Format::BC1_UNORM_SRGB, 8, &decodeBC1Block, Format::R8G8B8A8_UNORM_SRGB);
+        setBlock(Format::BC2_UNORM, 16, &decodeBC2Block, Format::R8G8B8A8_UNORM);
+        setBlock(Format::BC2_UNORM_SRGB, 16, &decodeBC2Block, Format::R8G8B8A8_UNORM_SRGB);
+        setBlock(Format::BC3_UNORM, 16, &decodeBC3Block, Format::R8G8B8A8_UNORM);
+        setBlock(Format::BC3_UNORM_SRGB, 16, &decodeBC3Block, Format::R8G8B8A8_UNORM_SRGB);
+        setBlock(Format::BC4_UNORM, 8, &decodeBC4Block<false>, Format::R32_FLOAT);
+        setBlock(Format::BC4_SNORM, 8, &decodeBC4Block<true>, Format::R32_FLOAT);
+        setBlock(Format::BC5_UNORM, 16, &decodeBC5Block<false>, Format::R32G32_FLOAT);
+        setBlock(Format::BC5_SNORM, 16, &decodeBC5Block<true>, Format::R32G32_FLOAT);
+
+        // 64-bit integers are unpacked as pairs of 32-bit components, which preserves their bit pattern.
+        set<UIntTexel<uint32_t, 2>>(Format::R64_UINT);
+        set<SIntTexel<int32_t, 2>>(Format::R64_SINT);
+    }
+
+    template<typename Traits>
+    void set(Format format)
+    {
+        auto& info = m_infos[Index(format)];
+        info.unpackFunc = &unpackTexel<Traits>;
+        info.unpackRowFunc = &unpackRow<Traits>;
+        info.packRowFunc = &packRow<Traits>;
+        info.valueType = getValueType<typename Traits::Value>();
+        info.texelSize = Traits::kTexelSize;
+        info.isUnpacked = IsUnpackedTexel<Traits>::value;
+    }
+
+    // Typeless formats store the bits of the typed formats that views reinterpret them as.
+    template<typename Traits>
+    void setTypeless(Format format)
+    {
+        set<Traits>(format);
+        m_infos[Index(format)].isTypeless = true;
+    }
+
+    void setBlock(Format format, uint32_t blockSize, CPUTextureDecodeBlockFunc func, Format decodedFormat)
+    {
+        auto& info = m_infos[Index(format)];
+        info.valueType = CPUTextureValueType::Float;
+        info.texelSize = blockSize;
+        info.decodeBlockFunc = func;
+        info.decodedFormat = decodedFormat;
+    }
+
+    SLANG_FORCE_INLINE const CPUTextureFormatInfo& get(Format format) const { return m_infos[Index(format)]; }
+
+    CPUTextureFormatInfo m_infos[Index(Format::_Count)];
+};
+
+static const CPUFormatInfoMap g_formatInfoMap;
+
+CPUTextureFormatInfo const* _getFormatInfo(Format format)
+{
+    const CPUTextureFormatInfo& info = g_formatInfoMap.get(format);
+    return (info.unpackFunc || info.decodeBlockFunc) ? &info : nullptr;
+}
+
+Format getWritableStorageFormat(Format format)
+{
+    auto info = _getFormatInfo(format);
+    // Typeless textures keep their layout so that views can reinterpret the texels.
+    if (!info || info->decodeBlockFunc || info->isUnpacked || info->isTypeless)
+        return format;
+    switch (info->valueType)
+    {
+    case CPUTextureValueType::Float:
+        return Format::R32G32B32A32_FLOAT;
+    case CPUTextureValueType::UInt:
+        return Format::R32G32B32A32_UINT;
+    case CPUTextureValueType::SInt:
+        return Format::R32G32B32A32_SINT;
+    }
+    return format;
+}
+
+Result convertTexels(Format srcFormat, void const* srcData, Format dstFormat, void* dstData, size_t count)
+{
+    auto srcInfo = _getFormatInfo(srcFormat);
+    auto dstInfo = _getFormatInfo(dstFormat);
+    if (!srcInfo || !dstInfo || !srcInfo->unpackRowFunc || !dstInfo->packRowFunc)
+        return SLANG_E_NOT_AVAILABLE;
+    if (srcInfo->valueType != dstInfo->valueType)
+        return SLANG_E_INVALID_ARG;
+
+    if (srcFormat == dstFormat)
+    {
+        memcpy(dstData, srcData, count * srcInfo->texelSize);
+        return SLANG_OK;
+    }
+
+    // Convert in batches small enough for the intermediate values to stay in L1.
+    static const size_t kBatchSize = 256;
+    uint32_t values[kBatchSize * 4];
+    auto src = (const uint8_t*)srcData;
+    auto dst = (uint8_t*)dstData;
+    while (count > 0)
+    {
+        size_t batchSize = std::min(count, kBatchSize);
+        srcInfo->unpackRowFunc(src, values, batchSize);
+        dstInfo->packRowFunc(values, dst, batchSize);
+        src += batchSize * srcInfo->texelSize;
+        dst += batchSize * dstInfo->texelSize;
+        count -= batchSize;
+    }
+    return SLANG_OK;
+}
+
+} // namespace rhi::cpu
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "cpu-base.h"
+
+namespace rhi::cpu {
+
+/// Unpack a single texel to a 4-component value and copy the first `outSize` bytes to `outData`.
+/// Float, unorm, snorm and sRGB formats unpack to `float[4]` (sRGB is decoded to linear),
+/// integer formats unpack to `uint32_t[4]` or `int32_t[4]`.
+/// Missing components are filled with (0, 0, 0, 1).
+typedef void (*CPUTextureUnpackFunc)(void const* texelData, void* outData, size_t outSize);
+
+/// Unpack `count` consecutive texels to `count` 4-component values.
+typedef void (*CPUTextureUnpackRowFunc)(void const* texelData, void* outData, size_t count);
+
+/// Pack `count` 4-component values to `count` consecutive texels.
+typedef void (*CPUTexturePackRowFunc)(void const* inData, void* texelData, size_t count);
+
+/// Decode a single 4x4 block of a block compressed format.
+/// The texels are written in the format's `decodedFormat`, rows are `outRowStride` bytes apart.
+typedef void (*CPUTextureDecodeBlockFunc)(void const* blockData, void* outData, size_t outRowStride);
+
+enum class CPUTextureValueType
+{
+    Float,
+    UInt,
+    SInt,
+};
+
+struct CPUTextureFormatInfo
+{
+    CPUTextureUnpackFunc unpackFunc;
+    CPUTextureUnpackRowFunc unpackRowFunc;
+    CPUTexturePackRowFunc packRowFunc;
+    /// Type of the components of unpacked values.
+    CPUTextureValueType valueType;
+    /// Size of a texel in bytes. For block compressed formats, the size of a block.
+    uint32_t texelSize;
+    /// True if texels are made of 32-bit components that unpack without conversion.
+    bool isUnpacked;
+    /// True for typeless formats.
+    bool isTypeless;
+
+    /// Set for block compressed formats, which are stored decoded to `decodedFormat`.
+    CPUTextureDecodeBlockFunc decodeBlockFunc;
+    Format decodedFormat;
+};
+
+/// Returns the conversion functions for `format` or nullptr if the format is not supported.
+CPUTextureFormatInfo const* _getFormatInfo(Format format);
+
+/// Returns the format that textures of `format` are stored in if kernels write to them.
+/// Kernels write 32-bit components straight to texel memory, so formats that are not unpacked
+/// are stored as 4 32-bit components of the same value type.
+Format getWritableStorageFormat(Format format);
+
+/// Convert `count` texels from `srcFormat` to `dstFormat`.
+/// Texels are converted in batches through an intermediate 4-component representation.
+/// Fails if either format is not supported or the formats have different value types
+/// (e.g. float and integer).
+Result convertTexels(Format srcFormat, void const* srcData, Format dstFormat, void* dstData, size_t count);
+
+} // namespace rhi::cpu
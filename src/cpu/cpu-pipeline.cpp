@@ -4,6 +4,12 @@
 
 namespace rhi::cpu {
 
+PipelineImpl::~PipelineImpl()
+{
+    if (m_sharedLibraryHandle)
+        unloadSharedLibrary(m_sharedLibraryHandle);
+}
+
 ShaderProgramImpl* PipelineImpl::getProgram()
 {
     return static_cast<ShaderProgramImpl*>(m_program.Ptr());
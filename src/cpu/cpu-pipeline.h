@@ -2,14 +2,25 @@
 
 #include "cpu-base.h"
 
+#include "core/platform.h"
+
 namespace rhi::cpu {
 
 class PipelineImpl : public PipelineBase
 {
 public:
+    ~PipelineImpl();
+
     ShaderProgramImpl* getProgram();
 
     void init(const ComputePipelineDesc& inDesc);
+
+    // Host-callable kernel of the entry point, resolved on the first dispatch.
+    // The shared library is kept alive for as long as the pipeline references its code.
+    // When kernels are loaded from the kernel cache directory, the library is owned through a native handle instead.
+    ComPtr<ISlangSharedLibrary> m_sharedLibrary;
+    SharedLibraryHandle m_sharedLibraryHandle = nullptr;
+    slang_prelude::ComputeFunc m_computeFunc = nullptr;
 };
 
 } // namespace rhi::cpu
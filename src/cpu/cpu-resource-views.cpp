@@ -1,4 +1,9 @@
 #include "cpu-resource-views.h"
+#include "cpu-sampler.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 namespace rhi::cpu {
 
@@ -13,6 +18,25 @@ BufferImpl* BufferViewImpl::getBuffer() const
     return m_buffer;
 }
 
+TextureViewImpl::TextureViewImpl(Desc const& desc, TextureImpl* texture)
+    : ResourceViewImpl(Kind::Texture, desc)
+    , m_texture(texture)
+    , m_formatInfo(texture->m_formatInfo)
+    , m_isFilterable(texture->m_isFilterable)
+{
+    // Views can reinterpret the texels as a different format of the same size.
+    // Block compressed textures are stored decoded and always use the decoded format.
+    if (desc.format != Format::Unknown && texture->m_storageFormat == texture->getFormat())
+    {
+        auto viewFormatInfo = _getFormatInfo(desc.format);
+        if (viewFormatInfo && viewFormatInfo->unpackFunc && viewFormatInfo->texelSize == texture->m_texelSize)
+        {
+            m_formatInfo = viewFormatInfo;
+            m_isFilterable = viewFormatInfo->valueType == CPUTextureValueType::Float;
+        }
+    }
+}
+
 TextureImpl* TextureViewImpl::getTexture() const
 {
     return m_texture;
@@ -40,7 +64,7 @@ void TextureViewImpl::Load(const int32_t* texelCoords, void* outData, size_t dat
 {
     void* texelPtr = _getTexelPtr(texelCoords);
 
-    m_texture->m_formatInfo->unpackFunc(texelPtr, outData, dataSize);
+    m_formatInfo->unpackFunc(texelPtr, outData, dataSize);
 }
 
 void TextureViewImpl::Sample(
@@ -58,6 +82,197 @@ void TextureViewImpl::Sample(
     SampleLevel(samplerState, coords, 0.0f, outData, dataSize);
 }
 
+// Sampler state used if no sampler is bound: point sampling with clamping.
+static const SamplerDesc& getDefaultSamplerDesc()
+{
+    static const SamplerDesc desc = []()
+    {
+        SamplerDesc result;
+        result.minFilter = TextureFilteringMode::Point;
+        result.magFilter = TextureFilteringMode::Point;
+        result.mipFilter = TextureFilteringMode::Point;
+        result.addressU = TextureAddressingMode::ClampToEdge;
+        result.addressV = TextureAddressingMode::ClampToEdge;
+        result.addressW = TextureAddressingMode::ClampToEdge;
+        return result;
+    }();
+    return desc;
+}
+
+/// Map an integer texel coordinate into `[0, extent)` according to the addressing mode.
+/// Returns false if the coordinate addresses the border color.
+static bool applyAddressingMode(TextureAddressingMode mode, int32_t extent, int32_t& coord)
+{
+    switch (mode)
+    {
+    case TextureAddressingMode::Wrap:
+        coord %= extent;
+        if (coord < 0)
+            coord += extent;
+        return true;
+    case TextureAddressingMode::ClampToEdge:
+        coord = std::clamp(coord, 0, extent - 1);
+        return true;
+    case TextureAddressingMode::ClampToBorder:
+        return coord >= 0 && coord < extent;
+    case TextureAddressingMode::MirrorRepeat:
+    {
+        int32_t period = 2 * extent;
+        coord %= period;
+        if (coord < 0)
+            coord += period;
+        if (coord >= extent)
+            coord = period - 1 - coord;
+        return true;
+    }
+    case TextureAddressingMode::MirrorOnce:
+        if (coord < 0)
+            coord = -coord - 1;
+        coord = std::min(coord, extent - 1);
+        return true;
+    }
+    return true;
+}
+
+/// Select the cube face for direction `dir` and compute the normalized coordinates on that face.
+static int32_t getCubeFaceCoords(const float* dir, float outCoords[2])
+{
+    float x = dir[0], y = dir[1], z = dir[2];
+    float ax = std::abs(x), ay = std::abs(y), az = std::abs(z);
+    int32_t face;
+    float ma, sc, tc;
+    if (ax >= ay && ax >= az)
+    {
+        ma = ax;
+        face = x >= 0 ? 0 : 1;
+        sc = x >= 0 ? -z : z;
+        tc = -y;
+    }
+    else if (ay >= az)
+    {
+        ma = ay;
+        face = y >= 0 ? 2 : 3;
+        sc = x;
+        tc = y >= 0 ? z : -z;
+    }
+    else
+    {
+        ma = az;
+        face = z >= 0 ? 4 : 5;
+        sc = z >= 0 ? x : -x;
+        tc = -y;
+    }
+    if (ma == 0.f)
+        ma = 1.f;
+    outCoords[0] = 0.5f * (sc / ma + 1.f);
+    outCoords[1] = 0.5f * (tc / ma + 1.f);
+    return face;
+}
+
+/// Sample a single mip level of a texture.
+/// `coords` are normalized texture coordinates, one for each axis of the base shape.
+/// Texels of all taps are unpacked to four floats and combined four lanes at a time,
+/// which compilers turn into SIMD multiply-adds.
+static void sampleMipLevel(
+    TextureImpl* texture,
+    CPUTextureFormatInfo const* formatInfo,
+    const SamplerDesc& samplerDesc,
+    TextureFilteringMode filter,
+    const float* coords,
+    int32_t elementIndex,
+    int32_t mipLevel,
+    float outTexel[4]
+)
+{
+    auto& mipLevelInfo = texture->m_mipLevels[mipLevel];
+    int32_t rank = texture->getRank();
+    const TextureAddressingMode addressingModes[3] = {
+        samplerDesc.addressU,
+        samplerDesc.addressV,
+        samplerDesc.addressW,
+    };
+
+    int32_t baseCoords[3] = {0, 0, 0};
+    float fractions[3] = {0.f, 0.f, 0.f};
+    int32_t tapCounts[3] = {1, 1, 1};
+    for (int32_t axis = 0; axis < rank; ++axis)
+    {
+        float coord = coords[axis] * mipLevelInfo.extents[axis];
+        if (filter == TextureFilteringMode::Linear)
+        {
+            coord -= 0.5f;
+            float base = std::floor(coord);
+            baseCoords[axis] = int32_t(base);
+            fractions[axis] = coord - base;
+            tapCounts[axis] = 2;
+        }
+        else
+        {
+            baseCoords[axis] = int32_t(std::floor(coord));
+        }
+    }
+
+    auto reductionOp = samplerDesc.reductionOp;
+    float result[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        result[i] = reductionOp == TextureReductionOp::Minimum   ? FLT_MAX
+                    : reductionOp == TextureReductionOp::Maximum ? -FLT_MAX
+                                                                 : 0.f;
+    }
+
+    const char* elementData =
+        (const char*)texture->m_data + mipLevelInfo.offset + elementIndex * mipLevelInfo.strides[3];
+    for (int32_t tz = 0; tz < tapCounts[2]; ++tz)
+    {
+        for (int32_t ty = 0; ty < tapCounts[1]; ++ty)
+        {
+            for (int32_t tx = 0; tx < tapCounts[0]; ++tx)
+            {
+                const int32_t taps[3] = {tx, ty, tz};
+                float weight = 1.f;
+                int32_t texelCoords[3] = {0, 0, 0};
+                bool isBorder = false;
+                for (int32_t axis = 0; axis < rank; ++axis)
+                {
+                    if (tapCounts[axis] == 2)
+                        weight *= taps[axis] ? fractions[axis] : 1.f - fractions[axis];
+                    int32_t coord = baseCoords[axis] + taps[axis];
+                    isBorder |= !applyAddressingMode(addressingModes[axis], mipLevelInfo.extents[axis], coord);
+                    texelCoords[axis] = coord;
+                }
+                if (weight == 0.f)
+                    continue;
+                int64_t texelOffset =
+                    texture->getTexelOffset(mipLevelInfo, texelCoords[0], texelCoords[1], texelCoords[2]);
+
+                float texel[4];
+                if (isBorder)
+                    memcpy(texel, samplerDesc.borderColor, sizeof(texel));
+                else
+                    formatInfo->unpackFunc(elementData + texelOffset, texel, sizeof(texel));
+
+                switch (reductionOp)
+                {
+                case TextureReductionOp::Minimum:
+                    for (int i = 0; i < 4; ++i)
+                        result[i] = std::min(result[i], texel[i]);
+                    break;
+                case TextureReductionOp::Maximum:
+                    for (int i = 0; i < 4; ++i)
+                        result[i] = std::max(result[i], texel[i]);
+                    break;
+                default:
+                    for (int i = 0; i < 4; ++i)
+                        result[i] += weight * texel[i];
+                    break;
+                }
+            }
+        }
+    }
+    memcpy(outTexel, result, sizeof(result));
+}
+
 void TextureViewImpl::SampleLevel(
     slang_prelude::SamplerState samplerState,
     const float* coords,
@@ -69,53 +284,86 @@ void TextureViewImpl::SampleLevel(
     TextureImpl* texture = m_texture;
     auto baseShape = texture->m_baseShape;
     auto& desc = texture->_getDesc();
-    int32_t rank = baseShape->rank;
     int32_t baseCoordCount = baseShape->baseCoordCount;
 
-    int32_t integerMipLevel = int32_t(level + 0.5f);
-    if (integerMipLevel >= desc.numMipLevels)
-        integerMipLevel = desc.numMipLevels - 1;
-    if (integerMipLevel < 0)
-        integerMipLevel = 0;
+    SamplerImpl* sampler = SamplerImpl::fromPreludeHandle(samplerState.state);
+    const SamplerDesc& samplerDesc = sampler ? sampler->m_desc : getDefaultSamplerDesc();
 
-    auto& mipLevelInfo = texture->m_mipLevels[integerMipLevel];
+    // Integer formats cannot be filtered.
+    TextureFilteringMode minFilter = samplerDesc.minFilter;
+    TextureFilteringMode magFilter = samplerDesc.magFilter;
+    TextureFilteringMode mipFilter = samplerDesc.mipFilter;
+    if (!m_isFilterable)
+    {
+        minFilter = magFilter = mipFilter = TextureFilteringMode::Point;
+    }
 
-    bool isArray = (desc.arraySize != 0) || (desc.type == rhi::TextureType::TextureCube);
-    int32_t effectiveArrayElementCount = texture->m_effectiveArrayElementCount;
-    int32_t coordIndex = baseCoordCount;
+    // Resolve the array element and, for cube maps, the face and the coordinates on that face.
     int32_t elementIndex = 0;
-    if (isArray)
-        elementIndex = int32_t(coords[coordIndex++] + 0.5f);
-    if (elementIndex >= effectiveArrayElementCount)
-        elementIndex = effectiveArrayElementCount - 1;
-    if (elementIndex < 0)
-        elementIndex = 0;
-
-    // Note: for now we are just going to do nearest-neighbor sampling
-    //
-    int64_t texelOffset = mipLevelInfo.offset;
-    texelOffset += elementIndex * mipLevelInfo.strides[3];
-    for (int32_t axis = 0; axis < rank; ++axis)
+    if (desc.arraySize != 0)
     {
-        int32_t extent = mipLevelInfo.extents[axis];
-
-        float coord = coords[axis];
-
-        // TODO: deal with wrap/clamp/repeat if `coord < 0` or `coord > 1`
-
-        int32_t integerCoord = int32_t(coord * (extent - 1) + 0.5f);
+        elementIndex = int32_t(std::floor(coords[baseCoordCount] + 0.5f));
+        elementIndex = std::clamp(elementIndex, 0, desc.arraySize - 1);
+    }
+    float faceCoords[2];
+    if (desc.type == TextureType::TextureCube)
+    {
+        elementIndex = elementIndex * 6 + getCubeFaceCoords(coords, faceCoords);
+        coords = faceCoords;
+    }
+    elementIndex = std::clamp(elementIndex, 0, texture->m_effectiveArrayElementCount - 1);
 
-        if (integerCoord >= extent)
-            integerCoord = extent - 1;
-        if (integerCoord < 0)
-            integerCoord = 0;
+    // Select the mip levels to sample from.
+    int32_t maxMipLevel = std::max(0, desc.numMipLevels - 1);
+    float lod = level + samplerDesc.mipLODBias;
+    lod = std::clamp(lod, samplerDesc.minLOD, samplerDesc.maxLOD);
+    lod = std::clamp(lod, 0.f, float(maxMipLevel));
+    TextureFilteringMode filter = lod > 0.f ? minFilter : magFilter;
 
-        texelOffset += integerCoord * mipLevelInfo.strides[axis];
+    float result[4];
+    if (mipFilter == TextureFilteringMode::Linear && lod < float(maxMipLevel))
+    {
+        int32_t mipLevel = int32_t(lod);
+        float weight = lod - float(mipLevel);
+        sampleMipLevel(texture, m_formatInfo, samplerDesc, filter, coords, elementIndex, mipLevel, result);
+        if (weight > 0.f)
+        {
+            float next[4];
+            sampleMipLevel(texture, m_formatInfo, samplerDesc, filter, coords, elementIndex, mipLevel + 1, next);
+            for (int i = 0; i < 4; ++i)
+                result[i] += weight * (next[i] - result[i]);
+        }
+    }
+    else
+    {
+        int32_t mipLevel = std::min(int32_t(lod + 0.5f), maxMipLevel);
+        if (!m_isFilterable)
+        {
+            // Return the raw unpacked value (e.g. integers) of the nearest texel.
+            auto& mipLevelInfo = texture->m_mipLevels[mipLevel];
+            int32_t texelCoords[3] = {0, 0, 0};
+            const TextureAddressingMode addressingModes[3] = {
+                samplerDesc.addressU,
+                samplerDesc.addressV,
+                samplerDesc.addressW,
+            };
+            for (int32_t axis = 0; axis < texture->getRank(); ++axis)
+            {
+                int32_t extent = mipLevelInfo.extents[axis];
+                int32_t coord = int32_t(std::floor(coords[axis] * extent));
+                if (!applyAddressingMode(addressingModes[axis], extent, coord))
+                    coord = std::clamp(coord, 0, extent - 1);
+                texelCoords[axis] = coord;
+            }
+            int64_t texelOffset = mipLevelInfo.offset + elementIndex * mipLevelInfo.strides[3] +
+                                  texture->getTexelOffset(mipLevelInfo, texelCoords[0], texelCoords[1], texelCoords[2]);
+            m_formatInfo->unpackFunc((const char*)texture->m_data + texelOffset, outData, dataSize);
+            return;
+        }
+        sampleMipLevel(texture, m_formatInfo, samplerDesc, filter, coords, elementIndex, mipLevel, result);
     }
 
-    auto texelPtr = (char const*)texture->m_data + texelOffset;
-
-    m_texture->m_formatInfo->unpackFunc(texelPtr, outData, dataSize);
+    memcpy(outData, result, std::min(dataSize, sizeof(result)));
 }
 
 void* TextureViewImpl::refAt(const uint32_t* texelCoords)
@@ -157,8 +405,7 @@ void* TextureViewImpl::_getTexelPtr(int32_t const* texelCoords)
 
     auto& mipLevelInfo = texture->m_mipLevels[mipLevel];
 
-    int64_t texelOffset = mipLevelInfo.offset;
-    texelOffset += elementIndex * mipLevelInfo.strides[3];
+    int32_t coords[3] = {0, 0, 0};
     for (int32_t axis = 0; axis < rank; ++axis)
     {
         int32_t coord = texelCoords[axis];
@@ -167,9 +414,13 @@ void* TextureViewImpl::_getTexelPtr(int32_t const* texelCoords)
         if (coord < 0)
             coord = 0;
 
-        texelOffset += texelCoords[axis] * mipLevelInfo.strides[axis];
+        coords[axis] = coord;
     }
 
+    int64_t texelOffset = mipLevelInfo.offset;
+    texelOffset += elementIndex * mipLevelInfo.strides[3];
+    texelOffset += texture->getTexelOffset(mipLevelInfo, coords[0], coords[1], coords[2]);
+
     return (uint8_t*)texture->m_data + texelOffset;
 }
 
@@ -43,11 +43,7 @@ private:
 class TextureViewImpl : public ResourceViewImpl, public slang_prelude::IRWTexture
 {
 public:
-    TextureViewImpl(Desc const& desc, TextureImpl* texture)
-        : ResourceViewImpl(Kind::Texture, desc)
-        , m_texture(texture)
-    {
-    }
+    TextureViewImpl(Desc const& desc, TextureImpl* texture);
 
     TextureImpl* getTexture() const;
 
@@ -78,6 +74,9 @@ public:
 
 private:
     RefPtr<TextureImpl> m_texture;
+    /// Conversion functions for the view format, which may reinterpret a typeless texture.
+    CPUTextureFormatInfo const* m_formatInfo;
+    bool m_isFilterable;
 
     void* _getTexelPtr(int32_t const* texelCoords);
 };
@@ -0,0 +1,10 @@
+#include "cpu-sampler.h"
+
+namespace rhi::cpu {
+
+void SamplerImpl::init(const SamplerDesc& desc)
+{
+    m_desc = desc;
+}
+
+} // namespace rhi::cpu
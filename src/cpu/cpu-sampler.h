@@ -0,0 +1,24 @@
+#pragma once
+
+#include "cpu-base.h"
+
+namespace rhi::cpu {
+
+class SamplerImpl : public SamplerBase
+{
+public:
+    SamplerDesc m_desc;
+
+    void init(const SamplerDesc& desc);
+
+    /// Returns the handle that is stored in a `SamplerState` shader parameter.
+    slang_prelude::ISampler* getPreludeHandle() { return reinterpret_cast<slang_prelude::ISampler*>(this); }
+
+    /// Returns the sampler referenced by a `SamplerState` shader parameter, or null if none is bound.
+    static SamplerImpl* fromPreludeHandle(slang_prelude::ISampler* handle)
+    {
+        return reinterpret_cast<SamplerImpl*>(handle);
+    }
+};
+
+} // namespace rhi::cpu
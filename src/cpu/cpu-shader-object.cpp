@@ -1,6 +1,7 @@
 #include "cpu-shader-object.h"
 #include "cpu-buffer.h"
 #include "cpu-resource-views.h"
+#include "cpu-sampler.h"
 #include "cpu-shader-object-layout.h"
 
 namespace rhi::cpu {
@@ -56,6 +57,7 @@ ResourceViewBase* CPUShaderObjectData::getResourceView(
 Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* typeLayout)
 {
     m_layout = typeLayout;
+    resetSpecializationCache();
 
     // If the layout tells us that there is any uniform data,
     // then we need to allocate a constant buffer to hold that data.
@@ -77,7 +79,8 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* typeLayou
     // and not just the number of resource/sub-object ranges.
     //
     m_resources.resize(typeLayout->getResourceCount());
-    m_objects.resize(typeLayout->getSubObjectCount());
+    m_samplers.resize(typeLayout->getResourceCount());
+    resizeSubObjects(typeLayout->getSubObjectCount());
 
     for (auto subObjectRange : getLayout()->subObjectRanges)
     {
@@ -218,8 +221,20 @@ SLANG_NO_THROW Result SLANG_MCALL ShaderObjectImpl::setObject(ShaderOffset const
 
 SLANG_NO_THROW Result SLANG_MCALL ShaderObjectImpl::setSampler(ShaderOffset const& offset, ISampler* sampler)
 {
-    SLANG_UNUSED(sampler);
-    SLANG_UNUSED(offset);
+    auto layout = getLayout();
+
+    auto bindingRangeIndex = offset.bindingRangeIndex;
+    SLANG_RHI_ASSERT(bindingRangeIndex >= 0);
+    SLANG_RHI_ASSERT(bindingRangeIndex < layout->m_bindingRanges.size());
+
+    auto& bindingRange = layout->m_bindingRanges[bindingRangeIndex];
+    auto samplerIndex = bindingRange.baseIndex + offset.bindingArrayIndex;
+
+    auto samplerImpl = static_cast<SamplerImpl*>(sampler);
+    m_samplers[samplerIndex] = samplerImpl;
+
+    slang_prelude::ISampler* samplerObj = samplerImpl ? samplerImpl->getPreludeHandle() : nullptr;
+    SLANG_RETURN_ON_FAIL(setData(offset, &samplerObj, sizeof(samplerObj)));
     return SLANG_OK;
 }
 
@@ -289,9 +304,23 @@ Result RootShaderObjectImpl::collectSpecializationArgs(ExtendedShaderObjectTypeL
     SLANG_RETURN_ON_FAIL(ShaderObjectImpl::collectSpecializationArgs(args));
     for (auto& entryPoint : m_entryPoints)
     {
-        SLANG_RETURN_ON_FAIL(entryPoint->collectSpecializationArgs(args));
+        const ExtendedShaderObjectTypeList* entryPointArgs;
+        SLANG_RETURN_ON_FAIL(entryPoint->getSpecializationArgs(entryPointArgs));
+        args.addRange(*entryPointArgs);
     }
     return SLANG_OK;
 }
 
+bool RootShaderObjectImpl::isSpecializationDirty()
+{
+    if (ShaderObjectImpl::isSpecializationDirty())
+        return true;
+    for (auto& entryPoint : m_entryPoints)
+    {
+        if (entryPoint->isSpecializationDirty())
+            return true;
+    }
+    return false;
+}
+
 } // namespace rhi::cpu
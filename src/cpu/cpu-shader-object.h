@@ -34,6 +34,8 @@ class ShaderObjectImpl : public ShaderObjectBaseImpl<ShaderObjectImpl, ShaderObj
 
 public:
     std::vector<RefPtr<ResourceViewImpl>> m_resources;
+    // Samplers share the slot indices of resources.
+    std::vector<RefPtr<SamplerImpl>> m_samplers;
 
     virtual SLANG_NO_THROW Result SLANG_MCALL init(IDevice* device, ShaderObjectLayoutImpl* typeLayout);
 
@@ -82,6 +84,7 @@ public:
     virtual SLANG_NO_THROW GfxCount SLANG_MCALL getEntryPointCount() override;
     virtual SLANG_NO_THROW Result SLANG_MCALL getEntryPoint(GfxIndex index, IShaderObject** outEntryPoint) override;
     virtual Result collectSpecializationArgs(ExtendedShaderObjectTypeList& args) override;
+    virtual bool isSpecializationDirty() override;
 };
 
 } // namespace rhi::cpu
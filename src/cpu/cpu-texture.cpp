@@ -7,109 +7,134 @@ static CPUTextureBaseShapeInfo const* _getBaseShapeInfo(TextureType baseShape)
     return &kCPUTextureBaseShapeInfos[(int)baseShape];
 }
 
-template<int N>
-void _unpackFloatTexel(void const* texelData, void* outData, size_t outSize)
+// Decode the block compressed data of one subresource.
+void TextureImpl::_decodeBlocks(
+    SubresourceData const& srcImage,
+    MipLevel const& level,
+    char* dstImage,
+    CPUTextureDecodeBlockFunc decodeBlockFunc,
+    uint32_t blockSize
+)
 {
-    auto input = (float const*)texelData;
+    const int32_t kBlockExtent = 4;
+    size_t blockRowStride = kBlockExtent * m_texelSize;
+    std::vector<char> block(kBlockExtent * blockRowStride);
 
-    float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
-    for (int i = 0; i < N; ++i)
-        temp[i] = input[i];
+    int32_t width = level.extents[0];
+    int32_t height = level.extents[1];
+    int32_t blockCountX = (width + kBlockExtent - 1) / kBlockExtent;
+    int32_t blockCountY = (height + kBlockExtent - 1) / kBlockExtent;
 
-    memcpy(outData, temp, outSize);
-}
-
-template<int N>
-void _unpackFloat16Texel(void const* texelData, void* outData, size_t outSize)
-{
-    auto input = (int16_t const*)texelData;
-
-    float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
-    for (int i = 0; i < N; ++i)
-        temp[i] = math::halfToFloat(input[i]);
-
-    memcpy(outData, temp, outSize);
-}
-
-static inline float _unpackUnorm8Value(uint8_t value)
-{
-    return value / 255.0f;
-}
-
-template<int N>
-void _unpackUnorm8Texel(void const* texelData, void* outData, size_t outSize)
-{
-    auto input = (uint8_t const*)texelData;
-
-    float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
-    for (int i = 0; i < N; ++i)
-        temp[i] = _unpackUnorm8Value(input[i]);
-
-    memcpy(outData, temp, outSize);
-}
-
-void _unpackUnormBGRA8Texel(void const* texelData, void* outData, size_t outSize)
-{
-    auto input = (uint8_t const*)texelData;
-
-    float temp[4];
-    temp[0] = _unpackUnorm8Value(input[2]);
-    temp[1] = _unpackUnorm8Value(input[1]);
-    temp[2] = _unpackUnorm8Value(input[0]);
-    temp[3] = _unpackUnorm8Value(input[3]);
-
-    memcpy(outData, temp, outSize);
+    const char* srcLayer = (const char*)srcImage.data;
+    for (int32_t depthLayer = 0; depthLayer < level.extents[2]; ++depthLayer)
+    {
+        for (int32_t blockY = 0; blockY < blockCountY; ++blockY)
+        {
+            const char* srcBlock = srcLayer + blockY * ptrdiff_t(srcImage.strideY);
+            for (int32_t blockX = 0; blockX < blockCountX; ++blockX)
+            {
+                decodeBlockFunc(srcBlock, block.data(), blockRowStride);
+                srcBlock += blockSize;
+
+                // Blocks at the edge of small mip levels extend past the texture.
+                int32_t x = blockX * kBlockExtent;
+                int32_t y = blockY * kBlockExtent;
+                int32_t copyWidth = std::min(kBlockExtent, width - x);
+                int32_t copyHeight = std::min(kBlockExtent, height - y);
+                for (int32_t row = 0; row < copyHeight; ++row)
+                {
+                    _writeTexels(
+                        level,
+                        dstImage,
+                        x,
+                        y + row,
+                        depthLayer,
+                        copyWidth,
+                        block.data() + row * blockRowStride
+                    );
+                }
+            }
+        }
+        srcLayer += srcImage.strideZ;
+    }
 }
 
-template<int N>
-void _unpackUInt16Texel(void const* texelData, void* outData, size_t outSize)
+void TextureImpl::_writeTexels(
+    MipLevel const& level,
+    char* elementData,
+    int32_t x,
+    int32_t y,
+    int32_t z,
+    int32_t count,
+    void const* texels
+)
 {
-    auto input = (uint16_t const*)texelData;
-
-    uint32_t temp[4] = {0, 0, 0, 0};
-    for (int i = 0; i < N; ++i)
-        temp[i] = input[i];
-
-    memcpy(outData, temp, outSize);
+    if (!m_isTiled)
+    {
+        memcpy(elementData + getTexelOffset(level, x, y, z), texels, count * m_texelSize);
+        return;
+    }
+    for (int32_t i = 0; i < count; ++i)
+        memcpy(elementData + getTexelOffset(level, x + i, y, z), (char const*)texels + i * m_texelSize, m_texelSize);
 }
 
-template<int N>
-void _unpackUInt32Texel(void const* texelData, void* outData, size_t outSize)
+void TextureImpl::_readTexels(
+    MipLevel const& level,
+    char const* elementData,
+    int32_t x,
+    int32_t y,
+    int32_t z,
+    int32_t count,
+    void* outTexels
+)
 {
-    auto input = (uint32_t const*)texelData;
-
-    uint32_t temp[4] = {0, 0, 0, 0};
-    for (int i = 0; i < N; ++i)
-        temp[i] = input[i];
-
-    memcpy(outData, temp, outSize);
+    if (!m_isTiled)
+    {
+        memcpy(outTexels, elementData + getTexelOffset(level, x, y, z), count * m_texelSize);
+        return;
+    }
+    for (int32_t i = 0; i < count; ++i)
+        memcpy((char*)outTexels + i * m_texelSize, elementData + getTexelOffset(level, x + i, y, z), m_texelSize);
 }
 
 TextureImpl::~TextureImpl()
 {
-    free(m_data);
+    if (m_data)
+        m_allocator->free(m_data, m_dataSize);
 }
 
-Result TextureImpl::init(SubresourceData const* initData)
+Result TextureImpl::init(
+    std::shared_ptr<MemoryAllocator> allocator,
+    CPUTextureLayout layout,
+    SubresourceData const* initData
+)
 {
     auto desc = m_desc;
 
     // The format of the texture will determine the
     // size of the texels we allocate.
     //
-    // TODO: Compressed formats usually work in terms
-    // of a fixed block size, so that we cannot actually
-    // compute a simple `texelSize` like this. Instead
-    // we should be computing a `blockSize` and then
-    // a `blockExtents` value that gives the extent
-    // in texels of each block. For uncompressed formats
-    // the block extents would be 1 along each axis.
+    // Block compressed formats are decoded when the texture
+    // is initialized, so that all texel addressing and
+    // sampling code can work with individual texels.
     //
     auto format = desc.format;
-    FormatInfo texelInfo;
-    rhiGetFormatInfo(format, &texelInfo);
-    uint32_t texelSize = uint32_t(texelInfo.blockSizeInBytes / texelInfo.pixelsPerBlock);
+    auto blockFormatInfo = _getFormatInfo(format);
+    if (!blockFormatInfo)
+        return SLANG_FAIL;
+    bool isBlockCompressed = blockFormatInfo->decodeBlockFunc != nullptr;
+    m_storageFormat = isBlockCompressed ? blockFormatInfo->decodedFormat : format;
+    // Kernels write texels through `refAt` without any conversion.
+    if (desc.allowedStates.contains(ResourceState::UnorderedAccess))
+        m_storageFormat = getWritableStorageFormat(m_storageFormat);
+    // Initial data is converted to the storage format row by row.
+    bool isConverted = !isBlockCompressed && m_storageFormat != format;
+
+    auto formatInfo = _getFormatInfo(m_storageFormat);
+    m_formatInfo = formatInfo;
+    uint32_t texelSize = formatInfo->texelSize;
     m_texelSize = texelSize;
+    m_isFilterable = formatInfo->valueType == CPUTextureValueType::Float;
 
     int32_t formatBlockSize[kMaxRank] = {1, 1, 1};
 
@@ -118,11 +143,6 @@ Result TextureImpl::init(SubresourceData const* initData)
     if (!baseShapeInfo)
         return SLANG_FAIL;
 
-    auto formatInfo = _getFormatInfo(desc.format);
-    m_formatInfo = formatInfo;
-    if (!formatInfo)
-        return SLANG_FAIL;
-
     int32_t rank = baseShapeInfo->rank;
     int32_t effectiveArrayElementCount = desc.arraySize ? desc.arraySize : 1;
     effectiveArrayElementCount *= baseShapeInfo->implicitArrayElementCount;
@@ -140,6 +160,10 @@ Result TextureImpl::init(SubresourceData const* initData)
 
     m_mipLevels.resize(levelCount);
 
+    // Tiling only pays off for textures with more than one dimension.
+    m_isTiled = layout == CPUTextureLayout::Tiled && rank >= 2;
+    m_tileSize = kTileExtent * kTileExtent * texelSize;
+
     int64_t totalDataSize = 0;
     for (int32_t levelIndex = 0; levelIndex < levelCount; ++levelIndex)
     {
@@ -154,25 +178,40 @@ Result TextureImpl::init(SubresourceData const* initData)
         }
 
         level.strides[0] = texelSize;
-        for (int32_t axis = 1; axis < kMaxRank + 1; ++axis)
+        if (m_isTiled)
         {
-            level.strides[axis] = level.strides[axis - 1] * level.extents[axis - 1];
+            // Each depth slice is padded to whole tiles.
+            level.tileCountX = (level.extents[0] + kTileExtent - 1) >> kTileShift;
+            int32_t tileCountY = (level.extents[1] + kTileExtent - 1) >> kTileShift;
+            level.strides[1] = int64_t(level.tileCountX) * m_tileSize;
+            level.strides[2] = level.strides[1] * tileCountY;
+            level.strides[3] = level.strides[2] * level.extents[2];
+        }
+        else
+        {
+            level.tileCountX = 0;
+            for (int32_t axis = 1; axis < kMaxRank + 1; ++axis)
+            {
+                level.strides[axis] = level.strides[axis - 1] * level.extents[axis - 1];
+            }
         }
 
-        int64_t levelDataSize = texelSize;
-        levelDataSize *= effectiveArrayElementCount;
-        for (int32_t axis = 0; axis < rank; ++axis)
-            levelDataSize *= int64_t(level.extents[axis]);
+        int64_t levelDataSize = level.strides[3] * effectiveArrayElementCount;
 
         level.offset = totalDataSize;
         totalDataSize += levelDataSize;
     }
 
-    void* textureData = malloc((size_t)totalDataSize);
+    void* textureData = allocator->allocate((size_t)totalDataSize);
+    if (!textureData)
+        return SLANG_E_OUT_OF_MEMORY;
     m_data = textureData;
+    m_dataSize = (size_t)totalDataSize;
+    m_allocator = std::move(allocator);
 
     if (initData)
     {
+        std::vector<char> rowData(isConverted ? extents[0] * texelSize : 0);
         int32_t subResourceCounter = 0;
         for (int32_t arrayElementIndex = 0; arrayElementIndex < effectiveArrayElementCount; ++arrayElementIndex)
         {
@@ -180,12 +219,9 @@ Result TextureImpl::init(SubresourceData const* initData)
             {
                 int32_t subResourceIndex = subResourceCounter++;
 
-                auto dstRowStride = m_mipLevels[mipLevel].strides[1];
-                auto dstLayerStride = m_mipLevels[mipLevel].strides[2];
                 auto dstArrayStride = m_mipLevels[mipLevel].strides[3];
 
-                auto textureRowSize = m_mipLevels[mipLevel].extents[0] * texelSize;
-
+                auto rowWidth = m_mipLevels[mipLevel].extents[0];
                 auto rowCount = m_mipLevels[mipLevel].extents[1];
                 auto depthLayerCount = m_mipLevels[mipLevel].extents[2];
 
@@ -197,23 +233,39 @@ Result TextureImpl::init(SubresourceData const* initData)
                 char* dstImage = dstLevel + dstArrayStride * arrayElementIndex;
 
                 const char* srcLayer = (const char*)srcImage.data;
-                char* dstLayer = dstImage;
+
+                if (isBlockCompressed)
+                {
+                    _decodeBlocks(
+                        srcImage,
+                        m_mipLevels[mipLevel],
+                        dstImage,
+                        blockFormatInfo->decodeBlockFunc,
+                        blockFormatInfo->texelSize
+                    );
+                    continue;
+                }
 
                 for (int32_t depthLayer = 0; depthLayer < depthLayerCount; ++depthLayer)
                 {
                     const char* srcRow = srcLayer;
-                    char* dstRow = dstLayer;
 
                     for (int32_t row = 0; row < rowCount; ++row)
                     {
-                        memcpy(dstRow, srcRow, textureRowSize);
+                        const char* rowTexels = srcRow;
+                        if (isConverted)
+                        {
+                            SLANG_RETURN_ON_FAIL(
+                                convertTexels(format, srcRow, m_storageFormat, rowData.data(), rowWidth)
+                            );
+                            rowTexels = rowData.data();
+                        }
+                        _writeTexels(m_mipLevels[mipLevel], dstImage, 0, row, depthLayer, rowWidth, rowTexels);
 
                         srcRow += srcRowStride;
-                        dstRow += dstRowStride;
                     }
 
                     srcLayer += srcLayerStride;
-                    dstLayer += dstLayerStride;
                 }
             }
         }
@@ -222,4 +274,42 @@ Result TextureImpl::init(SubresourceData const* initData)
     return SLANG_OK;
 }
 
+Result TextureImpl::readSubresource(
+    int32_t mipLevel,
+    int32_t arrayElement,
+    Format dstFormat,
+    void* outData,
+    size_t dstRowPitch
+)
+{
+    if (mipLevel < 0 || mipLevel >= int32_t(m_mipLevels.size()) || arrayElement < 0 ||
+        arrayElement >= m_effectiveArrayElementCount)
+        return SLANG_E_INVALID_ARG;
+
+    auto& level = m_mipLevels[mipLevel];
+    const char* srcImage = (const char*)m_data + level.offset + arrayElement * level.strides[3];
+    // Rows of tiled textures are gathered into a linear row first.
+    std::vector<char> rowData(m_isTiled ? level.extents[0] * m_texelSize : 0);
+    char* dstRow = (char*)outData;
+    for (int32_t depthLayer = 0; depthLayer < level.extents[2]; ++depthLayer)
+    {
+        for (int32_t row = 0; row < level.extents[1]; ++row)
+        {
+            const char* srcRow;
+            if (m_isTiled)
+            {
+                _readTexels(level, srcImage, 0, row, depthLayer, level.extents[0], rowData.data());
+                srcRow = rowData.data();
+            }
+            else
+            {
+                srcRow = srcImage + getTexelOffset(level, 0, row, depthLayer);
+            }
+            SLANG_RETURN_ON_FAIL(convertTexels(m_storageFormat, srcRow, dstFormat, dstRow, level.extents[0]));
+            dstRow += dstRowPitch;
+        }
+    }
+    return SLANG_OK;
+}
+
 } // namespace rhi::cpu
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "cpu-allocator.h"
 #include "cpu-base.h"
+#include "cpu-format.h"
 
 namespace rhi::cpu {
 
@@ -20,79 +22,13 @@ static const CPUTextureBaseShapeInfo kCPUTextureBaseShapeInfos[] = {
 
 static CPUTextureBaseShapeInfo const* _getBaseShapeInfo(TextureType baseShape);
 
-typedef void (*CPUTextureUnpackFunc)(void const* texelData, void* outData, size_t outSize);
-
-struct CPUTextureFormatInfo
-{
-    CPUTextureUnpackFunc unpackFunc;
-};
-
-template<int N>
-void _unpackFloatTexel(void const* texelData, void* outData, size_t outSize);
-
-template<int N>
-void _unpackFloat16Texel(void const* texelData, void* outData, size_t outSize);
-
-static inline float _unpackUnorm8Value(uint8_t value);
-
-template<int N>
-void _unpackUnorm8Texel(void const* texelData, void* outData, size_t outSize);
-
-void _unpackUnormBGRA8Texel(void const* texelData, void* outData, size_t outSize);
-
-template<int N>
-void _unpackUInt16Texel(void const* texelData, void* outData, size_t outSize);
-
-template<int N>
-void _unpackUInt32Texel(void const* texelData, void* outData, size_t outSize);
-
-struct CPUFormatInfoMap
-{
-    CPUFormatInfoMap()
-    {
-        memset(m_infos, 0, sizeof(m_infos));
-
-        set(Format::R32G32B32A32_FLOAT, &_unpackFloatTexel<4>);
-        set(Format::R32G32B32_FLOAT, &_unpackFloatTexel<3>);
-
-        set(Format::R32G32_FLOAT, &_unpackFloatTexel<2>);
-        set(Format::R32_FLOAT, &_unpackFloatTexel<1>);
-
-        set(Format::R16G16B16A16_FLOAT, &_unpackFloat16Texel<4>);
-        set(Format::R16G16_FLOAT, &_unpackFloat16Texel<2>);
-        set(Format::R16_FLOAT, &_unpackFloat16Texel<1>);
-
-        set(Format::R8G8B8A8_UNORM, &_unpackUnorm8Texel<4>);
-        set(Format::B8G8R8A8_UNORM, &_unpackUnormBGRA8Texel);
-        set(Format::R16_UINT, &_unpackUInt16Texel<1>);
-        set(Format::R32_UINT, &_unpackUInt32Texel<1>);
-        set(Format::D32_FLOAT, &_unpackFloatTexel<1>);
-    }
-
-    void set(Format format, CPUTextureUnpackFunc func)
-    {
-        auto& info = m_infos[Index(format)];
-        info.unpackFunc = func;
-    }
-
-    SLANG_FORCE_INLINE const CPUTextureFormatInfo& get(Format format) const { return m_infos[Index(format)]; }
-
-    CPUTextureFormatInfo m_infos[Index(Format::_Count)];
-};
-
-static const CPUFormatInfoMap g_formatInfoMap;
-
-static CPUTextureFormatInfo const* _getFormatInfo(Format format)
-{
-    const CPUTextureFormatInfo& info = g_formatInfoMap.get(format);
-    return info.unpackFunc ? &info : nullptr;
-}
-
 class TextureImpl : public Texture
 {
     enum
     {
-        kMaxRank = 3
+        kMaxRank = 3,
+        kTileShift = 3,
+        kTileExtent = 1 << kTileShift,
     };
 
 public:
@@ -102,25 +38,97 @@ public:
     }
     ~TextureImpl();
 
-    Result init(SubresourceData const* initData);
+    Result init(
+        std::shared_ptr<MemoryAllocator> allocator,
+        CPUTextureLayout layout,
+        SubresourceData const* initData
+    );
+
+    /// Read the texels of a subresource, converted to `dstFormat`.
+    /// Rows are written `dstRowPitch` bytes apart, depth slices follow each other without padding.
+    Result readSubresource(
+        int32_t mipLevel,
+        int32_t arrayElement,
+        Format dstFormat,
+        void* outData,
+        size_t dstRowPitch
+    );
 
     TextureDesc const& _getDesc() { return m_desc; }
     Format getFormat() { return m_desc.format; }
     int32_t getRank() { return m_baseShape->rank; }
 
     CPUTextureBaseShapeInfo const* m_baseShape;
+    /// Format of the texel data. Differs from the texture format for block compressed
+    /// formats, which are decoded when the texture is initialized, and for textures that
+    /// kernels write to (see `getWritableStorageFormat`).
+    Format m_storageFormat = Format::Unknown;
     CPUTextureFormatInfo const* m_formatInfo;
     int32_t m_effectiveArrayElementCount = 0;
     uint32_t m_texelSize = 0;
+    // True if texels unpack to floating point values that can be filtered.
+    bool m_isFilterable = false;
+
+    // True if the texels are stored in tiles, see `CPUTextureLayout::Tiled`.
+    bool m_isTiled = false;
+    // Size of a tile in bytes.
+    uint32_t m_tileSize = 0;
 
     struct MipLevel
     {
         int32_t extents[kMaxRank];
+        // For tiled textures, strides[0] and strides[1] are the strides of a texel and a row of tiles.
         int64_t strides[kMaxRank + 1];
         int64_t offset;
+        int32_t tileCountX;
     };
     std::vector<MipLevel> m_mipLevels;
+
+    /// Byte offset of a texel relative to the start of its array element in a mip level.
+    SLANG_FORCE_INLINE int64_t getTexelOffset(MipLevel const& level, int32_t x, int32_t y, int32_t z) const
+    {
+        if (!m_isTiled)
+            return x * level.strides[0] + y * level.strides[1] + z * level.strides[2];
+
+        int64_t tileIndex = int64_t(y >> kTileShift) * level.tileCountX + (x >> kTileShift);
+        // Interleave the bits of the coordinates inside the tile.
+        uint32_t tx = x & (kTileExtent - 1);
+        uint32_t ty = y & (kTileExtent - 1);
+        uint32_t mortonIndex = (tx & 1) | ((tx & 2) << 1) | ((tx & 4) << 2) | ((ty & 1) << 1) | ((ty & 2) << 2) |
+                               ((ty & 4) << 3);
+        return z * level.strides[2] + tileIndex * m_tileSize + mortonIndex * level.strides[0];
+    }
     void* m_data = nullptr;
+    size_t m_dataSize = 0;
+    std::shared_ptr<MemoryAllocator> m_allocator;
+
+private:
+    void _writeTexels(
+        MipLevel const& level,
+        char* elementData,
+        int32_t x,
+        int32_t y,
+        int32_t z,
+        int32_t count,
+        void const* texels
+    );
+    void _readTexels(
+        MipLevel const& level,
+        char const* elementData,
+        int32_t x,
+        int32_t y,
+        int32_t z,
+        int32_t count,
+        void* outTexels
+    );
+
+    void _decodeBlocks(
+        SubresourceData const& srcImage,
+        MipLevel const& level,
+        char* dstImage,
+        CPUTextureDecodeBlockFunc decodeBlockFunc,
+        uint32_t blockSize
+    );
 };
 
 } // namespace rhi::cpu
@@ -4,15 +4,17 @@ namespace rhi::cuda {
 
 ICommandBuffer* CommandBufferImpl::getInterface(const Guid& guid)
 {
-    if (guid == GUID::IID_ISlangUnknown || guid == GUID::IID_ICommandBuffer)
-        return static_cast<ICommandBuffer*>(this);
+    if (guid == GUID::IID_ISlangUnknown || guid == GUID::IID_ICommandBuffer ||
+        guid == GUID::IID_ICommandBufferImmediate)
+        return static_cast<ICommandBufferImmediate*>(this);
     return nullptr;
 }
 
-void CommandBufferImpl::init(DeviceImpl* device, TransientResourceHeapBase* transientHeap)
+void CommandBufferImpl::init(DeviceImpl* device, TransientResourceHeapBase* transientHeap, CommandChunkPool* chunkPool)
 {
     m_device = device;
     m_transientHeap = transientHeap;
+    setChunkPool(chunkPool);
 }
 
 SLANG_NO_THROW Result SLANG_MCALL CommandBufferImpl::encodeResourceCommands(IResourceCommandEncoder** outEncoder)
@@ -53,4 +55,22 @@ SLANG_NO_THROW Result SLANG_MCALL CommandBufferImpl::getNativeHandle(NativeHandl
     return SLANG_E_NOT_AVAILABLE;
 }
 
+SLANG_NO_THROW Result SLANG_MCALL CommandBufferImpl::beginBundle()
+{
+    if (!isEmpty() || m_isClosed)
+        return SLANG_FAIL;
+    m_isBundle = true;
+    return SLANG_OK;
+}
+
+SLANG_NO_THROW Result SLANG_MCALL CommandBufferImpl::executeBundle(ICommandBuffer* bundle)
+{
+    auto bundleImpl = static_cast<CommandBufferImpl*>(bundle);
+    if (!bundleImpl || bundleImpl == this || !bundleImpl->m_isBundle || !bundleImpl->m_isClosed)
+        return SLANG_E_INVALID_ARG;
+    CommandWriter::executeBundle(bundleImpl);
+    m_hasWriteTimestamps |= bundleImpl->m_hasWriteTimestamps;
+    return SLANG_OK;
+}
+
 } // namespace rhi::cuda
@@ -5,7 +5,7 @@
 
 namespace rhi::cuda {
 
-class CommandBufferImpl : public ICommandBuffer, public CommandWriter, public ComObject
+class CommandBufferImpl : public ICommandBufferImmediate, public CommandWriter, public ComObject
 {
 public:
     SLANG_COM_OBJECT_IUNKNOWN_ALL
@@ -16,8 +16,10 @@ public:
     TransientResourceHeapBase* m_transientHeap;
     ResourceCommandEncoderImpl m_resourceCommandEncoder;
     ComputeCommandEncoderImpl m_computeCommandEncoder;
+    bool m_isBundle = false;
+    bool m_isClosed = false;
 
-    void init(DeviceImpl* device, TransientResourceHeapBase* transientHeap);
+    void init(DeviceImpl* device, TransientResourceHeapBase* transientHeap, CommandChunkPool* chunkPool);
 
     virtual SLANG_NO_THROW Result SLANG_MCALL encodeResourceCommands(IResourceCommandEncoder** outEncoder) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL encodeRenderCommands(
@@ -28,9 +30,12 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL encodeComputeCommands(IComputeCommandEncoder** outEncoder) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL encodeRayTracingCommands(IRayTracingCommandEncoder** outEncoder) override;
 
-    virtual SLANG_NO_THROW void SLANG_MCALL close() override {}
+    virtual SLANG_NO_THROW void SLANG_MCALL close() override { m_isClosed = true; }
 
     virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL beginBundle() override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL executeBundle(ICommandBuffer* bundle) override;
 };
 
 } // namespace rhi::cuda
@@ -205,7 +205,9 @@ ComputeCommandEncoderImpl::bindPipelineWithRootObject(IPipeline* state, IShaderO
     SLANG_RETURN_ON_FAIL(
         m_commandBuffer->m_device->createRootShaderObject(pipelineImpl->m_program, m_rootObject.writeRef())
     );
-    m_rootObject->copyFrom(rootObject, m_commandBuffer->m_transientHeap);
+    // Bundles snapshot mutable objects, the versions allocated from the transient heap are recycled once it is reset
+    // while the bundle can still be executed.
+    m_rootObject->copyFrom(rootObject, m_commandBuffer->m_isBundle ? nullptr : m_commandBuffer->m_transientHeap);
     return SLANG_OK;
 }
 
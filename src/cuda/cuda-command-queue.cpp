@@ -79,8 +79,10 @@ Result CommandQueueImpl::bindRootShaderObject(IShaderObject* object)
 void CommandQueueImpl::dispatchCompute(int x, int y, int z)
 {
     // Specialize the compute kernel based on the shader object bindings.
+    // The dispatch is skipped if the specialization failed or is still pending.
     RefPtr<PipelineBase> newPipeline;
-    renderer->maybeSpecializePipeline(currentPipeline, currentRootObject, newPipeline);
+    if (SLANG_FAILED(renderer->maybeSpecializePipeline(currentPipeline, currentRootObject, newPipeline)))
+        return;
     currentPipeline = static_cast<ComputePipelineImpl*>(newPipeline.Ptr());
 
     // Find out thread group size from program reflection.
@@ -165,38 +167,39 @@ void CommandQueueImpl::writeTimestamp(IQueryPool* pool, SlangInt index)
 
 void CommandQueueImpl::execute(CommandBufferImpl* commandBuffer)
 {
-    for (auto& cmd : commandBuffer->m_commands)
+    for (const Command& cmd : commandBuffer->getCommands())
     {
         switch (cmd.name)
         {
         case CommandName::SetPipeline:
-            setPipeline(commandBuffer->getObject<PipelineBase>(cmd.operands[0]));
+            setPipeline(cmd.getObject<PipelineBase>(0));
             break;
         case CommandName::BindRootShaderObject:
-            bindRootShaderObject(commandBuffer->getObject<ShaderObjectBase>(cmd.operands[0]));
+            bindRootShaderObject(cmd.getObject<ShaderObjectBase>(0));
             break;
         case CommandName::DispatchCompute:
             dispatchCompute(int(cmd.operands[0]), int(cmd.operands[1]), int(cmd.operands[2]));
             break;
         case CommandName::CopyBuffer:
             copyBuffer(
-                commandBuffer->getObject<Buffer>(cmd.operands[0]),
+                cmd.getObject<Buffer>(0),
+                cmd.operands[0],
+                cmd.getObject<Buffer>(1),
                 cmd.operands[1],
-                commandBuffer->getObject<Buffer>(cmd.operands[2]),
-                cmd.operands[3],
-                cmd.operands[4]
+                cmd.operands[2]
             );
             break;
         case CommandName::UploadBufferData:
-            uploadBufferData(
-                commandBuffer->getObject<Buffer>(cmd.operands[0]),
-                cmd.operands[1],
-                cmd.operands[2],
-                commandBuffer->getData<uint8_t>(cmd.operands[3])
-            );
+            uploadBufferData(cmd.getObject<Buffer>(0), cmd.operands[0], cmd.operands[1], cmd.getData<uint8_t>());
             break;
         case CommandName::WriteTimestamp:
-            writeTimestamp(commandBuffer->getObject<QueryPoolBase>(cmd.operands[0]), (SlangInt)cmd.operands[1]);
+            writeTimestamp(cmd.getObject<QueryPoolBase>(0), (SlangInt)cmd.operands[0]);
+            break;
+        case CommandName::ExecuteBundle:
+            execute(cmd.getObject<CommandBufferImpl>(0));
+            break;
+        default:
+            break;
         }
     }
 }
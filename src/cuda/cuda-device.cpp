@@ -961,7 +961,7 @@ SLANG_NO_THROW Result SLANG_MCALL DeviceImpl::createShaderProgram(
     // don't actually create any kernels. This program will be specialized later when we know
     // the shader object bindings.
     RefPtr<ShaderProgramImpl> cudaProgram = new ShaderProgramImpl();
-    cudaProgram->init(desc);
+    cudaProgram->init(this, desc);
     cudaProgram->cudaContext = m_context;
     if (desc.slangGlobalScope->getSpecializationParamCount() != 0)
     {
@@ -1036,6 +1036,13 @@ void DeviceImpl::unmap(IBuffer* buffer)
     SLANG_UNUSED(buffer);
 }
 
+void DeviceImpl::waitForGpu()
+{
+    auto resultCode = cuCtxSynchronize();
+    if (resultCode != CUDA_SUCCESS)
+        SLANG_CUDA_HANDLE_ERROR(resultCode);
+}
+
 SLANG_NO_THROW const DeviceInfo& SLANG_MCALL DeviceImpl::getDeviceInfo() const
 {
     return m_info;
@@ -82,6 +82,9 @@ public:
 
     void unmap(IBuffer* buffer);
 
+    // Blocks until all work submitted to the device has completed.
+    void waitForGpu();
+
     virtual SLANG_NO_THROW const DeviceInfo& SLANG_MCALL getDeviceInfo() const override;
 
 public:
@@ -92,6 +92,7 @@ ResourceViewBase* ShaderObjectData::getResourceView(
 Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* typeLayout)
 {
     m_layout = typeLayout;
+    resetSpecializationCache();
 
     // If the layout tells us that there is any uniform data,
     // then we need to allocate a constant buffer to hold that data.
@@ -116,7 +117,7 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* typeLayou
     // and not just the number of resource/sub-object ranges.
     //
     resources.resize(typeLayout->getResourceCount());
-    m_objects.resize(typeLayout->getSubObjectCount());
+    resizeSubObjects(typeLayout->getSubObjectCount());
 
     for (auto subObjectRange : getLayout()->subObjectRanges)
     {
@@ -324,9 +325,23 @@ Result RootShaderObjectImpl::collectSpecializationArgs(ExtendedShaderObjectTypeL
     SLANG_RETURN_ON_FAIL(ShaderObjectImpl::collectSpecializationArgs(args));
     for (auto& entryPoint : entryPointObjects)
     {
-        SLANG_RETURN_ON_FAIL(entryPoint->collectSpecializationArgs(args));
+        const ExtendedShaderObjectTypeList* entryPointArgs;
+        SLANG_RETURN_ON_FAIL(entryPoint->getSpecializationArgs(entryPointArgs));
+        args.addRange(*entryPointArgs);
     }
     return SLANG_OK;
 }
 
+bool RootShaderObjectImpl::isSpecializationDirty()
+{
+    if (ShaderObjectImpl::isSpecializationDirty())
+        return true;
+    for (auto& entryPoint : entryPointObjects)
+    {
+        if (entryPoint->isSpecializationDirty())
+            return true;
+    }
+    return false;
+}
+
 } // namespace rhi::cuda
@@ -34,7 +34,11 @@ Result DeviceImpl::initialize(const Desc& desc)
         std::array{slang::PreprocessorMacroDesc{"__D3D11__", "1"}}
     ));
 
-    SLANG_RETURN_ON_FAIL(RendererBase::initialize(desc));
+    // Draws are issued immediately when shader objects are bound, so they cannot be skipped
+    // while a specialization is pending. Pipelines are always specialized synchronously.
+    Desc baseDesc = desc;
+    baseDesc.asyncPipelineSpecialization = false;
+    SLANG_RETURN_ON_FAIL(RendererBase::initialize(baseDesc));
 
     // Initialize DeviceInfo
     {
@@ -1328,7 +1332,7 @@ Result DeviceImpl::createShaderProgram(
     {
         // For a specializable program, we don't invoke any actual slang compilation yet.
         RefPtr<ShaderProgramImpl> shaderProgram = new ShaderProgramImpl();
-        shaderProgram->init(desc);
+        shaderProgram->init(this, desc);
         returnComPtr(outProgram, shaderProgram);
         return SLANG_OK;
     }
@@ -81,6 +81,7 @@ SLANG_NO_THROW Result SLANG_MCALL ShaderObjectImpl::setSampler(ShaderOffset cons
 Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* layout)
 {
     m_layout = layout;
+    resetSpecializationCache();
 
     // If the layout tells us that there is any uniform data,
     // then we will allocate a CPU memory buffer to hold that data
@@ -106,7 +107,7 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* layout)
     // we need to size the array to account for them.
     //
     Index subObjectCount = layout->getSubObjectCount();
-    m_objects.resize(subObjectCount);
+    resizeSubObjects(subObjectCount);
 
     for (auto subObjectRangeInfo : layout->getSubObjectRanges())
     {
@@ -130,7 +131,7 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* layout)
         {
             RefPtr<ShaderObjectImpl> subObject;
             SLANG_RETURN_ON_FAIL(ShaderObjectImpl::create(device, subObjectLayout, subObject.writeRef()));
-            m_objects[bindingRangeInfo.subObjectIndex + i] = subObject;
+            setSubObject(bindingRangeInfo.subObjectIndex + i, subObject);
         }
     }
 
@@ -504,11 +505,25 @@ Result RootShaderObjectImpl::collectSpecializationArgs(ExtendedShaderObjectTypeL
     SLANG_RETURN_ON_FAIL(ShaderObjectImpl::collectSpecializationArgs(args));
     for (auto& entryPoint : m_entryPoints)
     {
-        SLANG_RETURN_ON_FAIL(entryPoint->collectSpecializationArgs(args));
+        const ExtendedShaderObjectTypeList* entryPointArgs;
+        SLANG_RETURN_ON_FAIL(entryPoint->getSpecializationArgs(entryPointArgs));
+        args.addRange(*entryPointArgs);
     }
     return SLANG_OK;
 }
 
+bool RootShaderObjectImpl::isSpecializationDirty()
+{
+    if (ShaderObjectImpl::isSpecializationDirty())
+        return true;
+    for (auto& entryPoint : m_entryPoints)
+    {
+        if (entryPoint->isSpecializationDirty())
+            return true;
+    }
+    return false;
+}
+
 Result RootShaderObjectImpl::bindAsRoot(BindingContext* context, RootShaderObjectLayoutImpl* specializedLayout)
 {
     // When binding an entire root shader object, we need to deal with
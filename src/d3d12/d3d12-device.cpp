@@ -821,6 +821,7 @@ Result DeviceImpl::initialize(const Desc& desc)
         0,
         8,
         4,
+        0,
         m_resourceCommandTransientHeap.writeRef()
     ));
     // `TransientResourceHeap` holds a back reference to `D3D12Device`, make it a weak reference
@@ -961,6 +962,7 @@ Result DeviceImpl::createTransientResourceHeap(
         desc.constantBufferSize,
         getViewDescriptorCount(desc),
         std::max(1024, desc.samplerDescriptorCount),
+        desc.stagingBufferPageSize,
         heap.writeRef()
     ));
     returnComPtr(outHeap, heap);
@@ -1854,7 +1856,7 @@ Result DeviceImpl::createShaderProgram(
 )
 {
     RefPtr<ShaderProgramImpl> shaderProgram = new ShaderProgramImpl();
-    shaderProgram->init(desc);
+    shaderProgram->init(this, desc);
     ComPtr<ID3DBlob> d3dDiagnosticBlob;
     auto rootShaderLayoutResult = RootShaderObjectLayoutImpl::create(
         this,
@@ -2130,6 +2132,7 @@ Result DeviceImpl::createTransientResourceHeapImpl(
     Size constantBufferSize,
     uint32_t viewDescriptors,
     uint32_t samplerDescriptors,
+    Size stagingBufferPageSize,
     TransientResourceHeapImpl** outHeap
 )
 {
@@ -2142,6 +2145,7 @@ Result DeviceImpl::createTransientResourceHeapImpl(
     desc.accelerationStructureDescriptorCount = viewDescriptors;
     desc.srvDescriptorCount = viewDescriptors;
     desc.uavDescriptorCount = viewDescriptors;
+    desc.stagingBufferPageSize = stagingBufferPageSize;
     SLANG_RETURN_ON_FAIL(result->init(desc, this, viewDescriptors, samplerDescriptors));
     returnRefPtrMove(outHeap, result);
     return SLANG_OK;
@@ -2173,7 +2177,7 @@ void* DeviceImpl::loadProc(SharedLibraryHandle module, char const* name)
 
 DeviceImpl::~DeviceImpl()
 {
-    m_shaderObjectLayoutCache = decltype(m_shaderObjectLayoutCache)();
+    m_shaderObjectLayoutCache.clear();
 }
 
 } // namespace rhi::d3d12
@@ -206,6 +206,7 @@ public:
         Size constantBufferSize,
         uint32_t viewDescriptors,
         uint32_t samplerDescriptors,
+        Size stagingBufferPageSize,
         TransientResourceHeapImpl** outHeap
     );
 
@@ -54,6 +54,8 @@ Result PipelineImpl::ensureAPIPipelineCreated()
     {
         SLANG_RETURN_ON_FAIL(programImpl->compileShaders(m_device));
     }
+    ShaderCompilationTimer timer(m_device->m_shaderCompilationStats.pipelineCreation);
+
     if (desc.type == PipelineType::Graphics)
     {
         // Only actually create a D3D12 pipeline state if the pipeline is fully specialized.
@@ -456,6 +458,8 @@ Result RayTracingPipelineImpl::ensureAPIPipelineCreated()
         }
     }
 
+    ShaderCompilationTimer timer(m_device->m_shaderCompilationStats.pipelineCreation);
+
     for (Index i = 0; i < desc.rayTracing.hitGroupDescs.size(); i++)
     {
         auto& hitGroup = desc.rayTracing.hitGroups[i];
@@ -144,6 +144,7 @@ Result ShaderObjectImpl::init(
     m_device = device;
 
     m_layout = layout;
+    resetSpecializationCache();
 
     m_cachedTransientHeap = nullptr;
     m_cachedTransientHeapVersion = 0;
@@ -198,7 +199,7 @@ Result ShaderObjectImpl::init(
     // we need to size the array to account for them.
     //
     Index subObjectCount = layout->getSubObjectSlotCount();
-    m_objects.resize(subObjectCount);
+    resizeSubObjects(subObjectCount);
 
     for (auto subObjectRangeInfo : layout->getSubObjectRanges())
     {
@@ -222,7 +223,7 @@ Result ShaderObjectImpl::init(
         {
             RefPtr<ShaderObjectImpl> subObject;
             SLANG_RETURN_ON_FAIL(ShaderObjectImpl::create(device, subObjectLayout, subObject.writeRef()));
-            m_objects[bindingRangeInfo.subObjectIndex + i] = subObject;
+            setSubObject(bindingRangeInfo.subObjectIndex + i, subObject);
         }
     }
 
@@ -1053,11 +1054,25 @@ Result RootShaderObjectImpl::collectSpecializationArgs(ExtendedShaderObjectTypeL
     SLANG_RETURN_ON_FAIL(ShaderObjectImpl::collectSpecializationArgs(args));
     for (auto& entryPoint : m_entryPoints)
     {
-        SLANG_RETURN_ON_FAIL(entryPoint->collectSpecializationArgs(args));
+        const ExtendedShaderObjectTypeList* entryPointArgs;
+        SLANG_RETURN_ON_FAIL(entryPoint->getSpecializationArgs(entryPointArgs));
+        args.addRange(*entryPointArgs);
     }
     return SLANG_OK;
 }
 
+bool RootShaderObjectImpl::isSpecializationDirty()
+{
+    if (ShaderObjectImpl::isSpecializationDirty())
+        return true;
+    for (auto& entryPoint : m_entryPoints)
+    {
+        if (entryPoint->isSpecializationDirty())
+            return true;
+    }
+    return false;
+}
+
 Result RootShaderObjectImpl::_createSpecializedLayout(ShaderObjectLayoutImpl** outLayout)
 {
     ExtendedShaderObjectTypeList specializationArgs;
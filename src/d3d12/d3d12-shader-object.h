@@ -257,6 +257,7 @@ public:
     virtual SLANG_NO_THROW GfxCount SLANG_MCALL getEntryPointCount() override;
     virtual SLANG_NO_THROW Result SLANG_MCALL getEntryPoint(GfxIndex index, IShaderObject** outEntryPoint) override;
     virtual Result collectSpecializationArgs(ExtendedShaderObjectTypeList& args) override;
+    virtual bool isSpecializationDirty() override;
     virtual SLANG_NO_THROW Result SLANG_MCALL
     copyFrom(IShaderObject* object, ITransientResourceHeap* transientHeap) override;
 
@@ -20,6 +20,8 @@ ICommandBuffer* DebugCommandBuffer::getInterface(const Guid& guid)
         return (DebugObject<ICommandBuffer>*)this;
     if (guid == GUID::IID_ICommandBufferD3D12)
         return static_cast<ICommandBufferD3D12*>(this);
+    if (guid == GUID::IID_ICommandBufferImmediate)
+        return static_cast<ICommandBufferImmediate*>(this);
     return nullptr;
 }
 
@@ -139,6 +141,45 @@ void DebugCommandBuffer::ensureInternalDescriptorHeapsBound()
     return cmdBuf->ensureInternalDescriptorHeapsBound();
 }
 
+Result DebugCommandBuffer::beginBundle()
+{
+    SLANG_RHI_API_FUNC;
+    ComPtr<ICommandBufferImmediate> cmdBuf;
+    if (SLANG_FAILED(baseObject->queryInterface(ICommandBufferImmediate::getTypeGuid(), (void**)cmdBuf.writeRef())))
+    {
+        RHI_VALIDATION_ERROR("The current command buffer implementation does not support bundles.");
+        return SLANG_E_NOT_AVAILABLE;
+    }
+    SLANG_RETURN_ON_FAIL(cmdBuf->beginBundle());
+    isBundle = true;
+    return SLANG_OK;
+}
+
+Result DebugCommandBuffer::executeBundle(ICommandBuffer* bundle)
+{
+    SLANG_RHI_API_FUNC;
+    ComPtr<ICommandBufferImmediate> cmdBuf;
+    if (SLANG_FAILED(baseObject->queryInterface(ICommandBufferImmediate::getTypeGuid(), (void**)cmdBuf.writeRef())))
+    {
+        RHI_VALIDATION_ERROR("The current command buffer implementation does not support bundles.");
+        return SLANG_E_NOT_AVAILABLE;
+    }
+    if (!isOpen)
+    {
+        RHI_VALIDATION_ERROR("Cannot execute a bundle in a closed command buffer.");
+    }
+    auto bundleImpl = getDebugObj(bundle);
+    if (!bundleImpl->isBundle)
+    {
+        RHI_VALIDATION_ERROR("Only command buffers made bundles with beginBundle() can be executed as bundles.");
+    }
+    if (bundleImpl->isOpen)
+    {
+        RHI_VALIDATION_ERROR("A bundle must be closed before it is executed.");
+    }
+    return cmdBuf->executeBundle(getInnerObj(bundle));
+}
+
 void DebugCommandBuffer::checkEncodersClosedBeforeNewEncoder()
 {
     if (m_resourceCommandEncoder.isOpen || m_renderCommandEncoder.isOpen || m_computeCommandEncoder.isOpen ||
@@ -6,7 +6,7 @@
 
 namespace rhi::debug {
 
-class DebugCommandBuffer : public DebugObject<ICommandBuffer>, ICommandBufferD3D12
+class DebugCommandBuffer : public DebugObject<ICommandBuffer>, ICommandBufferD3D12, ICommandBufferImmediate
 {
 public:
     SLANG_COM_OBJECT_IUNKNOWN_ALL;
@@ -35,6 +35,8 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override;
     virtual SLANG_NO_THROW void SLANG_MCALL invalidateDescriptorHeapBinding() override;
     virtual SLANG_NO_THROW void SLANG_MCALL ensureInternalDescriptorHeapsBound() override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL beginBundle() override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL executeBundle(ICommandBuffer* bundle) override;
 
 private:
     void checkEncodersClosedBeforeNewEncoder();
@@ -43,6 +45,7 @@ private:
 public:
     DebugRootShaderObject rootObject;
     bool isOpen = true;
+    bool isBundle = false;
 };
 
 } // namespace rhi::debug
@@ -37,6 +37,14 @@ void DebugCommandQueue::executeCommandBuffers(
                 cmdBufferImpl->uid
             );
         }
+        if (cmdBufferImpl->isBundle)
+        {
+            RHI_VALIDATION_ERROR_FORMAT(
+                "Command buffer %lld is a bundle. Bundles are executed with "
+                "ICommandBufferImmediate::executeBundle instead of being submitted to a command queue.",
+                cmdBufferImpl->uid
+            );
+        }
         if (i > 0)
         {
             if (cmdBufferImpl->m_transientHeap != getDebugObj(commandBuffers[0])->m_transientHeap)
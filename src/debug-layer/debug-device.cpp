@@ -593,6 +593,60 @@ Result DebugDevice::getTextureRowAlignment(size_t* outAlignment)
     return baseObject->getTextureRowAlignment(outAlignment);
 }
 
+Result DebugDevice::getMemoryStats(DeviceMemoryStats* outStats)
+{
+    SLANG_RHI_API_FUNC;
+    return baseObject->getMemoryStats(outStats);
+}
+
+Result DebugDevice::getShaderCompilationStats(ShaderCompilationStats* outStats)
+{
+    SLANG_RHI_API_FUNC;
+    return baseObject->getShaderCompilationStats(outStats);
+}
+
+Result DebugDevice::resetShaderCompilationStats()
+{
+    SLANG_RHI_API_FUNC;
+    return baseObject->resetShaderCompilationStats();
+}
+
+Result DebugDevice::getStagingMemoryStats(StagingMemoryStats* outStats)
+{
+    SLANG_RHI_API_FUNC;
+    return baseObject->getStagingMemoryStats(outStats);
+}
+
+Result DebugDevice::getDescriptorPoolStats(DescriptorPoolStats* outStats)
+{
+    SLANG_RHI_API_FUNC;
+    return baseObject->getDescriptorPoolStats(outStats);
+}
+
+Result DebugDevice::savePipelineCache()
+{
+    SLANG_RHI_API_FUNC;
+    return baseObject->savePipelineCache();
+}
+
+Result DebugDevice::waitForPipelineSpecializations(uint64_t timeout)
+{
+    SLANG_RHI_API_FUNC;
+    return baseObject->waitForPipelineSpecializations(timeout);
+}
+
+Result DebugDevice::exportPipelineSpecializations(IPipeline* pipeline, ISlangBlob** outManifest)
+{
+    SLANG_RHI_API_FUNC;
+    return baseObject->exportPipelineSpecializations(getInnerObj(pipeline), outManifest);
+}
+
+Result DebugDevice::prewarmPipelineSpecializations(IPipeline* pipeline, const void* manifest, Size manifestSize)
+{
+    SLANG_RHI_API_FUNC;
+    return baseObject->prewarmPipelineSpecializations(getInnerObj(pipeline), manifest, manifestSize);
+}
+
 Result DebugDevice::createShaderTable(const IShaderTable::Desc& desc, IShaderTable** outTable)
 {
     SLANG_RHI_API_FUNC;
@@ -121,6 +121,17 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL
     getTextureAllocationInfo(const TextureDesc& desc, size_t* outSize, size_t* outAlignment) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL getTextureRowAlignment(size_t* outAlignment) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL getMemoryStats(DeviceMemoryStats* outStats) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL getShaderCompilationStats(ShaderCompilationStats* outStats) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL resetShaderCompilationStats() override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL getStagingMemoryStats(StagingMemoryStats* outStats) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL getDescriptorPoolStats(DescriptorPoolStats* outStats) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL savePipelineCache() override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL waitForPipelineSpecializations(uint64_t timeout) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    exportPipelineSpecializations(IPipeline* pipeline, ISlangBlob** outManifest) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    prewarmPipelineSpecializations(IPipeline* pipeline, const void* manifest, Size manifestSize) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL
     createShaderTable(const IShaderTable::Desc& desc, IShaderTable** outTable) override;
 };
@@ -11,14 +11,15 @@ namespace rhi {
 
 namespace {
 
-class CommandBufferImpl : public ICommandBuffer, public ComObject
+class CommandBufferImpl : public ICommandBufferImmediate, public ComObject
 {
 public:
     SLANG_COM_OBJECT_IUNKNOWN_ALL
     ICommandBuffer* getInterface(const Guid& guid)
     {
-        if (guid == GUID::IID_ISlangUnknown || guid == GUID::IID_ICommandBuffer)
-            return static_cast<ICommandBuffer*>(this);
+        if (guid == GUID::IID_ISlangUnknown || guid == GUID::IID_ICommandBuffer ||
+            guid == GUID::IID_ICommandBufferImmediate)
+            return static_cast<ICommandBufferImmediate*>(this);
         return nullptr;
     }
 
@@ -28,11 +29,15 @@ public:
     RefPtr<ImmediateRendererBase> m_renderer;
     RefPtr<ShaderObjectBase> m_rootShaderObject;
     TransientResourceHeapBase* m_transientHeap;
+    // Bundles keep their commands when executed, so they can be executed again.
+    bool m_isBundle = false;
+    bool m_isClosed = false;
 
-    void init(ImmediateRendererBase* renderer, TransientResourceHeapBase* transientHeap)
+    void init(ImmediateRendererBase* renderer, TransientResourceHeapBase* transientHeap, CommandChunkPool* chunkPool)
     {
         m_renderer = renderer;
         m_transientHeap = transientHeap;
+        m_writer.setChunkPool(chunkPool);
     }
 
     void reset() { m_writer.clear(); }
@@ -329,7 +334,12 @@ public:
                 stateImpl->m_program,
                 m_commandBuffer->m_rootShaderObject.writeRef()
             ));
-            m_commandBuffer->m_rootShaderObject->copyFrom(rootObject, m_commandBuffer->m_transientHeap);
+            // Bundles snapshot mutable objects, the versions allocated from the transient heap are recycled once it is
+            // reset while the bundle can still be executed.
+            m_commandBuffer->m_rootShaderObject->copyFrom(
+                rootObject,
+                m_commandBuffer->m_isBundle ? nullptr : m_commandBuffer->m_transientHeap
+            );
             return SLANG_OK;
         }
 
@@ -511,7 +521,11 @@ public:
                 stateImpl->m_program,
                 m_commandBuffer->m_rootShaderObject.writeRef()
             ));
-            m_commandBuffer->m_rootShaderObject->copyFrom(rootObject, m_commandBuffer->m_transientHeap);
+            // Bundles snapshot mutable objects, as in the render encoder above.
+            m_commandBuffer->m_rootShaderObject->copyFrom(
+                rootObject,
+                m_commandBuffer->m_isBundle ? nullptr : m_commandBuffer->m_transientHeap
+            );
             return SLANG_OK;
         }
 
@@ -542,7 +556,7 @@ public:
         return SLANG_OK;
     }
 
-    virtual SLANG_NO_THROW void SLANG_MCALL close() override {}
+    virtual SLANG_NO_THROW void SLANG_MCALL close() override { m_isClosed = true; }
 
     virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override
     {
@@ -550,30 +564,55 @@ public:
         return SLANG_E_NOT_AVAILABLE;
     }
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL beginBundle() override
+    {
+        if (!m_writer.isEmpty() || m_isClosed)
+            return SLANG_FAIL;
+        m_isBundle = true;
+        return SLANG_OK;
+    }
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL executeBundle(ICommandBuffer* bundle) override
+    {
+        auto bundleImpl = static_cast<CommandBufferImpl*>(bundle);
+        if (!bundleImpl || bundleImpl == this || !bundleImpl->m_isBundle || !bundleImpl->m_isClosed)
+            return SLANG_E_INVALID_ARG;
+        m_writer.executeBundle(bundleImpl);
+        m_writer.m_hasWriteTimestamps |= bundleImpl->m_writer.m_hasWriteTimestamps;
+        return SLANG_OK;
+    }
+
     void execute()
     {
-        for (auto& cmd : m_writer.m_commands)
+        replay();
+        if (!m_isBundle)
+            m_writer.clear();
+    }
+
+    void replay()
+    {
+        for (const Command& cmd : m_writer.getCommands())
         {
             auto name = cmd.name;
             switch (name)
             {
             case CommandName::SetPipeline:
-                m_renderer->setPipeline(m_writer.getObject<PipelineBase>(cmd.operands[0]));
+                m_renderer->setPipeline(cmd.getObject<PipelineBase>(0));
                 break;
             case CommandName::BindRootShaderObject:
-                m_renderer->bindRootShaderObject(m_writer.getObject<ShaderObjectBase>(cmd.operands[0]));
+                m_renderer->bindRootShaderObject(cmd.getObject<ShaderObjectBase>(0));
                 break;
             case CommandName::SetFramebuffer:
-                m_renderer->setFramebuffer(m_writer.getObject<FramebufferBase>(cmd.operands[0]));
+                m_renderer->setFramebuffer(cmd.getObject<FramebufferBase>(0));
                 break;
             case CommandName::ClearFrame:
                 m_renderer->clearFrame(cmd.operands[0], (cmd.operands[1] != 0), (cmd.operands[2] != 0));
                 break;
             case CommandName::SetViewports:
-                m_renderer->setViewports((UInt)cmd.operands[0], m_writer.getData<Viewport>(cmd.operands[1]));
+                m_renderer->setViewports((UInt)cmd.operands[0], cmd.getData<Viewport>());
                 break;
             case CommandName::SetScissorRects:
-                m_renderer->setScissorRects((UInt)cmd.operands[0], m_writer.getData<ScissorRect>(cmd.operands[1]));
+                m_renderer->setScissorRects((UInt)cmd.operands[0], cmd.getData<ScissorRect>());
                 break;
             case CommandName::SetPrimitiveTopology:
                 m_renderer->setPrimitiveTopology((PrimitiveTopology)cmd.operands[0]);
@@ -583,22 +622,13 @@ public:
                 short_vector<IBuffer*> buffers;
                 for (uint32_t i = 0; i < cmd.operands[1]; i++)
                 {
-                    buffers.push_back(m_writer.getObject<Buffer>(cmd.operands[2] + i));
+                    buffers.push_back(cmd.getObject<Buffer>(i));
                 }
-                m_renderer->setVertexBuffers(
-                    cmd.operands[0],
-                    cmd.operands[1],
-                    buffers.data(),
-                    m_writer.getData<Offset>(cmd.operands[3])
-                );
+                m_renderer->setVertexBuffers(cmd.operands[0], cmd.operands[1], buffers.data(), cmd.getData<Offset>());
             }
             break;
             case CommandName::SetIndexBuffer:
-                m_renderer->setIndexBuffer(
-                    m_writer.getObject<Buffer>(cmd.operands[0]),
-                    (Format)cmd.operands[1],
-                    (UInt)cmd.operands[2]
-                );
+                m_renderer->setIndexBuffer(cmd.getObject<Buffer>(0), (Format)cmd.operands[0], (UInt)cmd.operands[1]);
                 break;
             case CommandName::Draw:
                 m_renderer->draw(cmd.operands[0], cmd.operands[1]);
@@ -626,33 +656,64 @@ public:
                 break;
             case CommandName::UploadBufferData:
                 m_renderer->uploadBufferData(
-                    m_writer.getObject<Buffer>(cmd.operands[0]),
+                    cmd.getObject<Buffer>(0),
+                    cmd.operands[0],
                     cmd.operands[1],
-                    cmd.operands[2],
-                    m_writer.getData<uint8_t>(cmd.operands[3])
+                    cmd.getData<uint8_t>()
                 );
                 break;
             case CommandName::CopyBuffer:
                 m_renderer->copyBuffer(
-                    m_writer.getObject<Buffer>(cmd.operands[0]),
+                    cmd.getObject<Buffer>(0),
+                    cmd.operands[0],
+                    cmd.getObject<Buffer>(1),
                     cmd.operands[1],
-                    m_writer.getObject<Buffer>(cmd.operands[2]),
-                    cmd.operands[3],
-                    cmd.operands[4]
+                    cmd.operands[2]
                 );
                 break;
             case CommandName::WriteTimestamp:
-                m_renderer->writeTimestamp(
-                    m_writer.getObject<QueryPoolBase>(cmd.operands[0]),
-                    (GfxIndex)cmd.operands[1]
-                );
+                m_renderer->writeTimestamp(cmd.getObject<QueryPoolBase>(0), (GfxIndex)cmd.operands[0]);
+                break;
+            case CommandName::ExecuteBundle:
+                cmd.getObject<CommandBufferImpl>(0)->replay();
                 break;
             default:
                 SLANG_RHI_ASSERT_FAILURE("Unknown command");
                 break;
             }
         }
-        m_writer.clear();
+    }
+
+    void prepare()
+    {
+        PipelineBase* pipeline = nullptr;
+        ShaderObjectBase* rootObject = nullptr;
+        prepare(pipeline, rootObject);
+    }
+
+    // `pipeline` and `rootObject` track the state bound at each command, which bundles inherit and change.
+    void prepare(PipelineBase*& pipeline, ShaderObjectBase*& rootObject)
+    {
+        for (const Command& cmd : m_writer.getCommands())
+        {
+            switch (cmd.name)
+            {
+            case CommandName::SetPipeline:
+                pipeline = cmd.getObject<PipelineBase>(0);
+                break;
+            case CommandName::BindRootShaderObject:
+                rootObject = cmd.getObject<ShaderObjectBase>(0);
+                break;
+            case CommandName::DispatchCompute:
+                m_renderer->prepareDispatchCompute(pipeline, rootObject);
+                break;
+            case CommandName::ExecuteBundle:
+                cmd.getObject<CommandBufferImpl>(0)->prepare(pipeline, rootObject);
+                break;
+            default:
+                break;
+            }
+        }
     }
 };
 
@@ -681,21 +742,7 @@ public:
     executeCommandBuffers(GfxCount count, ICommandBuffer* const* commandBuffers, IFence* fence, uint64_t valueToSignal)
         override
     {
-        // TODO: implement fence signal.
-        SLANG_RHI_ASSERT(fence == nullptr);
-
-        CommandBufferInfo info = {};
-        for (GfxIndex i = 0; i < count; i++)
-        {
-            info.hasWriteTimestamps |=
-                static_cast<CommandBufferImpl*>(commandBuffers[i])->m_writer.m_hasWriteTimestamps;
-        }
-        static_cast<ImmediateRendererBase*>(m_renderer.get())->beginCommandBuffer(info);
-        for (GfxIndex i = 0; i < count; i++)
-        {
-            static_cast<CommandBufferImpl*>(commandBuffers[i])->execute();
-        }
-        static_cast<ImmediateRendererBase*>(m_renderer.get())->endCommandBuffer(info);
+        getRenderer()->executeCommandBuffers(count, commandBuffers, fence, valueToSignal);
     }
 
     virtual SLANG_NO_THROW void SLANG_MCALL waitOnHost() override { getRenderer()->waitForGpu(); }
@@ -703,7 +750,7 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL
     waitForFenceValuesOnDevice(GfxCount fenceCount, IFence** fences, uint64_t* waitValues) override
     {
-        return SLANG_FAIL;
+        return getRenderer()->waitForFenceValuesOnDevice(fenceCount, fences, waitValues);
     }
 
     virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override
@@ -721,6 +768,47 @@ ImmediateRendererBase::ImmediateRendererBase()
     m_queue = new CommandQueueImpl(this);
 }
 
+void ImmediateRendererBase::executeCommandBuffers(
+    GfxCount count,
+    ICommandBuffer* const* commandBuffers,
+    IFence* fence,
+    uint64_t valueToSignal
+)
+{
+    CommandBufferInfo info = {};
+    for (GfxIndex i = 0; i < count; i++)
+    {
+        info.hasWriteTimestamps |= static_cast<CommandBufferImpl*>(commandBuffers[i])->m_writer.m_hasWriteTimestamps;
+    }
+    beginCommandBuffer(info);
+    for (GfxIndex i = 0; i < count; i++)
+    {
+        static_cast<CommandBufferImpl*>(commandBuffers[i])->execute();
+    }
+    endCommandBuffer(info);
+
+    if (fence)
+    {
+        fence->setCurrentValue(valueToSignal);
+    }
+}
+
+Result ImmediateRendererBase::waitForFenceValuesOnDevice(GfxCount fenceCount, IFence** fences, uint64_t* waitValues)
+{
+    SLANG_UNUSED(fenceCount);
+    SLANG_UNUSED(fences);
+    SLANG_UNUSED(waitValues);
+    return SLANG_FAIL;
+}
+
+void ImmediateRendererBase::prepareCommandBuffers(GfxCount count, ICommandBuffer* const* commandBuffers)
+{
+    for (GfxIndex i = 0; i < count; i++)
+    {
+        static_cast<CommandBufferImpl*>(commandBuffers[i])->prepare();
+    }
+}
+
 SLANG_NO_THROW Result SLANG_MCALL ImmediateRendererBase::createTransientResourceHeap(
     const ITransientResourceHeap::Desc& desc,
     ITransientResourceHeap** outHeap
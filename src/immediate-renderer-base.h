@@ -87,6 +87,25 @@ public:
     virtual void beginCommandBuffer(const CommandBufferInfo&) {}
     virtual void endCommandBuffer(const CommandBufferInfo&) {}
 
+    // Queue operations. The default implementation replays the command buffers on the calling thread.
+    virtual void executeCommandBuffers(
+        GfxCount count,
+        ICommandBuffer* const* commandBuffers,
+        IFence* fence,
+        uint64_t valueToSignal
+    );
+    virtual Result waitForFenceValuesOnDevice(GfxCount fenceCount, IFence** fences, uint64_t* waitValues);
+
+    // Called by `prepareCommandBuffers` for every dispatch with the pipeline and root object bound at that point.
+    // Targets that execute commands asynchronously use this to specialize and compile kernels up front
+    // on the submitting thread.
+    virtual void prepareDispatchCompute(PipelineBase* pipeline, ShaderObjectBase* rootObject)
+    {
+        SLANG_UNUSED(pipeline);
+        SLANG_UNUSED(rootObject);
+    }
+    void prepareCommandBuffers(GfxCount count, ICommandBuffer* const* commandBuffers);
+
 public:
     RefPtr<ImmediateCommandQueueBase> m_queue;
     uint32_t m_queueCreateCount = 0;
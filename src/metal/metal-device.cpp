@@ -696,7 +696,7 @@ Result DeviceImpl::createShaderProgram(
     AUTORELEASEPOOL
 
     RefPtr<ShaderProgramImpl> shaderProgram = new ShaderProgramImpl(this);
-    shaderProgram->init(desc);
+    shaderProgram->init(this, desc);
 
     RootShaderObjectLayoutImpl::create(
         this,
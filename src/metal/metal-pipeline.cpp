@@ -195,12 +195,16 @@ Result PipelineImpl::ensureAPIPipelineCreated()
 {
     AUTORELEASEPOOL
 
+    if (m_computePipelineState || m_renderPipelineState)
+        return SLANG_OK;
+
+    ShaderCompilationTimer timer(m_device->m_shaderCompilationStats.pipelineCreation);
     switch (desc.type)
     {
     case PipelineType::Compute:
-        return m_computePipelineState ? SLANG_OK : createMetalComputePipelineState();
+        return createMetalComputePipelineState();
     case PipelineType::Graphics:
-        return m_renderPipelineState ? SLANG_OK : createMetalRenderPipelineState();
+        return createMetalRenderPipelineState();
     default:
         SLANG_RHI_UNREACHABLE("Unknown pipeline type.");
         return SLANG_FAIL;
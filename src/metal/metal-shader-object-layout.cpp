@@ -204,6 +204,7 @@ slang::TypeLayoutReflection* ShaderObjectLayoutImpl::getParameterBlockTypeLayout
 {
     if (!m_parameterBlockTypeLayout)
     {
+        std::lock_guard<std::recursive_mutex> lock(m_renderer->m_slangSessionMutex);
         m_parameterBlockTypeLayout = m_slangSession->getTypeLayout(
             m_elementTypeLayout->getType(),
             0,
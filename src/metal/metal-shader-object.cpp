@@ -97,6 +97,7 @@ SLANG_NO_THROW Result SLANG_MCALL ShaderObjectImpl::setSampler(ShaderOffset cons
 Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* layout)
 {
     m_layout = layout;
+    resetSpecializationCache();
 
     // If the layout tells us that there is any uniform data,
     // then we will allocate a CPU memory buffer to hold that data
@@ -122,7 +123,7 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* layout)
     // we need to size the array to account for them.
     //
     Index subObjectCount = layout->getSubObjectCount();
-    m_objects.resize(subObjectCount);
+    resizeSubObjects(subObjectCount);
 
     for (auto subObjectRangeInfo : layout->getSubObjectRanges())
     {
@@ -146,7 +147,7 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* layout)
         {
             RefPtr<ShaderObjectImpl> subObject;
             SLANG_RETURN_ON_FAIL(ShaderObjectImpl::create(device, subObjectLayout, subObject.writeRef()));
-            m_objects[bindingRangeInfo.subObjectIndex + i] = subObject;
+            setSubObject(bindingRangeInfo.subObjectIndex + i, subObject);
         }
     }
     m_isArgumentBufferDirty = true;
@@ -655,11 +656,25 @@ Result RootShaderObjectImpl::collectSpecializationArgs(ExtendedShaderObjectTypeL
     SLANG_RETURN_ON_FAIL(ShaderObjectImpl::collectSpecializationArgs(args));
     for (auto& entryPoint : m_entryPoints)
     {
-        SLANG_RETURN_ON_FAIL(entryPoint->collectSpecializationArgs(args));
+        const ExtendedShaderObjectTypeList* entryPointArgs;
+        SLANG_RETURN_ON_FAIL(entryPoint->getSpecializationArgs(entryPointArgs));
+        args.addRange(*entryPointArgs);
     }
     return SLANG_OK;
 }
 
+bool RootShaderObjectImpl::isSpecializationDirty()
+{
+    if (ShaderObjectImpl::isSpecializationDirty())
+        return true;
+    for (auto& entryPoint : m_entryPoints)
+    {
+        if (entryPoint->isSpecializationDirty())
+            return true;
+    }
+    return false;
+}
+
 Result RootShaderObjectImpl::bindAsRoot(BindingContext* context, RootShaderObjectLayoutImpl* layout)
 {
     // When binding an entire root shader object, we need to deal with
@@ -149,6 +149,7 @@ public:
     }
 
     virtual Result collectSpecializationArgs(ExtendedShaderObjectTypeList& args) override;
+    virtual bool isSpecializationDirty() override;
 
     /// Bind this object as a root shader object
     Result bindAsRoot(BindingContext* context, RootShaderObjectLayoutImpl* specializedLayout);
@@ -15,18 +15,36 @@ Result TransientResourceHeapImpl::init(const ITransientResourceHeap::Desc& desc,
     return SLANG_OK;
 }
 
-TransientResourceHeapImpl::~TransientResourceHeapImpl() {}
+TransientResourceHeapImpl::~TransientResourceHeapImpl()
+{
+    // Staging buffers go back to the device for reuse, so the GPU must be done with them.
+    waitForCommandBuffers();
+}
+
+void TransientResourceHeapImpl::waitForCommandBuffers()
+{
+    for (auto& commandBuffer : m_commandBuffers)
+    {
+        // Command buffers that were never committed don't use the heap, and waiting on them would block forever.
+        MTL::CommandBufferStatus status = commandBuffer->status();
+        if (status == MTL::CommandBufferStatusCommitted || status == MTL::CommandBufferStatusScheduled)
+            commandBuffer->waitUntilCompleted();
+    }
+    m_commandBuffers.clear();
+}
 
 Result TransientResourceHeapImpl::createCommandBuffer(ICommandBuffer** outCmdBuffer)
 {
     RefPtr<CommandBufferImpl> commandBuffer = new CommandBufferImpl();
     SLANG_RETURN_ON_FAIL(commandBuffer->init(m_device, this));
+    m_commandBuffers.push_back(commandBuffer->m_commandBuffer);
     returnComPtr(outCmdBuffer, commandBuffer);
     return SLANG_OK;
 }
 
 Result TransientResourceHeapImpl::synchronizeAndReset()
 {
+    waitForCommandBuffers();
     Super::reset();
     return SLANG_OK;
 }
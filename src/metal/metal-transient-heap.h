@@ -13,10 +13,15 @@ private:
 
 public:
     NS::SharedPtr<MTL::CommandQueue> m_commandQueue;
+    // Command buffers created since the last reset, which may still use the heap's staging buffers.
+    std::vector<NS::SharedPtr<MTL::CommandBuffer>> m_commandBuffers;
 
     Result init(const ITransientResourceHeap::Desc& desc, DeviceImpl* device);
     ~TransientResourceHeapImpl();
 
+    // Waits until the GPU has completed all command buffers created from this heap that were committed.
+    void waitForCommandBuffers();
+
 public:
     virtual SLANG_NO_THROW Result SLANG_MCALL createCommandBuffer(ICommandBuffer** outCommandBuffer) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL synchronizeAndReset() override;
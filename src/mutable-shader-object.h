@@ -7,46 +7,101 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace rhi {
 
 class ShaderObjectLayoutBase;
 
+// Pool of object versions used by transient heaps.
+// Versions are grouped by the transient heap they were allocated for. Once that heap is reset, its version changes
+// and the whole group is recycled at once. Recycled objects are kept in a free list, up to `kMaxFreeObjects`.
 template<typename T>
 class VersionedObjectPool
 {
 public:
-    struct ObjectVersion
+    static constexpr size_t kMaxFreeObjects = 1024;
+
+    // Objects allocated for a transient heap since its last reset.
+    struct HeapObjects
     {
-        RefPtr<T> object;
         RefPtr<TransientResourceHeapBase> transientHeap;
         uint64_t transientHeapVersion;
+        std::vector<RefPtr<T>> objects;
         bool canRecycle() { return (transientHeap->getVersion() != transientHeapVersion); }
     };
-    std::vector<ObjectVersion> objects;
-    SlangInt lastAllocationIndex = -1;
-    ObjectVersion& allocate(TransientResourceHeapBase* currentTransientHeap)
+    std::unordered_map<TransientResourceHeapBase*, HeapObjects> heapObjects;
+    std::vector<RefPtr<T>> freeObjects;
+    HeapObjects* lastAllocationHeapObjects = nullptr;
+    // Value of the transient heap version counter when groups were last checked for recycling.
+    // Groups can only become recyclable after a heap was reset, which advances the counter.
+    uint64_t lastCollectVersion = 0;
+
+    // Returns the slot of a new version. The slot holds a recycled object, or null if a new object must be created.
+    // The slot stays valid until the next call to `allocate`.
+    RefPtr<T>& allocate(TransientResourceHeapBase* currentTransientHeap)
+    {
+        auto& current = heapObjects[currentTransientHeap];
+        if (!current.transientHeap)
+        {
+            current.transientHeap = currentTransientHeap;
+        }
+        else if (current.canRecycle())
+        {
+            recycle(current);
+        }
+        current.transientHeapVersion = currentTransientHeap->getVersion();
+
+        if (freeObjects.empty())
+            collectRecyclable(currentTransientHeap->getVersionCounter());
+
+        if (freeObjects.empty())
+        {
+            current.objects.push_back(nullptr);
+        }
+        else
+        {
+            current.objects.push_back(std::move(freeObjects.back()));
+            freeObjects.pop_back();
+        }
+        lastAllocationHeapObjects = &current;
+        return current.objects.back();
+    }
+
+    RefPtr<T>& getLastAllocation() { return lastAllocationHeapObjects->objects.back(); }
+
+private:
+    void recycle(HeapObjects& group)
+    {
+        for (auto& object : group.objects)
+        {
+            if (freeObjects.size() >= kMaxFreeObjects)
+                break;
+            if (object)
+                freeObjects.push_back(std::move(object));
+        }
+        group.objects.clear();
+    }
+
+    void collectRecyclable(uint64_t versionCounter)
     {
-        for (SlangInt i = 0; i < objects.size(); i++)
+        if (versionCounter == lastCollectVersion)
+            return;
+        lastCollectVersion = versionCounter;
+        for (auto it = heapObjects.begin(); it != heapObjects.end();)
         {
-            auto& object = objects[i];
-            if (object.canRecycle())
+            if (it->second.canRecycle())
+            {
+                recycle(it->second);
+                it = heapObjects.erase(it);
+            }
+            else
             {
-                object.transientHeap = currentTransientHeap;
-                object.transientHeapVersion = currentTransientHeap->getVersion();
-                lastAllocationIndex = i;
-                return object;
+                ++it;
             }
         }
-        ObjectVersion v;
-        v.transientHeap = currentTransientHeap;
-        v.transientHeapVersion = currentTransientHeap->getVersion();
-        objects.push_back(v);
-        lastAllocationIndex = objects.size() - 1;
-        return objects.back();
     }
-    ObjectVersion& getLastAllocation() { return objects[lastAllocationIndex]; }
 };
 
 class MutableShaderObjectData
@@ -107,8 +162,9 @@ public:
         this->m_device = device;
         auto layoutImpl = static_cast<TShaderObjectLayoutImpl*>(layout);
         this->m_layout = layoutImpl;
+        this->resetSpecializationCache();
         Index subObjectCount = layoutImpl->getSubObjectCount();
-        this->m_objects.resize(subObjectCount);
+        this->resizeSubObjects(subObjectCount);
         auto dataSize = layoutImpl->getElementTypeLayout()->getSize();
         SLANG_RHI_ASSERT(dataSize >= 0);
         this->m_data.setCount(dataSize);
@@ -164,9 +220,21 @@ public:
         return SLANG_OK;
     }
 
+    // Returns a version holding the current contents of this object.
+    // Without a transient heap, the version is a snapshot that is not owned by the version pool, so it is never
+    // recycled. Bundles use snapshots because they are executed again after their transient heap was reset.
     virtual SLANG_NO_THROW Result SLANG_MCALL
     getCurrentVersion(ITransientResourceHeap* transientHeap, IShaderObject** outObject) override
     {
+        if (!transientHeap)
+        {
+            ComPtr<IShaderObject> snapshot;
+            SLANG_RETURN_ON_FAIL(this->m_device->createShaderObject(this->m_layout, snapshot.writeRef()));
+            SLANG_RETURN_ON_FAIL(writeVersion(static_cast<ShaderObjectBase*>(snapshot.get()), nullptr));
+            returnComPtr(outObject, snapshot);
+            return SLANG_OK;
+        }
+
         if (!isDirty())
         {
             returnComPtr(outObject, getLastAllocatedShaderObject());
@@ -174,6 +242,18 @@ public:
         }
 
         RefPtr<ShaderObjectBase> object = allocateShaderObject(static_cast<TransientResourceHeapBase*>(transientHeap));
+        if (!object)
+            return SLANG_FAIL;
+        SLANG_RETURN_ON_FAIL(writeVersion(object, transientHeap));
+        m_dirty = false;
+        this->m_data.m_dirty = false;
+        returnComPtr(outObject, object);
+        return SLANG_OK;
+    }
+
+private:
+    Result writeVersion(ShaderObjectBase* object, ITransientResourceHeap* transientHeap)
+    {
         SLANG_RETURN_ON_FAIL(object->setData(ShaderOffset(), this->m_data.getBuffer(), this->m_data.getCount()));
         for (auto it : m_resources)
             SLANG_RETURN_ON_FAIL(object->setResource(it.first, it.second));
@@ -196,28 +276,22 @@ public:
                 SLANG_RETURN_ON_FAIL(object->setObject(offset, subObjectVersion));
             }
         }
-        m_dirty = false;
-        this->m_data.m_dirty = false;
-        returnComPtr(outObject, object);
         return SLANG_OK;
     }
 
 public:
     RefPtr<ShaderObjectBase> allocateShaderObject(TransientResourceHeapBase* transientHeap)
     {
-        auto& version = m_shaderObjectVersions.allocate(transientHeap);
-        if (!version.object)
+        auto& object = m_shaderObjectVersions.allocate(transientHeap);
+        if (!object)
         {
             ComPtr<IShaderObject> shaderObject;
             SLANG_RETURN_NULL_ON_FAIL(this->m_device->createShaderObject(this->m_layout, shaderObject.writeRef()));
-            version.object = static_cast<ShaderObjectBase*>(shaderObject.get());
+            object = static_cast<ShaderObjectBase*>(shaderObject.get());
         }
-        return version.object;
-    }
-    RefPtr<ShaderObjectBase> getLastAllocatedShaderObject()
-    {
-        return m_shaderObjectVersions.getLastAllocation().object;
+        return object;
     }
+    RefPtr<ShaderObjectBase> getLastAllocatedShaderObject() { return m_shaderObjectVersions.getLastAllocation(); }
 };
 
 // A proxy shader object to hold mutable shader parameters for global scope and entry-points.
@@ -0,0 +1,886 @@
+#include "persistent-shader-cache.h"
+#include "renderer-shared.h"
+
+#include "core/blob.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#if SLANG_WINDOWS_FAMILY
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rhi {
+
+static const char kPackMagic[8] = {'S', 'R', 'H', 'I', 'P', 'A', 'C', 'K'};
+static const uint32_t kPackVersion = 1;
+static const uint32_t kRecordMagic = 0x43455253; // "SREC"
+// Record data is aligned so that shader code can be consumed directly from the mapping.
+static const uint64_t kRecordAlignment = 16;
+static const uint64_t kMinMaxSize = 64 * 1024;
+static const uint64_t kMinGrowSize = 1024 * 1024;
+
+struct PackHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    // End of the committed records. Records past this offset are ignored.
+    uint64_t committedEnd;
+    // Last use clock, used to continue the clock when the pack is reopened.
+    uint64_t useClock;
+    uint64_t reserved[4];
+};
+static_assert(sizeof(PackHeader) == 64, "unexpected pack header size");
+
+struct RecordHeader
+{
+    uint32_t magic;
+    uint32_t keySize;
+    uint64_t dataSize;
+    uint64_t keyHash;
+    // Hash of the key and data.
+    uint64_t checksum;
+    uint64_t lastUse;
+    uint64_t reserved;
+};
+static_assert(sizeof(RecordHeader) == 48, "unexpected record header size");
+
+inline uint64_t alignRecordOffset(uint64_t offset)
+{
+    return (offset + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+}
+
+inline uint64_t getRecordDataOffset(uint64_t keySize)
+{
+    return alignRecordOffset(sizeof(RecordHeader) + keySize);
+}
+
+inline uint64_t getRecordSize(uint64_t keySize, uint64_t dataSize)
+{
+    return alignRecordOffset(getRecordDataOffset(keySize) + dataSize);
+}
+
+// MurmurHash64A, processes 8 bytes per step.
+static uint64_t hashBytes(const void* data, size_t size, uint64_t seed)
+{
+    const uint64_t m = 0xc6a4a7935bd1e995ull;
+    const int r = 47;
+    uint64_t h = seed ^ (size * m);
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const uint8_t* end = bytes + (size & ~size_t(7));
+    for (; bytes != end; bytes += 8)
+    {
+        uint64_t k;
+        memcpy(&k, bytes, 8);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    uint64_t tail = 0;
+    switch (size & 7)
+    {
+    case 7:
+        tail ^= uint64_t(bytes[6]) << 48;
+        [[fallthrough]];
+    case 6:
+        tail ^= uint64_t(bytes[5]) << 40;
+        [[fallthrough]];
+    case 5:
+        tail ^= uint64_t(bytes[4]) << 32;
+        [[fallthrough]];
+    case 4:
+        tail ^= uint64_t(bytes[3]) << 24;
+        [[fallthrough]];
+    case 3:
+        tail ^= uint64_t(bytes[2]) << 16;
+        [[fallthrough]];
+    case 2:
+        tail ^= uint64_t(bytes[1]) << 8;
+        [[fallthrough]];
+    case 1:
+        tail ^= uint64_t(bytes[0]);
+        h ^= tail;
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+static uint64_t hashKey(const void* key, size_t keySize)
+{
+    return hashBytes(key, keySize, 0x5348414445524b59ull);
+}
+
+static uint64_t computeChecksum(const void* key, size_t keySize, const void* data, size_t dataSize)
+{
+    return hashBytes(data, dataSize, hashBytes(key, keySize, 0x434845434b53554dull));
+}
+
+// Platform file operations.
+// Files are identified by a file descriptor or a Win32 handle stored in an intptr_t, -1 if invalid.
+
+#if SLANG_WINDOWS_FAMILY
+
+static std::wstring toWidePath(const std::string& path)
+{
+    int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring result(length > 0 ? length - 1 : 0, L'\0');
+    if (length > 1)
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, result.data(), length);
+    return result;
+}
+
+static bool openFile(const std::string& path, bool truncate, intptr_t& outFile)
+{
+    // Sharing delete access allows other processes to replace the pack file while it is open.
+    HANDLE handle = CreateFileW(
+        toWidePath(path).c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        truncate ? CREATE_ALWAYS : OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    outFile = intptr_t(handle);
+    return true;
+}
+
+static void closeFile(intptr_t file)
+{
+    CloseHandle(HANDLE(file));
+}
+
+static bool readFile(intptr_t file, uint64_t offset, void* data, size_t size)
+{
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    while (size > 0)
+    {
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = DWORD(offset & 0xffffffff);
+        overlapped.OffsetHigh = DWORD(offset >> 32);
+        DWORD chunkSize = DWORD(std::min<size_t>(size, 1u << 30));
+        DWORD readSize = 0;
+        if (!ReadFile(HANDLE(file), bytes, chunkSize, &readSize, &overlapped) || readSize == 0)
+            return false;
+        bytes += readSize;
+        offset += readSize;
+        size -= readSize;
+    }
+    return true;
+}
+
+static bool writeFile(intptr_t file, uint64_t offset, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0)
+    {
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = DWORD(offset & 0xffffffff);
+        overlapped.OffsetHigh = DWORD(offset >> 32);
+        DWORD chunkSize = DWORD(std::min<size_t>(size, 1u << 30));
+        DWORD writtenSize = 0;
+        if (!WriteFile(HANDLE(file), bytes, chunkSize, &writtenSize, &overlapped) || writtenSize == 0)
+            return false;
+        bytes += writtenSize;
+        offset += writtenSize;
+        size -= writtenSize;
+    }
+    return true;
+}
+
+static bool getFileSize(intptr_t file, uint64_t& outSize)
+{
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(HANDLE(file), &size))
+        return false;
+    outSize = uint64_t(size.QuadPart);
+    return true;
+}
+
+static bool setFileSize(intptr_t file, uint64_t size)
+{
+    FILE_END_OF_FILE_INFO info = {};
+    info.EndOfFile.QuadPart = LONGLONG(size);
+    return SetFileInformationByHandle(HANDLE(file), FileEndOfFileInfo, &info, sizeof(info)) != 0;
+}
+
+static bool syncFile(intptr_t file)
+{
+    return FlushFileBuffers(HANDLE(file)) != 0;
+}
+
+// Lock a byte range past any data, so the lock doesn't block reads and writes of other processes.
+static const DWORD kLockOffsetHigh = 0xffffffff;
+
+static bool lockFile(intptr_t file)
+{
+    OVERLAPPED overlapped = {};
+    overlapped.OffsetHigh = kLockOffsetHigh;
+    return LockFileEx(HANDLE(file), LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped) != 0;
+}
+
+static void unlockFile(intptr_t file)
+{
+    OVERLAPPED overlapped = {};
+    overlapped.OffsetHigh = kLockOffsetHigh;
+    UnlockFileEx(HANDLE(file), 0, 1, 0, &overlapped);
+}
+
+static bool getFileId(intptr_t file, PersistentShaderCache::FileId& outId)
+{
+    BY_HANDLE_FILE_INFORMATION info;
+    if (!GetFileInformationByHandle(HANDLE(file), &info))
+        return false;
+    outId.volume = info.dwVolumeSerialNumber;
+    outId.index = (uint64_t(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    return true;
+}
+
+static bool getPathFileId(const std::string& path, PersistentShaderCache::FileId& outId)
+{
+    HANDLE handle = CreateFileW(
+        toWidePath(path).c_str(),
+        0,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS,
+        nullptr
+    );
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    bool result = getFileId(intptr_t(handle), outId);
+    CloseHandle(handle);
+    return result;
+}
+
+static const uint8_t* mapFile(intptr_t file, size_t size)
+{
+    HANDLE mapping = CreateFileMappingW(HANDLE(file), nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+        return nullptr;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    // The view keeps the file mapping alive.
+    CloseHandle(mapping);
+    return static_cast<const uint8_t*>(view);
+}
+
+static void unmapFile(const uint8_t* data, size_t size)
+{
+    SLANG_UNUSED(size);
+    UnmapViewOfFile(data);
+}
+
+static bool replaceFile(const std::string& from, const std::string& to)
+{
+    return MoveFileExW(toWidePath(from).c_str(), toWidePath(to).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+static void removeFile(const std::string& path)
+{
+    DeleteFileW(toWidePath(path).c_str());
+}
+
+#else // SLANG_WINDOWS_FAMILY
+
+static bool openFile(const std::string& path, bool truncate, intptr_t& outFile)
+{
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    if (fd < 0)
+        return false;
+    outFile = fd;
+    return true;
+}
+
+static void closeFile(intptr_t file)
+{
+    close(int(file));
+}
+
+static bool readFile(intptr_t file, uint64_t offset, void* data, size_t size)
+{
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    while (size > 0)
+    {
+        ssize_t readSize = pread(int(file), bytes, size, off_t(offset));
+        if (readSize <= 0)
+            return false;
+        bytes += readSize;
+        offset += readSize;
+        size -= readSize;
+    }
+    return true;
+}
+
+static bool writeFile(intptr_t file, uint64_t offset, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0)
+    {
+        ssize_t writtenSize = pwrite(int(file), bytes, size, off_t(offset));
+        if (writtenSize <= 0)
+            return false;
+        bytes += writtenSize;
+        offset += writtenSize;
+        size -= writtenSize;
+    }
+    return true;
+}
+
+static bool getFileSize(intptr_t file, uint64_t& outSize)
+{
+    struct stat info;
+    if (fstat(int(file), &info) != 0)
+        return false;
+    outSize = uint64_t(info.st_size);
+    return true;
+}
+
+static bool setFileSize(intptr_t file, uint64_t size)
+{
+    return ftruncate(int(file), off_t(size)) == 0;
+}
+
+static bool syncFile(intptr_t file)
+{
+#if SLANG_LINUX_FAMILY
+    return fdatasync(int(file)) == 0;
+#else
+    return fsync(int(file)) == 0;
+#endif
+}
+
+// flock locks belong to the open file description, so they also exclude other caches in the same process.
+static bool lockFile(intptr_t file)
+{
+    while (flock(int(file), LOCK_EX) != 0)
+    {
+        if (errno != EINTR)
+            return false;
+    }
+    return true;
+}
+
+static void unlockFile(intptr_t file)
+{
+    flock(int(file), LOCK_UN);
+}
+
+static bool getFileId(intptr_t file, PersistentShaderCache::FileId& outId)
+{
+    struct stat info;
+    if (fstat(int(file), &info) != 0)
+        return false;
+    outId.volume = uint64_t(info.st_dev);
+    outId.index = uint64_t(info.st_ino);
+    return true;
+}
+
+static bool getPathFileId(const std::string& path, PersistentShaderCache::FileId& outId)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return false;
+    outId.volume = uint64_t(info.st_dev);
+    outId.index = uint64_t(info.st_ino);
+    return true;
+}
+
+static const uint8_t* mapFile(intptr_t file, size_t size)
+{
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, int(file), 0);
+    if (view == MAP_FAILED)
+        return nullptr;
+    return static_cast<const uint8_t*>(view);
+}
+
+static void unmapFile(const uint8_t* data, size_t size)
+{
+    munmap(const_cast<uint8_t*>(data), size);
+}
+
+static bool replaceFile(const std::string& from, const std::string& to)
+{
+    return rename(from.c_str(), to.c_str()) == 0;
+}
+
+static void removeFile(const std::string& path)
+{
+    unlink(path.c_str());
+}
+
+#endif // SLANG_WINDOWS_FAMILY
+
+/// Blob pointing into a pack file mapping.
+class MappedBlob : public BlobBase
+{
+public:
+    MappedBlob(PackFileMapping* mapping, const void* data, size_t size)
+        : m_mapping(mapping)
+        , m_data(data)
+        , m_size(size)
+    {
+    }
+
+    virtual SLANG_NO_THROW void const* SLANG_MCALL getBufferPointer() { return m_data; }
+    virtual SLANG_NO_THROW size_t SLANG_MCALL getBufferSize() { return m_size; }
+
+private:
+    RefPtr<PackFileMapping> m_mapping;
+    const void* m_data;
+    size_t m_size;
+};
+
+PackFileMapping::~PackFileMapping()
+{
+    if (data)
+        unmapFile(data, size);
+}
+
+IPersistentShaderCache* PersistentShaderCache::getInterface(const Guid& guid)
+{
+    if (guid == GUID::IID_ISlangUnknown || guid == GUID::IID_IPersistentShaderCache)
+        return static_cast<IPersistentShaderCache*>(this);
+    return nullptr;
+}
+
+PersistentShaderCache::~PersistentShaderCache()
+{
+    flushLastUse();
+    closePack();
+}
+
+Result PersistentShaderCache::init(const PersistentShaderCacheDesc& desc)
+{
+    if (!desc.path || !desc.path[0])
+        return SLANG_E_INVALID_ARG;
+    m_path = desc.path;
+    m_maxSize = std::max(desc.maxSize, kMinMaxSize);
+    return openPack();
+}
+
+Result PersistentShaderCache::openPack()
+{
+    if (!openFile(m_path, false, m_file))
+        return SLANG_FAIL;
+    if (!lockFile(m_file))
+    {
+        closePack();
+        return SLANG_FAIL;
+    }
+
+    // Initialize the header if the file is new, or was written by an incompatible version.
+    // The file is not truncated, because other processes may still have it mapped.
+    PackHeader header;
+    uint64_t fileSize = 0;
+    bool valid = getFileSize(m_file, fileSize) && fileSize >= sizeof(PackHeader) &&
+                 readFile(m_file, 0, &header, sizeof(header)) && memcmp(header.magic, kPackMagic, 8) == 0 &&
+                 header.version == kPackVersion && header.headerSize == sizeof(PackHeader) &&
+                 header.committedEnd >= sizeof(PackHeader) && header.committedEnd <= fileSize;
+    Result result = SLANG_OK;
+    if (!valid)
+    {
+        header = {};
+        memcpy(header.magic, kPackMagic, 8);
+        header.version = kPackVersion;
+        header.headerSize = sizeof(PackHeader);
+        header.committedEnd = sizeof(PackHeader);
+        if (!writeFile(m_file, 0, &header, sizeof(header)) || !syncFile(m_file))
+            result = SLANG_FAIL;
+    }
+    unlockFile(m_file);
+
+    if (SLANG_SUCCEEDED(result) && !getFileId(m_file, m_fileId))
+        result = SLANG_FAIL;
+    if (SLANG_FAILED(result))
+    {
+        closePack();
+        return result;
+    }
+
+    m_useClock = std::max(m_useClock, header.useClock);
+    m_compactRetryEnd = 0;
+    return mapPack();
+}
+
+Result PersistentShaderCache::mapPack()
+{
+    m_scannedEnd = sizeof(PackHeader);
+    m_entries.clear();
+    Result result = remap();
+    if (SLANG_SUCCEEDED(result))
+        result = refresh();
+    // The pack is only kept open if it is mapped.
+    if (SLANG_FAILED(result))
+        closePack();
+    return result;
+}
+
+void PersistentShaderCache::closePack()
+{
+    // Blobs returned by `queryCache` keep the mapping alive.
+    m_mapping = nullptr;
+    if (m_file != -1)
+    {
+        closeFile(m_file);
+        m_file = -1;
+    }
+}
+
+bool PersistentShaderCache::isPackReplaced()
+{
+    FileId pathId;
+    return !getPathFileId(m_path, pathId) || pathId != m_fileId;
+}
+
+Result PersistentShaderCache::reopenIfReplaced()
+{
+    if (m_file != -1 && !isPackReplaced())
+        return SLANG_OK;
+    closePack();
+    return openPack();
+}
+
+Result PersistentShaderCache::remap()
+{
+    uint64_t fileSize;
+    if (!getFileSize(m_file, fileSize))
+        return SLANG_FAIL;
+    if (m_mapping && m_mapping->size == fileSize)
+        return SLANG_OK;
+    RefPtr<PackFileMapping> mapping = new PackFileMapping();
+    mapping->data = mapFile(m_file, size_t(fileSize));
+    if (!mapping->data)
+        return SLANG_FAIL;
+    mapping->size = size_t(fileSize);
+    m_mapping = mapping;
+    return SLANG_OK;
+}
+
+uint64_t PersistentShaderCache::getCommittedEnd()
+{
+    // The header is updated by other processes while it is mapped.
+    auto header = reinterpret_cast<const volatile PackHeader*>(m_mapping->data);
+    return header->committedEnd;
+}
+
+Result PersistentShaderCache::refresh()
+{
+    uint64_t committedEnd = getCommittedEnd();
+    if (committedEnd > m_mapping->size)
+    {
+        SLANG_RETURN_ON_FAIL(remap());
+        committedEnd = std::min<uint64_t>(committedEnd, m_mapping->size);
+    }
+    if (committedEnd < m_scannedEnd)
+    {
+        // The pack was reinitialized, drop all records.
+        m_entries.clear();
+        m_scannedEnd = sizeof(PackHeader);
+    }
+
+    uint64_t offset = m_scannedEnd;
+    while (offset + sizeof(RecordHeader) <= committedEnd)
+    {
+        RecordHeader record;
+        memcpy(&record, m_mapping->data + offset, sizeof(record));
+        if (record.magic != kRecordMagic || record.dataSize > committedEnd ||
+            offset + getRecordSize(record.keySize, record.dataSize) > committedEnd)
+            break;
+        Entry& entry = m_entries[record.keyHash];
+        entry.offset = offset;
+        entry.keySize = record.keySize;
+        entry.dataSize = record.dataSize;
+        entry.lastUse = record.lastUse;
+        entry.verified = false;
+        entry.lastUseDirty = false;
+        m_useClock = std::max(m_useClock, record.lastUse);
+        offset += getRecordSize(record.keySize, record.dataSize);
+    }
+    m_scannedEnd = offset;
+    return SLANG_OK;
+}
+
+PersistentShaderCache::Entry* PersistentShaderCache::findEntry(uint64_t keyHash, const void* key, size_t keySize)
+{
+    auto it = m_entries.find(keyHash);
+    if (it == m_entries.end())
+        return nullptr;
+    Entry& entry = it->second;
+    const uint8_t* record = m_mapping->data + entry.offset;
+    const uint8_t* recordKey = record + sizeof(RecordHeader);
+    if (entry.keySize != keySize || memcmp(recordKey, key, keySize) != 0)
+        return nullptr;
+    if (!entry.verified)
+    {
+        // Committed records can still be damaged if the system crashed before they reached the disk.
+        RecordHeader header;
+        memcpy(&header, record, sizeof(header));
+        const uint8_t* recordData = record + getRecordDataOffset(keySize);
+        if (computeChecksum(recordKey, keySize, recordData, size_t(entry.dataSize)) != header.checksum)
+        {
+            m_entries.erase(it);
+            return nullptr;
+        }
+        entry.verified = true;
+    }
+    return &entry;
+}
+
+SLANG_NO_THROW Result SLANG_MCALL PersistentShaderCache::queryCache(ISlangBlob* key, ISlangBlob** outData)
+{
+    *outData = nullptr;
+    const void* keyData = key->getBufferPointer();
+    size_t keySize = key->getBufferSize();
+    uint64_t keyHash = hashKey(keyData, keySize);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry* entry = m_file != -1 ? findEntry(keyHash, keyData, keySize) : nullptr;
+    if (!entry)
+    {
+        // Pick up records written by other processes.
+        if (SLANG_FAILED(reopenIfReplaced()) || SLANG_FAILED(refresh()))
+            return SLANG_E_NOT_FOUND;
+        entry = findEntry(keyHash, keyData, keySize);
+        if (!entry)
+            return SLANG_E_NOT_FOUND;
+    }
+
+    entry->lastUse = ++m_useClock;
+    entry->lastUseDirty = true;
+    const uint8_t* data = m_mapping->data + entry->offset + getRecordDataOffset(entry->keySize);
+    ComPtr<ISlangBlob> blob(new MappedBlob(m_mapping.Ptr(), data, size_t(entry->dataSize)));
+    returnComPtr(outData, blob);
+    return SLANG_OK;
+}
+
+SLANG_NO_THROW Result SLANG_MCALL PersistentShaderCache::writeCache(ISlangBlob* key, ISlangBlob* data)
+{
+    const void* keyData = key->getBufferPointer();
+    size_t keySize = key->getBufferSize();
+    const void* dataData = data->getBufferPointer();
+    size_t dataSize = data->getBufferSize();
+    uint64_t keyHash = hashKey(keyData, keySize);
+    uint64_t recordSize = getRecordSize(keySize, dataSize);
+    if (keySize > UINT32_MAX || recordSize > m_maxSize - sizeof(PackHeader))
+        return SLANG_E_INVALID_ARG;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SLANG_RETURN_ON_FAIL(reopenIfReplaced());
+
+    // Lock the pack file. Another process may have replaced it while we were waiting for the lock.
+    for (;;)
+    {
+        if (!lockFile(m_file))
+            return SLANG_FAIL;
+        if (!isPackReplaced())
+            break;
+        unlockFile(m_file);
+        closePack();
+        SLANG_RETURN_ON_FAIL(openPack());
+    }
+
+    Result result = [&]() -> Result
+    {
+        SLANG_RETURN_ON_FAIL(refresh());
+
+        // Nothing to do if the same entry was written already, for example by another process.
+        if (Entry* entry = findEntry(keyHash, keyData, keySize))
+        {
+            const uint8_t* entryData = m_mapping->data + entry->offset + getRecordDataOffset(keySize);
+            if (entry->dataSize == dataSize && memcmp(entryData, dataData, dataSize) == 0)
+                return SLANG_OK;
+        }
+
+        // Records past the last valid record are damaged, overwrite them.
+        uint64_t committedEnd = m_scannedEnd;
+        if (committedEnd + recordSize > m_maxSize && committedEnd >= m_compactRetryEnd)
+        {
+            m_compactRetryEnd = 0;
+            if (SLANG_FAILED(compact(recordSize)))
+            {
+                if (m_file == -1)
+                    return SLANG_FAIL;
+                // The pack file could not be replaced, append past the size cap instead.
+                m_compactRetryEnd = committedEnd + m_maxSize / 4;
+            }
+            committedEnd = m_scannedEnd;
+        }
+
+        uint64_t fileSize;
+        if (!getFileSize(m_file, fileSize))
+            return SLANG_FAIL;
+        if (committedEnd + recordSize > fileSize)
+        {
+            // Grow the file geometrically to limit how often it is remapped.
+            uint64_t newFileSize = std::max(fileSize * 2, kMinGrowSize);
+            newFileSize = std::max(std::min(newFileSize, m_maxSize), committedEnd + recordSize);
+            if (!setFileSize(m_file, newFileSize))
+                return SLANG_FAIL;
+        }
+
+        RecordHeader header = {};
+        header.magic = kRecordMagic;
+        header.keySize = uint32_t(keySize);
+        header.dataSize = dataSize;
+        header.keyHash = keyHash;
+        header.checksum = computeChecksum(keyData, keySize, dataData, dataSize);
+        header.lastUse = ++m_useClock;
+
+        std::vector<uint8_t> recordPrefix(size_t(getRecordDataOffset(keySize)), 0);
+        memcpy(recordPrefix.data(), &header, sizeof(header));
+        memcpy(recordPrefix.data() + sizeof(header), keyData, keySize);
+
+        // Write and flush the record before committing it, so a crash can't commit a partial record.
+        if (!writeFile(m_file, committedEnd, recordPrefix.data(), recordPrefix.size()) ||
+            !writeFile(m_file, committedEnd + recordPrefix.size(), dataData, dataSize) || !syncFile(m_file))
+            return SLANG_FAIL;
+        uint64_t newCommittedEnd = committedEnd + recordSize;
+        if (!writeFile(m_file, offsetof(PackHeader, committedEnd), &newCommittedEnd, sizeof(newCommittedEnd)))
+            return SLANG_FAIL;
+
+        SLANG_RETURN_ON_FAIL(remap());
+        return refresh();
+    }();
+
+    // A failed compaction may have closed the pack file, which also releases the lock.
+    if (m_file != -1)
+        unlockFile(m_file);
+    return result;
+}
+
+Result PersistentShaderCache::compact(uint64_t requiredSize)
+{
+    // Keep the most recently used records, filling up to half of the size cap.
+    std::vector<Entry> entries;
+    entries.reserve(m_entries.size());
+    for (const auto& it : m_entries)
+        entries.push_back(it.second);
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUse > b.lastUse; });
+    uint64_t targetSize = std::min(m_maxSize / 2, m_maxSize - requiredSize);
+
+    std::string compactPath = m_path + ".compact";
+    intptr_t compactFile;
+    if (!openFile(compactPath, true, compactFile))
+        return SLANG_FAIL;
+    // Hold the lock of the new pack file, so it is not written to before the append that triggered
+    // the compaction has finished.
+    if (!lockFile(compactFile))
+    {
+        closeFile(compactFile);
+        removeFile(compactPath);
+        return SLANG_FAIL;
+    }
+
+    bool succeeded = true;
+    uint64_t offset = sizeof(PackHeader);
+    for (const Entry& entry : entries)
+    {
+        uint64_t size = getRecordSize(entry.keySize, entry.dataSize);
+        if (offset + size > targetSize)
+            continue;
+        const uint8_t* record = m_mapping->data + entry.offset;
+        RecordHeader header;
+        memcpy(&header, record, sizeof(header));
+        // Don't carry damaged records over.
+        if (!entry.verified && computeChecksum(
+                                   record + sizeof(RecordHeader),
+                                   entry.keySize,
+                                   record + getRecordDataOffset(entry.keySize),
+                                   size_t(entry.dataSize)
+                               ) != header.checksum)
+            continue;
+        header.lastUse = entry.lastUse;
+        if (!writeFile(compactFile, offset, &header, sizeof(header)) ||
+            !writeFile(compactFile, offset + sizeof(header), record + sizeof(header), size_t(size - sizeof(header))))
+        {
+            succeeded = false;
+            break;
+        }
+        offset += size;
+    }
+
+    PackHeader header = {};
+    memcpy(header.magic, kPackMagic, 8);
+    header.version = kPackVersion;
+    header.headerSize = sizeof(PackHeader);
+    header.committedEnd = offset;
+    header.useClock = m_useClock;
+    succeeded = succeeded && writeFile(compactFile, 0, &header, sizeof(header)) && syncFile(compactFile);
+
+    // Windows can't replace a file that is mapped, so drop our mapping first.
+    // Blobs returned earlier keep their mapping alive.
+    m_mapping = nullptr;
+    if (!succeeded || !replaceFile(compactPath, m_path))
+    {
+        unlockFile(compactFile);
+        closeFile(compactFile);
+        removeFile(compactPath);
+        Result result = remap();
+        if (SLANG_FAILED(result))
+            closePack();
+        return SLANG_FAIL;
+    }
+
+    // Closing the old pack file releases its lock, other processes waiting for it will notice
+    // the replacement and wait for the lock of the new file instead.
+    closePack();
+    m_file = compactFile;
+    if (!getFileId(m_file, m_fileId))
+    {
+        closePack();
+        return SLANG_FAIL;
+    }
+    return mapPack();
+}
+
+void PersistentShaderCache::flushLastUse()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file == -1 || !lockFile(m_file))
+        return;
+    if (!isPackReplaced())
+    {
+        for (auto& it : m_entries)
+        {
+            Entry& entry = it.second;
+            if (!entry.lastUseDirty)
+                continue;
+            writeFile(m_file, entry.offset + offsetof(RecordHeader, lastUse), &entry.lastUse, sizeof(entry.lastUse));
+            entry.lastUseDirty = false;
+        }
+        uint64_t useClock = std::max(m_useClock, reinterpret_cast<const PackHeader*>(m_mapping->data)->useClock);
+        writeFile(m_file, offsetof(PackHeader, useClock), &useClock, sizeof(useClock));
+    }
+    unlockFile(m_file);
+}
+
+Result createPersistentShaderCache(const PersistentShaderCacheDesc& desc, IPersistentShaderCache** outCache)
+{
+    RefPtr<PersistentShaderCache> cache = new PersistentShaderCache();
+    SLANG_RETURN_ON_FAIL(cache->init(desc));
+    returnComPtr(outCache, cache);
+    return SLANG_OK;
+}
+
+} // namespace rhi
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <slang-rhi.h>
+
+#include "core/com-object.h"
+#include "core/smart-pointer.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace rhi {
+
+/// Read-only memory mapping of a pack file.
+/// Blobs returned by the cache hold a reference, so the mapping outlives remapping and file replacement.
+class PackFileMapping : public RefObject
+{
+public:
+    ~PackFileMapping();
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+/// Persistent shader cache stored in a single pack file.
+///
+/// The pack file starts with a header, followed by records that each hold a key and its data.
+/// Records are only ever appended and never change once committed, so the file is memory-mapped
+/// and `queryCache` returns blobs pointing straight into the mapping.
+///
+/// Appends are crash-safe: a record is written and flushed past the committed end of the file
+/// first, then the committed end stored in the header is advanced. Records past the committed end
+/// are ignored, and each record has a checksum that is verified when it is first read.
+///
+/// Multiple processes can share a pack file. Appends are serialized through an exclusive file lock,
+/// and records appended by other processes are picked up on the next miss.
+///
+/// When an append would grow the file beyond the size cap, the most recently used records are
+/// copied to a new pack file that atomically replaces the old one. Processes still using the old
+/// file notice the replacement and reopen the pack file. Windows can't replace a file that is still
+/// mapped, by another process or by a blob returned earlier. If the replacement fails, records are
+/// appended past the size cap and compaction is retried once the file has grown by a quarter of the cap.
+class PersistentShaderCache : public IPersistentShaderCache, public ComObject
+{
+public:
+    SLANG_COM_OBJECT_IUNKNOWN_ALL
+    IPersistentShaderCache* getInterface(const Guid& guid);
+
+    ~PersistentShaderCache();
+
+    Result init(const PersistentShaderCacheDesc& desc);
+
+    // IPersistentShaderCache implementation
+    virtual SLANG_NO_THROW Result SLANG_MCALL writeCache(ISlangBlob* key, ISlangBlob* data) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL queryCache(ISlangBlob* key, ISlangBlob** outData) override;
+
+    /// Identifies a file independently of its path.
+    struct FileId
+    {
+        uint64_t volume = 0;
+        uint64_t index = 0;
+        bool operator!=(const FileId& other) const { return volume != other.volume || index != other.index; }
+    };
+
+private:
+    struct Entry
+    {
+        // Offset of the record in the pack file.
+        uint64_t offset;
+        uint32_t keySize;
+        uint64_t dataSize;
+        uint64_t lastUse;
+        // Set once the checksum was verified.
+        bool verified;
+        // Set if `lastUse` changed since the record was read.
+        bool lastUseDirty;
+    };
+
+    Result openPack();
+    // Map the pack file and index its records. Closes the pack file on failure.
+    Result mapPack();
+    void closePack();
+    bool isPackReplaced();
+    Result reopenIfReplaced();
+    Result remap();
+    // Index records committed since the last call.
+    Result refresh();
+    uint64_t getCommittedEnd();
+    Entry* findEntry(uint64_t keyHash, const void* key, size_t keySize);
+    // Replace the pack file with one holding the most recently used records.
+    // Leaves at least `requiredSize` bytes below the size cap. The file lock must be held.
+    Result compact(uint64_t requiredSize);
+    // Write back the last use times of records used by this process.
+    void flushLastUse();
+
+    std::string m_path;
+    uint64_t m_maxSize = 0;
+
+    std::mutex m_mutex;
+    // File descriptor or handle of the pack file, -1 if not open.
+    intptr_t m_file = -1;
+    FileId m_fileId;
+    RefPtr<PackFileMapping> m_mapping;
+    // Records before this offset are indexed.
+    uint64_t m_scannedEnd = 0;
+    // Compaction is not retried before the committed end reaches this offset, after it failed to replace the pack.
+    uint64_t m_compactRetryEnd = 0;
+    // Clock used to order records by their last use.
+    uint64_t m_useClock = 0;
+    // Index of the records, keyed by key hash. A newer record replaces an older one with the same key hash.
+    std::unordered_map<uint64_t, Entry> m_entries;
+};
+
+Result createPersistentShaderCache(const PersistentShaderCacheDesc& desc, IPersistentShaderCache** outCache);
+
+} // namespace rhi
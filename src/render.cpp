@@ -1,6 +1,7 @@
 #include <slang-rhi.h>
 
 #include "debug-layer/debug-device.h"
+#include "persistent-shader-cache.h"
 #include "renderer-shared.h"
 #if SLANG_RHI_ENABLE_CUDA
 #include "cuda/cuda-api.h"
@@ -353,6 +354,12 @@ extern "C"
         return resultCode;
     }
 
+    SLANG_RHI_API Result SLANG_MCALL
+    rhiCreatePersistentShaderCache(const PersistentShaderCacheDesc* desc, IPersistentShaderCache** outCache)
+    {
+        return createPersistentShaderCache(*desc, outCache);
+    }
+
     SLANG_RHI_API Result SLANG_MCALL rhiReportLiveObjects()
     {
 #if SLANG_RHI_ENABLE_D3D12
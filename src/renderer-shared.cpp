@@ -6,6 +6,9 @@
 #include <slang.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -39,6 +42,7 @@ const Guid GUID::IID_IRayTracingCommandEncoder = IRayTracingCommandEncoder::getT
 
 const Guid GUID::IID_ICommandBuffer = ICommandBuffer::getTypeGuid();
 const Guid GUID::IID_ICommandBufferD3D12 = ICommandBufferD3D12::getTypeGuid();
+const Guid GUID::IID_ICommandBufferImmediate = ICommandBufferImmediate::getTypeGuid();
 
 const Guid GUID::IID_ICommandQueue = ICommandQueue::getTypeGuid();
 const Guid GUID::IID_IQueryPool = IQueryPool::getTypeGuid();
@@ -281,22 +285,37 @@ Result RendererBase::getEntryPointCodeFromShaderCache(
     // Immediately call getEntryPointCode if shader cache is not available.
     if (!persistentShaderCache)
     {
+        std::lock_guard<std::recursive_mutex> lock(m_slangSessionMutex);
+        ShaderCompilationTimer timer(m_shaderCompilationStats.entryPointCodeGeneration);
         return program->getEntryPointCode(entryPointIndex, targetIndex, outCode, outDiagnostics);
     }
 
     // Hash all relevant state for generating the entry point shader code to use as a key
     // for the shader cache.
     ComPtr<ISlangBlob> hashBlob;
-    program->getEntryPointHash(entryPointIndex, targetIndex, hashBlob.writeRef());
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_slangSessionMutex);
+        program->getEntryPointHash(entryPointIndex, targetIndex, hashBlob.writeRef());
+    }
 
     // Query the shader cache.
     ComPtr<ISlangBlob> codeBlob;
-    if (persistentShaderCache->queryCache(hashBlob, codeBlob.writeRef()) != SLANG_OK)
+    auto queryStartTime = std::chrono::steady_clock::now();
+    bool hit = persistentShaderCache->queryCache(hashBlob, codeBlob.writeRef()) == SLANG_OK;
+    auto queryTime = std::chrono::steady_clock::now() - queryStartTime;
+    (hit ? m_shaderCompilationStats.persistentCacheHits : m_shaderCompilationStats.persistentCacheMisses)
+        .record(std::chrono::duration_cast<std::chrono::nanoseconds>(queryTime).count());
+    if (!hit)
     {
         // No cached entry found. Generate the code and add it to the cache.
-        SLANG_RETURN_ON_FAIL(
-            program->getEntryPointCode(entryPointIndex, targetIndex, codeBlob.writeRef(), outDiagnostics)
-        );
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_slangSessionMutex);
+            ShaderCompilationTimer timer(m_shaderCompilationStats.entryPointCodeGeneration);
+            SLANG_RETURN_ON_FAIL(
+                program->getEntryPointCode(entryPointIndex, targetIndex, codeBlob.writeRef(), outDiagnostics)
+            );
+        }
+        ShaderCompilationTimer timer(m_shaderCompilationStats.persistentCacheWrites);
         persistentShaderCache->writeCache(hashBlob, codeBlob);
     }
 
@@ -315,9 +334,34 @@ IDevice* RendererBase::getInterface(const Guid& guid)
     return (guid == GUID::IID_ISlangUnknown || guid == GUID::IID_IDevice) ? static_cast<IDevice*>(this) : nullptr;
 }
 
+RendererBase::~RendererBase()
+{
+    // Pending specializations hold a reference to the device, so the queue is empty unless
+    // the last reference was released by the specialization thread itself.
+    if (m_specializationQueue)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_specializationQueue->mutex);
+            m_specializationQueue->stop = true;
+        }
+        m_specializationQueue->workAvailable.notify_all();
+        if (std::this_thread::get_id() == m_specializationThread.get_id())
+            m_specializationThread.detach();
+        else
+            m_specializationThread.join();
+    }
+}
+
 SLANG_NO_THROW Result SLANG_MCALL RendererBase::initialize(const Desc& desc)
 {
     persistentShaderCache = desc.persistentShaderCache;
+    m_stagingBufferAllocator.init(this);
+
+    if (desc.asyncPipelineSpecialization)
+    {
+        m_specializationQueue = std::make_shared<SpecializationQueue>();
+        m_specializationThread = std::thread(specializationThreadMain, m_specializationQueue);
+    }
 
     if (desc.apiCommandDispatcher)
     {
@@ -571,6 +615,199 @@ Result RendererBase::getTextureRowAlignment(Size* outAlignment)
     return SLANG_E_NOT_AVAILABLE;
 }
 
+Result RendererBase::getMemoryStats(DeviceMemoryStats* outStats)
+{
+    *outStats = {};
+    return SLANG_E_NOT_AVAILABLE;
+}
+
+void ShaderCompilationStatCounter::record(uint64_t time)
+{
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_totalTime.fetch_add(time, std::memory_order_relaxed);
+    uint64_t maxTime = m_maxTime.load(std::memory_order_relaxed);
+    while (time > maxTime && !m_maxTime.compare_exchange_weak(maxTime, time, std::memory_order_relaxed))
+    {
+    }
+}
+
+ShaderCompilationStat ShaderCompilationStatCounter::get() const
+{
+    ShaderCompilationStat stat;
+    stat.count = m_count.load(std::memory_order_relaxed);
+    stat.totalTime = m_totalTime.load(std::memory_order_relaxed);
+    stat.maxTime = m_maxTime.load(std::memory_order_relaxed);
+    return stat;
+}
+
+void ShaderCompilationStatCounter::reset()
+{
+    m_count.store(0, std::memory_order_relaxed);
+    m_totalTime.store(0, std::memory_order_relaxed);
+    m_maxTime.store(0, std::memory_order_relaxed);
+}
+
+Result RendererBase::getShaderCompilationStats(ShaderCompilationStats* outStats)
+{
+    auto& stats = m_shaderCompilationStats;
+    outStats->programLinking = stats.programLinking.get();
+    outStats->entryPointCodeGeneration = stats.entryPointCodeGeneration.get();
+    outStats->persistentCacheHits = stats.persistentCacheHits.get();
+    outStats->persistentCacheMisses = stats.persistentCacheMisses.get();
+    outStats->persistentCacheWrites = stats.persistentCacheWrites.get();
+    outStats->pipelineSpecialization = stats.pipelineSpecialization.get();
+    outStats->pipelineCreation = stats.pipelineCreation.get();
+    outStats->specializedPipelineCacheHitCount = stats.specializedPipelineCacheHitCount.load();
+    outStats->specializedPipelineCacheMissCount = stats.specializedPipelineCacheMissCount.load();
+    return SLANG_OK;
+}
+
+Result RendererBase::resetShaderCompilationStats()
+{
+    auto& stats = m_shaderCompilationStats;
+    stats.programLinking.reset();
+    stats.entryPointCodeGeneration.reset();
+    stats.persistentCacheHits.reset();
+    stats.persistentCacheMisses.reset();
+    stats.persistentCacheWrites.reset();
+    stats.pipelineSpecialization.reset();
+    stats.pipelineCreation.reset();
+    stats.specializedPipelineCacheHitCount.store(0, std::memory_order_relaxed);
+    stats.specializedPipelineCacheMissCount.store(0, std::memory_order_relaxed);
+    return SLANG_OK;
+}
+
+size_t StagingBufferAllocator::getBlockSize(size_t size)
+{
+    size_t blockSize = kMinBlockSize;
+    while (blockSize < size)
+        blockSize *= 2;
+    return blockSize;
+}
+
+int StagingBufferAllocator::getSizeClass(size_t blockSize)
+{
+    int sizeClass = 0;
+    while ((size_t(1) << sizeClass) < blockSize)
+        sizeClass++;
+    return sizeClass;
+}
+
+Result StagingBufferAllocator::acquire(StagingBufferKind kind, size_t size, RefPtr<Buffer>& outBuffer)
+{
+    size_t blockSize = getBlockSize(size);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& freeBuffers = m_freeBuffers[int(kind)][getSizeClass(blockSize)];
+        if (!freeBuffers.empty())
+        {
+            outBuffer = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+            m_stats.bytesPooled -= blockSize;
+            m_stats.bytesInUse += blockSize;
+            m_stats.bytesInUsePeak = std::max(m_stats.bytesInUsePeak, m_stats.bytesInUse);
+            m_stats.bufferReuseCount++;
+            return SLANG_OK;
+        }
+    }
+
+    // Create the buffer outside of the lock, so other heaps can reuse pooled buffers in the meantime.
+    BufferDesc bufferDesc;
+    bufferDesc.size = blockSize;
+    bufferDesc.defaultState = ResourceState::General;
+    switch (kind)
+    {
+    case StagingBufferKind::Constant:
+        bufferDesc.memoryType = MemoryType::Upload;
+        bufferDesc.allowedStates =
+            ResourceStateSet(ResourceState::ConstantBuffer, ResourceState::CopySource, ResourceState::CopyDestination);
+        break;
+    case StagingBufferKind::Upload:
+        bufferDesc.memoryType = MemoryType::Upload;
+        bufferDesc.allowedStates = ResourceStateSet(ResourceState::CopySource, ResourceState::CopyDestination);
+        break;
+    default:
+        bufferDesc.memoryType = MemoryType::ReadBack;
+        bufferDesc.allowedStates = ResourceStateSet(ResourceState::CopySource, ResourceState::CopyDestination);
+        break;
+    }
+    ComPtr<IBuffer> buffer;
+    SLANG_RETURN_ON_FAIL(m_device->createBuffer(bufferDesc, nullptr, buffer.writeRef()));
+    outBuffer = static_cast<Buffer*>(buffer.get());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytesInUse += blockSize;
+    m_stats.bytesInUsePeak = std::max(m_stats.bytesInUsePeak, m_stats.bytesInUse);
+    m_stats.bufferCreationCount++;
+    return SLANG_OK;
+}
+
+void StagingBufferAllocator::release(StagingBufferKind kind, RefPtr<Buffer>& buffer)
+{
+    // Buffers that don't fit into the pool are destroyed after the lock is released.
+    RefPtr<Buffer> destroyedBuffer = std::move(buffer);
+    size_t blockSize = destroyedBuffer->getDesc()->size;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytesInUse -= blockSize;
+    if (m_stats.bytesPooled + blockSize <= kMaxPooledBytes)
+    {
+        m_freeBuffers[int(kind)][getSizeClass(blockSize)].push_back(std::move(destroyedBuffer));
+        m_stats.bytesPooled += blockSize;
+    }
+}
+
+void StagingBufferAllocator::addHeap()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_heapCount++;
+}
+
+void StagingBufferAllocator::removeHeap()
+{
+    std::vector<RefPtr<Buffer>> destroyedBuffers;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_heapCount > 0)
+        return;
+    for (auto& freeBuffersOfKind : m_freeBuffers)
+    {
+        for (auto& freeBuffers : freeBuffersOfKind)
+        {
+            for (auto& buffer : freeBuffers)
+                destroyedBuffers.push_back(std::move(buffer));
+            freeBuffers.clear();
+        }
+    }
+    m_stats.bytesPooled = 0;
+}
+
+void StagingBufferAllocator::recordHeapUsage(uint64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytesPerResetPeak = std::max(m_stats.bytesPerResetPeak, bytes);
+}
+
+void StagingBufferAllocator::getStats(StagingMemoryStats* outStats)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    *outStats = m_stats;
+}
+
+Result RendererBase::getStagingMemoryStats(StagingMemoryStats* outStats)
+{
+    m_stagingBufferAllocator.getStats(outStats);
+    return SLANG_OK;
+}
+
+Result RendererBase::getDescriptorPoolStats(DescriptorPoolStats* outStats)
+{
+    return SLANG_E_NOT_AVAILABLE;
+}
+
+Result RendererBase::savePipelineCache()
+{
+    return SLANG_E_NOT_AVAILABLE;
+}
+
 Result RendererBase::getShaderObjectLayout(
     slang::ISession* session,
     slang::TypeReflection* type,
@@ -578,6 +815,7 @@ Result RendererBase::getShaderObjectLayout(
     ShaderObjectLayoutBase** outLayout
 )
 {
+    std::lock_guard<std::recursive_mutex> lock(m_slangSessionMutex);
     switch (container)
     {
     case ShaderObjectContainerType::StructuredBuffer:
@@ -603,21 +841,27 @@ Result RendererBase::getShaderObjectLayout(
 )
 {
     RefPtr<ShaderObjectLayoutBase> shaderObjectLayout;
-    auto it = m_shaderObjectLayoutCache.find(typeLayout);
-    if (it != m_shaderObjectLayoutCache.end())
-    {
-        shaderObjectLayout = it->second;
-    }
-    else
+    if (!m_shaderObjectLayoutCache.tryGet(typeLayout, shaderObjectLayout))
     {
+        // The layout is created without holding a lock of the cache because creating it recursively looks up
+        // the layouts of sub-objects. If several threads create the same layout, the first one is kept.
+        std::lock_guard<std::recursive_mutex> lock(m_slangSessionMutex);
         SLANG_RETURN_ON_FAIL(createShaderObjectLayout(session, typeLayout, shaderObjectLayout.writeRef()));
-        m_shaderObjectLayoutCache.emplace(typeLayout, shaderObjectLayout);
+        shaderObjectLayout = m_shaderObjectLayoutCache.insertOrGet(typeLayout, shaderObjectLayout);
     }
     *outLayout = shaderObjectLayout.detach();
     return SLANG_OK;
 }
 
 ShaderComponentID ShaderCache::getComponentId(slang::TypeReflection* type)
+{
+    ShaderComponentID id;
+    if (typeComponentIds.tryGet(type, id))
+        return id;
+    return typeComponentIds.insertOrGet(type, getComponentIdFromName(type));
+}
+
+ShaderComponentID ShaderCache::getComponentIdFromName(slang::TypeReflection* type)
 {
     ComponentKey key;
     key.typeName = string::from_cstr(type->getName());
@@ -668,17 +912,42 @@ ShaderComponentID ShaderCache::getComponentId(std::string_view name)
 
 ShaderComponentID ShaderCache::getComponentId(ComponentKey key)
 {
-    auto it = componentIds.find(key);
-    if (it != componentIds.end())
-        return it->second;
-    ShaderComponentID resultId = static_cast<ShaderComponentID>(componentIds.size());
-    componentIds.emplace(key, resultId);
-    return resultId;
+    return componentIds.getOrCreate(
+        key,
+        [&]()
+        {
+            ShaderComponentID id = nextComponentId++;
+            std::lock_guard<std::mutex> lock(componentNamesMutex);
+            if (componentNames.size() <= id)
+                componentNames.resize(id + 1);
+            componentNames[id] = key.typeName;
+            return id;
+        }
+    );
+}
+
+std::string ShaderCache::getComponentName(ShaderComponentID id)
+{
+    std::lock_guard<std::mutex> lock(componentNamesMutex);
+    return id < componentNames.size() ? componentNames[id] : std::string();
+}
+
+std::vector<PipelineKey> ShaderCache::getSpecializationKeys(PipelineBase* unspecializedPipeline)
+{
+    std::vector<PipelineKey> keys;
+    specializedPipelines.forEach(
+        [&](const PipelineKey& key, const RefPtr<PipelineBase>&)
+        {
+            if (key.pipeline == unspecializedPipeline)
+                keys.push_back(key);
+        }
+    );
+    return keys;
 }
 
-void ShaderCache::addSpecializedPipeline(PipelineKey key, RefPtr<PipelineBase> specializedPipeline)
+RefPtr<PipelineBase> ShaderCache::addSpecializedPipeline(PipelineKey key, RefPtr<PipelineBase> specializedPipeline)
 {
-    specializedPipelines[key] = specializedPipeline;
+    return specializedPipelines.insertOrGet(key, specializedPipeline);
 }
 
 void ShaderObjectLayoutBase::initBase(
@@ -702,28 +971,98 @@ Result ShaderObjectBase::getSpecializedShaderObjectType(ExtendedShaderObjectType
 
 Result ShaderObjectBase::_getSpecializedShaderObjectType(ExtendedShaderObjectType* outType)
 {
-    if (shaderObjectType.slangType)
+    const ExtendedShaderObjectTypeList* specializationArgs;
+    SLANG_RETURN_ON_FAIL(getSpecializationArgs(specializationArgs));
+    if (m_shaderObjectTypeVersion == m_specializationArgsVersion)
+    {
         *outType = shaderObjectType;
-    ExtendedShaderObjectTypeList specializationArgs;
-    SLANG_RETURN_ON_FAIL(collectSpecializationArgs(specializationArgs));
-    if (specializationArgs.getCount() == 0)
+        return SLANG_OK;
+    }
+    if (specializationArgs->getCount() == 0)
     {
         shaderObjectType.componentID = getLayoutBase()->getComponentID();
         shaderObjectType.slangType = getLayoutBase()->getElementTypeLayout()->getType();
     }
     else
     {
+        std::lock_guard<std::recursive_mutex> lock(getRenderer()->m_slangSessionMutex);
         shaderObjectType.slangType = getRenderer()->slangContext.session->specializeType(
             _getElementTypeLayout()->getType(),
-            specializationArgs.components.data(),
-            specializationArgs.getCount()
+            specializationArgs->components.data(),
+            specializationArgs->getCount()
         );
         shaderObjectType.componentID = getRenderer()->shaderCache.getComponentId(shaderObjectType.slangType);
     }
+    m_shaderObjectTypeVersion = m_specializationArgsVersion;
     *outType = shaderObjectType;
     return SLANG_OK;
 }
 
+void ShaderObjectBase::markSpecializationDirty()
+{
+    // Parents are invalidated even if this object is already dirty, because a parent may have
+    // collected its signature without collecting the signature of this object.
+    m_specializationDirty = true;
+    std::lock_guard<std::mutex> lock(m_parents.mutex);
+    for (ShaderObjectBase* parent : m_parents.objects)
+        parent->markSpecializationDirty();
+}
+
+void ShaderObjectBase::addParent(ShaderObjectBase* parent)
+{
+    std::lock_guard<std::mutex> lock(m_parents.mutex);
+    m_parents.objects.push_back(parent);
+}
+
+void ShaderObjectBase::removeParent(ShaderObjectBase* parent)
+{
+    std::lock_guard<std::mutex> lock(m_parents.mutex);
+    auto it = std::find(m_parents.objects.begin(), m_parents.objects.end(), parent);
+    if (it != m_parents.objects.end())
+        m_parents.objects.erase(it);
+}
+
+Result ShaderObjectBase::getSpecializationArgs(const ExtendedShaderObjectTypeList*& outArgs)
+{
+    if (isSpecializationDirty())
+    {
+        // Clear the flag before collecting, so changes made while collecting invalidate the result.
+        m_specializationDirty = false;
+        m_specializationArgs.clear();
+        Result result = collectSpecializationArgs(m_specializationArgs);
+        if (SLANG_FAILED(result))
+        {
+            m_specializationDirty = true;
+            return result;
+        }
+        m_specializationArgsVersion++;
+    }
+    outArgs = &m_specializationArgs;
+    return SLANG_OK;
+}
+
+Result ShaderObjectBase::getSpecializationKey(
+    PipelineBase* pipeline,
+    const PipelineKey*& outKey,
+    const ExtendedShaderObjectTypeList*& outArgs
+)
+{
+    SLANG_RETURN_ON_FAIL(getSpecializationArgs(outArgs));
+    if (m_pipelineKeyVersion != m_specializationArgsVersion || m_pipelineKey.pipeline != pipeline)
+    {
+        m_pipelineKey.pipeline = pipeline;
+        m_pipelineKey.specializationArgs.clear();
+        for (const auto& componentID : outArgs->componentIDs)
+        {
+            m_pipelineKey.specializationArgs.push_back(componentID);
+        }
+        m_pipelineKey.updateHash();
+        m_pipelineKeyVersion = m_specializationArgsVersion;
+    }
+    outKey = &m_pipelineKey;
+    return SLANG_OK;
+}
+
 Result ShaderObjectBase::setExistentialHeader(
     slang::TypeReflection* existentialType,
     slang::TypeReflection* concreteType,
@@ -751,11 +1090,14 @@ Result ShaderObjectBase::setExistentialHeader(
     // fact and error out.
     //
     uint32_t conformanceID = 0xFFFFFFFF;
-    SLANG_RETURN_ON_FAIL(getLayoutBase()->m_slangSession->getTypeConformanceWitnessSequentialID(
-        concreteType,
-        existentialType,
-        &conformanceID
-    ));
+    {
+        std::lock_guard<std::recursive_mutex> lock(getRenderer()->m_slangSessionMutex);
+        SLANG_RETURN_ON_FAIL(getLayoutBase()->m_slangSession->getTypeConformanceWitnessSequentialID(
+            concreteType,
+            existentialType,
+            &conformanceID
+        ));
+    }
     //
     // Once we have the conformance ID, then we can write it into the object
     // at the required offset.
@@ -808,7 +1150,7 @@ ResourceViewBase* SimpleShaderObjectData::getResourceView(
     }
 }
 
-void ShaderProgramBase::init(const ShaderProgramDesc& inDesc)
+void ShaderProgramBase::init(RendererBase* device, const ShaderProgramDesc& inDesc)
 {
     desc = inDesc;
 
@@ -818,6 +1160,8 @@ void ShaderProgramBase::init(const ShaderProgramDesc& inDesc)
         slangEntryPoints.push_back(ComPtr<slang::IComponentType>(desc.slangEntryPoints[i]));
     }
 
+    std::lock_guard<std::recursive_mutex> lock(device->m_slangSessionMutex);
+    ShaderCompilationTimer timer(device->m_shaderCompilationStats.programLinking);
     auto session = desc.slangGlobalScope ? desc.slangGlobalScope->getSession() : nullptr;
     if (desc.linkingStyle == LinkingStyle::SingleProgram)
     {
@@ -854,6 +1198,13 @@ void ShaderProgramBase::init(const ShaderProgramDesc& inDesc)
         }
         linkedProgram = desc.slangGlobalScope;
     }
+
+    // Layouts are computed on first use. Compute them while the session is locked, so reflecting the program
+    // later only reads them.
+    if (linkedProgram)
+        linkedProgram->getLayout();
+    for (auto& entryPoint : linkedEntryPoints)
+        entryPoint->getLayout();
 }
 
 Result ShaderProgramBase::compileShaders(RendererBase* device)
@@ -943,103 +1294,347 @@ Result RendererBase::maybeSpecializePipeline(
 {
     outNewPipeline = static_cast<PipelineBase*>(currentPipeline);
 
-    auto pipelineType = currentPipeline->desc.type;
     if (currentPipeline->unspecializedPipeline)
         currentPipeline = currentPipeline->unspecializedPipeline;
     // If the currently bound pipeline is specializable, we need to specialize it based on bound shader objects.
     if (currentPipeline->isSpecializable)
     {
-        specializationArgs.clear();
-        SLANG_RETURN_ON_FAIL(rootObject->collectSpecializationArgs(specializationArgs));
-
-        // Construct a shader cache key that represents the specialized shader kernels.
-        PipelineKey pipelineKey;
-        pipelineKey.pipeline = currentPipeline;
-        for (const auto& componentID : specializationArgs.componentIDs)
-        {
-            pipelineKey.specializationArgs.push_back(componentID);
-        }
-        pipelineKey.updateHash();
+        // Get the shader cache key that represents the specialized shader kernels.
+        // The root object caches it, so this is cheap unless a binding affecting specialization changed.
+        const PipelineKey* cachedPipelineKey;
+        const ExtendedShaderObjectTypeList* cachedSpecializationArgs;
+        SLANG_RETURN_ON_FAIL(
+            rootObject->getSpecializationKey(currentPipeline, cachedPipelineKey, cachedSpecializationArgs)
+        );
+        const PipelineKey& pipelineKey = *cachedPipelineKey;
+        const ExtendedShaderObjectTypeList& specializationArgs = *cachedSpecializationArgs;
 
         RefPtr<PipelineBase> specializedPipeline = shaderCache.getSpecializedPipeline(pipelineKey);
         // Try to find specialized pipeline from shader cache.
-        if (!specializedPipeline)
+        if (specializedPipeline)
         {
-            auto unspecializedProgram = static_cast<ShaderProgramBase*>(
-                pipelineType == PipelineType::Compute ? currentPipeline->desc.compute.program
-                                                      : currentPipeline->desc.graphics.program
-            );
-            auto unspecializedProgramLayout = unspecializedProgram->linkedProgram->getLayout();
-
-            ComPtr<slang::IComponentType> specializedComponentType;
-            ComPtr<slang::IBlob> diagnosticBlob;
-            auto compileRs = unspecializedProgram->linkedProgram->specialize(
-                specializationArgs.components.data(),
-                specializationArgs.getCount(),
-                specializedComponentType.writeRef(),
-                diagnosticBlob.writeRef()
+            m_shaderCompilationStats.specializedPipelineCacheHitCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (m_specializationQueue)
+        {
+            // Dispatches are retried while the specialization is pending, count the miss only once per key.
+            bool queued = false;
+            Result result = queuePipelineSpecialization(
+                currentPipeline,
+                pipelineKey,
+                specializationArgs,
+                specializedPipeline,
+                queued
             );
-            if (diagnosticBlob)
-            {
-                getDebugCallback()->handleMessage(
-                    compileRs == SLANG_OK ? DebugMessageType::Warning : DebugMessageType::Error,
-                    DebugMessageSource::Slang,
-                    (char*)diagnosticBlob->getBufferPointer()
-                );
-            }
-            SLANG_RETURN_ON_FAIL(compileRs);
+            if (queued)
+                m_shaderCompilationStats.specializedPipelineCacheMissCount.fetch_add(1, std::memory_order_relaxed);
+            SLANG_RETURN_ON_FAIL(result);
+        }
+        else
+        {
+            m_shaderCompilationStats.specializedPipelineCacheMissCount.fetch_add(1, std::memory_order_relaxed);
+            SLANG_RETURN_ON_FAIL(specializePipeline(currentPipeline, specializationArgs, specializedPipeline));
+            specializedPipeline = shaderCache.addSpecializedPipeline(pipelineKey, specializedPipeline);
+        }
+        auto specializedPipelineBase = static_cast<PipelineBase*>(specializedPipeline.Ptr());
+        outNewPipeline = specializedPipelineBase;
+    }
+    return SLANG_OK;
+}
 
-            // Now create the specialized shader program using compiled binaries.
-            ComPtr<IShaderProgram> specializedProgram;
-            ShaderProgramDesc specializedProgramDesc = unspecializedProgram->desc;
-            specializedProgramDesc.slangGlobalScope = specializedComponentType;
+Result RendererBase::specializePipeline(
+    PipelineBase* unspecializedPipeline,
+    const ExtendedShaderObjectTypeList& specializationArgs,
+    RefPtr<PipelineBase>& outPipeline
+)
+{
+    ShaderCompilationTimer timer(m_shaderCompilationStats.pipelineSpecialization);
+    auto pipelineType = unspecializedPipeline->desc.type;
+    auto unspecializedProgram = static_cast<ShaderProgramBase*>(
+        pipelineType == PipelineType::Compute ? unspecializedPipeline->desc.compute.program
+                                              : unspecializedPipeline->desc.graphics.program
+    );
 
-            if (specializedProgramDesc.linkingStyle == LinkingStyle::SingleProgram)
-            {
-                // When linking style is GraphicsCompute, the specialized global scope already contains
-                // entry-points, so we do not need to supply them again when creating the specialized
-                // pipeline.
-                specializedProgramDesc.slangEntryPointCount = 0;
-            }
-            SLANG_RETURN_ON_FAIL(createShaderProgram(specializedProgramDesc, specializedProgram.writeRef()));
+    ComPtr<slang::IComponentType> specializedComponentType;
+    ComPtr<slang::IBlob> diagnosticBlob;
+    Result compileRs;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_slangSessionMutex);
+        compileRs = unspecializedProgram->linkedProgram->specialize(
+            specializationArgs.components.data(),
+            specializationArgs.getCount(),
+            specializedComponentType.writeRef(),
+            diagnosticBlob.writeRef()
+        );
+    }
+    if (diagnosticBlob)
+    {
+        getDebugCallback()->handleMessage(
+            compileRs == SLANG_OK ? DebugMessageType::Warning : DebugMessageType::Error,
+            DebugMessageSource::Slang,
+            (char*)diagnosticBlob->getBufferPointer()
+        );
+    }
+    SLANG_RETURN_ON_FAIL(compileRs);
 
-            // Create specialized pipeline state.
-            ComPtr<IPipeline> specializedPipelineComPtr;
-            switch (pipelineType)
-            {
-            case PipelineType::Compute:
-            {
-                auto pipelineDesc = currentPipeline->desc.compute;
-                pipelineDesc.program = specializedProgram;
-                SLANG_RETURN_ON_FAIL(createComputePipeline(pipelineDesc, specializedPipelineComPtr.writeRef()));
-                break;
-            }
-            case PipelineType::Graphics:
+    // Now create the specialized shader program using compiled binaries.
+    ComPtr<IShaderProgram> specializedProgram;
+    ShaderProgramDesc specializedProgramDesc = unspecializedProgram->desc;
+    specializedProgramDesc.slangGlobalScope = specializedComponentType;
+
+    if (specializedProgramDesc.linkingStyle == LinkingStyle::SingleProgram)
+    {
+        // When linking style is GraphicsCompute, the specialized global scope already contains
+        // entry-points, so we do not need to supply them again when creating the specialized
+        // pipeline.
+        specializedProgramDesc.slangEntryPointCount = 0;
+    }
+    SLANG_RETURN_ON_FAIL(createShaderProgram(specializedProgramDesc, specializedProgram.writeRef()));
+
+    // Create specialized pipeline state.
+    ComPtr<IPipeline> specializedPipelineComPtr;
+    switch (pipelineType)
+    {
+    case PipelineType::Compute:
+    {
+        auto pipelineDesc = unspecializedPipeline->desc.compute;
+        pipelineDesc.program = specializedProgram;
+        SLANG_RETURN_ON_FAIL(createComputePipeline(pipelineDesc, specializedPipelineComPtr.writeRef()));
+        break;
+    }
+    case PipelineType::Graphics:
+    {
+        auto pipelineDesc = unspecializedPipeline->desc.graphics;
+        pipelineDesc.program = static_cast<ShaderProgramBase*>(specializedProgram.get());
+        SLANG_RETURN_ON_FAIL(createRenderPipeline(pipelineDesc, specializedPipelineComPtr.writeRef()));
+        break;
+    }
+    case PipelineType::RayTracing:
+    {
+        auto pipelineDesc = unspecializedPipeline->desc.rayTracing;
+        pipelineDesc.program = static_cast<ShaderProgramBase*>(specializedProgram.get());
+        SLANG_RETURN_ON_FAIL(createRayTracingPipeline(pipelineDesc.get(), specializedPipelineComPtr.writeRef()));
+        break;
+    }
+    default:
+        break;
+    }
+    outPipeline = static_cast<PipelineBase*>(specializedPipelineComPtr.get());
+    outPipeline->unspecializedPipeline = unspecializedPipeline;
+    return SLANG_OK;
+}
+
+// Manifests are text files. The header line is followed by one block per specialization:
+// a line with the number of specialization arguments and one line per argument with its type name.
+static const char* kSpecializationManifestHeader = "slang-rhi-specializations 1";
+
+Result RendererBase::exportPipelineSpecializations(IPipeline* pipeline, ISlangBlob** outManifest)
+{
+    auto pipelineBase = static_cast<PipelineBase*>(pipeline);
+    if (pipelineBase->unspecializedPipeline)
+        pipelineBase = pipelineBase->unspecializedPipeline;
+
+    std::string manifest = kSpecializationManifestHeader;
+    manifest += '\n';
+    for (const PipelineKey& key : shaderCache.getSpecializationKeys(pipelineBase))
+    {
+        manifest += std::to_string(key.specializationArgs.size());
+        manifest += '\n';
+        for (ShaderComponentID componentID : key.specializationArgs)
+        {
+            manifest += shaderCache.getComponentName(componentID);
+            manifest += '\n';
+        }
+    }
+    auto blob = OwnedBlob::create(manifest.data(), manifest.size());
+    returnComPtr(outManifest, blob);
+    return SLANG_OK;
+}
+
+Result RendererBase::prewarmPipelineSpecializations(IPipeline* pipeline, const void* manifest, Size manifestSize)
+{
+    auto pipelineBase = static_cast<PipelineBase*>(pipeline);
+    if (pipelineBase->unspecializedPipeline)
+        pipelineBase = pipelineBase->unspecializedPipeline;
+    if (!pipelineBase->isSpecializable)
+        return SLANG_OK;
+    auto programLayout = pipelineBase->desc.getProgram()->linkedProgram->getLayout();
+
+    std::istringstream stream(std::string((const char*)manifest, manifestSize));
+    std::string line;
+    if (!std::getline(stream, line) || line != kSpecializationManifestHeader)
+        return SLANG_E_INVALID_ARG;
+
+    // Resolve all type names before queueing any specialization, because queued specializations
+    // use the Slang session on the background thread.
+    struct Specialization
+    {
+        PipelineKey key;
+        ExtendedShaderObjectTypeList args;
+    };
+    std::vector<Specialization> specializations;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_slangSessionMutex);
+        while (std::getline(stream, line))
+        {
+            if (line.empty())
+                continue;
+            uint32_t argCount = 0;
+            if (sscanf(line.c_str(), "%u", &argCount) != 1)
+                return SLANG_E_INVALID_ARG;
+
+            // Resolve the type names and compute the key the same way binding shader objects does.
+            ExtendedShaderObjectTypeList specializationArgs;
+            bool typesFound = true;
+            for (uint32_t i = 0; i < argCount; i++)
             {
-                auto pipelineDesc = currentPipeline->desc.graphics;
-                pipelineDesc.program = static_cast<ShaderProgramBase*>(specializedProgram.get());
-                SLANG_RETURN_ON_FAIL(createRenderPipeline(pipelineDesc, specializedPipelineComPtr.writeRef()));
-                break;
+                if (!std::getline(stream, line))
+                    return SLANG_E_INVALID_ARG;
+                slang::TypeReflection* type = programLayout->findTypeByName(line.c_str());
+                if (!type)
+                {
+                    getDebugCallback()->handleMessage(
+                        DebugMessageType::Warning,
+                        DebugMessageSource::Layer,
+                        ("Skipping specialization with unknown type " + line).c_str()
+                    );
+                    typesFound = false;
+                    continue;
+                }
+                specializationArgs.add({type, shaderCache.getComponentId(type)});
             }
-            case PipelineType::RayTracing:
+            if (!typesFound)
+                continue;
+
+            PipelineKey pipelineKey;
+            pipelineKey.pipeline = pipelineBase;
+            for (const auto& componentID : specializationArgs.componentIDs)
+                pipelineKey.specializationArgs.push_back(componentID);
+            pipelineKey.updateHash();
+            specializations.push_back({std::move(pipelineKey), std::move(specializationArgs)});
+        }
+    }
+
+    for (const Specialization& specialization : specializations)
+    {
+        RefPtr<PipelineBase> specializedPipeline = shaderCache.getSpecializedPipeline(specialization.key);
+        if (specializedPipeline)
+            continue;
+        if (m_specializationQueue)
+        {
+            bool queued = false;
+            Result result = queuePipelineSpecialization(
+                pipelineBase,
+                specialization.key,
+                specialization.args,
+                specializedPipeline,
+                queued
+            );
+            if (result != SLANG_E_PENDING)
+                SLANG_RETURN_ON_FAIL(result);
+        }
+        else
+        {
+            SLANG_RETURN_ON_FAIL(specializePipeline(pipelineBase, specialization.args, specializedPipeline));
+            SLANG_RETURN_ON_FAIL(specializedPipeline->ensureAPIPipelineCreated());
+            shaderCache.addSpecializedPipeline(specialization.key, specializedPipeline);
+        }
+    }
+    return SLANG_OK;
+}
+
+Result RendererBase::queuePipelineSpecialization(
+    PipelineBase* unspecializedPipeline,
+    const PipelineKey& pipelineKey,
+    const ExtendedShaderObjectTypeList& specializationArgs,
+    RefPtr<PipelineBase>& outPipeline,
+    bool& outQueued
+)
+{
+    outQueued = false;
+    auto queue = m_specializationQueue;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (m_pendingSpecializations.count(pipelineKey))
+            return SLANG_E_PENDING;
+        auto failed = m_failedSpecializations.find(pipelineKey);
+        if (failed != m_failedSpecializations.end())
+        {
+            Result result = failed->second;
+            m_failedSpecializations.erase(failed);
+            return result;
+        }
+        // A specialization adds its pipeline to the cache before it is removed from the pending set,
+        // so it may have finished since the caller looked up the cache.
+        outPipeline = shaderCache.getSpecializedPipeline(pipelineKey);
+        if (outPipeline)
+            return SLANG_OK;
+
+        m_pendingSpecializations.insert(pipelineKey);
+        queue->pendingCount++;
+        outQueued = true;
+        RefPtr<RendererBase> device = this;
+        RefPtr<PipelineBase> pipeline = unspecializedPipeline;
+        queue->tasks.push_back(
+            [device, pipeline, pipelineKey, args = specializationArgs]() mutable
             {
-                auto pipelineDesc = currentPipeline->desc.rayTracing;
-                pipelineDesc.program = static_cast<ShaderProgramBase*>(specializedProgram.get());
-                SLANG_RETURN_ON_FAIL(createRayTracingPipeline(pipelineDesc.get(), specializedPipelineComPtr.writeRef())
-                );
-                break;
+                // The API pipeline is created here as well, so the first dispatch that uses it doesn't compile it.
+                RefPtr<PipelineBase> specializedPipeline;
+                Result result = device->specializePipeline(pipeline, args, specializedPipeline);
+                if (SLANG_SUCCEEDED(result))
+                    result = specializedPipeline->ensureAPIPipelineCreated();
+                if (SLANG_SUCCEEDED(result))
+                    device->shaderCache.addSpecializedPipeline(pipelineKey, specializedPipeline);
+
+                std::lock_guard<std::mutex> lock(device->m_specializationQueue->mutex);
+                device->m_pendingSpecializations.erase(pipelineKey);
+                if (SLANG_FAILED(result))
+                    device->m_failedSpecializations[pipelineKey] = result;
             }
-            default:
-                break;
-            }
-            specializedPipeline = static_cast<PipelineBase*>(specializedPipelineComPtr.get());
-            specializedPipeline->unspecializedPipeline = currentPipeline;
-            shaderCache.addSpecializedPipeline(pipelineKey, specializedPipeline);
+        );
+    }
+    queue->workAvailable.notify_one();
+    return SLANG_E_PENDING;
+}
+
+void RendererBase::specializationThreadMain(std::shared_ptr<SpecializationQueue> queue)
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            queue->workAvailable.wait(lock, [&]() { return queue->stop || !queue->tasks.empty(); });
+            if (queue->tasks.empty())
+                return;
+            task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+        }
+        task();
+        // Releasing the task can release the last reference to the device, so only
+        // the shared queue state may be accessed from here on.
+        task = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (--queue->pendingCount == 0)
+                queue->idle.notify_all();
         }
-        auto specializedPipelineBase = static_cast<PipelineBase*>(specializedPipeline.Ptr());
-        outNewPipeline = specializedPipelineBase;
     }
-    return SLANG_OK;
+}
+
+Result RendererBase::waitForPipelineSpecializations(uint64_t timeout)
+{
+    if (!m_specializationQueue)
+        return SLANG_OK;
+    auto queue = m_specializationQueue;
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    auto isIdle = [&]() { return queue->pendingCount == 0; };
+    if (timeout == kTimeoutInfinite)
+    {
+        queue->idle.wait(lock, isIdle);
+        return SLANG_OK;
+    }
+    return queue->idle.wait_for(lock, std::chrono::nanoseconds(timeout), isIdle) ? SLANG_OK : SLANG_E_TIME_OUT;
 }
 
 IDebugCallback*& _getDebugCallback()
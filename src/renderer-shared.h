@@ -7,13 +7,22 @@
 #include "resource-desc-utils.h"
 
 #include "core/common.h"
+#include "core/sharded-map.h"
 #include "core/short_vector.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace rhi {
 
@@ -44,6 +53,7 @@ struct GUID
     static const Guid IID_IRayTracingCommandEncoder;
     static const Guid IID_ICommandBuffer;
     static const Guid IID_ICommandBufferD3D12;
+    static const Guid IID_ICommandBufferImmediate;
     static const Guid IID_ICommandQueue;
     static const Guid IID_IQueryPool;
     static const Guid IID_IAccelerationStructure;
@@ -332,6 +342,34 @@ struct ExtendedShaderObjectTypeList
 struct ExtendedShaderObjectTypeListObject : public ExtendedShaderObjectTypeList, public RefObject
 {};
 
+class PipelineBase;
+
+struct PipelineKey
+{
+    PipelineBase* pipeline;
+    short_vector<ShaderComponentID> specializationArgs;
+    size_t hash;
+    void updateHash()
+    {
+        hash = std::hash<void*>()(pipeline);
+        for (auto& arg : specializationArgs)
+            hash_combine(hash, arg);
+    }
+    bool operator==(const PipelineKey& other) const
+    {
+        if (pipeline != other.pipeline)
+            return false;
+        if (specializationArgs.size() != other.specializationArgs.size())
+            return false;
+        for (Index i = 0; i < other.specializationArgs.size(); i++)
+        {
+            if (specializationArgs[i] != other.specializationArgs[i])
+                return false;
+        }
+        return true;
+    }
+};
+
 class ShaderObjectLayoutBase : public RefObject
 {
 protected:
@@ -429,6 +467,20 @@ bool _doesValueFitInExistentialPayload(
     slang::TypeLayoutReflection* existentialFieldLayout
 );
 
+class ShaderObjectBase;
+
+// Weak references to the shader objects a shader object is bound to as a sub-object.
+// Like the reference count of `ComObject`, the list is not copied when the shader object is copied.
+struct ShaderObjectParentList
+{
+    std::mutex mutex;
+    std::vector<ShaderObjectBase*> objects;
+
+    ShaderObjectParentList() = default;
+    ShaderObjectParentList(const ShaderObjectParentList&) {}
+    ShaderObjectParentList& operator=(const ShaderObjectParentList&) { return *this; }
+};
+
 class ShaderObjectBase : public IShaderObject, public ComObject
 {
 public:
@@ -451,6 +503,32 @@ protected:
     // The specialized shader object type.
     ExtendedShaderObjectType shaderObjectType = {nullptr, kInvalidComponentID};
 
+    // Specialization signature of this object, cached until a binding of this object or one of its
+    // sub-objects that affects specialization changes. The version is incremented whenever the
+    // signature is collected, the specialized type and pipeline key record the version they were
+    // computed from. A version of 0 marks them as invalid.
+    ExtendedShaderObjectTypeList m_specializationArgs;
+    bool m_specializationDirty = true;
+    uint32_t m_specializationArgsVersion = 0;
+    uint32_t m_shaderObjectTypeVersion = 0;
+    // Key of the last pipeline specialized with `m_specializationArgs`.
+    PipelineKey m_pipelineKey = {};
+    uint32_t m_pipelineKeyVersion = 0;
+
+    // Objects this object is bound to. Their specialization depends on the specialization of this object.
+    ShaderObjectParentList m_parents;
+
+    // Called when a binding that affects the specialization args changes.
+    // Invalidates the cached signature of this object and of all objects it is bound to.
+    void markSpecializationDirty();
+    // Drop the cached specialization signature, called when the object is (re)initialized.
+    void resetSpecializationCache()
+    {
+        m_specializationDirty = true;
+        m_shaderObjectTypeVersion = 0;
+        m_pipelineKeyVersion = 0;
+    }
+
     Result _getSpecializedShaderObjectType(ExtendedShaderObjectType* outType);
     slang::TypeLayoutReflection* _getElementTypeLayout() { return m_layout->getElementTypeLayout(); }
 
@@ -466,6 +544,27 @@ public:
 
     virtual Result collectSpecializationArgs(ExtendedShaderObjectTypeList& args) = 0;
 
+    // Get the specialization args of this object, only calling `collectSpecializationArgs` if
+    // a binding of this object or one of its sub-objects changed since the last call.
+    Result getSpecializationArgs(const ExtendedShaderObjectTypeList*& outArgs);
+
+    // Get the key of `pipeline` specialized for this object, and the args to specialize it with.
+    // The key is only rebuilt and rehashed if the specialization args or the pipeline changed.
+    Result getSpecializationKey(
+        PipelineBase* pipeline,
+        const PipelineKey*& outKey,
+        const ExtendedShaderObjectTypeList*& outArgs
+    );
+
+    // Whether the specialization signature must be collected again.
+    // Root objects also check their entry points, which are not tracked as sub-objects.
+    virtual bool isSpecializationDirty() { return m_specializationDirty; }
+
+    // Track that `parent` holds this object as a sub-object, or no longer does.
+    // An object bound to several slots of the same parent is tracked once per slot.
+    void addParent(ShaderObjectBase* parent);
+    void removeParent(ShaderObjectBase* parent);
+
     RendererBase* getRenderer() { return m_layout->getDevice(); }
 
     ShaderObjectLayoutBase* getLayoutBase() { return m_layout; }
@@ -524,7 +623,38 @@ protected:
     // Specialization args for a StructuredBuffer object.
     ExtendedShaderObjectTypeList m_structuredBufferSpecializationArgs;
 
+    // Bind `subObject` to the sub-object slot at `index`, tracking this object as its parent.
+    void setSubObject(Index index, TShaderObjectImpl* subObject)
+    {
+        auto& slot = m_objects[index];
+        if (slot.Ptr() == subObject)
+            return;
+        if (slot)
+            slot->removeParent(this);
+        slot = subObject;
+        if (subObject)
+            subObject->addParent(this);
+        markSpecializationDirty();
+    }
+
+    // Resize the sub-object slots, releasing the objects in removed slots.
+    void resizeSubObjects(Index count)
+    {
+        for (Index i = count; i < (Index)m_objects.size(); i++)
+            setSubObject(i, nullptr);
+        m_objects.resize(count);
+    }
+
 public:
+    ~ShaderObjectBaseImpl()
+    {
+        for (auto& object : m_objects)
+        {
+            if (object)
+                object->removeParent(this);
+        }
+    }
+
     TShaderObjectLayoutImpl* getLayout() { return static_cast<TShaderObjectLayoutImpl*>(m_layout.Ptr()); }
 
     void* getBuffer() { return m_data.getBuffer(); }
@@ -576,11 +706,12 @@ public:
             // writing uniform data to the plain buffer.
             if (offset.bindingArrayIndex >= m_objects.size())
             {
-                m_objects.resize(offset.bindingArrayIndex + 1);
+                resizeSubObjects(offset.bindingArrayIndex + 1);
                 auto stride = layout->getElementTypeLayout()->getStride();
                 m_data.setCount(m_objects.size() * stride);
             }
-            m_objects[offset.bindingArrayIndex] = subObject;
+            setSubObject(offset.bindingArrayIndex, subObject);
+            markSpecializationDirty();
 
             ExtendedShaderObjectTypeList specializationArgs;
 
@@ -630,7 +761,9 @@ public:
         auto bindingRangeIndex = offset.bindingRangeIndex;
         auto bindingRange = layout->getBindingRange(bindingRangeIndex);
 
-        m_objects[bindingRange.subObjectIndex + offset.bindingArrayIndex] = subObject;
+        // Rebinding the same object doesn't change specialization, changes made to the object
+        // itself are propagated to this object when they are made.
+        setSubObject(bindingRange.subObjectIndex + offset.bindingArrayIndex, subObject);
 
         switch (bindingRange.bindingType)
         {
@@ -725,6 +858,7 @@ public:
     setSpecializationArgs(ShaderOffset const& offset, const slang::SpecializationArg* args, GfxCount count) override
     {
         auto layout = getLayout();
+        markSpecializationDirty();
 
         // If the shader object is a container, delegate the processing to
         // `setSpecializationArgsForContainerElements`.
@@ -783,7 +917,7 @@ public:
     // Linked program for each entry point when linkingStyle is RayTracing.
     std::vector<ComPtr<slang::IComponentType>> linkedEntryPoints;
 
-    void init(const ShaderProgramDesc& desc);
+    void init(RendererBase* device, const ShaderProgramDesc& desc);
 
     bool isSpecializable()
     {
@@ -1005,55 +1139,38 @@ struct ComponentKey
     }
 };
 
-struct PipelineKey
-{
-    PipelineBase* pipeline;
-    short_vector<ShaderComponentID> specializationArgs;
-    size_t hash;
-    void updateHash()
-    {
-        hash = std::hash<void*>()(pipeline);
-        for (auto& arg : specializationArgs)
-            hash_combine(hash, arg);
-    }
-    bool operator==(const PipelineKey& other) const
-    {
-        if (pipeline != other.pipeline)
-            return false;
-        if (specializationArgs.size() != other.specializationArgs.size())
-            return false;
-        for (Index i = 0; i < other.specializationArgs.size(); i++)
-        {
-            if (specializationArgs[i] != other.specializationArgs[i])
-                return false;
-        }
-        return true;
-    }
-};
-
 // A cache from specialization keys to a specialized `ShaderKernel`.
+// The cache can be accessed from multiple threads.
 class ShaderCache : public RefObject
 {
 public:
     ShaderComponentID getComponentId(slang::TypeReflection* type);
     ShaderComponentID getComponentId(std::string_view name);
     ShaderComponentID getComponentId(ComponentKey key);
+    // Name of the type a component ID was created for.
+    std::string getComponentName(ShaderComponentID id);
 
     RefPtr<PipelineBase> getSpecializedPipeline(PipelineKey programKey)
     {
-        auto it = specializedPipelines.find(programKey);
-        if (it != specializedPipelines.end())
-            return it->second;
-        return nullptr;
+        RefPtr<PipelineBase> pipeline;
+        specializedPipelines.tryGet(programKey, pipeline);
+        return pipeline;
     }
-    void addSpecializedPipeline(PipelineKey key, RefPtr<PipelineBase> specializedPipeline);
+    // Returns the pipeline stored in the cache, which is an existing pipeline if another thread
+    // added a pipeline for the same key first.
+    RefPtr<PipelineBase> addSpecializedPipeline(PipelineKey key, RefPtr<PipelineBase> specializedPipeline);
+    // Keys of all specialized pipelines created from `unspecializedPipeline`.
+    std::vector<PipelineKey> getSpecializationKeys(PipelineBase* unspecializedPipeline);
     void free()
     {
-        specializedPipelines = decltype(specializedPipelines)();
-        componentIds = decltype(componentIds)();
+        specializedPipelines.clear();
+        typeComponentIds.clear();
+        componentIds.clear();
+        nextComponentId = 0;
+        std::lock_guard<std::mutex> lock(componentNamesMutex);
+        componentNames.clear();
     }
 
-protected:
     struct ComponentKeyHasher
     {
         std::size_t operator()(const ComponentKey& k) const { return k.hash; }
@@ -1063,8 +1180,16 @@ protected:
         std::size_t operator()(const PipelineKey& k) const { return k.hash; }
     };
 
-    std::unordered_map<ComponentKey, ShaderComponentID, ComponentKeyHasher> componentIds;
-    std::unordered_map<PipelineKey, RefPtr<PipelineBase>, PipelineKeyHasher> specializedPipelines;
+protected:
+    ShaderComponentID getComponentIdFromName(slang::TypeReflection* type);
+
+    ShardedMap<ComponentKey, ShaderComponentID, ComponentKeyHasher> componentIds;
+    // Component IDs of reflected types, so looking up a type seen before doesn't build its name.
+    ShardedMap<slang::TypeReflection*, ShaderComponentID> typeComponentIds;
+    std::atomic<ShaderComponentID> nextComponentId = 0;
+    std::mutex componentNamesMutex;
+    std::vector<std::string> componentNames;
+    ShardedMap<PipelineKey, RefPtr<PipelineBase>, PipelineKeyHasher> specializedPipelines;
 };
 
 class TransientResourceHeapBase : public ITransientResourceHeap, public ComObject
@@ -1138,6 +1263,103 @@ public:
     Result init(const IShaderTable::Desc& desc);
 };
 
+// Accumulates a `ShaderCompilationStat`. Can be recorded from multiple threads.
+class ShaderCompilationStatCounter
+{
+public:
+    void record(uint64_t time);
+    ShaderCompilationStat get() const;
+    void reset();
+
+private:
+    std::atomic<uint64_t> m_count = 0;
+    std::atomic<uint64_t> m_totalTime = 0;
+    std::atomic<uint64_t> m_maxTime = 0;
+};
+
+struct ShaderCompilationStatCounters
+{
+    ShaderCompilationStatCounter programLinking;
+    ShaderCompilationStatCounter entryPointCodeGeneration;
+    ShaderCompilationStatCounter persistentCacheHits;
+    ShaderCompilationStatCounter persistentCacheMisses;
+    ShaderCompilationStatCounter persistentCacheWrites;
+    ShaderCompilationStatCounter pipelineSpecialization;
+    ShaderCompilationStatCounter pipelineCreation;
+    std::atomic<uint64_t> specializedPipelineCacheHitCount = 0;
+    std::atomic<uint64_t> specializedPipelineCacheMissCount = 0;
+};
+
+// Records the time from construction to destruction in a `ShaderCompilationStatCounter`.
+class ShaderCompilationTimer
+{
+public:
+    ShaderCompilationTimer(ShaderCompilationStatCounter& counter)
+        : m_counter(&counter)
+        , m_startTime(std::chrono::steady_clock::now())
+    {
+    }
+    ~ShaderCompilationTimer()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - m_startTime;
+        m_counter->record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    ShaderCompilationTimer(const ShaderCompilationTimer&) = delete;
+    ShaderCompilationTimer& operator=(const ShaderCompilationTimer&) = delete;
+
+private:
+    ShaderCompilationStatCounter* m_counter;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+enum class StagingBufferKind
+{
+    Constant,
+    Upload,
+    ReadBack,
+    Count,
+};
+
+// Pool of staging buffers shared by all transient resource heaps of a device.
+// Heaps acquire buffers in power-of-two size classes and return them once the GPU is done with them, which is
+// when the heap is reset after waiting on its fences, or destroyed. Returned buffers are kept for reuse instead
+// of being destroyed, up to `kMaxPooledBytes`.
+// Pooled buffers may hold a reference to the device, so the pool is emptied when the last heap is removed.
+class StagingBufferAllocator
+{
+public:
+    static constexpr size_t kMinBlockSize = 64 * 1024;
+    static constexpr uint64_t kMaxPooledBytes = 256 * 1024 * 1024;
+
+    void init(IDevice* device) { m_device = device; }
+
+    // Returns the size of the buffers used for allocations of `size` bytes.
+    static size_t getBlockSize(size_t size);
+
+    Result acquire(StagingBufferKind kind, size_t size, RefPtr<Buffer>& outBuffer);
+    void release(StagingBufferKind kind, RefPtr<Buffer>& buffer);
+
+    void addHeap();
+    void removeHeap();
+
+    // Records the number of bytes a heap allocated between two resets.
+    void recordHeapUsage(uint64_t bytes);
+
+    void getStats(StagingMemoryStats* outStats);
+
+private:
+    static constexpr int kSizeClassCount = 64;
+
+    static int getSizeClass(size_t blockSize);
+
+    IDevice* m_device = nullptr;
+    std::mutex m_mutex;
+    std::vector<RefPtr<Buffer>> m_freeBuffers[int(StagingBufferKind::Count)][kSizeClassCount];
+    uint32_t m_heapCount = 0;
+    StagingMemoryStats m_stats;
+};
+
 // Renderer implementation shared by all platforms.
 // Responsible for shader compilation, specialization and caching.
 class RendererBase : public IDevice, public ComObject
@@ -1250,6 +1472,29 @@ public:
     // Provides a default implementation that returns SLANG_E_NOT_AVAILABLE.
     virtual SLANG_NO_THROW Result SLANG_MCALL getTextureRowAlignment(size_t* outAlignment) override;
 
+    // Provides a default implementation that returns SLANG_E_NOT_AVAILABLE.
+    virtual SLANG_NO_THROW Result SLANG_MCALL getMemoryStats(DeviceMemoryStats* outStats) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getShaderCompilationStats(ShaderCompilationStats* outStats) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL resetShaderCompilationStats() override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getStagingMemoryStats(StagingMemoryStats* outStats) override;
+
+    // Provides a default implementation that returns SLANG_E_NOT_AVAILABLE.
+    virtual SLANG_NO_THROW Result SLANG_MCALL getDescriptorPoolStats(DescriptorPoolStats* outStats) override;
+
+    // Provides a default implementation that returns SLANG_E_NOT_AVAILABLE.
+    virtual SLANG_NO_THROW Result SLANG_MCALL savePipelineCache() override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL waitForPipelineSpecializations(uint64_t timeout) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    exportPipelineSpecializations(IPipeline* pipeline, ISlangBlob** outManifest) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    prewarmPipelineSpecializations(IPipeline* pipeline, const void* manifest, Size manifestSize) override;
+
     Result getEntryPointCodeFromShaderCache(
         slang::IComponentType* program,
         SlangInt entryPointIndex,
@@ -1272,16 +1517,24 @@ public:
     );
 
 public:
-    ExtendedShaderObjectTypeList specializationArgs;
     // Given current pipeline and root shader object binding, generate and bind a specialized pipeline if necessary.
     // The newly specialized pipeline is held alive by the pipeline cache so users of `outNewPipeline` do not
     // need to maintain its lifespan.
+    // With async pipeline specialization, returns SLANG_E_PENDING while the specialization is compiled in the
+    // background. Callers skip the draw or dispatch in that case.
     Result maybeSpecializePipeline(
         PipelineBase* currentPipeline,
         ShaderObjectBase* rootObject,
         RefPtr<PipelineBase>& outNewPipeline
     );
 
+    // Compile `unspecializedPipeline` specialized to `specializationArgs`.
+    Result specializePipeline(
+        PipelineBase* unspecializedPipeline,
+        const ExtendedShaderObjectTypeList& specializationArgs,
+        RefPtr<PipelineBase>& outPipeline
+    );
+
     virtual Result createShaderObjectLayout(
         slang::ISession* session,
         slang::TypeLayoutReflection* typeLayout,
@@ -1295,17 +1548,64 @@ public:
 protected:
     virtual SLANG_NO_THROW Result SLANG_MCALL initialize(const Desc& desc);
 
+public:
+    ~RendererBase();
+
 protected:
     std::vector<std::string> m_features;
 
+    // Work queue of the background specialization thread. The state is shared with the thread,
+    // because the thread can release the last reference to the device and outlive it.
+    struct SpecializationQueue
+    {
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable idle;
+        std::deque<std::function<void()>> tasks;
+        // Number of queued and running tasks.
+        size_t pendingCount = 0;
+        bool stop = false;
+    };
+
+    static void specializationThreadMain(std::shared_ptr<SpecializationQueue> queue);
+
+    // Queue a specialization of `unspecializedPipeline` on the background thread.
+    // Returns SLANG_E_PENDING, the cached pipeline if it finished in the meantime, or the result
+    // of a previously failed attempt. A failure is reported once, the next call queues a new attempt.
+    // `outQueued` is set if this call queued the specialization, rather than finding it pending or done.
+    Result queuePipelineSpecialization(
+        PipelineBase* unspecializedPipeline,
+        const PipelineKey& pipelineKey,
+        const ExtendedShaderObjectTypeList& specializationArgs,
+        RefPtr<PipelineBase>& outPipeline,
+        bool& outQueued
+    );
+
+    // Null unless async pipeline specialization is enabled.
+    std::shared_ptr<SpecializationQueue> m_specializationQueue;
+    std::thread m_specializationThread;
+    // Keys of queued and running specializations, and results of failed ones that were not reported yet.
+    // Protected by the mutex of the specialization queue.
+    std::unordered_set<PipelineKey, ShaderCache::PipelineKeyHasher> m_pendingSpecializations;
+    std::unordered_map<PipelineKey, Result, ShaderCache::PipelineKeyHasher> m_failedSpecializations;
+
 public:
     SlangContext slangContext;
     ShaderCache shaderCache;
 
+    // Slang sessions are not thread-safe. All calls into a session that can run while the background
+    // specialization thread compiles pipelines are serialized by this mutex. It is held only around the Slang
+    // calls, so recording threads don't wait for the driver to create pipelines.
+    std::recursive_mutex m_slangSessionMutex;
+
     ComPtr<IPersistentShaderCache> persistentShaderCache;
 
-    std::map<slang::TypeLayoutReflection*, RefPtr<ShaderObjectLayoutBase>> m_shaderObjectLayoutCache;
+    ShardedMap<slang::TypeLayoutReflection*, RefPtr<ShaderObjectLayoutBase>> m_shaderObjectLayoutCache;
     ComPtr<IPipelineCreationAPIDispatcher> m_pipelineCreationAPIDispatcher;
+
+    ShaderCompilationStatCounters m_shaderCompilationStats;
+
+    StagingBufferAllocator m_stagingBufferAllocator;
 };
 
 bool isDepthFormat(Format format);
@@ -1464,7 +1764,9 @@ Result ShaderObjectBaseImpl<TShaderObjectImpl, TShaderObjectLayoutImpl, TShaderO
                 // If field's type is `ParameterBlock<SomeStruct>` or `ConstantBuffer<SomeStruct>`, where
                 // `SomeStruct` is a struct type (not directly an interface type), we need to recursively
                 // collect the specialization arguments from the bound sub object.
-                SLANG_RETURN_ON_FAIL(subObject->collectSpecializationArgs(typeArgs));
+                const ExtendedShaderObjectTypeList* subObjectArgs;
+                SLANG_RETURN_ON_FAIL(subObject->getSpecializationArgs(subObjectArgs));
+                typeArgs.addRange(*subObjectArgs);
                 break;
             }
 
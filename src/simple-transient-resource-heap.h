@@ -5,6 +5,7 @@
 
 #include <slang-rhi.h>
 
+#include "command-writer.h"
 #include "renderer-shared.h"
 
 namespace rhi {
@@ -15,6 +16,8 @@ class SimpleTransientResourceHeap : public TransientResourceHeapBase
 public:
     RefPtr<TDevice> m_device;
     ComPtr<IBuffer> m_constantBuffer;
+    // Command chunks of released command buffers, reused by the command buffers created after them.
+    RefPtr<CommandChunkPool> m_commandChunkPool = new CommandChunkPool();
 
 public:
     Result init(TDevice* device, const ITransientResourceHeap::Desc& desc)
@@ -31,13 +34,15 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL createCommandBuffer(ICommandBuffer** outCommandBuffer) override
     {
         RefPtr<TCommandBuffer> newCmdBuffer = new TCommandBuffer();
-        newCmdBuffer->init(m_device, this);
+        newCmdBuffer->init(m_device, this, m_commandChunkPool);
         returnComPtr(outCommandBuffer, newCmdBuffer);
         return SLANG_OK;
     }
 
     virtual SLANG_NO_THROW Result SLANG_MCALL synchronizeAndReset() override
     {
+        // Commands may still be executing asynchronously and read versions and constant data owned by this heap.
+        m_device->waitForGpu();
         ++getVersionCounter();
         return SLANG_OK;
     }
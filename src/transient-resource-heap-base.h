@@ -4,122 +4,116 @@
 
 namespace rhi {
 
-template<typename TDevice, typename TBuffer>
+// Sub-allocates staging memory for a transient resource heap.
+// Allocations are placed linearly in pages acquired from the device's `StagingBufferAllocator`, allocations that are
+// large compared to the page size get a dedicated buffer. All buffers go back to the allocator on reset.
+// The page size grows when a heap needs more than one page between two resets, and shrinks back towards the initial
+// size once the heap used only a small part of a page for a number of resets in a row.
+template<typename TBuffer>
 class StagingBufferPool
 {
 public:
-    struct StagingBufferPage
-    {
-        RefPtr<TBuffer> resource;
-        size_t size;
-    };
-
     struct Allocation
     {
         TBuffer* resource;
         size_t offset;
     };
 
-    TDevice* m_device;
-    MemoryType m_memoryType;
+    StagingBufferAllocator* m_allocator = nullptr;
+    StagingBufferKind m_kind;
     uint32_t m_alignment;
-    ResourceStateSet m_allowedStates;
+    size_t m_pageSize;
+    size_t m_initialPageSize;
+    // Number of resets in a row that allocated at most a quarter of a page.
+    uint32_t m_lowUsageResetCount = 0;
 
-    std::vector<StagingBufferPage> m_pages;
-    std::vector<RefPtr<TBuffer>> m_largeAllocations;
+    // Buffers acquired since the last reset.
+    std::vector<RefPtr<Buffer>> m_pages;
+    std::vector<RefPtr<Buffer>> m_largeAllocations;
 
-    Index m_pageAllocCounter = 0;
     size_t m_offsetAllocCounter = 0;
+    size_t m_allocatedBytes = 0;
 
-    const size_t kStagingBufferDefaultPageSize = 16 * 1024 * 1024;
+    static constexpr size_t kStagingBufferDefaultPageSize = 16 * 1024 * 1024;
+    static constexpr size_t kStagingBufferMaxPageSize = 256 * 1024 * 1024;
+    static constexpr uint32_t kLowUsageResetsBeforeShrink = 16;
 
-    void init(TDevice* device, MemoryType memoryType, uint32_t alignment, ResourceStateSet allowedStates)
+    void init(StagingBufferAllocator* allocator, StagingBufferKind kind, uint32_t alignment, size_t pageSize)
     {
-        m_device = device;
-        m_memoryType = memoryType;
+        m_allocator = allocator;
+        m_kind = kind;
         m_alignment = alignment;
-        m_allowedStates = allowedStates;
+        m_pageSize = StagingBufferAllocator::getBlockSize(pageSize ? pageSize : kStagingBufferDefaultPageSize);
+        m_initialPageSize = m_pageSize;
     }
 
     static size_t alignUp(size_t value, uint32_t alignment) { return (value + alignment - 1) / alignment * alignment; }
 
     void reset()
     {
-        m_pageAllocCounter = 0;
-        m_offsetAllocCounter = 0;
+        // Use larger pages from now on if the allocations since the last reset did not fit into a single page.
+        if (m_pages.size() > 1 && m_pageSize < kStagingBufferMaxPageSize)
+        {
+            m_pageSize = std::min(
+                std::max(m_pageSize * 2, StagingBufferAllocator::getBlockSize(m_allocatedBytes)),
+                kStagingBufferMaxPageSize
+            );
+            m_lowUsageResetCount = 0;
+        }
+        // Halve the page size after a burst once usage stayed low, so a single large frame doesn't keep large pages
+        // in use for the lifetime of the heap. Usage fits into half of the smaller page, so it doesn't grow again.
+        else if (m_pageSize > m_initialPageSize && m_allocatedBytes <= m_pageSize / 4)
+        {
+            if (++m_lowUsageResetCount >= kLowUsageResetsBeforeShrink)
+            {
+                m_pageSize = std::max(m_pageSize / 2, m_initialPageSize);
+                m_lowUsageResetCount = 0;
+            }
+        }
+        else
+        {
+            m_lowUsageResetCount = 0;
+        }
+        if (m_allocatedBytes > 0)
+            m_allocator->recordHeapUsage(m_allocatedBytes);
+
+        for (auto& page : m_pages)
+            m_allocator->release(m_kind, page);
+        for (auto& buffer : m_largeAllocations)
+            m_allocator->release(m_kind, buffer);
+        m_pages.clear();
         m_largeAllocations.clear();
+        m_offsetAllocCounter = 0;
+        m_allocatedBytes = 0;
     }
 
-    Result newStagingBufferPage()
-    {
-        StagingBufferPage page;
-        size_t pageSize = kStagingBufferDefaultPageSize;
-
-        ComPtr<IBuffer> bufferPtr;
-        BufferDesc bufferDesc;
-        bufferDesc.defaultState = ResourceState::General;
-        bufferDesc.allowedStates = m_allowedStates;
-        bufferDesc.memoryType = m_memoryType;
-        bufferDesc.size = pageSize;
-        SLANG_RETURN_ON_FAIL(m_device->createBuffer(bufferDesc, nullptr, bufferPtr.writeRef()));
-
-        page.resource = static_cast<TBuffer*>(bufferPtr.get());
-        page.size = pageSize;
-        m_pages.push_back(page);
-        return SLANG_OK;
-    }
-
-    Result newLargeBuffer(size_t size)
+    Result allocate(size_t size, bool forceLargePage, Allocation& outAllocation)
     {
-        ComPtr<IBuffer> bufferPtr;
-        BufferDesc bufferDesc;
-        bufferDesc.defaultState = ResourceState::General;
-        bufferDesc.allowedStates = m_allowedStates;
-        bufferDesc.memoryType = m_memoryType;
-        bufferDesc.size = size;
-        SLANG_RETURN_ON_FAIL(m_device->createBuffer(bufferDesc, nullptr, bufferPtr.writeRef()));
-        auto bufferImpl = static_cast<TBuffer*>(bufferPtr.get());
-        m_largeAllocations.push_back(bufferImpl);
-        return SLANG_OK;
-    }
+        m_allocatedBytes += size;
 
-    Allocation allocate(size_t size, bool forceLargePage)
-    {
-        if (forceLargePage || size >= (kStagingBufferDefaultPageSize >> 2))
+        if (forceLargePage || size >= (m_pageSize >> 2))
         {
-            newLargeBuffer(size);
-            Allocation result;
-            result.resource = m_largeAllocations.back();
-            result.offset = 0;
-            return result;
+            RefPtr<Buffer> buffer;
+            SLANG_RETURN_ON_FAIL(m_allocator->acquire(m_kind, size, buffer));
+            outAllocation.resource = static_cast<TBuffer*>(buffer.Ptr());
+            outAllocation.offset = 0;
+            m_largeAllocations.push_back(buffer);
+            return SLANG_OK;
         }
 
+        // Sub allocate from the current page, or start a new page if it is full.
         size_t bufferAllocOffset = alignUp(m_offsetAllocCounter, m_alignment);
-        Index bufferId = -1;
-        for (GfxIndex i = m_pageAllocCounter; i < m_pages.size(); i++)
+        if (m_pages.empty() || bufferAllocOffset + size > m_pages.back()->getDesc()->size)
         {
-            auto cb = m_pages[i].resource.Ptr();
-            if (bufferAllocOffset + size <= cb->getDesc()->size)
-            {
-                bufferId = i;
-                break;
-            }
+            RefPtr<Buffer> page;
+            SLANG_RETURN_ON_FAIL(m_allocator->acquire(m_kind, m_pageSize, page));
+            m_pages.push_back(page);
             bufferAllocOffset = 0;
         }
-        // If we cannot find an existing page with sufficient free space,
-        // create a new page.
-        if (bufferId == -1)
-        {
-            newStagingBufferPage();
-            bufferId = m_pages.size() - 1;
-        }
-        // Sub allocate from current page.
-        Allocation result;
-        result.resource = m_pages[bufferId].resource.Ptr();
-        result.offset = bufferAllocOffset;
-        m_pageAllocCounter = bufferId;
+        outAllocation.resource = static_cast<TBuffer*>(m_pages.back().Ptr());
+        outAllocation.offset = bufferAllocOffset;
         m_offsetAllocCounter = bufferAllocOffset + size;
-        return result;
+        return SLANG_OK;
     }
 };
 
@@ -131,34 +125,32 @@ public:
 
 public:
     BreakableReference<TDevice> m_device;
-    StagingBufferPool<TDevice, TBuffer> m_constantBufferPool;
-    StagingBufferPool<TDevice, TBuffer> m_uploadBufferPool;
-    StagingBufferPool<TDevice, TBuffer> m_readbackBufferPool;
+    StagingBufferAllocator* m_stagingBufferAllocator = nullptr;
+    StagingBufferPool<TBuffer> m_constantBufferPool;
+    StagingBufferPool<TBuffer> m_uploadBufferPool;
+    StagingBufferPool<TBuffer> m_readbackBufferPool;
+
+    ~TransientResourceHeapBaseImpl()
+    {
+        if (!m_stagingBufferAllocator)
+            return;
+        // Backends wait for the GPU to finish using the heap before it is destroyed.
+        m_constantBufferPool.reset();
+        m_uploadBufferPool.reset();
+        m_readbackBufferPool.reset();
+        m_stagingBufferAllocator->removeHeap();
+    }
 
     Result init(const ITransientResourceHeap::Desc& desc, uint32_t alignment, TDevice* device)
     {
         m_device = device;
+        m_stagingBufferAllocator = &device->m_stagingBufferAllocator;
+        m_stagingBufferAllocator->addHeap();
 
-        m_constantBufferPool.init(
-            device,
-            MemoryType::Upload,
-            256,
-            ResourceStateSet(ResourceState::ConstantBuffer, ResourceState::CopySource, ResourceState::CopyDestination)
-        );
-
-        m_uploadBufferPool.init(
-            device,
-            MemoryType::Upload,
-            256,
-            ResourceStateSet(ResourceState::CopySource, ResourceState::CopyDestination)
-        );
-
-        m_readbackBufferPool.init(
-            device,
-            MemoryType::ReadBack,
-            256,
-            ResourceStateSet(ResourceState::CopySource, ResourceState::CopyDestination)
-        );
+        size_t pageSize = desc.stagingBufferPageSize;
+        m_constantBufferPool.init(m_stagingBufferAllocator, StagingBufferKind::Constant, 256, pageSize);
+        m_uploadBufferPool.init(m_stagingBufferAllocator, StagingBufferKind::Upload, 256, pageSize);
+        m_readbackBufferPool.init(m_stagingBufferAllocator, StagingBufferKind::ReadBack, 256, pageSize);
 
         m_version = getVersionCounter();
         getVersionCounter()++;
@@ -173,29 +165,18 @@ public:
         bool forceLargePage = false
     )
     {
-        switch (memoryType)
-        {
-        case MemoryType::ReadBack:
-        {
-            auto allocation = m_readbackBufferPool.allocate(size, forceLargePage);
-            outBufferWeakPtr = allocation.resource;
-            offset = allocation.offset;
-        }
-        break;
-        default:
-        {
-            auto allocation = m_uploadBufferPool.allocate(size, forceLargePage);
-            outBufferWeakPtr = allocation.resource;
-            offset = allocation.offset;
-        }
-        break;
-        }
+        auto& pool = memoryType == MemoryType::ReadBack ? m_readbackBufferPool : m_uploadBufferPool;
+        typename StagingBufferPool<TBuffer>::Allocation allocation;
+        SLANG_RETURN_ON_FAIL(pool.allocate(size, forceLargePage, allocation));
+        outBufferWeakPtr = allocation.resource;
+        offset = allocation.offset;
         return SLANG_OK;
     }
 
     Result allocateConstantBuffer(size_t size, IBuffer*& outBufferWeakPtr, size_t& outOffset)
     {
-        auto allocation = m_constantBufferPool.allocate(size, false);
+        typename StagingBufferPool<TBuffer>::Allocation allocation;
+        SLANG_RETURN_ON_FAIL(m_constantBufferPool.allocate(size, false, allocation));
         outBufferWeakPtr = allocation.resource;
         outOffset = allocation.offset;
         return SLANG_OK;
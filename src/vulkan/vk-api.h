@@ -17,6 +17,7 @@ namespace rhi::vk {
 #define VK_API_INSTANCE_PROCS_OPT(x) \
     x(vkGetPhysicalDeviceFeatures2) \
     x(vkGetPhysicalDeviceProperties2) \
+    x(vkGetPhysicalDeviceMemoryProperties2) \
     x(vkCreateDebugReportCallbackEXT) \
     x(vkDestroyDebugReportCallbackEXT) \
     x(vkDebugReportMessageEXT) \
@@ -58,6 +59,9 @@ namespace rhi::vk {
     x(vkCreateComputePipelines) \
     x(vkCreateGraphicsPipelines) \
     x(vkDestroyPipeline) \
+    x(vkCreatePipelineCache) \
+    x(vkDestroyPipelineCache) \
+    x(vkGetPipelineCacheData) \
     x(vkCreateShaderModule) \
     x(vkDestroyShaderModule) \
     x(vkCreateFramebuffer) \
@@ -7,6 +7,7 @@
 #include "vk-api.h"
 #include "vk-descriptor-allocator.h"
 #include "vk-device-queue.h"
+#include "vk-memory-allocator.h"
 
 #include "core/common.h"
 
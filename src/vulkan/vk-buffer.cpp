@@ -8,18 +8,20 @@
 namespace rhi::vk {
 
 Result VKBufferHandleRAII::init(
-    const VulkanApi& api,
+    MemoryAllocator& allocator,
     Size bufferSize,
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags reqMemoryProperties,
     bool isShared,
-    VkExternalMemoryHandleTypeFlagsKHR extMemHandleType
+    VkExternalMemoryHandleTypeFlagsKHR extMemHandleType,
+    VkMemoryPropertyFlags preferredMemoryProperties
 )
 {
     SLANG_RHI_ASSERT(!isInitialized());
 
+    const VulkanApi& api = *allocator.getApi();
+    m_allocator = &allocator;
     m_api = &api;
-    m_memory = VK_NULL_HANDLE;
     m_buffer = VK_NULL_HANDLE;
 
     VkBufferCreateInfo bufferCreateInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
@@ -41,47 +43,15 @@ Result VKBufferHandleRAII::init(
     VkMemoryRequirements memoryReqs = {};
     api.vkGetBufferMemoryRequirements(api.m_device, m_buffer, &memoryReqs);
 
-    int memoryTypeIndex = api.findMemoryTypeIndex(memoryReqs.memoryTypeBits, reqMemoryProperties);
-    SLANG_RHI_ASSERT(memoryTypeIndex >= 0);
-
-    VkMemoryPropertyFlags actualMemoryProperites =
-        api.m_deviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
-    VkMemoryAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-    allocateInfo.allocationSize = memoryReqs.size;
-    allocateInfo.memoryTypeIndex = memoryTypeIndex;
-#if SLANG_WINDOWS_FAMILY
-    VkExportMemoryWin32HandleInfoKHR exportMemoryWin32HandleInfo = {
-        VK_STRUCTURE_TYPE_EXPORT_MEMORY_WIN32_HANDLE_INFO_KHR
-    };
-#endif
-    VkExportMemoryAllocateInfoKHR exportMemoryAllocateInfo = {VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO_KHR};
-    if (isShared)
-    {
-#if SLANG_WINDOWS_FAMILY
-        exportMemoryWin32HandleInfo.pNext = nullptr;
-        exportMemoryWin32HandleInfo.pAttributes = nullptr;
-        exportMemoryWin32HandleInfo.dwAccess = DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE;
-        exportMemoryWin32HandleInfo.name = NULL;
-
-        exportMemoryAllocateInfo.pNext = extMemHandleType & VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT_KHR
-                                             ? &exportMemoryWin32HandleInfo
-                                             : nullptr;
-#endif
-        exportMemoryAllocateInfo.handleTypes = extMemHandleType;
-        allocateInfo.pNext = &exportMemoryAllocateInfo;
-    }
-    VkMemoryAllocateFlagsInfo flagInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO};
-    if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
-    {
-        flagInfo.deviceMask = 1;
-        flagInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
-
-        flagInfo.pNext = allocateInfo.pNext;
-        allocateInfo.pNext = &flagInfo;
-    }
-
-    SLANG_VK_RETURN_ON_FAIL(api.vkAllocateMemory(api.m_device, &allocateInfo, nullptr, &m_memory));
-    SLANG_VK_RETURN_ON_FAIL(api.vkBindBufferMemory(api.m_device, m_buffer, m_memory, 0));
+    SLANG_RETURN_ON_FAIL(allocator.allocate(
+        memoryReqs,
+        reqMemoryProperties,
+        MemoryResourceKind::Linear,
+        isShared ? extMemHandleType : 0,
+        m_memory,
+        preferredMemoryProperties
+    ));
+    SLANG_VK_RETURN_ON_FAIL(api.vkBindBufferMemory(api.m_device, m_buffer, m_memory.memory, m_memory.offset));
 
     return SLANG_OK;
 }
@@ -134,7 +104,7 @@ Result BufferImpl::getSharedHandle(NativeHandle* outHandle)
     VkMemoryGetWin32HandleInfoKHR info = {};
     info.sType = VK_STRUCTURE_TYPE_MEMORY_GET_WIN32_HANDLE_INFO_KHR;
     info.pNext = nullptr;
-    info.memory = m_buffer.m_memory;
+    info.memory = m_buffer.m_memory.memory;
     info.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT;
 
     auto api = m_buffer.m_api;
@@ -150,7 +120,7 @@ Result BufferImpl::getSharedHandle(NativeHandle* outHandle)
     VkMemoryGetFdInfoKHR info = {};
     info.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
     info.pNext = nullptr;
-    info.memory = m_buffer.m_memory;
+    info.memory = m_buffer.m_memory.memory;
     info.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
 
     auto api = m_buffer.m_api;
@@ -170,16 +140,14 @@ Result BufferImpl::getSharedHandle(NativeHandle* outHandle)
 Result BufferImpl::map(MemoryRange* rangeToRead, void** outPointer)
 {
     SLANG_UNUSED(rangeToRead);
-    auto api = m_buffer.m_api;
-    SLANG_VK_RETURN_ON_FAIL(api->vkMapMemory(api->m_device, m_buffer.m_memory, 0, VK_WHOLE_SIZE, 0, outPointer));
-    return SLANG_OK;
+    // Host visible memory stays mapped for its whole lifetime.
+    *outPointer = m_buffer.getMappedData();
+    return *outPointer ? SLANG_OK : SLANG_FAIL;
 }
 
 Result BufferImpl::unmap(MemoryRange* writtenRange)
 {
     SLANG_UNUSED(writtenRange);
-    auto api = m_buffer.m_api;
-    api->vkUnmapMemory(api->m_device, m_buffer.m_memory);
     return SLANG_OK;
 }
 
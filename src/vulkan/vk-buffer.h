@@ -9,20 +9,26 @@ class VKBufferHandleRAII
 {
 public:
     /// Initialize a buffer with specified size, and memory props
+    /// Memory that also has `preferredMemoryProperties` is used if available.
     Result init(
-        const VulkanApi& api,
+        MemoryAllocator& allocator,
         Size bufferSize,
         VkBufferUsageFlags usage,
         VkMemoryPropertyFlags reqMemoryProperties,
         bool isShared = false,
-        VkExternalMemoryHandleTypeFlagsKHR extMemHandleType = 0
+        VkExternalMemoryHandleTypeFlagsKHR extMemHandleType = 0,
+        VkMemoryPropertyFlags preferredMemoryProperties = 0
     );
 
     /// Returns true if has been initialized
     bool isInitialized() const { return m_api != nullptr; }
 
+    /// Returns the host address of the buffer, or null if its memory is not host visible
+    void* getMappedData() const { return m_memory.mappedData; }
+
     VKBufferHandleRAII()
-        : m_api(nullptr)
+        : m_allocator(nullptr)
+        , m_api(nullptr)
     {
     }
 
@@ -31,12 +37,13 @@ public:
         if (m_api)
         {
             m_api->vkDestroyBuffer(m_api->m_device, m_buffer, nullptr);
-            m_api->vkFreeMemory(m_api->m_device, m_memory, nullptr);
+            m_allocator->free(m_memory);
         }
     }
 
     VkBuffer m_buffer;
-    VkDeviceMemory m_memory;
+    MemoryAllocation m_memory;
+    MemoryAllocator* m_allocator;
     const VulkanApi* m_api;
 };
 
@@ -136,6 +136,8 @@ void CommandBufferImpl::close()
         );
         vkAPI.vkEndCommandBuffer(m_preCommandBuffer);
     }
+    // Uploads are recorded lazily, make sure none are dropped if the resource encoder was not ended.
+    m_resourceCommandEncoder.flushPendingUploads();
     vkAPI.vkEndCommandBuffer(m_commandBuffer);
 }
 
@@ -21,6 +21,8 @@ namespace rhi::vk {
 
 void CommandEncoderImpl::textureBarrier(GfxCount count, ITexture* const* textures, ResourceState src, ResourceState dst)
 {
+    flushPendingUploads();
+
     short_vector<VkImageMemoryBarrier, 16> barriers;
 
     for (GfxIndex i = 0; i < count; i++)
@@ -68,6 +70,8 @@ void CommandEncoderImpl::textureSubresourceBarrier(
     ResourceState dst
 )
 {
+    flushPendingUploads();
+
     short_vector<VkImageMemoryBarrier> barriers;
     auto image = static_cast<TextureImpl*>(texture);
     auto desc = image->getDesc();
@@ -107,6 +111,8 @@ void CommandEncoderImpl::textureSubresourceBarrier(
 // TODO: Change size_t to Count?
 void CommandEncoderImpl::bufferBarrier(GfxCount count, IBuffer* const* buffers, ResourceState src, ResourceState dst)
 {
+    flushPendingUploads();
+
     std::vector<VkBufferMemoryBarrier> barriers;
     barriers.reserve(count);
 
@@ -145,6 +151,7 @@ void CommandEncoderImpl::bufferBarrier(GfxCount count, IBuffer* const* buffers,
 
 void CommandEncoderImpl::beginDebugEvent(const char* name, float rgbColor[3])
 {
+    flushPendingUploads();
     auto& vkApi = m_commandBuffer->m_renderer->m_api;
     if (vkApi.vkCmdDebugMarkerBeginEXT)
     {
@@ -161,6 +168,7 @@ void CommandEncoderImpl::beginDebugEvent(const char* name, float rgbColor[3])
 
 void CommandEncoderImpl::endDebugEvent()
 {
+    flushPendingUploads();
     auto& vkApi = m_commandBuffer->m_renderer->m_api;
     if (vkApi.vkCmdDebugMarkerEndEXT)
     {
@@ -170,6 +178,7 @@ void CommandEncoderImpl::endDebugEvent()
 
 void CommandEncoderImpl::writeTimestamp(IQueryPool* queryPool, GfxIndex index)
 {
+    flushPendingUploads();
     _writeTimestamp(&m_commandBuffer->m_renderer->m_api, m_commandBuffer->m_commandBuffer, queryPool, index);
 }
 
@@ -195,6 +204,7 @@ void CommandEncoderImpl::init(CommandBufferImpl* commandBuffer)
     m_device = commandBuffer->m_renderer;
     m_vkCommandBuffer = m_commandBuffer->m_commandBuffer;
     m_api = &m_commandBuffer->m_renderer->m_api;
+    m_uploadedRanges.clear();
 }
 
 void CommandEncoderImpl::endEncodingImpl()
@@ -203,6 +213,25 @@ void CommandEncoderImpl::endEncodingImpl()
         pipeline = VK_NULL_HANDLE;
 }
 
+Result CommandEncoderImpl::_stageUploadData(
+    TransientResourceHeapImpl* transientHeap,
+    Size size,
+    void* data,
+    BufferImpl*& outStagingBuffer,
+    Offset& outStagingBufferOffset
+)
+{
+    IBuffer* stagingBuffer = nullptr;
+    SLANG_RETURN_ON_FAIL(
+        transientHeap->allocateStagingBuffer(size, stagingBuffer, outStagingBufferOffset, MemoryType::Upload)
+    );
+    outStagingBuffer = static_cast<BufferImpl*>(stagingBuffer);
+
+    // Staging memory stays mapped for its whole lifetime.
+    memcpy((char*)outStagingBuffer->m_buffer.getMappedData() + outStagingBufferOffset, data, size);
+    return SLANG_OK;
+}
+
 void CommandEncoderImpl::_uploadBufferData(
     VkCommandBuffer commandBuffer,
     TransientResourceHeapImpl* transientHeap,
@@ -213,23 +242,10 @@ void CommandEncoderImpl::_uploadBufferData(
 )
 {
     auto& api = buffer->m_renderer->m_api;
-    IBuffer* stagingBuffer = nullptr;
+    BufferImpl* stagingBufferImpl = nullptr;
     Offset stagingBufferOffset = 0;
-    transientHeap->allocateStagingBuffer(size, stagingBuffer, stagingBufferOffset, MemoryType::Upload);
-
-    BufferImpl* stagingBufferImpl = static_cast<BufferImpl*>(stagingBuffer);
-
-    void* mappedData = nullptr;
-    SLANG_VK_CHECK(api.vkMapMemory(
-        api.m_device,
-        stagingBufferImpl->m_buffer.m_memory,
-        0,
-        stagingBufferOffset + size,
-        0,
-        &mappedData
-    ));
-    memcpy((char*)mappedData + stagingBufferOffset, data, size);
-    api.vkUnmapMemory(api.m_device, stagingBufferImpl->m_buffer.m_memory);
+    if (SLANG_FAILED(_stageUploadData(transientHeap, size, data, stagingBufferImpl, stagingBufferOffset)))
+        return;
 
     // Copy from staging buffer to real buffer
     VkBufferCopy copyInfo = {};
@@ -239,6 +255,33 @@ void CommandEncoderImpl::_uploadBufferData(
     api.vkCmdCopyBuffer(commandBuffer, stagingBufferImpl->m_buffer.m_buffer, buffer->m_buffer.m_buffer, 1, &copyInfo);
 }
 
+void CommandEncoderImpl::flushPendingUploads()
+{
+    if (m_pendingUploadRegions.empty())
+        return;
+    m_api->vkCmdCopyBuffer(
+        m_commandBuffer->m_commandBuffer,
+        m_pendingUploadSrc,
+        m_pendingUploadDst,
+        (uint32_t)m_pendingUploadRegions.size(),
+        m_pendingUploadRegions.data()
+    );
+    m_pendingUploadRegions.clear();
+}
+
+bool CommandEncoderImpl::isUploadedRange(VkBuffer buffer, const VkBufferCopy& region)
+{
+    auto next = m_uploadedRanges.upper_bound({buffer, region.dstOffset});
+    if (next != m_uploadedRanges.end() && next->first.first == buffer &&
+        next->first.second < region.dstOffset + region.size)
+        return true;
+    if (next == m_uploadedRanges.begin())
+        return false;
+    auto prev = next;
+    --prev;
+    return prev->first.first == buffer && prev->second > region.dstOffset;
+}
+
 void CommandEncoderImpl::uploadBufferDataImpl(IBuffer* buffer, Offset offset, Size size, void* data)
 {
     m_vkPreCommandBuffer = m_commandBuffer->getPreCommandBuffer();
@@ -280,6 +323,7 @@ Result CommandEncoderImpl::bindRootShaderObjectImpl(
     std::vector<VkDescriptorSet> descriptorSetsStorage;
 
     context.descriptorSets = &descriptorSetsStorage;
+    context.descriptorWrites = &m_descriptorWrites;
 
     // We kick off recursive binding of shader objects to the pipeline (plus
     // the state in `context`).
@@ -292,6 +336,10 @@ Result CommandEncoderImpl::bindRootShaderObjectImpl(
     //
     rootShaderObject->bindAsRoot(this, context, specializedLayout);
 
+    // All descriptor writes collected during binding are applied at once.
+    //
+    m_descriptorWrites.flush(*m_api);
+
     // Once we've filled in all the descriptor sets, we bind them
     // to the pipeline at once.
     //
@@ -363,6 +411,8 @@ Result CommandEncoderImpl::bindRenderState(VkPipelineBindPoint pipelineBindPoint
 
 void ResourceCommandEncoderImpl::copyBuffer(IBuffer* dst, Offset dstOffset, IBuffer* src, Offset srcOffset, Size size)
 {
+    flushPendingUploads();
+
     auto& vkAPI = m_commandBuffer->m_renderer->m_api;
 
     auto dstBuffer = static_cast<BufferImpl*>(dst);
@@ -388,19 +438,61 @@ void ResourceCommandEncoderImpl::copyBuffer(IBuffer* dst, Offset dstOffset, IBuf
 
 void ResourceCommandEncoderImpl::uploadBufferData(IBuffer* buffer, Offset offset, Size size, void* data)
 {
-    CommandEncoderImpl::_uploadBufferData(
-        m_commandBuffer->m_commandBuffer,
-        m_commandBuffer->m_transientHeap.get(),
-        static_cast<BufferImpl*>(buffer),
-        offset,
-        size,
-        data
-    );
-}
+    if (size == 0)
+        return;
+
+    BufferImpl* stagingBuffer = nullptr;
+    Offset stagingBufferOffset = 0;
+    if (SLANG_FAILED(
+            _stageUploadData(m_commandBuffer->m_transientHeap.get(), size, data, stagingBuffer, stagingBufferOffset)
+        ))
+    {
+        return;
+    }
+
+    VkBufferCopy region = {};
+    region.srcOffset = stagingBufferOffset;
+    region.dstOffset = offset;
+    region.size = size;
+
+    VkBuffer dstBuffer = static_cast<BufferImpl*>(buffer)->m_buffer.m_buffer;
+    if (isUploadedRange(dstBuffer, region))
+    {
+        // Regions of a single copy must not overlap, and copies writing the same range are only ordered by a
+        // barrier. Record the earlier uploads and a barrier, so this upload wins.
+        flushPendingUploads();
+        VkMemoryBarrier memBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        memBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        m_api->vkCmdPipelineBarrier(
+            m_commandBuffer->m_commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            1,
+            &memBarrier,
+            0,
+            nullptr,
+            0,
+            nullptr
+        );
+        m_uploadedRanges.clear();
+    }
+    else if (stagingBuffer->m_buffer.m_buffer != m_pendingUploadSrc || dstBuffer != m_pendingUploadDst)
+    {
+        flushPendingUploads();
+    }
 
+    m_pendingUploadSrc = stagingBuffer->m_buffer.m_buffer;
+    m_pendingUploadDst = dstBuffer;
+    m_pendingUploadRegions.push_back(region);
+    m_uploadedRanges.emplace(std::make_pair(dstBuffer, region.dstOffset), region.dstOffset + region.size);
+}
 
 void ResourceCommandEncoderImpl::endEncoding()
 {
+    flushPendingUploads();
+
     // Insert memory barrier to ensure transfers are visible to the GPU.
     auto& vkAPI = m_commandBuffer->m_renderer->m_api;
 
@@ -433,6 +525,8 @@ void ResourceCommandEncoderImpl::copyTexture(
     Extents extent
 )
 {
+    flushPendingUploads();
+
     auto srcImage = static_cast<TextureImpl*>(src);
     auto srcDesc = srcImage->getDesc();
     auto srcImageLayout = VulkanUtil::getImageLayoutFromState(srcState);
@@ -489,6 +583,8 @@ void ResourceCommandEncoderImpl::uploadTextureData(
     GfxCount subResourceDataCount
 )
 {
+    flushPendingUploads();
+
     // VALIDATION: dst must be in TransferDst state.
 
     auto& vkApi = m_commandBuffer->m_renderer->m_api;
@@ -755,6 +851,8 @@ void ResourceCommandEncoderImpl::clearResourceView(
     ClearResourceViewFlags::Enum flags
 )
 {
+    flushPendingUploads();
+
     auto& api = m_commandBuffer->m_renderer->m_api;
     switch (view->getViewDesc()->type)
     {
@@ -840,6 +938,8 @@ void ResourceCommandEncoderImpl::resolveResource(
     SubresourceRange destRange
 )
 {
+    flushPendingUploads();
+
     auto srcTexture = static_cast<TextureImpl*>(source);
     auto srcExtent = srcTexture->getDesc()->size;
     auto dstTexture = static_cast<TextureImpl*>(dest);
@@ -890,6 +990,7 @@ void ResourceCommandEncoderImpl::resolveQuery(
     Offset offset
 )
 {
+    flushPendingUploads();
     auto& vkApi = m_commandBuffer->m_renderer->m_api;
     auto poolImpl = static_cast<QueryPoolImpl*>(queryPool);
     auto bufferImpl = static_cast<BufferImpl*>(buffer);
@@ -917,6 +1018,8 @@ void ResourceCommandEncoderImpl::copyTextureToBuffer(
     Extents extent
 )
 {
+    flushPendingUploads();
+
     SLANG_RHI_ASSERT(srcSubresource.mipLevelCount <= 1);
 
     auto image = static_cast<TextureImpl*>(src);
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "vk-base.h"
+#include "vk-helper-functions.h"
 #include "vk-pipeline.h"
 
+#include <map>
+#include <utility>
 #include <vector>
 
 namespace rhi::vk {
@@ -55,12 +58,33 @@ public:
 
     VulkanApi* m_api;
 
+    // Copies from staging memory recorded by `uploadBufferData` that are not in the command buffer yet.
+    // Consecutive uploads from one staging buffer to one buffer are recorded as a single copy with many regions.
+    VkBuffer m_pendingUploadSrc = VK_NULL_HANDLE;
+    VkBuffer m_pendingUploadDst = VK_NULL_HANDLE;
+    std::vector<VkBufferCopy> m_pendingUploadRegions;
+    // Ranges written by uploads since the last transfer barrier, mapping the buffer and start offset to the end
+    // offset. The ranges don't overlap, an upload to a range that was already written records a barrier first.
+    std::map<std::pair<VkBuffer, VkDeviceSize>, VkDeviceSize> m_uploadedRanges;
+
+    // Descriptor writes of the current root shader object binding, kept to reuse their storage.
+    DescriptorWriteBatch m_descriptorWrites;
+
     static int getBindPointIndex(VkPipelineBindPoint bindPoint);
 
     void init(CommandBufferImpl* commandBuffer);
 
     void endEncodingImpl();
 
+    // Copy `data` into staging memory allocated from the transient heap.
+    static Result _stageUploadData(
+        TransientResourceHeapImpl* transientHeap,
+        Size size,
+        void* data,
+        BufferImpl*& outStagingBuffer,
+        Offset& outStagingBufferOffset
+    );
+
     static void _uploadBufferData(
         VkCommandBuffer commandBuffer,
         TransientResourceHeapImpl* transientHeap,
@@ -70,6 +94,12 @@ public:
         void* data
     );
 
+    // Records the pending uploads. Must be called before recording any other command.
+    void flushPendingUploads();
+
+    // Returns true if an upload since the last transfer barrier wrote to a range overlapping `region` of `buffer`.
+    bool isUploadedRange(VkBuffer buffer, const VkBufferCopy& region);
+
     void uploadBufferDataImpl(IBuffer* buffer, Offset offset, Size size, void* data);
 
     Result bindRootShaderObjectImpl(RootShaderObjectImpl* rootShaderObject, VkPipelineBindPoint bindPoint);
@@ -1,84 +1,164 @@
 #include "vk-descriptor-allocator.h"
 #include "vk-util.h"
 
-#include "core/static_vector.h"
+#include <algorithm>
 
 namespace rhi::vk {
 
-VkDescriptorPool DescriptorSetAllocator::newPool()
+void DescriptorPoolCounters::getStats(DescriptorPoolStats& outStats) const
 {
-    VkDescriptorPoolCreateInfo descriptorPoolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-    static_vector<VkDescriptorPoolSize, 32> poolSizes;
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, 1024});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1024});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4096});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1024});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 256});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 256});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4096});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4096});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 4096});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 4096});
-    poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 16});
-    if (m_api->m_extendedFeatures.inlineUniformBlockFeatures.inlineUniformBlock)
-    {
-        poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT, 16});
-    }
-    if (m_api->m_extendedFeatures.accelerationStructureFeatures.accelerationStructure)
+    outStats.poolCount = poolCount;
+    outStats.poolCreationCount = poolCreationCount;
+    outStats.setCapacity = setCapacity;
+    outStats.setCount = setCount;
+    outStats.setsInUse = setsInUse;
+    outStats.setAllocationCount = setAllocationCount;
+    outStats.setReuseCount = setReuseCount;
+}
+
+uint64_t DescriptorSetAllocator::createLayoutId()
+{
+    static std::atomic<uint64_t> nextLayoutId{1};
+    return nextLayoutId++;
+}
+
+void DescriptorSetAllocator::init(const VulkanApi* api, DescriptorPoolCounters* counters)
+{
+    m_api = api;
+    m_counters = counters;
+}
+
+Result DescriptorSetAllocator::createPool(
+    LayoutPools& layoutPools,
+    const std::vector<VkDescriptorSetLayoutBinding>& bindings
+)
+{
+    uint32_t setCount = layoutPools.nextPoolSetCount;
+
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    uint32_t inlineUniformBlockBindingCount = 0;
+    for (const auto& binding : bindings)
     {
-        poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, 256});
+        if (binding.descriptorCount == 0)
+            continue;
+        poolSizes.push_back(VkDescriptorPoolSize{binding.descriptorType, binding.descriptorCount * setCount});
+        if (binding.descriptorType == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT)
+            inlineUniformBlockBindingCount++;
     }
-    descriptorPoolInfo.maxSets = 4096;
+
+    VkDescriptorPoolCreateInfo descriptorPoolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    descriptorPoolInfo.maxSets = setCount;
     descriptorPoolInfo.poolSizeCount = (uint32_t)poolSizes.size();
     descriptorPoolInfo.pPoolSizes = poolSizes.data();
-    descriptorPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
     VkDescriptorPoolInlineUniformBlockCreateInfo inlineUniformBlockInfo = {
         VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_INLINE_UNIFORM_BLOCK_CREATE_INFO
     };
-    inlineUniformBlockInfo.maxInlineUniformBlockBindings = 16;
-    descriptorPoolInfo.pNext = &inlineUniformBlockInfo;
+    if (inlineUniformBlockBindingCount)
+    {
+        inlineUniformBlockInfo.maxInlineUniformBlockBindings = inlineUniformBlockBindingCount * setCount;
+        descriptorPoolInfo.pNext = &inlineUniformBlockInfo;
+    }
 
     VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
-    SLANG_VK_CHECK(m_api->vkCreateDescriptorPool(m_api->m_device, &descriptorPoolInfo, nullptr, &descriptorPool));
-    pools.push_back(descriptorPool);
-    return descriptorPool;
+    SLANG_VK_RETURN_ON_FAIL(
+        m_api->vkCreateDescriptorPool(m_api->m_device, &descriptorPoolInfo, nullptr, &descriptorPool)
+    );
+    layoutPools.pools.push_back(descriptorPool);
+    layoutPools.remainingSetCount = setCount;
+    layoutPools.setCapacity += setCount;
+    layoutPools.nextPoolSetCount = std::min(setCount * 2, kMaxSetsPerPool);
+
+    m_counters->poolCount++;
+    m_counters->poolCreationCount++;
+    m_counters->setCapacity += setCount;
+    return SLANG_OK;
 }
 
-VulkanDescriptorSet DescriptorSetAllocator::allocate(VkDescriptorSetLayout layout)
+void DescriptorSetAllocator::destroyPools(LayoutPools& layoutPools)
 {
+    // Destroying a pool frees all sets allocated from it.
+    for (auto pool : layoutPools.pools)
+        m_api->vkDestroyDescriptorPool(m_api->m_device, pool, nullptr);
+
+    m_counters->poolCount -= layoutPools.pools.size();
+    m_counters->setCapacity -= layoutPools.setCapacity;
+    m_counters->setCount -= layoutPools.setCount;
+    m_counters->setsInUse -= layoutPools.usedSets.size();
+}
+
+VulkanDescriptorSet DescriptorSetAllocator::allocate(
+    VkDescriptorSetLayout layout,
+    uint64_t layoutId,
+    const std::vector<VkDescriptorSetLayoutBinding>& bindings
+)
+{
+    LayoutPools& layoutPools = m_layoutPools[layoutId];
+    layoutPools.idleResetCount = 0;
+
     VulkanDescriptorSet rs = {};
-    VkDescriptorSetAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = getPool();
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &layout;
-    if (m_api->vkAllocateDescriptorSets(m_api->m_device, &allocInfo, &rs.handle) == VK_SUCCESS)
+    if (!layoutPools.freeSets.empty())
     {
-        rs.pool = allocInfo.descriptorPool;
-        return rs;
+        rs = layoutPools.freeSets.back();
+        layoutPools.freeSets.pop_back();
+        m_counters->setReuseCount++;
     }
-    // If allocation from last pool fails, try all existing pools.
-    for (Index i = 0; i < pools.size() - 1; i++)
+    else
     {
-        allocInfo.descriptorPool = pools[i];
-        if (m_api->vkAllocateDescriptorSets(m_api->m_device, &allocInfo, &rs.handle) == VK_SUCCESS)
+        // Pools only hold sets of this layout, so a pool with remaining sets always has room for one more.
+        // Once the last pool is full, a new one is created without retrying the older ones.
+        if (layoutPools.remainingSetCount == 0 && SLANG_FAILED(createPool(layoutPools, bindings)))
         {
-            rs.pool = allocInfo.descriptorPool;
+            SLANG_RHI_ASSERT_FAILURE("Descriptor pool creation failed.");
+            return rs;
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        allocInfo.descriptorPool = layoutPools.pools.back();
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+        if (m_api->vkAllocateDescriptorSets(m_api->m_device, &allocInfo, &rs.handle) != VK_SUCCESS)
+        {
+            SLANG_RHI_ASSERT_FAILURE("Descriptor set allocation failed.");
             return rs;
         }
-    }
-    // If we still cannot allocate the descriptor set, add a new pool.
-    auto pool = newPool();
-    allocInfo.descriptorPool = pool;
-    if (m_api->vkAllocateDescriptorSets(m_api->m_device, &allocInfo, &rs.handle) == VK_SUCCESS)
-    {
         rs.pool = allocInfo.descriptorPool;
-        return rs;
+        layoutPools.remainingSetCount--;
+        layoutPools.setCount++;
+        m_counters->setCount++;
+        m_counters->setAllocationCount++;
     }
-    // Failed to allocate from a new pool, we are in trouble.
-    SLANG_RHI_ASSERT_FAILURE("Descriptor set allocation failed.");
+
+    layoutPools.usedSets.push_back(rs);
+    m_counters->setsInUse++;
     return rs;
 }
 
+void DescriptorSetAllocator::reset()
+{
+    for (auto it = m_layoutPools.begin(); it != m_layoutPools.end();)
+    {
+        LayoutPools& layoutPools = it->second;
+        if (layoutPools.usedSets.empty() && ++layoutPools.idleResetCount >= kMaxIdleResets)
+        {
+            // The layout may have been destroyed, release its pools.
+            destroyPools(layoutPools);
+            it = m_layoutPools.erase(it);
+            continue;
+        }
+        m_counters->setsInUse -= layoutPools.usedSets.size();
+        auto& freeSets = layoutPools.freeSets;
+        freeSets.insert(freeSets.end(), layoutPools.usedSets.begin(), layoutPools.usedSets.end());
+        layoutPools.usedSets.clear();
+        ++it;
+    }
+}
+
+void DescriptorSetAllocator::close()
+{
+    for (auto& it : m_layoutPools)
+        destroyPools(it.second);
+    m_layoutPools.clear();
+}
+
 } // namespace rhi::vk
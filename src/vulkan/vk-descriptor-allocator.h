@@ -4,6 +4,10 @@
 
 #include "core/common.h"
 
+#include <slang-rhi.h>
+
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 
 namespace rhi::vk {
@@ -13,30 +17,75 @@ struct VulkanDescriptorSet
     VkDescriptorSet handle;
     VkDescriptorPool pool;
 };
+
+/// Descriptor pool statistics shared by all descriptor set allocators of a device.
+struct DescriptorPoolCounters
+{
+    std::atomic<uint64_t> poolCount{0};
+    std::atomic<uint64_t> poolCreationCount{0};
+    std::atomic<uint64_t> setCapacity{0};
+    std::atomic<uint64_t> setCount{0};
+    std::atomic<uint64_t> setsInUse{0};
+    std::atomic<uint64_t> setAllocationCount{0};
+    std::atomic<uint64_t> setReuseCount{0};
+
+    void getStats(DescriptorPoolStats& outStats) const;
+};
+
+/// Allocator for the descriptor sets of a transient resource heap.
+///
+/// Every pool holds sets of a single descriptor set layout and is sized for exactly that layout, so allocating
+/// from a pool that still has room never fails. The first pool of a layout holds `kMinSetsPerPool` sets, and each
+/// further pool twice as many as the previous one, up to `kMaxSetsPerPool`. Sets are never freed individually:
+/// `reset` moves all sets handed out since the previous reset to a free list per layout, and later allocations
+/// for the layout reuse them without calling `vkAllocateDescriptorSets`. Pools of layouts that were not used
+/// for `kMaxIdleResets` resets are destroyed.
 class DescriptorSetAllocator
 {
 public:
-    std::vector<VkDescriptorPool> pools;
-    const VulkanApi* m_api;
-    VkDescriptorPool newPool();
-    VkDescriptorPool getPool()
-    {
-        if (!pools.empty())
-            return pools.back();
-        return newPool();
-    }
-    VulkanDescriptorSet allocate(VkDescriptorSetLayout layout);
-    void free(VulkanDescriptorSet set) { m_api->vkFreeDescriptorSets(m_api->m_device, set.pool, 1, &set.handle); }
-    void reset()
-    {
-        for (auto pool : pools)
-            m_api->vkResetDescriptorPool(m_api->m_device, pool, 0);
-    }
-    void close()
+    static constexpr uint32_t kMinSetsPerPool = 16;
+    static constexpr uint32_t kMaxSetsPerPool = 1024;
+    static constexpr uint32_t kMaxIdleResets = 16;
+
+    /// Returns a new layout id. Unlike layout handles, ids are never reused after a layout is destroyed.
+    static uint64_t createLayoutId();
+
+    void init(const VulkanApi* api, DescriptorPoolCounters* counters);
+
+    /// Allocate a descriptor set for the layout `layoutId`, created as `layout` from `bindings`.
+    /// The set stays valid until the allocator is reset.
+    VulkanDescriptorSet allocate(
+        VkDescriptorSetLayout layout,
+        uint64_t layoutId,
+        const std::vector<VkDescriptorSetLayoutBinding>& bindings
+    );
+
+    /// Recycle all sets allocated since the last reset. The GPU must be done with them.
+    void reset();
+    void close();
+
+private:
+    struct LayoutPools
     {
-        for (auto pool : pools)
-            m_api->vkDestroyDescriptorPool(m_api->m_device, pool, nullptr);
-    }
+        std::vector<VkDescriptorPool> pools;
+        /// Number of sets that can still be allocated from the last pool.
+        uint32_t remainingSetCount = 0;
+        /// Number of sets the next pool is created for.
+        uint32_t nextPoolSetCount = kMinSetsPerPool;
+        uint32_t setCapacity = 0;
+        uint32_t setCount = 0;
+        std::vector<VulkanDescriptorSet> freeSets;
+        std::vector<VulkanDescriptorSet> usedSets;
+        /// Number of resets since a set was last allocated for the layout.
+        uint32_t idleResetCount = 0;
+    };
+
+    Result createPool(LayoutPools& layoutPools, const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+    void destroyPools(LayoutPools& layoutPools);
+
+    const VulkanApi* m_api = nullptr;
+    DescriptorPoolCounters* m_counters = nullptr;
+    std::unordered_map<uint64_t, LayoutPools> m_layoutPools;
 };
 
 } // namespace rhi::vk
@@ -40,10 +40,15 @@ DeviceImpl::~DeviceImpl()
         waitForGpu();
     }
 
-    m_shaderObjectLayoutCache = decltype(m_shaderObjectLayoutCache)();
+    m_shaderObjectLayoutCache.clear();
     shaderCache.free();
     m_deviceObjectsWithPotentialBackReferences.clear();
 
+    if (m_pipelineCache != VK_NULL_HANDLE)
+    {
+        m_api.vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+    }
+
     if (m_api.vkDestroySampler)
     {
         m_api.vkDestroySampler(m_device, m_defaultSampler, nullptr);
@@ -55,6 +60,8 @@ DeviceImpl::~DeviceImpl()
 
     m_emptyFramebuffer = nullptr;
 
+    m_memoryAllocator.close();
+
     if (m_device != VK_NULL_HANDLE)
     {
         if (!m_desc.existingDeviceHandles.handles[2])
@@ -843,6 +850,11 @@ Result DeviceImpl::initVulkanInstanceAndDevice(const NativeHandle* handles, bool
             deviceExtensions.push_back(VK_NV_SHADER_SUBGROUP_PARTITIONED_EXTENSION_NAME);
             m_features.push_back("shader-subgroup-partitioned");
         }
+        if (extensionNames.count(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) && !handles[2])
+        {
+            deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            m_memoryBudgetEnabled = true;
+        }
 
         // Derive approximate DX12 shader model.
         const char* featureTable[] = {
@@ -1002,7 +1014,7 @@ Result DeviceImpl::initialize(const Desc& desc)
         initDeviceResult = m_api.initGlobalProcs(m_module);
         if (initDeviceResult != SLANG_OK)
             continue;
-        descriptorSetAllocator.m_api = &m_api;
+        descriptorSetAllocator.init(&m_api, &m_descriptorPoolCounters);
         initDeviceResult = initVulkanInstanceAndDevice(
             desc.existingDeviceHandles.handles,
             ENABLE_VALIDATION_LAYER != 0 || isRhiDebugLayerEnabled()
@@ -1018,6 +1030,14 @@ Result DeviceImpl::initialize(const Desc& desc)
         SLANG_RETURN_ON_FAIL(m_deviceQueue.init(m_api, queue, m_queueFamilyIndex));
     }
 
+    m_memoryAllocator.init(
+        &m_api,
+        m_api.m_extendedFeatures.vulkan12Features.bufferDeviceAddress,
+        m_memoryBudgetEnabled
+    );
+
+    SLANG_RETURN_ON_FAIL(initPipelineCache());
+
     SLANG_RETURN_ON_FAIL(slangContext.initialize(
         desc.slang,
         desc.extendedDescCount,
@@ -1062,6 +1082,86 @@ Result DeviceImpl::initialize(const Desc& desc)
     return SLANG_OK;
 }
 
+// The data returned by vkGetPipelineCacheData starts with a VkPipelineCacheHeaderVersionOne header.
+// Drivers are supposed to reject data from other devices, but some crash instead, so it is validated here first.
+static bool isPipelineCacheDataCompatible(const void* data, size_t size, const VkPhysicalDeviceProperties& properties)
+{
+    const size_t headerSize = 16 + VK_UUID_SIZE;
+    if (size < headerSize)
+        return false;
+    uint32_t header[4];
+    ::memcpy(header, data, sizeof(header));
+    return header[0] >= headerSize && header[0] <= size && header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header[2] == properties.vendorID && header[3] == properties.deviceID &&
+           ::memcmp((const uint8_t*)data + 16, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+ComPtr<ISlangBlob> DeviceImpl::getPipelineCacheKey()
+{
+    const auto& properties = m_api.m_deviceProperties;
+    std::string key = "VkPipelineCache";
+    key.append((const char*)&properties.vendorID, sizeof(properties.vendorID));
+    key.append((const char*)&properties.deviceID, sizeof(properties.deviceID));
+    key.append((const char*)&properties.driverVersion, sizeof(properties.driverVersion));
+    key.append((const char*)properties.pipelineCacheUUID, VK_UUID_SIZE);
+    return OwnedBlob::create(key.data(), key.size());
+}
+
+Result DeviceImpl::initPipelineCache()
+{
+    ComPtr<ISlangBlob> initialData;
+    if (persistentShaderCache && m_desc.persistentPipelineCache)
+    {
+        if (SLANG_SUCCEEDED(persistentShaderCache->queryCache(getPipelineCacheKey(), initialData.writeRef())) &&
+            !isPipelineCacheDataCompatible(
+                initialData->getBufferPointer(),
+                initialData->getBufferSize(),
+                m_api.m_deviceProperties
+            ))
+        {
+            initialData = nullptr;
+        }
+    }
+
+    VkPipelineCacheCreateInfo createInfo = {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    if (initialData)
+    {
+        createInfo.initialDataSize = initialData->getBufferSize();
+        createInfo.pInitialData = initialData->getBufferPointer();
+    }
+    if (m_api.vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_pipelineCache) != VK_SUCCESS && initialData)
+    {
+        // Retry without the stored data, in case the driver rejected it.
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        SLANG_VK_RETURN_ON_FAIL(m_api.vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_pipelineCache));
+    }
+    return SLANG_OK;
+}
+
+Result DeviceImpl::savePipelineCache()
+{
+    if (!persistentShaderCache || !m_desc.persistentPipelineCache || m_pipelineCache == VK_NULL_HANDLE)
+        return SLANG_E_NOT_AVAILABLE;
+    if (!m_pipelineCacheDirty.exchange(false))
+        return SLANG_OK;
+
+    // Pipelines can be created concurrently, which makes the cache grow between the two calls.
+    size_t size = 0;
+    std::vector<uint8_t> data;
+    VkResult result = VK_INCOMPLETE;
+    while (result == VK_INCOMPLETE)
+    {
+        SLANG_VK_RETURN_ON_FAIL(m_api.vkGetPipelineCacheData(m_device, m_pipelineCache, &size, nullptr));
+        data.resize(size);
+        result = m_api.vkGetPipelineCacheData(m_device, m_pipelineCache, &size, data.data());
+    }
+    SLANG_VK_RETURN_ON_FAIL(result);
+    if (!isPipelineCacheDataCompatible(data.data(), size, m_api.m_deviceProperties))
+        return SLANG_FAIL;
+    return persistentShaderCache->writeCache(getPipelineCacheKey(), OwnedBlob::create(data.data(), size));
+}
+
 void DeviceImpl::waitForGpu()
 {
     m_deviceQueue.flushAndWait();
@@ -1179,7 +1279,7 @@ Result DeviceImpl::readTexture(
 
     VKBufferHandleRAII staging;
     SLANG_RETURN_ON_FAIL(staging.init(
-        m_api,
+        m_memoryAllocator,
         bufferSize,
         VK_BUFFER_USAGE_TRANSFER_DST_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
@@ -1223,11 +1323,7 @@ Result DeviceImpl::readTexture(
     auto blob = OwnedBlob::create(bufferSize);
 
     // Write out the data from the buffer
-    void* mappedData = nullptr;
-    SLANG_RETURN_ON_FAIL(m_api.vkMapMemory(m_device, staging.m_memory, 0, bufferSize, 0, &mappedData));
-
-    ::memcpy((void*)blob->getBufferPointer(), mappedData, bufferSize);
-    m_api.vkUnmapMemory(m_device, staging.m_memory);
+    ::memcpy((void*)blob->getBufferPointer(), staging.getMappedData(), bufferSize);
 
     *outPixelSize = pixelSize;
     *outRowPitch = rowPitch;
@@ -1244,7 +1340,7 @@ Result DeviceImpl::readBuffer(IBuffer* inBuffer, Offset offset, Size size, ISlan
     VKBufferHandleRAII staging;
 
     SLANG_RETURN_ON_FAIL(staging.init(
-        m_api,
+        m_memoryAllocator,
         size,
         VK_BUFFER_USAGE_TRANSFER_DST_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
@@ -1263,11 +1359,7 @@ Result DeviceImpl::readBuffer(IBuffer* inBuffer, Offset offset, Size size, ISlan
     auto blob = OwnedBlob::create(size);
 
     // Write out the data from the buffer
-    void* mappedData = nullptr;
-    SLANG_RETURN_ON_FAIL(m_api.vkMapMemory(m_device, staging.m_memory, 0, size, 0, &mappedData));
-
-    ::memcpy((void*)blob->getBufferPointer(), mappedData, size);
-    m_api.vkUnmapMemory(m_device, staging.m_memory);
+    ::memcpy((void*)blob->getBufferPointer(), staging.getMappedData(), size);
 
     returnComPtr(outBlob, blob);
     return SLANG_OK;
@@ -1473,6 +1565,18 @@ Result DeviceImpl::getTextureAllocationInfo(const TextureDesc& descIn, Size* out
     return SLANG_OK;
 }
 
+Result DeviceImpl::getMemoryStats(DeviceMemoryStats* outStats)
+{
+    m_memoryAllocator.getStats(*outStats);
+    return SLANG_OK;
+}
+
+Result DeviceImpl::getDescriptorPoolStats(DescriptorPoolStats* outStats)
+{
+    m_descriptorPoolCounters.getStats(*outStats);
+    return SLANG_OK;
+}
+
 Result DeviceImpl::getTextureRowAlignment(Size* outAlignment)
 {
     *outAlignment = 1;
@@ -1566,40 +1670,21 @@ Result DeviceImpl::createTexture(const TextureDesc& descIn, const SubresourceDat
     m_api.vkGetImageMemoryRequirements(m_device, texture->m_image, &memRequirements);
 
     // Allocate the memory
-    VkMemoryPropertyFlags reqMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-    int memoryTypeIndex = m_api.findMemoryTypeIndex(memRequirements.memoryTypeBits, reqMemoryProperties);
-    SLANG_RHI_ASSERT(memoryTypeIndex >= 0);
-
-    VkMemoryPropertyFlags actualMemoryProperites =
-        m_api.m_deviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
-    VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = memoryTypeIndex;
-#if SLANG_WINDOWS_FAMILY
-    VkExportMemoryWin32HandleInfoKHR exportMemoryWin32HandleInfo = {
-        VK_STRUCTURE_TYPE_EXPORT_MEMORY_WIN32_HANDLE_INFO_KHR
-    };
-#endif
-    VkExportMemoryAllocateInfoKHR exportMemoryAllocateInfo = {VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO_KHR};
-    if (descIn.isShared)
-    {
-#if SLANG_WINDOWS_FAMILY
-        exportMemoryWin32HandleInfo.pNext = nullptr;
-        exportMemoryWin32HandleInfo.pAttributes = nullptr;
-        exportMemoryWin32HandleInfo.dwAccess = DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE;
-        exportMemoryWin32HandleInfo.name = NULL;
-
-        exportMemoryAllocateInfo.pNext = extMemoryHandleType & VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT_KHR
-                                             ? &exportMemoryWin32HandleInfo
-                                             : nullptr;
-#endif
-        exportMemoryAllocateInfo.handleTypes = extMemoryHandleType;
-        allocInfo.pNext = &exportMemoryAllocateInfo;
-    }
-    SLANG_VK_RETURN_ON_FAIL(m_api.vkAllocateMemory(m_device, &allocInfo, nullptr, &texture->m_imageMemory));
+    SLANG_RETURN_ON_FAIL(m_memoryAllocator.allocate(
+        memRequirements,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        MemoryResourceKind::Optimal,
+        descIn.isShared ? extMemoryHandleType : 0,
+        texture->m_imageMemory
+    ));
 
     // Bind the memory to the image
-    m_api.vkBindImageMemory(m_device, texture->m_image, texture->m_imageMemory, 0);
+    SLANG_VK_RETURN_ON_FAIL(m_api.vkBindImageMemory(
+        m_device,
+        texture->m_image,
+        texture->m_imageMemory.memory,
+        texture->m_imageMemory.offset
+    ));
 
     if (desc.label && m_api.vkDebugMarkerSetObjectNameEXT)
     {
@@ -1639,7 +1724,7 @@ Result DeviceImpl::createTexture(const TextureDesc& descIn, const SubresourceDat
         bufferSize *= arraySize;
 
         SLANG_RETURN_ON_FAIL(uploadBuffer.init(
-            m_api,
+            m_memoryAllocator,
             bufferSize,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
@@ -1651,10 +1736,7 @@ Result DeviceImpl::createTexture(const TextureDesc& descIn, const SubresourceDat
         {
             int subResourceCounter = 0;
 
-            uint8_t* dstData;
-            m_api.vkMapMemory(m_device, uploadBuffer.m_memory, 0, bufferSize, 0, (void**)&dstData);
-            uint8_t* dstDataStart;
-            dstDataStart = dstData;
+            uint8_t* dstData = (uint8_t*)uploadBuffer.getMappedData();
 
             Offset dstSubresourceOffset = 0;
             for (int i = 0; i < arraySize; ++i)
@@ -1696,8 +1778,6 @@ Result DeviceImpl::createTexture(const TextureDesc& descIn, const SubresourceDat
                     dstSubresourceOffset += dstLayerSizeInBytes * mipSize.depth;
                 }
             }
-
-            m_api.vkUnmapMemory(m_device, uploadBuffer.m_memory);
         }
 
         _transitionImageLayout(
@@ -1892,6 +1972,7 @@ Result DeviceImpl::createBufferImpl(
     const Size bufferSize = desc.size;
 
     VkMemoryPropertyFlags reqMemoryProperties = 0;
+    VkMemoryPropertyFlags preferredMemoryProperties = 0;
 
     VkBufferUsageFlags usage = _calcBufferUsageFlags(desc.allowedStates) | additionalUsageFlag;
     if (m_api.m_extendedFeatures.vulkan12Features.bufferDeviceAddress)
@@ -1912,29 +1993,34 @@ Result DeviceImpl::createBufferImpl(
         desc.memoryType == MemoryType::ReadBack)
     {
         reqMemoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        // Constant buffers are written by the host and read by shaders, so prefer memory that is device local
+        // as well, if the device has any.
+        if (desc.allowedStates.contains(ResourceState::ConstantBuffer) && desc.memoryType != MemoryType::ReadBack)
+        {
+            preferredMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        }
     }
     else
     {
         reqMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
     }
 
-    RefPtr<BufferImpl> buffer(new BufferImpl(desc, this));
-    if (desc.isShared)
-    {
-        VkExternalMemoryHandleTypeFlagsKHR extMemHandleType
+    VkExternalMemoryHandleTypeFlagsKHR extMemHandleType
 #if SLANG_WINDOWS_FAMILY
-            = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT;
+        = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT;
 #else
-            = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+        = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
 #endif
-        SLANG_RETURN_ON_FAIL(
-            buffer->m_buffer.init(m_api, desc.size, usage, reqMemoryProperties, desc.isShared, extMemHandleType)
-        );
-    }
-    else
-    {
-        SLANG_RETURN_ON_FAIL(buffer->m_buffer.init(m_api, desc.size, usage, reqMemoryProperties));
-    }
+    RefPtr<BufferImpl> buffer(new BufferImpl(desc, this));
+    SLANG_RETURN_ON_FAIL(buffer->m_buffer.init(
+        m_memoryAllocator,
+        desc.size,
+        usage,
+        reqMemoryProperties,
+        desc.isShared,
+        extMemHandleType,
+        preferredMemoryProperties
+    ));
 
     if (desc.label && m_api.vkDebugMarkerSetObjectNameEXT)
     {
@@ -1951,16 +2037,13 @@ Result DeviceImpl::createBufferImpl(
         if (desc.memoryType == MemoryType::DeviceLocal)
         {
             SLANG_RETURN_ON_FAIL(buffer->m_uploadBuffer.init(
-                m_api,
+                m_memoryAllocator,
                 bufferSize,
                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
             ));
             // Copy into staging buffer
-            void* mappedData = nullptr;
-            SLANG_VK_CHECK(m_api.vkMapMemory(m_device, buffer->m_uploadBuffer.m_memory, 0, bufferSize, 0, &mappedData));
-            ::memcpy(mappedData, initData, bufferSize);
-            m_api.vkUnmapMemory(m_device, buffer->m_uploadBuffer.m_memory);
+            ::memcpy(buffer->m_uploadBuffer.getMappedData(), initData, bufferSize);
 
             // Copy from staging buffer to real buffer
             VkCommandBuffer commandBuffer = m_deviceQueue.getCommandBuffer();
@@ -1979,10 +2062,7 @@ Result DeviceImpl::createBufferImpl(
         else
         {
             // Copy into mapped buffer directly
-            void* mappedData = nullptr;
-            SLANG_VK_CHECK(m_api.vkMapMemory(m_device, buffer->m_buffer.m_memory, 0, bufferSize, 0, &mappedData));
-            ::memcpy(mappedData, initData, bufferSize);
-            m_api.vkUnmapMemory(m_device, buffer->m_buffer.m_memory);
+            ::memcpy(buffer->m_buffer.getMappedData(), initData, bufferSize);
         }
     }
 
@@ -2391,7 +2471,7 @@ Result DeviceImpl::createShaderProgram(
 )
 {
     RefPtr<ShaderProgramImpl> shaderProgram = new ShaderProgramImpl(this);
-    shaderProgram->init(desc);
+    shaderProgram->init(this, desc);
 
     m_deviceObjectsWithPotentialBackReferences.push_back(shaderProgram);
 
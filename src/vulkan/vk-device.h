@@ -98,6 +98,8 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL
     getTextureAllocationInfo(const TextureDesc& desc, Size* outSize, Size* outAlignment) override;
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL getMemoryStats(DeviceMemoryStats* outStats) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL getDescriptorPoolStats(DescriptorPoolStats* outStats) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL getTextureRowAlignment(Size* outAlignment) override;
 
     virtual SLANG_NO_THROW Result SLANG_MCALL createFence(const IFence::Desc& desc, IFence** outFence) override;
@@ -106,6 +108,8 @@ public:
     waitForFences(GfxCount fenceCount, IFence** fences, uint64_t* fenceValues, bool waitForAll, uint64_t timeout)
         override;
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL savePipelineCache() override;
+
     void waitForGpu();
 
     virtual SLANG_NO_THROW const DeviceInfo& SLANG_MCALL getDeviceInfo() const override;
@@ -154,6 +158,11 @@ public:
 
     uint32_t getQueueFamilyIndex(ICommandQueue::QueueType queueType);
 
+    // Creates `m_pipelineCache`, seeded with the data stored in the persistent shader cache.
+    Result initPipelineCache();
+    // Key of the pipeline cache data in the persistent shader cache, specific to the physical device and driver.
+    ComPtr<ISlangBlob> getPipelineCacheKey();
+
 public:
     // DeviceImpl members.
 
@@ -172,8 +181,15 @@ public:
 
     Desc m_desc;
 
+    // Statistics of the descriptor pools of the device and its transient heaps.
+    DescriptorPoolCounters m_descriptorPoolCounters;
     DescriptorSetAllocator descriptorSetAllocator;
 
+    // Allocator for the memory of all buffers and textures created by the device.
+    MemoryAllocator m_memoryAllocator;
+    // Set when VK_EXT_memory_budget is enabled on the device.
+    bool m_memoryBudgetEnabled = false;
+
     uint32_t m_queueAllocCount;
 
     // A list to hold objects that may have a strong back reference to the device
@@ -190,6 +206,11 @@ public:
 
     VkSampler m_defaultSampler;
 
+    // Driver cache used for creating all pipelines.
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+    // Set when pipelines were created since the pipeline cache was loaded or saved.
+    std::atomic<bool> m_pipelineCacheDirty = false;
+
     RefPtr<FramebufferImpl> m_emptyFramebuffer;
 };
 
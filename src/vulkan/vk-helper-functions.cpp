@@ -459,6 +459,122 @@ AdapterLUID getAdapterLUID(VulkanApi api, VkPhysicalDevice physicalDevice)
     return luid;
 }
 
+template<typename T>
+T* DescriptorWriteBatch::addWrite(
+    std::vector<T>& infos,
+    VkDescriptorSet set,
+    uint32_t binding,
+    VkDescriptorType type,
+    uint32_t count
+)
+{
+    if (count == 0)
+        return nullptr;
+
+    VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = set;
+    write.dstBinding = binding;
+    write.dstArrayElement = 0;
+    write.descriptorCount = count;
+    write.descriptorType = type;
+    writes.push_back(write);
+
+    size_t offset = infos.size();
+    infoOffsets.push_back(offset);
+    infos.resize(offset + count);
+    return infos.data() + offset;
+}
+
+VkDescriptorBufferInfo* DescriptorWriteBatch::addBufferWrite(
+    VkDescriptorSet set,
+    uint32_t binding,
+    VkDescriptorType type,
+    uint32_t count
+)
+{
+    return addWrite(bufferInfos, set, binding, type, count);
+}
+
+VkDescriptorImageInfo* DescriptorWriteBatch::addImageWrite(
+    VkDescriptorSet set,
+    uint32_t binding,
+    VkDescriptorType type,
+    uint32_t count
+)
+{
+    return addWrite(imageInfos, set, binding, type, count);
+}
+
+VkBufferView* DescriptorWriteBatch::addTexelBufferWrite(
+    VkDescriptorSet set,
+    uint32_t binding,
+    VkDescriptorType type,
+    uint32_t count
+)
+{
+    return addWrite(texelBufferViews, set, binding, type, count);
+}
+
+VkAccelerationStructureKHR* DescriptorWriteBatch::addAccelerationStructureWrite(
+    VkDescriptorSet set,
+    uint32_t binding,
+    VkDescriptorType type,
+    uint32_t count
+)
+{
+    return addWrite(accelerationStructures, set, binding, type, count);
+}
+
+void DescriptorWriteBatch::flush(const VulkanApi& api)
+{
+    if (!writes.empty())
+    {
+        // The info arrays are complete now, so the pointers into them stay valid.
+        accelerationStructureWrites.clear();
+        accelerationStructureWrites.reserve(writes.size());
+        for (size_t i = 0; i < writes.size(); ++i)
+        {
+            VkWriteDescriptorSet& write = writes[i];
+            size_t offset = infoOffsets[i];
+            switch (write.descriptorType)
+            {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                write.pBufferInfo = bufferInfos.data() + offset;
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                write.pTexelBufferView = texelBufferViews.data() + offset;
+                break;
+            case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+            {
+                VkWriteDescriptorSetAccelerationStructureKHR writeAS = {
+                    VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR
+                };
+                writeAS.accelerationStructureCount = write.descriptorCount;
+                writeAS.pAccelerationStructures = accelerationStructures.data() + offset;
+                accelerationStructureWrites.push_back(writeAS);
+                write.pNext = &accelerationStructureWrites.back();
+                break;
+            }
+            default:
+                write.pImageInfo = imageInfos.data() + offset;
+                break;
+            }
+        }
+        api.vkUpdateDescriptorSets(api.m_device, (uint32_t)writes.size(), writes.data(), 0, nullptr);
+    }
+
+    writes.clear();
+    infoOffsets.clear();
+    bufferInfos.clear();
+    imageInfos.clear();
+    texelBufferViews.clear();
+    accelerationStructures.clear();
+}
+
 } // namespace rhi::vk
 
 namespace rhi {
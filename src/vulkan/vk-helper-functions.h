@@ -122,6 +122,47 @@ struct BindingOffset : SimpleBindingOffset
     }
 };
 
+/// Descriptor writes collected while binding shader objects, applied with a single `vkUpdateDescriptorSets` call
+///
+/// Each write covers a whole binding range. The descriptor infos are stored in arrays owned by the batch, and the
+/// info pointers of the writes are only filled in by `flush`, so the arrays can grow while writes are added.
+struct DescriptorWriteBatch
+{
+    std::vector<VkWriteDescriptorSet> writes;
+    /// Index of the first info of each write, in the info array matching its descriptor type
+    std::vector<size_t> infoOffsets;
+
+    std::vector<VkDescriptorBufferInfo> bufferInfos;
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    std::vector<VkBufferView> texelBufferViews;
+    std::vector<VkAccelerationStructureKHR> accelerationStructures;
+    std::vector<VkWriteDescriptorSetAccelerationStructureKHR> accelerationStructureWrites;
+
+    /// Add a write of `count` descriptors and return the zero-initialized infos to fill in.
+    /// The returned pointer is only valid until the next write is added.
+    VkDescriptorBufferInfo* addBufferWrite(
+        VkDescriptorSet set,
+        uint32_t binding,
+        VkDescriptorType type,
+        uint32_t count
+    );
+    VkDescriptorImageInfo* addImageWrite(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, uint32_t count);
+    VkBufferView* addTexelBufferWrite(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, uint32_t count);
+    VkAccelerationStructureKHR* addAccelerationStructureWrite(
+        VkDescriptorSet set,
+        uint32_t binding,
+        VkDescriptorType type,
+        uint32_t count
+    );
+
+    /// Apply all writes and clear the batch
+    void flush(const VulkanApi& api);
+
+private:
+    template<typename T>
+    T* addWrite(std::vector<T>& infos, VkDescriptorSet set, uint32_t binding, VkDescriptorType type, uint32_t count);
+};
+
 /// Context information required when binding shader objects to the pipeline
 struct RootBindingContext
 {
@@ -137,6 +178,9 @@ struct RootBindingContext
     /// The descriptor sets that are being allocated and bound
     std::vector<VkDescriptorSet>* descriptorSets;
 
+    /// Writes to the descriptor sets, flushed once binding is complete
+    DescriptorWriteBatch* descriptorWrites;
+
     /// Information about all the push-constant ranges that should be bound
     span<const VkPushConstantRange> pushConstantRanges;
 };
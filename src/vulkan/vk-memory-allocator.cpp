@@ -0,0 +1,370 @@
+#include "vk-memory-allocator.h"
+#include "vk-util.h"
+
+#if SLANG_WINDOWS_FAMILY
+#include <dxgi1_2.h>
+#endif
+
+#include <algorithm>
+
+namespace rhi::vk {
+
+int BuddyAllocator::getOrder(VkDeviceSize size, VkDeviceSize alignment)
+{
+    VkDeviceSize rangeSize = std::max(size, alignment);
+    int order = 0;
+    while (getOrderSize(order) < rangeSize)
+        order++;
+    return order;
+}
+
+void BuddyAllocator::init(VkDeviceSize size)
+{
+    SLANG_RHI_ASSERT(size >= kMinAllocationSize && (size & (size - 1)) == 0);
+    int maxOrder = getOrder(size, 1);
+    m_size = size;
+    m_freeBytes = size;
+    m_freeRanges.clear();
+    m_freeRanges.resize(maxOrder + 1);
+    m_freeRanges[maxOrder].insert(0);
+}
+
+bool BuddyAllocator::allocate(int order, VkDeviceSize& outOffset)
+{
+    int freeOrder = order;
+    while (freeOrder < (int)m_freeRanges.size() && m_freeRanges[freeOrder].empty())
+        freeOrder++;
+    if (freeOrder >= (int)m_freeRanges.size())
+        return false;
+
+    auto it = m_freeRanges[freeOrder].begin();
+    VkDeviceSize offset = *it;
+    m_freeRanges[freeOrder].erase(it);
+
+    // Split the range down to the requested order, keeping the lower halves.
+    while (freeOrder > order)
+    {
+        freeOrder--;
+        m_freeRanges[freeOrder].insert(offset + getOrderSize(freeOrder));
+    }
+
+    m_freeBytes -= getOrderSize(order);
+    outOffset = offset;
+    return true;
+}
+
+void BuddyAllocator::free(VkDeviceSize offset, int order)
+{
+    m_freeBytes += getOrderSize(order);
+
+    int maxOrder = (int)m_freeRanges.size() - 1;
+    while (order < maxOrder)
+    {
+        VkDeviceSize buddyOffset = offset ^ getOrderSize(order);
+        auto it = m_freeRanges[order].find(buddyOffset);
+        if (it == m_freeRanges[order].end())
+            break;
+        m_freeRanges[order].erase(it);
+        offset = std::min(offset, buddyOffset);
+        order++;
+    }
+    m_freeRanges[order].insert(offset);
+}
+
+VkDeviceSize BuddyAllocator::getLargestFreeRange() const
+{
+    for (int order = (int)m_freeRanges.size() - 1; order >= 0; --order)
+    {
+        if (!m_freeRanges[order].empty())
+            return getOrderSize(order);
+    }
+    return 0;
+}
+
+void MemoryAllocator::init(const VulkanApi* api, bool bufferDeviceAddress, bool memoryBudget)
+{
+    m_api = api;
+    m_bufferDeviceAddress = bufferDeviceAddress;
+    m_memoryBudget = memoryBudget;
+
+    const VkPhysicalDeviceMemoryProperties& memoryProperties = api->m_deviceMemoryProperties;
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i)
+    {
+        VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size;
+        VkDeviceSize blockSize = kDefaultBlockSize;
+        while (blockSize > kMinBlockSize && blockSize > heapSize / 8)
+            blockSize /= 2;
+        m_blockSizes[i] = blockSize;
+    }
+}
+
+void MemoryAllocator::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& blocksOfType : m_blocks)
+    {
+        for (BlockList& blocks : blocksOfType)
+        {
+            for (const auto& block : blocks)
+            {
+                SLANG_RHI_ASSERT(block->m_allocator.isEmpty());
+                freeDeviceMemory(block->m_memory, block->m_allocator.getSize());
+            }
+            blocks.clear();
+        }
+    }
+}
+
+Result MemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    VkMemoryPropertyFlags properties,
+    MemoryResourceKind kind,
+    VkExternalMemoryHandleTypeFlags exportHandleTypes,
+    MemoryAllocation& outAllocation,
+    VkMemoryPropertyFlags preferredProperties
+)
+{
+    if (preferredProperties)
+    {
+        int memoryTypeIndex =
+            m_api->findMemoryTypeIndex(requirements.memoryTypeBits, properties | preferredProperties);
+        if (memoryTypeIndex >= 0 &&
+            SLANG_SUCCEEDED(
+                allocateFromMemoryType(memoryTypeIndex, requirements, kind, exportHandleTypes, outAllocation)
+            ))
+        {
+            return SLANG_OK;
+        }
+    }
+
+    int memoryTypeIndex = m_api->findMemoryTypeIndex(requirements.memoryTypeBits, properties);
+    if (memoryTypeIndex < 0)
+        return SLANG_FAIL;
+    return allocateFromMemoryType(memoryTypeIndex, requirements, kind, exportHandleTypes, outAllocation);
+}
+
+Result MemoryAllocator::allocateFromMemoryType(
+    uint32_t memoryTypeIndex,
+    const VkMemoryRequirements& requirements,
+    MemoryResourceKind kind,
+    VkExternalMemoryHandleTypeFlags exportHandleTypes,
+    MemoryAllocation& outAllocation
+)
+{
+    VkDeviceSize blockSize = m_blockSizes[memoryTypeIndex];
+    int order = BuddyAllocator::getOrder(requirements.size, requirements.alignment);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    MemoryAllocation allocation;
+    if (exportHandleTypes || BuddyAllocator::getOrderSize(order) > blockSize / 2)
+    {
+        SLANG_RETURN_ON_FAIL(allocateDeviceMemory(
+            memoryTypeIndex,
+            requirements.size,
+            kind,
+            exportHandleTypes,
+            allocation.memory,
+            allocation.mappedData
+        ));
+        allocation.size = requirements.size;
+    }
+    else
+    {
+        BlockList& blocks = m_blocks[memoryTypeIndex][size_t(kind)];
+        MemoryBlock* block = nullptr;
+        VkDeviceSize offset = 0;
+        for (const auto& candidate : blocks)
+        {
+            if (candidate->m_allocator.allocate(order, offset))
+            {
+                block = candidate.get();
+                m_stats.poolHitCount++;
+                break;
+            }
+        }
+        if (!block)
+        {
+            auto newBlock = std::make_unique<MemoryBlock>();
+            SLANG_RETURN_ON_FAIL(
+                allocateDeviceMemory(memoryTypeIndex, blockSize, kind, 0, newBlock->m_memory, newBlock->m_mappedData)
+            );
+            newBlock->m_memoryTypeIndex = memoryTypeIndex;
+            newBlock->m_kind = kind;
+            newBlock->m_allocator.init(blockSize);
+            newBlock->m_allocator.allocate(order, offset);
+            block = newBlock.get();
+            blocks.push_back(std::move(newBlock));
+        }
+
+        allocation.memory = block->m_memory;
+        allocation.offset = offset;
+        allocation.size = BuddyAllocator::getOrderSize(order);
+        allocation.mappedData = block->m_mappedData ? block->m_mappedData + offset : nullptr;
+        allocation.block = block;
+        m_stats.poolAllocationCount++;
+    }
+
+    m_stats.allocationCount++;
+    m_stats.bytesLive += allocation.size;
+    m_stats.bytesPeak = std::max(m_stats.bytesPeak, m_stats.bytesLive);
+    outAllocation = allocation;
+    return SLANG_OK;
+}
+
+void MemoryAllocator::free(MemoryAllocation& allocation)
+{
+    if (!allocation.memory)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytesLive -= allocation.size;
+
+    if (MemoryBlock* block = allocation.block)
+    {
+        block->m_allocator.free(allocation.offset, BuddyAllocator::getOrder(allocation.size, 1));
+        if (block->m_allocator.isEmpty())
+        {
+            // Keep one empty block per pool, so that repeatedly creating and destroying a single resource
+            // doesn't allocate device memory every time.
+            BlockList& blocks = m_blocks[block->m_memoryTypeIndex][size_t(block->m_kind)];
+            bool hasOtherEmptyBlock = std::any_of(
+                blocks.begin(),
+                blocks.end(),
+                [&](const auto& other) { return other.get() != block && other->m_allocator.isEmpty(); }
+            );
+            if (hasOtherEmptyBlock)
+            {
+                freeDeviceMemory(block->m_memory, block->m_allocator.getSize());
+                blocks.erase(std::find_if(
+                    blocks.begin(),
+                    blocks.end(),
+                    [&](const auto& other) { return other.get() == block; }
+                ));
+            }
+        }
+    }
+    else
+    {
+        freeDeviceMemory(allocation.memory, allocation.size);
+    }
+
+    allocation = {};
+}
+
+void MemoryAllocator::getStats(DeviceMemoryStats& outStats)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        outStats = m_stats;
+        for (const auto& blocksOfType : m_blocks)
+        {
+            for (const BlockList& blocks : blocksOfType)
+            {
+                for (const auto& block : blocks)
+                {
+                    outStats.bytesPooled += block->m_allocator.getFreeBytes();
+                    outStats.bytesLargestPooledRange =
+                        std::max(outStats.bytesLargestPooledRange, block->m_allocator.getLargestFreeRange());
+                }
+            }
+        }
+    }
+
+    const VkPhysicalDeviceMemoryProperties& memoryProperties = m_api->m_deviceMemoryProperties;
+    if (m_memoryBudget && m_api->vkGetPhysicalDeviceMemoryProperties2)
+    {
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT
+        };
+        VkPhysicalDeviceMemoryProperties2 properties = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2};
+        properties.pNext = &budgetProperties;
+        m_api->vkGetPhysicalDeviceMemoryProperties2(m_api->m_physicalDevice, &properties);
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i)
+            outStats.bytesBudget += budgetProperties.heapBudget[i];
+    }
+    else
+    {
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i)
+            outStats.bytesBudget += memoryProperties.memoryHeaps[i].size;
+    }
+}
+
+Result MemoryAllocator::allocateDeviceMemory(
+    uint32_t memoryTypeIndex,
+    VkDeviceSize size,
+    MemoryResourceKind kind,
+    VkExternalMemoryHandleTypeFlags exportHandleTypes,
+    VkDeviceMemory& outMemory,
+    uint8_t*& outMappedData
+)
+{
+    VkMemoryAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    allocateInfo.allocationSize = size;
+    allocateInfo.memoryTypeIndex = memoryTypeIndex;
+#if SLANG_WINDOWS_FAMILY
+    VkExportMemoryWin32HandleInfoKHR exportMemoryWin32HandleInfo = {
+        VK_STRUCTURE_TYPE_EXPORT_MEMORY_WIN32_HANDLE_INFO_KHR
+    };
+#endif
+    VkExportMemoryAllocateInfoKHR exportMemoryAllocateInfo = {VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO_KHR};
+    if (exportHandleTypes)
+    {
+#if SLANG_WINDOWS_FAMILY
+        exportMemoryWin32HandleInfo.pNext = nullptr;
+        exportMemoryWin32HandleInfo.pAttributes = nullptr;
+        exportMemoryWin32HandleInfo.dwAccess = DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE;
+        exportMemoryWin32HandleInfo.name = NULL;
+
+        exportMemoryAllocateInfo.pNext = exportHandleTypes & VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT_KHR
+                                             ? &exportMemoryWin32HandleInfo
+                                             : nullptr;
+#endif
+        exportMemoryAllocateInfo.handleTypes = exportHandleTypes;
+        allocateInfo.pNext = &exportMemoryAllocateInfo;
+    }
+    // Any buffer placed in the memory may need a device address.
+    VkMemoryAllocateFlagsInfo flagInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO};
+    if (kind == MemoryResourceKind::Linear && m_bufferDeviceAddress)
+    {
+        flagInfo.deviceMask = 1;
+        flagInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+
+        flagInfo.pNext = allocateInfo.pNext;
+        allocateInfo.pNext = &flagInfo;
+    }
+
+    // Running out of memory is not an error here, the caller may fall back to another memory type.
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkResult allocateResult = m_api->vkAllocateMemory(m_api->m_device, &allocateInfo, nullptr, &memory);
+    if (allocateResult != VK_SUCCESS)
+        return VulkanUtil::toResult(allocateResult);
+
+    void* mappedData = nullptr;
+    if (m_api->m_deviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags &
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        VkResult result = m_api->vkMapMemory(m_api->m_device, memory, 0, VK_WHOLE_SIZE, 0, &mappedData);
+        if (result != VK_SUCCESS)
+        {
+            m_api->vkFreeMemory(m_api->m_device, memory, nullptr);
+            return VulkanUtil::handleFail(result);
+        }
+    }
+
+    m_stats.bytesReserved += size;
+    m_stats.deviceAllocationCount++;
+    outMemory = memory;
+    outMappedData = (uint8_t*)mappedData;
+    return SLANG_OK;
+}
+
+void MemoryAllocator::freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size)
+{
+    // Freeing memory implicitly unmaps it.
+    m_api->vkFreeMemory(m_api->m_device, memory, nullptr);
+    m_stats.bytesReserved -= size;
+    m_stats.deviceAllocationCount--;
+}
+
+} // namespace rhi::vk
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "vk-api.h"
+
+#include "core/common.h"
+
+#include <slang-rhi.h>
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace rhi::vk {
+
+class MemoryBlock;
+
+/// Memory bound to a buffer or image.
+struct MemoryAllocation
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    /// Size of the memory range reserved for the allocation.
+    VkDeviceSize size = 0;
+    /// Host address of the allocation if it is in host visible memory, null otherwise.
+    uint8_t* mappedData = nullptr;
+    /// Block the allocation is placed in, null for dedicated allocations.
+    MemoryBlock* block = nullptr;
+};
+
+enum class MemoryResourceKind
+{
+    /// Buffers and linearly tiled images.
+    Linear,
+    /// Optimally tiled images.
+    Optimal,
+    Count,
+};
+
+/// Buddy allocator dividing a power of two sized range.
+///
+/// Ranges of order `k` are `kMinAllocationSize << k` bytes large and aligned to their size. Free ranges are kept
+/// sorted by offset, so allocations are packed towards the start of the range.
+class BuddyAllocator
+{
+public:
+    static constexpr VkDeviceSize kMinAllocationSize = 256;
+
+    /// Order of the smallest range that holds `size` bytes aligned to `alignment`.
+    static int getOrder(VkDeviceSize size, VkDeviceSize alignment);
+    static VkDeviceSize getOrderSize(int order) { return kMinAllocationSize << order; }
+
+    void init(VkDeviceSize size);
+
+    /// Allocate a range of the given order. Returns false if there is no free range large enough.
+    bool allocate(int order, VkDeviceSize& outOffset);
+    /// Free a range previously returned by `allocate`, merging it with its free buddies.
+    void free(VkDeviceSize offset, int order);
+
+    VkDeviceSize getSize() const { return m_size; }
+    VkDeviceSize getFreeBytes() const { return m_freeBytes; }
+    bool isEmpty() const { return m_freeBytes == m_size; }
+    /// Size of the largest free range, 0 if the allocator is full.
+    VkDeviceSize getLargestFreeRange() const;
+
+private:
+    VkDeviceSize m_size = 0;
+    VkDeviceSize m_freeBytes = 0;
+    // Offsets of the free ranges of each order.
+    std::vector<std::set<VkDeviceSize>> m_freeRanges;
+};
+
+/// Block of device memory divided between many resources.
+class MemoryBlock
+{
+public:
+    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    uint8_t* m_mappedData = nullptr;
+    uint32_t m_memoryTypeIndex = 0;
+    MemoryResourceKind m_kind = MemoryResourceKind::Linear;
+    BuddyAllocator m_allocator;
+};
+
+/// Allocator for the device memory backing buffers and textures.
+///
+/// Calling `vkAllocateMemory` for every resource is slow and quickly runs into `maxMemoryAllocationCount`.
+/// Instead, resources are placed in large blocks, kept in one pool per memory type, and each block is divided
+/// with a buddy allocator. Buddy ranges are aligned to their size, which satisfies any alignment the resource
+/// requires. Linear and optimally tiled resources are placed in separate pools, so they never share a
+/// `bufferImageGranularity` page.
+///
+/// Resources larger than half a block and resources with exported memory get a dedicated allocation.
+///
+/// Host visible memory is mapped once when it is allocated and stays mapped, so resources sharing a block can be
+/// mapped at the same time.
+class MemoryAllocator
+{
+public:
+    /// Blocks are 64 MB large, or an eighth of the memory heap size for small heaps, but at least 1 MB.
+    static constexpr VkDeviceSize kDefaultBlockSize = 64 * 1024 * 1024;
+    static constexpr VkDeviceSize kMinBlockSize = 1024 * 1024;
+
+    /// `bufferDeviceAddress` is set if buffers are created with `VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT`.
+    /// `memoryBudget` is set if `VK_EXT_memory_budget` is enabled on the device.
+    void init(const VulkanApi* api, bool bufferDeviceAddress, bool memoryBudget);
+    /// Release all memory blocks. Must be called before the device is destroyed.
+    void close();
+
+    /// Allocate memory for a resource. Memory with `exportHandleTypes` set always gets a dedicated allocation.
+    /// Memory types that also have `preferredProperties` are used if available and not out of memory.
+    Result allocate(
+        const VkMemoryRequirements& requirements,
+        VkMemoryPropertyFlags properties,
+        MemoryResourceKind kind,
+        VkExternalMemoryHandleTypeFlags exportHandleTypes,
+        MemoryAllocation& outAllocation,
+        VkMemoryPropertyFlags preferredProperties = 0
+    );
+    /// Free memory returned by `allocate` and reset the allocation.
+    void free(MemoryAllocation& allocation);
+
+    void getStats(DeviceMemoryStats& outStats);
+
+    const VulkanApi* getApi() const { return m_api; }
+
+private:
+    using BlockList = std::vector<std::unique_ptr<MemoryBlock>>;
+
+    Result allocateFromMemoryType(
+        uint32_t memoryTypeIndex,
+        const VkMemoryRequirements& requirements,
+        MemoryResourceKind kind,
+        VkExternalMemoryHandleTypeFlags exportHandleTypes,
+        MemoryAllocation& outAllocation
+    );
+    Result allocateDeviceMemory(
+        uint32_t memoryTypeIndex,
+        VkDeviceSize size,
+        MemoryResourceKind kind,
+        VkExternalMemoryHandleTypeFlags exportHandleTypes,
+        VkDeviceMemory& outMemory,
+        uint8_t*& outMappedData
+    );
+    void freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size);
+
+    const VulkanApi* m_api = nullptr;
+    bool m_bufferDeviceAddress = false;
+    bool m_memoryBudget = false;
+    VkDeviceSize m_blockSizes[VK_MAX_MEMORY_TYPES] = {};
+
+    std::mutex m_mutex;
+    BlockList m_blocks[VK_MAX_MEMORY_TYPES][size_t(MemoryResourceKind::Count)];
+    DeviceMemoryStats m_stats;
+};
+
+} // namespace rhi::vk
@@ -68,8 +68,6 @@ void PipelineImpl::init(const RayTracingPipelineDesc& inDesc)
 
 Result PipelineImpl::createVKGraphicsPipeline()
 {
-    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
-
     auto inputLayoutImpl = (InputLayoutImpl*)desc.graphics.inputLayout;
 
     // VertexBuffer/s
@@ -244,6 +242,7 @@ Result PipelineImpl::createVKGraphicsPipeline()
     {
         SLANG_RETURN_ON_FAIL(programImpl->compileShaders(m_device));
     }
+    ShaderCompilationTimer timer(m_device->m_shaderCompilationStats.pipelineCreation);
 
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
     pipelineInfo.stageCount = (uint32_t)programImpl->m_stageCreateInfos.size();
@@ -270,10 +269,15 @@ Result PipelineImpl::createVKGraphicsPipeline()
     }
     else
     {
-        SLANG_VK_RETURN_ON_FAIL(
-            m_device->m_api
-                .vkCreateGraphicsPipelines(m_device->m_device, pipelineCache, 1, &pipelineInfo, nullptr, &m_pipeline)
-        );
+        SLANG_VK_RETURN_ON_FAIL(m_device->m_api.vkCreateGraphicsPipelines(
+            m_device->m_device,
+            m_device->m_pipelineCache,
+            1,
+            &pipelineInfo,
+            nullptr,
+            &m_pipeline
+        ));
+        m_device->m_pipelineCacheDirty = true;
     }
 
     return SLANG_OK;
@@ -286,6 +290,7 @@ Result PipelineImpl::createVKComputePipeline()
     {
         SLANG_RETURN_ON_FAIL(programImpl->compileShaders(m_device));
     }
+    ShaderCompilationTimer timer(m_device->m_shaderCompilationStats.pipelineCreation);
 
     VkComputePipelineCreateInfo computePipelineInfo = {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
     computePipelineInfo.stage = programImpl->m_stageCreateInfos[0];
@@ -302,15 +307,15 @@ Result PipelineImpl::createVKComputePipeline()
     }
     else
     {
-        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
         SLANG_VK_RETURN_ON_FAIL(m_device->m_api.vkCreateComputePipelines(
             m_device->m_device,
-            pipelineCache,
+            m_device->m_pipelineCache,
             1,
             &computePipelineInfo,
             nullptr,
             &m_pipeline
         ));
+        m_device->m_pipelineCacheDirty = true;
     }
     return SLANG_OK;
 }
@@ -364,6 +369,7 @@ Result RayTracingPipelineImpl::createVKRayTracingPipeline()
     {
         SLANG_RETURN_ON_FAIL(programImpl->compileShaders(m_device));
     }
+    ShaderCompilationTimer timer(m_device->m_shaderCompilationStats.pipelineCreation);
 
     VkRayTracingPipelineCreateInfoKHR raytracingPipelineInfo = {VK_STRUCTURE_TYPE_RAY_TRACING_PIPELINE_CREATE_INFO_KHR};
     raytracingPipelineInfo.pNext = nullptr;
@@ -451,16 +457,16 @@ Result RayTracingPipelineImpl::createVKRayTracingPipeline()
         );
     }
 
-    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
     SLANG_VK_RETURN_ON_FAIL(m_device->m_api.vkCreateRayTracingPipelinesKHR(
         m_device->m_device,
         VK_NULL_HANDLE,
-        pipelineCache,
+        m_device->m_pipelineCache,
         1,
         &raytracingPipelineInfo,
         nullptr,
         &m_pipeline
     ));
+    m_device->m_pipelineCacheDirty = true;
     shaderGroupCount = shaderGroupInfos.size();
 
     if (m_device->m_pipelineCreationAPIDispatcher)
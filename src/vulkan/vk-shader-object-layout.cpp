@@ -640,6 +640,7 @@ Result ShaderObjectLayoutImpl::_init(Builder const* builder)
                 .vkCreateDescriptorSetLayout(renderer->m_api.m_device, &createInfo, nullptr, &vkDescSetLayout)
         );
         descriptorSetInfo.descriptorSetLayout = vkDescSetLayout;
+        descriptorSetInfo.descriptorSetLayoutId = DescriptorSetAllocator::createLayoutId();
     }
     return SLANG_OK;
 }
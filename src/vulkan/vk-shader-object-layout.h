@@ -126,6 +126,8 @@ public:
         std::vector<VkDescriptorSetLayoutBinding> vkBindings;
         int32_t space = -1;
         VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        /// Identifies the layout in `DescriptorSetAllocator`.
+        uint64_t descriptorSetLayoutId = 0;
     };
 
     struct Builder
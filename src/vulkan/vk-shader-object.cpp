@@ -1,4 +1,5 @@
 #include "vk-shader-object.h"
+#include "vk-buffer.h"
 #include "vk-command-buffer.h"
 #include "vk-command-encoder.h"
 #include "vk-transient-heap.h"
@@ -66,6 +67,7 @@ Result ShaderObjectImpl::setData(ShaderOffset const& inOffset, void const* data,
     memcpy(dest + offset, data, size);
 
     m_isConstantBufferDirty = true;
+    m_cachedDescriptorSet = VK_NULL_HANDLE;
 
     return SLANG_OK;
 }
@@ -78,6 +80,7 @@ Result ShaderObjectImpl::setResource(ShaderOffset const& offset, IResourceView*
     if (offset.bindingRangeIndex >= layout->getBindingRangeCount())
         return SLANG_E_INVALID_ARG;
     auto& bindingRange = layout->getBindingRange(offset.bindingRangeIndex);
+    m_cachedDescriptorSet = VK_NULL_HANDLE;
     if (!resourceView)
     {
         m_resourceViews[bindingRange.baseIndex + offset.bindingArrayIndex] = nullptr;
@@ -108,6 +111,7 @@ Result ShaderObjectImpl::setSampler(ShaderOffset const& offset, ISampler* sample
     auto& bindingRange = layout->getBindingRange(offset.bindingRangeIndex);
 
     m_samplers[bindingRange.baseIndex + offset.bindingArrayIndex] = static_cast<SamplerImpl*>(sampler);
+    m_cachedDescriptorSet = VK_NULL_HANDLE;
     return SLANG_OK;
 }
 
@@ -127,16 +131,25 @@ Result ShaderObjectImpl::setCombinedTextureSampler(
     auto& slot = m_combinedTextureSamplers[bindingRange.baseIndex + offset.bindingArrayIndex];
     slot.textureView = static_cast<TextureViewImpl*>(textureView);
     slot.sampler = static_cast<SamplerImpl*>(sampler);
+    m_cachedDescriptorSet = VK_NULL_HANDLE;
     return SLANG_OK;
 }
 
+Result ShaderObjectImpl::setObject(ShaderOffset const& offset, IShaderObject* object)
+{
+    m_cachedDescriptorSet = VK_NULL_HANDLE;
+    return ShaderObjectBaseImpl::setObject(offset, object);
+}
+
 Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* layout)
 {
     m_layout = layout;
+    resetSpecializationCache();
 
     m_constantBufferTransientHeap = nullptr;
     m_constantBufferTransientHeapVersion = 0;
     m_isConstantBufferDirty = true;
+    m_cachedDescriptorSet = VK_NULL_HANDLE;
 
     // If the layout tells us that there is any uniform data,
     // then we will allocate a CPU memory buffer to hold that data
@@ -175,7 +188,7 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* layout)
     // we need to size the array to account for them.
     //
     Index subObjectCount = layout->getSubObjectCount();
-    m_objects.resize(subObjectCount);
+    resizeSubObjects(subObjectCount);
 
     for (auto subObjectRangeInfo : layout->getSubObjectRanges())
     {
@@ -199,7 +212,7 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* layout)
         {
             RefPtr<ShaderObjectImpl> subObject;
             SLANG_RETURN_ON_FAIL(ShaderObjectImpl::create(device, subObjectLayout, subObject.writeRef()));
-            m_objects[bindingRangeInfo.subObjectIndex + i] = subObject;
+            setSubObject(bindingRangeInfo.subObjectIndex + i, subObject);
         }
     }
 
@@ -220,7 +233,13 @@ Result ShaderObjectImpl::_writeOrdinaryData(
 
     SLANG_RHI_ASSERT(srcSize <= destSize);
 
-    encoder->uploadBufferDataImpl(buffer, offset, srcSize, src);
+    // Ordinary data buffers are allocated from the transient heap in host visible memory that stays mapped,
+    // so the data can be written in place without a staging copy.
+    auto bufferImpl = static_cast<BufferImpl*>(buffer);
+    if (auto mappedData = (uint8_t*)bufferImpl->m_buffer.getMappedData())
+        memcpy(mappedData + offset, src, srcSize);
+    else
+        encoder->uploadBufferDataImpl(buffer, offset, srcSize, src);
 
     // In the case where this object has any sub-objects of
     // existential/interface type, we need to recurse on those objects
@@ -310,12 +329,6 @@ Result ShaderObjectImpl::_writeOrdinaryData(
     return SLANG_OK;
 }
 
-void ShaderObjectImpl::writeDescriptor(RootBindingContext& context, VkWriteDescriptorSet const& write)
-{
-    auto device = context.device;
-    device->m_api.vkUpdateDescriptorSets(device->m_device, 1, &write, 0, nullptr);
-}
-
 void ShaderObjectImpl::writeBufferDescriptor(
     RootBindingContext& context,
     BindingOffset const& offset,
@@ -327,24 +340,14 @@ void ShaderObjectImpl::writeBufferDescriptor(
 {
     auto descriptorSet = (*context.descriptorSets)[offset.bindingSet];
 
-    VkDescriptorBufferInfo bufferInfo = {};
+    VkDescriptorBufferInfo* bufferInfo =
+        context.descriptorWrites->addBufferWrite(descriptorSet, offset.binding, descriptorType, 1);
     if (buffer)
     {
-        bufferInfo.buffer = buffer->m_buffer.m_buffer;
+        bufferInfo->buffer = buffer->m_buffer.m_buffer;
     }
-    bufferInfo.offset = bufferOffset;
-    bufferInfo.range = bufferSize;
-
-    VkWriteDescriptorSet write = {};
-    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    write.descriptorCount = 1;
-    write.descriptorType = descriptorType;
-    write.dstArrayElement = 0;
-    write.dstBinding = offset.binding;
-    write.dstSet = descriptorSet;
-    write.pBufferInfo = &bufferInfo;
-
-    writeDescriptor(context, write);
+    bufferInfo->offset = bufferOffset;
+    bufferInfo->range = bufferSize;
 }
 
 void ShaderObjectImpl::writeBufferDescriptor(
@@ -366,10 +369,12 @@ void ShaderObjectImpl::writePlainBufferDescriptor(
 {
     auto descriptorSet = (*context.descriptorSets)[offset.bindingSet];
 
-    Index count = resourceViews.size();
-    for (Index i = 0; i < count; ++i)
+    uint32_t count = (uint32_t)resourceViews.size();
+    VkDescriptorBufferInfo* bufferInfos =
+        context.descriptorWrites->addBufferWrite(descriptorSet, offset.binding, descriptorType, count);
+    for (uint32_t i = 0; i < count; ++i)
     {
-        VkDescriptorBufferInfo bufferInfo = {};
+        VkDescriptorBufferInfo& bufferInfo = bufferInfos[i];
         bufferInfo.range = VK_WHOLE_SIZE;
 
         if (resourceViews[i])
@@ -383,17 +388,6 @@ void ShaderObjectImpl::writePlainBufferDescriptor(
                 bufferInfo.range = bufferView->size;
             }
         }
-
-        VkWriteDescriptorSet write = {};
-        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        write.descriptorCount = 1;
-        write.descriptorType = descriptorType;
-        write.dstArrayElement = uint32_t(i);
-        write.dstBinding = offset.binding;
-        write.dstSet = descriptorSet;
-        write.pBufferInfo = &bufferInfo;
-
-        writeDescriptor(context, write);
     }
 }
 
@@ -406,28 +400,20 @@ void ShaderObjectImpl::writeTexelBufferDescriptor(
 {
     auto descriptorSet = (*context.descriptorSets)[offset.bindingSet];
 
-    Index count = resourceViews.size();
-    for (Index i = 0; i < count; ++i)
+    uint32_t count = (uint32_t)resourceViews.size();
+    VkBufferView* bufferViews =
+        context.descriptorWrites->addTexelBufferWrite(descriptorSet, offset.binding, descriptorType, count);
+    for (uint32_t i = 0; i < count; ++i)
     {
-        VkBufferView bufferView = VK_NULL_HANDLE;
         if (resourceViews[i])
         {
             auto boundViewType = static_cast<ResourceViewImpl*>(resourceViews[i].Ptr())->m_type;
             if (boundViewType == ResourceViewImpl::ViewType::TexelBuffer)
             {
                 auto resourceView = static_cast<TexelBufferViewImpl*>(resourceViews[i].Ptr());
-                bufferView = resourceView->m_view;
+                bufferViews[i] = resourceView->m_view;
             }
         }
-        VkWriteDescriptorSet write = {};
-        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        write.descriptorType = descriptorType;
-        write.dstArrayElement = uint32_t(i);
-        write.dstBinding = offset.binding;
-        write.dstSet = descriptorSet;
-        write.descriptorCount = 1;
-        write.pTexelBufferView = &bufferView;
-        writeDescriptor(context, write);
     }
 }
 
@@ -440,12 +426,14 @@ void ShaderObjectImpl::writeTextureSamplerDescriptor(
 {
     auto descriptorSet = (*context.descriptorSets)[offset.bindingSet];
 
-    Index count = slots.size();
-    for (Index i = 0; i < count; ++i)
+    uint32_t count = (uint32_t)slots.size();
+    VkDescriptorImageInfo* imageInfos =
+        context.descriptorWrites->addImageWrite(descriptorSet, offset.binding, descriptorType, count);
+    for (uint32_t i = 0; i < count; ++i)
     {
         auto texture = slots[i].textureView;
         auto sampler = slots[i].sampler;
-        VkDescriptorImageInfo imageInfo = {};
+        VkDescriptorImageInfo& imageInfo = imageInfos[i];
         if (texture)
         {
             imageInfo.imageView = texture->m_view;
@@ -459,17 +447,6 @@ void ShaderObjectImpl::writeTextureSamplerDescriptor(
         {
             imageInfo.sampler = context.device->m_defaultSampler;
         }
-
-        VkWriteDescriptorSet write = {};
-        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        write.descriptorCount = 1;
-        write.descriptorType = descriptorType;
-        write.dstArrayElement = uint32_t(i);
-        write.dstBinding = offset.binding;
-        write.dstSet = descriptorSet;
-        write.pImageInfo = &imageInfo;
-
-        writeDescriptor(context, write);
     }
 }
 
@@ -482,32 +459,13 @@ void ShaderObjectImpl::writeAccelerationStructureDescriptor(
 {
     auto descriptorSet = (*context.descriptorSets)[offset.bindingSet];
 
-    Index count = resourceViews.size();
-    for (Index i = 0; i < count; ++i)
+    uint32_t count = (uint32_t)resourceViews.size();
+    VkAccelerationStructureKHR* accelerationStructures =
+        context.descriptorWrites->addAccelerationStructureWrite(descriptorSet, offset.binding, descriptorType, count);
+    for (uint32_t i = 0; i < count; ++i)
     {
         auto accelerationStructure = static_cast<AccelerationStructureImpl*>(resourceViews[i].Ptr());
-        VkWriteDescriptorSetAccelerationStructureKHR writeAS = {};
-        writeAS.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
-        VkAccelerationStructureKHR nullHandle = VK_NULL_HANDLE;
-        if (accelerationStructure)
-        {
-            writeAS.accelerationStructureCount = 1;
-            writeAS.pAccelerationStructures = &accelerationStructure->m_vkHandle;
-        }
-        else
-        {
-            writeAS.accelerationStructureCount = 1;
-            writeAS.pAccelerationStructures = &nullHandle;
-        }
-        VkWriteDescriptorSet write = {};
-        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        write.descriptorCount = 1;
-        write.descriptorType = descriptorType;
-        write.dstArrayElement = uint32_t(i);
-        write.dstBinding = offset.binding;
-        write.dstSet = descriptorSet;
-        write.pNext = &writeAS;
-        writeDescriptor(context, write);
+        accelerationStructures[i] = accelerationStructure ? accelerationStructure->m_vkHandle : VK_NULL_HANDLE;
     }
 }
 
@@ -520,32 +478,21 @@ void ShaderObjectImpl::writeTextureDescriptor(
 {
     auto descriptorSet = (*context.descriptorSets)[offset.bindingSet];
 
-    Index count = resourceViews.size();
-    for (Index i = 0; i < count; ++i)
+    uint32_t count = (uint32_t)resourceViews.size();
+    VkDescriptorImageInfo* imageInfos =
+        context.descriptorWrites->addImageWrite(descriptorSet, offset.binding, descriptorType, count);
+    for (uint32_t i = 0; i < count; ++i)
     {
-        VkDescriptorImageInfo imageInfo = {};
         if (resourceViews[i])
         {
             auto boundViewType = static_cast<ResourceViewImpl*>(resourceViews[i].Ptr())->m_type;
             if (boundViewType == ResourceViewImpl::ViewType::Texture)
             {
                 auto texture = static_cast<TextureViewImpl*>(resourceViews[i].Ptr());
-                imageInfo.imageView = texture->m_view;
-                imageInfo.imageLayout = texture->m_layout;
+                imageInfos[i].imageView = texture->m_view;
+                imageInfos[i].imageLayout = texture->m_layout;
             }
         }
-        imageInfo.sampler = 0;
-
-        VkWriteDescriptorSet write = {};
-        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        write.descriptorCount = 1;
-        write.descriptorType = descriptorType;
-        write.dstArrayElement = uint32_t(i);
-        write.dstBinding = offset.binding;
-        write.dstSet = descriptorSet;
-        write.pImageInfo = &imageInfo;
-
-        writeDescriptor(context, write);
     }
 }
 
@@ -558,12 +505,13 @@ void ShaderObjectImpl::writeSamplerDescriptor(
 {
     auto descriptorSet = (*context.descriptorSets)[offset.bindingSet];
 
-    Index count = samplers.size();
-    for (Index i = 0; i < count; ++i)
+    uint32_t count = (uint32_t)samplers.size();
+    VkDescriptorImageInfo* imageInfos =
+        context.descriptorWrites->addImageWrite(descriptorSet, offset.binding, descriptorType, count);
+    for (uint32_t i = 0; i < count; ++i)
     {
         auto sampler = samplers[i];
-        VkDescriptorImageInfo imageInfo = {};
-        imageInfo.imageView = 0;
+        VkDescriptorImageInfo& imageInfo = imageInfos[i];
         imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
         if (sampler)
         {
@@ -573,17 +521,6 @@ void ShaderObjectImpl::writeSamplerDescriptor(
         {
             imageInfo.sampler = context.device->m_defaultSampler;
         }
-
-        VkWriteDescriptorSet write = {};
-        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        write.descriptorCount = 1;
-        write.descriptorType = descriptorType;
-        write.dstArrayElement = uint32_t(i);
-        write.dstBinding = offset.binding;
-        write.dstSet = descriptorSet;
-        write.pImageInfo = &imageInfo;
-
-        writeDescriptor(context, write);
     }
 }
 
@@ -871,8 +808,13 @@ Result ShaderObjectImpl::allocateDescriptorSets(
     //
     for (auto descriptorSetInfo : specializedLayout->getOwnDescriptorSets())
     {
-        auto descriptorSetHandle =
-            context.descriptorSetAllocator->allocate(descriptorSetInfo.descriptorSetLayout).handle;
+        auto descriptorSetHandle = context.descriptorSetAllocator
+                                       ->allocate(
+                                           descriptorSetInfo.descriptorSetLayout,
+                                           descriptorSetInfo.descriptorSetLayoutId,
+                                           descriptorSetInfo.vkBindings
+                                       )
+                                       .handle;
 
         // For each set, we need to write it into the set of descriptor sets
         // being used for binding. This is done both so that other steps
@@ -902,6 +844,21 @@ Result ShaderObjectImpl::bindAsParameterBlock(
     offset.bindingSet = (uint32_t)context.descriptorSets->size();
     offset.binding = 0;
 
+    // A parameter block without sub-objects fills a single descriptor set from its own state only. That set
+    // can be bound again as is, as long as the object is unchanged and the transient heap holding the set and
+    // the ordinary data buffer has not been reset.
+    //
+    TransientResourceHeapImpl* transientHeap = encoder->m_commandBuffer->m_transientHeap;
+    bool canCacheDescriptorSet =
+        specializedLayout->getSubObjectRanges().empty() && specializedLayout->getOwnDescriptorSets().size() == 1;
+    if (canCacheDescriptorSet && m_cachedDescriptorSet != VK_NULL_HANDLE &&
+        m_cachedDescriptorSetLayout == specializedLayout && m_cachedDescriptorSetTransientHeap == transientHeap &&
+        m_cachedDescriptorSetTransientHeapVersion == transientHeap->getVersion())
+    {
+        context.descriptorSets->push_back(m_cachedDescriptorSet);
+        return SLANG_OK;
+    }
+
     // TODO: We should also be writing to `offset.pending` here,
     // because any resource/sampler bindings related to "pending"
     // data should *also* be writing into the chosen set.
@@ -919,6 +876,14 @@ Result ShaderObjectImpl::bindAsParameterBlock(
     SLANG_RHI_ASSERT(offset.bindingSet < (uint32_t)context.descriptorSets->size());
     SLANG_RETURN_ON_FAIL(bindAsConstantBuffer(encoder, context, offset, specializedLayout));
 
+    if (canCacheDescriptorSet)
+    {
+        m_cachedDescriptorSet = (*context.descriptorSets)[offset.bindingSet];
+        m_cachedDescriptorSetLayout = specializedLayout;
+        m_cachedDescriptorSetTransientHeap = transientHeap;
+        m_cachedDescriptorSetTransientHeapVersion = transientHeap->getVersion();
+    }
+
     return SLANG_OK;
 }
 
@@ -1181,11 +1146,25 @@ Result RootShaderObjectImpl::collectSpecializationArgs(ExtendedShaderObjectTypeL
     SLANG_RETURN_ON_FAIL(ShaderObjectImpl::collectSpecializationArgs(args));
     for (auto& entryPoint : m_entryPoints)
     {
-        SLANG_RETURN_ON_FAIL(entryPoint->collectSpecializationArgs(args));
+        const ExtendedShaderObjectTypeList* entryPointArgs;
+        SLANG_RETURN_ON_FAIL(entryPoint->getSpecializationArgs(entryPointArgs));
+        args.addRange(*entryPointArgs);
     }
     return SLANG_OK;
 }
 
+bool RootShaderObjectImpl::isSpecializationDirty()
+{
+    if (ShaderObjectImpl::isSpecializationDirty())
+        return true;
+    for (auto& entryPoint : m_entryPoints)
+    {
+        if (entryPoint->isSpecializationDirty())
+            return true;
+    }
+    return false;
+}
+
 Result RootShaderObjectImpl::init(IDevice* device, RootShaderObjectLayout* layout)
 {
     SLANG_RETURN_ON_FAIL(Super::init(device, layout));
@@ -44,6 +44,8 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL
     setCombinedTextureSampler(ShaderOffset const& offset, IResourceView* textureView, ISampler* sampler) override;
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL setObject(ShaderOffset const& offset, IShaderObject* object) override;
+
 protected:
     friend class RootShaderObjectLayout;
 
@@ -60,9 +62,6 @@ protected:
     );
 
 public:
-    /// Write a single descriptor using the Vulkan API
-    static void writeDescriptor(RootBindingContext& context, VkWriteDescriptorSet const& write);
-
     static void writeBufferDescriptor(
         RootBindingContext& context,
         BindingOffset const& offset,
@@ -196,6 +195,16 @@ public:
     /// The version of the transient heap when the constant buffer is allocated.
     uint64_t m_constantBufferTransientHeapVersion;
 
+    /// Descriptor set written when this object was last bound as a parameter block.
+    /// It is reused until the object is modified or the transient heap it was allocated from is reset.
+    VkDescriptorSet m_cachedDescriptorSet = VK_NULL_HANDLE;
+    /// The specialized layout the cached descriptor set was written for.
+    ShaderObjectLayoutImpl* m_cachedDescriptorSetLayout = nullptr;
+    /// The transient heap from which the cached descriptor set is allocated.
+    TransientResourceHeapImpl* m_cachedDescriptorSetTransientHeap = nullptr;
+    /// The version of the transient heap when the cached descriptor set is allocated.
+    uint64_t m_cachedDescriptorSetTransientHeapVersion = 0;
+
     /// Get the layout of this shader object with specialization arguments considered
     ///
     /// This operation should only be called after the shader object has been
@@ -260,6 +269,7 @@ public:
     Result bindAsRoot(CommandEncoderImpl* encoder, RootBindingContext& context, RootShaderObjectLayout* layout);
 
     virtual Result collectSpecializationArgs(ExtendedShaderObjectTypeList& args) override;
+    virtual bool isSpecializationDirty() override;
 
 public:
     Result init(IDevice* device, RootShaderObjectLayout* layout);
@@ -13,8 +13,8 @@ TextureImpl::~TextureImpl()
     auto& vkAPI = m_device->m_api;
     if (!m_isWeakImageReference)
     {
-        vkAPI.vkFreeMemory(vkAPI.m_device, m_imageMemory, nullptr);
         vkAPI.vkDestroyImage(vkAPI.m_device, m_image, nullptr);
+        m_device->m_memoryAllocator.free(m_imageMemory);
     }
     if (sharedHandle)
     {
@@ -45,7 +45,7 @@ Result TextureImpl::getSharedHandle(NativeHandle* outHandle)
     VkMemoryGetWin32HandleInfoKHR info = {};
     info.sType = VK_STRUCTURE_TYPE_MEMORY_GET_WIN32_HANDLE_INFO_KHR;
     info.pNext = nullptr;
-    info.memory = m_imageMemory;
+    info.memory = m_imageMemory.memory;
     info.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT;
 
     auto& api = m_device->m_api;
@@ -61,7 +61,7 @@ Result TextureImpl::getSharedHandle(NativeHandle* outHandle)
     VkMemoryGetFdInfoKHR info = {};
     info.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
     info.pNext = nullptr;
-    info.memory = m_imageMemory;
+    info.memory = m_imageMemory.memory;
     info.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
 
     auto& api = m_device->m_api;
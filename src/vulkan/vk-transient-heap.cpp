@@ -21,7 +21,7 @@ Result TransientResourceHeapImpl::init(const ITransientResourceHeap::Desc& desc,
 {
     Super::init(desc, (uint32_t)device->m_api.m_deviceProperties.limits.minUniformBufferOffsetAlignment, device);
 
-    m_descSetAllocator.m_api = &device->m_api;
+    m_descSetAllocator.init(&device->m_api, &device->m_descriptorPoolCounters);
 
     VkCommandPoolCreateInfo poolCreateInfo = {};
     poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -35,6 +35,10 @@ Result TransientResourceHeapImpl::init(const ITransientResourceHeap::Desc& desc,
 
 TransientResourceHeapImpl::~TransientResourceHeapImpl()
 {
+    // Staging buffers go back to the device for reuse, so the GPU must be done with them.
+    auto& api = m_device->m_api;
+    if (!m_fences.empty())
+        api.vkWaitForFences(api.m_device, (uint32_t)m_fences.size(), m_fences.data(), 1, UINT64_MAX);
     m_commandBufferPool = decltype(m_commandBufferPool)();
     m_device->m_api.vkDestroyCommandPool(m_device->m_api.m_device, m_commandPool, nullptr);
     for (auto fence : m_fences)
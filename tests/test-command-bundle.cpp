@@ -0,0 +1,216 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// A bundle is recorded once and executed by reference from several command buffers.
+
+void testCommandBundle(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-mutable-shader-object", "computeMain", slangReflection)
+    );
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::UnorderedAccess, ResourceState::CopySource);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    REQUIRE_CALL(device->createBufferView(buffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    slang::TypeReflection* transformerType = slangReflection->findTypeByName("AddTransformer");
+    ComPtr<IShaderObject> transformer;
+    REQUIRE_CALL(
+        device->createShaderObject(transformerType, ShaderObjectContainerType::None, transformer.writeRef())
+    );
+    float c = 1.0f;
+    ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+
+    // Record a bundle that adds 1 to every element.
+    ComPtr<ICommandBuffer> bundle = transientHeap->createCommandBuffer();
+    ComPtr<ICommandBufferImmediate> bundleImmediate;
+    REQUIRE_CALL(bundle->queryInterface(ICommandBufferImmediate::getTypeGuid(), (void**)bundleImmediate.writeRef()));
+    REQUIRE_CALL(bundleImmediate->beginBundle());
+    {
+        auto encoder = bundle->encodeComputeCommands();
+        auto rootObject = encoder->bindPipeline(pipeline);
+        ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+        entryPointCursor.getPath("buffer").setResource(bufferView);
+        entryPointCursor.getPath("transformer").setObject(transformer);
+        encoder->dispatchCompute(1, 1, 1);
+        encoder->endEncoding();
+    }
+    bundle->close();
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    auto executeBundle = [&](int count)
+    {
+        ComPtr<ICommandBuffer> commandBuffer = transientHeap->createCommandBuffer();
+        ComPtr<ICommandBufferImmediate> commandBufferImmediate;
+        REQUIRE_CALL(commandBuffer->queryInterface(
+            ICommandBufferImmediate::getTypeGuid(),
+            (void**)commandBufferImmediate.writeRef()
+        ));
+        for (int i = 0; i < count; i++)
+            REQUIRE_CALL(commandBufferImmediate->executeBundle(bundle));
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    };
+
+    executeBundle(1);
+    compareComputeResult(device, buffer, makeArray<float>(1.0f, 2.0f, 3.0f, 4.0f));
+
+    executeBundle(1);
+    compareComputeResult(device, buffer, makeArray<float>(2.0f, 3.0f, 4.0f, 5.0f));
+
+    executeBundle(3);
+    compareComputeResult(device, buffer, makeArray<float>(5.0f, 6.0f, 7.0f, 8.0f));
+
+    // Bundles can't be made from command buffers that already have commands.
+    ComPtr<ICommandBuffer> commandBuffer = transientHeap->createCommandBuffer();
+    ComPtr<ICommandBufferImmediate> commandBufferImmediate;
+    REQUIRE_CALL(
+        commandBuffer->queryInterface(ICommandBufferImmediate::getTypeGuid(), (void**)commandBufferImmediate.writeRef())
+    );
+    REQUIRE_CALL(commandBufferImmediate->executeBundle(bundle));
+    CHECK(SLANG_FAILED(commandBufferImmediate->beginBundle()));
+    commandBuffer->close();
+}
+
+// A bundle bound with a mutable root object keeps the versions it captured, even after the transient heap is reset
+// and the mutable objects are changed.
+void testCommandBundleMutableObject(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-mutable-shader-object", "computeMain", slangReflection)
+    );
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::UnorderedAccess, ResourceState::CopySource);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    REQUIRE_CALL(device->createBufferView(buffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    slang::TypeReflection* transformerType = slangReflection->findTypeByName("AddTransformer");
+    ComPtr<IShaderObject> transformer;
+    REQUIRE_CALL(
+        device->createMutableShaderObject(transformerType, ShaderObjectContainerType::None, transformer.writeRef())
+    );
+    float c = 1.0f;
+    ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+
+    ComPtr<IShaderObject> rootObject;
+    REQUIRE_CALL(device->createMutableRootShaderObject(shaderProgram, rootObject.writeRef()));
+    ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+    entryPointCursor.getPath("buffer").setResource(bufferView);
+    entryPointCursor.getPath("transformer").setObject(transformer);
+
+    // Record a bundle that adds 1 to every element.
+    ComPtr<ICommandBuffer> bundle = transientHeap->createCommandBuffer();
+    ComPtr<ICommandBufferImmediate> bundleImmediate;
+    REQUIRE_CALL(bundle->queryInterface(ICommandBufferImmediate::getTypeGuid(), (void**)bundleImmediate.writeRef()));
+    REQUIRE_CALL(bundleImmediate->beginBundle());
+    {
+        auto encoder = bundle->encodeComputeCommands();
+        REQUIRE_CALL(encoder->bindPipelineWithRootObject(pipeline, rootObject));
+        encoder->dispatchCompute(1, 1, 1);
+        encoder->endEncoding();
+    }
+    bundle->close();
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    auto executeBundle = [&]()
+    {
+        ComPtr<ICommandBuffer> commandBuffer = transientHeap->createCommandBuffer();
+        ComPtr<ICommandBufferImmediate> commandBufferImmediate;
+        REQUIRE_CALL(commandBuffer->queryInterface(
+            ICommandBufferImmediate::getTypeGuid(),
+            (void**)commandBufferImmediate.writeRef()
+        ));
+        REQUIRE_CALL(commandBufferImmediate->executeBundle(bundle));
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    };
+
+    executeBundle();
+    compareComputeResult(device, buffer, makeArray<float>(1.0f, 2.0f, 3.0f, 4.0f));
+
+    // After the reset, a new version of the transformer may reuse the storage of the versions allocated before it.
+    REQUIRE_CALL(transientHeap->synchronizeAndReset());
+    c = 5.0f;
+    ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+    ComPtr<IShaderObject> transformerVersion;
+    REQUIRE_CALL(transformer->getCurrentVersion(transientHeap, transformerVersion.writeRef()));
+
+    executeBundle();
+    compareComputeResult(device, buffer, makeArray<float>(2.0f, 3.0f, 4.0f, 5.0f));
+}
+
+TEST_CASE("command-bundle")
+{
+    runGpuTests(
+        testCommandBundle,
+        {
+            DeviceType::D3D11,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("command-bundle-mutable-object")
+{
+    runGpuTests(
+        testCommandBundleMutableObject,
+        {
+            DeviceType::D3D11,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
@@ -0,0 +1,62 @@
+#include "testing.h"
+
+#include <chrono>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Measures how fast dispatches are recorded into command buffers, without executing them.
+// Only devices recording into a `CommandWriter` are listed, the others encode into native command lists.
+// Run explicitly with `-tc=command-recording-benchmark`.
+void benchmarkCommandRecording(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-trivial", "computeMain", slangReflection));
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    const int commandBufferCount = 1000;
+    const int dispatchCount = 10000;
+    double totalTime = 0.0;
+    for (int i = 0; i < commandBufferCount; i++)
+    {
+        // Command buffers are created per frame, only the recording is measured.
+        // From the second frame on, they record into the chunks released by the previous frame.
+        {
+            auto commandBuffer = transientHeap->createCommandBuffer();
+            auto startTime = std::chrono::high_resolution_clock::now();
+            auto encoder = commandBuffer->encodeComputeCommands();
+            encoder->bindPipeline(pipeline);
+            for (int j = 0; j < dispatchCount; j++)
+                encoder->dispatchCompute(1, 1, 1);
+            encoder->endEncoding();
+            commandBuffer->close();
+            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+            totalTime += elapsed.count();
+        }
+        REQUIRE_CALL(transientHeap->synchronizeAndReset());
+    }
+    MESSAGE("recording: " << commandBufferCount * dispatchCount / totalTime / 1e6 << " M dispatches/s");
+}
+
+TEST_CASE("command-recording-benchmark" * doctest::skip())
+{
+    runGpuTests(
+        benchmarkCommandRecording,
+        {
+            DeviceType::D3D11,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
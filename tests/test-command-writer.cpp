@@ -0,0 +1,213 @@
+#include "testing.h"
+
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Immediate devices record commands into chunks that are reused by later command buffers of the same transient heap.
+// These tests record enough commands to cross chunk boundaries, payloads larger than a chunk, and several frames
+// that reuse the chunks of the previous ones.
+
+struct CommandWriterTest
+{
+    // Enough dispatches to fill several 64KB chunks.
+    static constexpr int kDispatchCount = 4000;
+    // Larger than a chunk, so the upload gets a dedicated one.
+    static constexpr size_t kPayloadCount = 64 * 1024;
+
+    ComPtr<IDevice> device;
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ComPtr<ICommandQueue> queue;
+    ComPtr<IPipeline> pipeline;
+    ComPtr<IBuffer> numbersBuffer;
+    ComPtr<IResourceView> numbersBufferView;
+    ComPtr<IBuffer> payloadBuffer;
+    ComPtr<IShaderObject> transformer;
+
+    void init(GpuTestContext* ctx, DeviceType deviceType)
+    {
+        device = createTestingDevice(ctx, deviceType);
+
+        ITransientResourceHeap::Desc transientHeapDesc = {};
+        transientHeapDesc.constantBufferSize = 4096;
+        REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+        ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+        queue = device->createCommandQueue(queueDesc);
+
+        ComPtr<IShaderProgram> shaderProgram;
+        slang::ProgramLayout* slangReflection;
+        REQUIRE_CALL(
+            loadComputeProgram(device, shaderProgram, "test-mutable-shader-object", "computeMain", slangReflection)
+        );
+        ComputePipelineDesc pipelineDesc = {};
+        pipelineDesc.program = shaderProgram.get();
+        REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+        float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = sizeof(initialData);
+        bufferDesc.elementSize = sizeof(float);
+        bufferDesc.allowedStates = ResourceStateSet(ResourceState::UnorderedAccess, ResourceState::CopySource);
+        bufferDesc.defaultState = ResourceState::UnorderedAccess;
+        REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, numbersBuffer.writeRef()));
+        IResourceView::Desc viewDesc = {};
+        viewDesc.type = IResourceView::Type::UnorderedAccess;
+        REQUIRE_CALL(device->createBufferView(numbersBuffer, nullptr, viewDesc, numbersBufferView.writeRef()));
+
+        BufferDesc payloadBufferDesc = {};
+        payloadBufferDesc.size = kPayloadCount * sizeof(uint32_t);
+        payloadBufferDesc.allowedStates = ResourceStateSet(ResourceState::CopyDestination, ResourceState::CopySource);
+        payloadBufferDesc.defaultState = ResourceState::CopyDestination;
+        REQUIRE_CALL(device->createBuffer(payloadBufferDesc, nullptr, payloadBuffer.writeRef()));
+
+        REQUIRE_CALL(device->createShaderObject(
+            slangReflection->findTypeByName("AddTransformer"),
+            ShaderObjectContainerType::None,
+            transformer.writeRef()
+        ));
+        float c = 1.0f;
+        ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+    }
+
+    // Adds `count` to every number, one dispatch at a time.
+    void recordDispatches(ICommandBuffer* commandBuffer, int count)
+    {
+        auto encoder = commandBuffer->encodeComputeCommands();
+        auto rootObject = encoder->bindPipeline(pipeline);
+        ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+        entryPointCursor.getPath("buffer").setResource(numbersBufferView);
+        entryPointCursor.getPath("transformer").setObject(transformer);
+        for (int i = 0; i < count; i++)
+            encoder->dispatchCompute(1, 1, 1);
+        encoder->endEncoding();
+    }
+
+    void recordUpload(ICommandBuffer* commandBuffer, std::vector<uint32_t>& payload)
+    {
+        auto encoder = commandBuffer->encodeResourceCommands();
+        encoder->uploadBufferData(payloadBuffer, 0, payload.size() * sizeof(uint32_t), payload.data());
+        encoder->endEncoding();
+    }
+
+    void execute(ICommandBuffer* commandBuffer)
+    {
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    void checkNumbers(float added)
+    {
+        compareComputeResult(
+            device,
+            numbersBuffer,
+            makeArray<float>(0.0f + added, 1.0f + added, 2.0f + added, 3.0f + added)
+        );
+    }
+
+    void checkPayload(const std::vector<uint32_t>& payload)
+    {
+        compareComputeResult(device, payloadBuffer, 0, payload.data(), payload.size() * sizeof(uint32_t));
+    }
+};
+
+static std::vector<uint32_t> makePayload(uint32_t seed)
+{
+    std::vector<uint32_t> payload(CommandWriterTest::kPayloadCount);
+    for (size_t i = 0; i < payload.size(); i++)
+        payload[i] = uint32_t(i) * 3 + seed;
+    return payload;
+}
+
+// Commands spanning several chunks are replayed in order.
+void testCommandWriterChunkBoundary(GpuTestContext* ctx, DeviceType deviceType)
+{
+    CommandWriterTest test;
+    test.init(ctx, deviceType);
+
+    auto commandBuffer = test.transientHeap->createCommandBuffer();
+    test.recordDispatches(commandBuffer, CommandWriterTest::kDispatchCount);
+    test.execute(commandBuffer);
+    test.checkNumbers(float(CommandWriterTest::kDispatchCount));
+}
+
+// A payload larger than a chunk is stored in its own chunk, between commands stored in regular chunks.
+void testCommandWriterOversizedPayload(GpuTestContext* ctx, DeviceType deviceType)
+{
+    CommandWriterTest test;
+    test.init(ctx, deviceType);
+
+    std::vector<uint32_t> payload = makePayload(7);
+    auto commandBuffer = test.transientHeap->createCommandBuffer();
+    test.recordDispatches(commandBuffer, 10);
+    test.recordUpload(commandBuffer, payload);
+    test.recordDispatches(commandBuffer, 10);
+    test.execute(commandBuffer);
+    test.checkNumbers(20.0f);
+    test.checkPayload(payload);
+}
+
+// Command buffers created after a reset reuse the chunks of the previous frame and must not replay stale commands.
+void testCommandWriterReuse(GpuTestContext* ctx, DeviceType deviceType)
+{
+    CommandWriterTest test;
+    test.init(ctx, deviceType);
+
+    const int frameCount = 3;
+    for (int frame = 0; frame < frameCount; frame++)
+    {
+        // Record fewer commands each frame, so reused chunks still hold commands of the previous frame.
+        int dispatchCount = CommandWriterTest::kDispatchCount / (frame + 1);
+        std::vector<uint32_t> payload = makePayload(frame);
+        auto commandBuffer = test.transientHeap->createCommandBuffer();
+        test.recordUpload(commandBuffer, payload);
+        test.recordDispatches(commandBuffer, dispatchCount);
+        test.execute(commandBuffer);
+        test.checkPayload(payload);
+
+        float added = 0.0f;
+        for (int i = 0; i <= frame; i++)
+            added += float(CommandWriterTest::kDispatchCount / (i + 1));
+        test.checkNumbers(added);
+
+        REQUIRE_CALL(test.transientHeap->synchronizeAndReset());
+    }
+}
+
+TEST_CASE("command-writer-chunk-boundary")
+{
+    runGpuTests(
+        testCommandWriterChunkBoundary,
+        {
+            DeviceType::D3D11,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("command-writer-oversized-payload")
+{
+    runGpuTests(
+        testCommandWriterOversizedPayload,
+        {
+            DeviceType::D3D11,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("command-writer-reuse")
+{
+    runGpuTests(
+        testCommandWriterReuse,
+        {
+            DeviceType::D3D11,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
@@ -0,0 +1,132 @@
+#include "testing.h"
+
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static void runMultiGroupDispatch(
+    IDevice* device,
+    ITransientResourceHeap* transientHeap,
+    IShaderProgram* shaderProgram,
+    CPUGroupOrder groupOrder,
+    const uint32_t groupCount[3]
+)
+{
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram;
+    pipelineDesc.cpuGroupOrder = groupOrder;
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    const uint32_t threadCount[3] = {groupCount[0] * 4, groupCount[1], groupCount[2]};
+    const uint32_t numberCount = threadCount[0] * threadCount[1] * threadCount[2];
+
+    std::vector<uint32_t> initialData(numberCount, 0);
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = numberCount * sizeof(uint32_t);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(uint32_t);
+    bufferDesc.allowedStates = ResourceStateSet(
+        ResourceState::ShaderResource,
+        ResourceState::UnorderedAccess,
+        ResourceState::CopyDestination,
+        ResourceState::CopySource
+    );
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    ComPtr<IBuffer> numbersBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, initialData.data(), numbersBuffer.writeRef()));
+
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::Unknown;
+    REQUIRE_CALL(device->createBufferView(numbersBuffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    {
+        ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+        auto queue = device->createCommandQueue(queueDesc);
+
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+
+        auto rootObject = encoder->bindPipeline(pipeline);
+
+        ShaderCursor cursor(rootObject);
+        cursor.getPath("buffer").setResource(bufferView);
+        cursor.getPath("threadCount").setData(threadCount, sizeof(threadCount));
+
+        encoder->dispatchCompute(groupCount[0], groupCount[1], groupCount[2]);
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    std::vector<uint32_t> expectedData(numberCount);
+    for (uint32_t i = 0; i < numberCount; i++)
+        expectedData[i] = i;
+    compareComputeResult(device, numbersBuffer, 0, expectedData.data(), expectedData.size() * sizeof(uint32_t));
+}
+
+static void runMultiGroupDispatches(IDevice* device)
+{
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-multi-group", "computeMain", slangReflection));
+
+    // Use uneven group counts on every axis so that work gets split across all of them
+    // and tiles of groups are clipped at the edges.
+    const uint32_t groupCounts[2][3] = {{37, 5, 3}, {13, 11, 2}};
+    // The group order only affects the CPU device, other devices must ignore it.
+    for (CPUGroupOrder groupOrder :
+         {CPUGroupOrder::Linear, CPUGroupOrder::Tiled, CPUGroupOrder::Morton, CPUGroupOrder::Hilbert})
+    {
+        for (const auto& groupCount : groupCounts)
+            runMultiGroupDispatch(device, transientHeap, shaderProgram, groupOrder, groupCount);
+    }
+}
+
+void testComputeMultiGroup(GpuTestContext* ctx, DeviceType deviceType)
+{
+    runMultiGroupDispatches(createTestingDevice(ctx, deviceType));
+}
+
+// Dispatches must produce the same results on the submitting thread only and with more workers than hardware threads.
+void testComputeMultiGroupWorkerThreadCount(GpuTestContext* ctx, DeviceType deviceType)
+{
+    for (uint32_t workerThreadCount : {1u, 3u, 64u})
+    {
+        CPUDeviceExtendedDesc cpuExtDesc = {};
+        cpuExtDesc.workerThreadCount = workerThreadCount;
+        DeviceDescOverrides overrides;
+        overrides.extendedDescs.push_back(&cpuExtDesc);
+        runMultiGroupDispatches(createTestingDevice(ctx, deviceType, overrides));
+    }
+}
+
+TEST_CASE("compute-multi-group")
+{
+    runGpuTests(
+        testComputeMultiGroup,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::Metal,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("compute-multi-group-worker-thread-count")
+{
+    runGpuTests(testComputeMultiGroupWorkerThreadCount, {DeviceType::CPU});
+}
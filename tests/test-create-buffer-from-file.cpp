@@ -0,0 +1,142 @@
+#include "testing.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#if SLANG_WINDOWS_FAMILY
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace rhi;
+using namespace rhi::testing;
+
+void testCreateBufferFromFile(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-trivial", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    // Write the numbers at an offset that is not page aligned.
+    std::string filePath = (std::filesystem::path(getCaseTempDirectory()) / "create-buffer-from-file.bin").string();
+    const char* fileName = filePath.c_str();
+    const size_t dataOffset = 5000;
+    const int numberCount = 4;
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    {
+        std::vector<char> padding(dataOffset, 0);
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        file.write(padding.data(), padding.size());
+        file.write((const char*)initialData, sizeof(initialData));
+    }
+
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = numberCount * sizeof(float);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(
+        ResourceState::ShaderResource,
+        ResourceState::UnorderedAccess,
+        ResourceState::CopyDestination,
+        ResourceState::CopySource
+    );
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    bufferDesc.nativeHandleOffset = dataOffset;
+
+    // The mapping stays valid after the file is closed.
+    ComPtr<IBuffer> numbersBuffer;
+    {
+        NativeHandle handle;
+#if SLANG_WINDOWS_FAMILY
+        HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+        REQUIRE(file != INVALID_HANDLE_VALUE);
+        handle.type = NativeHandleType::Win32;
+        handle.value = (uint64_t)file;
+#else
+        int file = open(fileName, O_RDONLY);
+        REQUIRE(file >= 0);
+        handle.type = NativeHandleType::FileDescriptor;
+        handle.value = (uint64_t)file;
+#endif
+        Result result = device->createBufferFromNativeHandle(handle, bufferDesc, numbersBuffer.writeRef());
+
+        // Ranges that extend past the end of the file are rejected.
+        BufferDesc outOfRangeDesc = bufferDesc;
+        outOfRangeDesc.nativeHandleOffset = dataOffset + sizeof(float);
+        ComPtr<IBuffer> outOfRangeBuffer;
+        Result outOfRangeResult =
+            device->createBufferFromNativeHandle(handle, outOfRangeDesc, outOfRangeBuffer.writeRef());
+#if SLANG_WINDOWS_FAMILY
+        CloseHandle(file);
+#else
+        close(file);
+#endif
+        REQUIRE_CALL(result);
+        CHECK(outOfRangeResult == SLANG_E_INVALID_ARG);
+    }
+    compareComputeResult(device, numbersBuffer, makeArray<float>(0.0f, 1.0f, 2.0f, 3.0f));
+
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::Unknown;
+    REQUIRE_CALL(device->createBufferView(numbersBuffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    {
+        ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+        auto queue = device->createCommandQueue(queueDesc);
+
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+
+        auto rootObject = encoder->bindPipeline(pipeline);
+
+        ShaderCursor rootCursor(rootObject);
+        rootCursor.getPath("buffer").setResource(bufferView);
+
+        encoder->dispatchCompute(1, 1, 1);
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    compareComputeResult(device, numbersBuffer, makeArray<float>(1.0f, 2.0f, 3.0f, 4.0f));
+
+    // Writes to the buffer are copy-on-write and must not change the file.
+    numbersBuffer = nullptr;
+    bufferView = nullptr;
+    {
+        float fileData[numberCount];
+        std::ifstream file(fileName, std::ios::binary);
+        file.seekg(dataOffset);
+        file.read((char*)fileData, sizeof(fileData));
+        CHECK(memcmp(fileData, initialData, sizeof(initialData)) == 0);
+    }
+}
+
+TEST_CASE("create-buffer-from-file")
+{
+    runGpuTests(
+        testCreateBufferFromFile,
+        {
+            DeviceType::CPU,
+        }
+    );
+}
@@ -0,0 +1,110 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Descriptor sets allocated by a transient heap are recycled on reset instead of being allocated again.
+
+void testDescriptorPoolStats(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-trivial", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    const int numberCount = 4;
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = numberCount * sizeof(float);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(
+        ResourceState::ShaderResource,
+        ResourceState::UnorderedAccess,
+        ResourceState::CopyDestination,
+        ResourceState::CopySource
+    );
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    ComPtr<IBuffer> numbersBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, numbersBuffer.writeRef()));
+
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::Unknown;
+    REQUIRE_CALL(device->createBufferView(numbersBuffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    // Every dispatch binds a new root object, which allocates a descriptor set.
+    const int dispatchCount = 8;
+    auto dispatchFrame = [&]()
+    {
+        REQUIRE_CALL(transientHeap->synchronizeAndReset());
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+        for (int i = 0; i < dispatchCount; i++)
+        {
+            auto rootObject = encoder->bindPipeline(pipeline);
+            ShaderCursor(rootObject).getPath("buffer").setResource(bufferView);
+            encoder->dispatchCompute(1, 1, 1);
+            encoder->bufferBarrier(numbersBuffer, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess);
+        }
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        REQUIRE_CALL(transientHeap->finish());
+        queue->waitOnHost();
+    };
+
+    dispatchFrame();
+    dispatchFrame();
+
+    DescriptorPoolStats stats;
+    REQUIRE_CALL(device->getDescriptorPoolStats(&stats));
+    CHECK_GE(stats.poolCreationCount, 1);
+    CHECK_GE(stats.setAllocationCount, dispatchCount);
+    CHECK_LE(stats.setCount, stats.setCapacity);
+    CHECK_LE(stats.setsInUse, stats.setCount);
+
+    // Later frames only reuse the descriptor sets of the first one.
+    for (int i = 0; i < 3; i++)
+        dispatchFrame();
+    DescriptorPoolStats reuseStats;
+    REQUIRE_CALL(device->getDescriptorPoolStats(&reuseStats));
+    CHECK_EQ(reuseStats.poolCreationCount, stats.poolCreationCount);
+    CHECK_EQ(reuseStats.setAllocationCount, stats.setAllocationCount);
+    CHECK_GE(reuseStats.setReuseCount, stats.setReuseCount + 3 * dispatchCount);
+
+    // Recycled descriptor sets are rewritten with the bindings of the new dispatches.
+    const float added = float(5 * dispatchCount);
+    compareComputeResult(
+        device,
+        numbersBuffer,
+        makeArray<float>(0.0f + added, 1.0f + added, 2.0f + added, 3.0f + added)
+    );
+}
+
+TEST_CASE("descriptor-pool-stats")
+{
+    runGpuTests(
+        testDescriptorPoolStats,
+        {
+            DeviceType::Vulkan,
+        }
+    );
+}
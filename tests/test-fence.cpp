@@ -0,0 +1,129 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+void testFenceValue(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<IFence> fence;
+    IFence::Desc fenceDesc = {};
+    fenceDesc.initialValue = 1;
+    REQUIRE_CALL(device->createFence(fenceDesc, fence.writeRef()));
+
+    uint64_t value = 0;
+    CHECK_CALL(fence->getCurrentValue(&value));
+    CHECK_EQ(value, 1);
+
+    CHECK_CALL(fence->setCurrentValue(5));
+    CHECK_CALL(fence->getCurrentValue(&value));
+    CHECK_EQ(value, 5);
+
+    // Waiting for a value that has been reached returns immediately.
+    IFence* fences[] = {fence.get()};
+    uint64_t waitValues[] = {5};
+    CHECK_CALL(device->waitForFences(1, fences, waitValues, true, kTimeoutInfinite));
+
+    // Waiting for a value that is never reached times out.
+    waitValues[0] = 6;
+    CHECK_EQ(device->waitForFences(1, fences, waitValues, true, 1000000), SLANG_E_TIME_OUT);
+}
+
+void testFenceSubmit(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-trivial", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    const int numberCount = 4;
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = numberCount * sizeof(float);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(
+        ResourceState::ShaderResource,
+        ResourceState::UnorderedAccess,
+        ResourceState::CopyDestination,
+        ResourceState::CopySource
+    );
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    ComPtr<IBuffer> numbersBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, numbersBuffer.writeRef()));
+
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::Unknown;
+    REQUIRE_CALL(device->createBufferView(numbersBuffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ComPtr<IFence> fence;
+    IFence::Desc fenceDesc = {};
+    REQUIRE_CALL(device->createFence(fenceDesc, fence.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    // Submit several batches back to back, each signaling the next fence value.
+    const uint64_t batchCount = 4;
+    for (uint64_t i = 1; i <= batchCount; i++)
+    {
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+        auto rootObject = encoder->bindPipeline(pipeline);
+        ShaderCursor(rootObject).getPath("buffer").setResource(bufferView);
+        encoder->dispatchCompute(1, 1, 1);
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer, fence, i);
+    }
+
+    IFence* fences[] = {fence.get()};
+    uint64_t waitValues[] = {batchCount};
+    REQUIRE_CALL(device->waitForFences(1, fences, waitValues, true, kTimeoutInfinite));
+
+    uint64_t value = 0;
+    CHECK_CALL(fence->getCurrentValue(&value));
+    CHECK_EQ(value, batchCount);
+
+    compareComputeResult(device, numbersBuffer, makeArray<float>(4.0f, 5.0f, 6.0f, 7.0f));
+}
+
+TEST_CASE("fence-value")
+{
+    runGpuTests(
+        testFenceValue,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("fence-submit")
+{
+    runGpuTests(
+        testFenceSubmit,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CPU,
+        }
+    );
+}
@@ -0,0 +1,137 @@
+#include "testing.h"
+
+#include <chrono>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static ComPtr<IBuffer> createTestBuffer(IDevice* device, Size size)
+{
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = size;
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::ShaderResource, ResourceState::UnorderedAccess);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, buffer.writeRef()));
+    return buffer;
+}
+
+void testMemoryStats(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    DeviceMemoryStats initialStats;
+    REQUIRE_CALL(device->getMemoryStats(&initialStats));
+
+    {
+        ComPtr<IBuffer> buffer = createTestBuffer(device, 1000);
+        CHECK_EQ(buffer->getDeviceAddress() % 64, 0);
+
+        DeviceMemoryStats stats;
+        REQUIRE_CALL(device->getMemoryStats(&stats));
+        CHECK_GE(stats.bytesLive, initialStats.bytesLive + 1000);
+        CHECK_GE(stats.bytesPeak, stats.bytesLive);
+        CHECK_EQ(stats.allocationCount, initialStats.allocationCount + 1);
+    }
+
+    DeviceMemoryStats releasedStats;
+    REQUIRE_CALL(device->getMemoryStats(&releasedStats));
+    CHECK_EQ(releasedStats.bytesLive, initialStats.bytesLive);
+    CHECK_GT(releasedStats.bytesPooled, initialStats.bytesPooled);
+
+    // Allocations of the same size class reuse the pooled memory.
+    {
+        ComPtr<IBuffer> buffer = createTestBuffer(device, 1020);
+        DeviceMemoryStats stats;
+        REQUIRE_CALL(device->getMemoryStats(&stats));
+        CHECK_EQ(stats.poolHitCount, releasedStats.poolHitCount + 1);
+    }
+}
+
+TEST_CASE("memory-stats")
+{
+    runGpuTests(
+        testMemoryStats,
+        {
+            DeviceType::CPU,
+        }
+    );
+}
+
+// Small buffers are placed in shared device memory blocks instead of getting a device allocation each.
+
+void testMemoryStatsSuballocation(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    DeviceMemoryStats initialStats;
+    REQUIRE_CALL(device->getMemoryStats(&initialStats));
+    CHECK_GT(initialStats.bytesBudget, 0);
+
+    const int bufferCount = 1000;
+    {
+        std::vector<ComPtr<IBuffer>> buffers;
+        for (int i = 0; i < bufferCount; i++)
+            buffers.push_back(createTestBuffer(device, 256 + i * 16));
+
+        DeviceMemoryStats stats;
+        REQUIRE_CALL(device->getMemoryStats(&stats));
+        CHECK_EQ(stats.allocationCount, initialStats.allocationCount + bufferCount);
+        CHECK_EQ(stats.poolAllocationCount, initialStats.poolAllocationCount + bufferCount);
+        CHECK_LT(stats.deviceAllocationCount, initialStats.deviceAllocationCount + 4);
+        CHECK_GE(stats.bytesReserved, stats.bytesLive + stats.bytesPooled);
+        CHECK_LE(stats.bytesLargestPooledRange, stats.bytesPooled);
+    }
+
+    DeviceMemoryStats releasedStats;
+    REQUIRE_CALL(device->getMemoryStats(&releasedStats));
+    CHECK_EQ(releasedStats.bytesLive, initialStats.bytesLive);
+    CHECK_LT(releasedStats.deviceAllocationCount, initialStats.deviceAllocationCount + 2);
+}
+
+TEST_CASE("memory-stats-suballocation")
+{
+    runGpuTests(
+        testMemoryStatsSuballocation,
+        {
+            DeviceType::Vulkan,
+        }
+    );
+}
+
+// Measures how fast small buffers are created and destroyed.
+// Run explicitly with `-tc=buffer-creation-benchmark`.
+void benchmarkBufferCreation(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    const int roundCount = 10;
+    const int bufferCount = 10000;
+    std::vector<ComPtr<IBuffer>> buffers(bufferCount);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < roundCount; i++)
+    {
+        for (int j = 0; j < bufferCount; j++)
+            buffers[j] = createTestBuffer(device, 256 + (j % 64) * 64);
+        for (int j = 0; j < bufferCount; j++)
+            buffers[j] = nullptr;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    MESSAGE("buffer creation: " << roundCount * bufferCount / elapsed.count() / 1e3 << " K buffers/s");
+}
+
+TEST_CASE("buffer-creation-benchmark" * doctest::skip())
+{
+    runGpuTests(
+        benchmarkBufferCreation,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CPU,
+        }
+    );
+}
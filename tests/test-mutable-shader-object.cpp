@@ -1,5 +1,9 @@
 #include "testing.h"
 
+#include <chrono>
+#include <set>
+#include <vector>
+
 using namespace rhi;
 using namespace rhi::testing;
 
@@ -120,3 +124,175 @@ TEST_CASE("mutable-shader-object")
         }
     );
 }
+
+// Versions created for a transient heap are recycled once the heap is reset. At most 1024 versions are kept for
+// recycling, the others are created again.
+void testMutableShaderObjectVersionRecycling(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-mutable-shader-object", "computeMain", slangReflection)
+    );
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::UnorderedAccess, ResourceState::CopySource);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    ComPtr<IBuffer> numbersBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, numbersBuffer.writeRef()));
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    REQUIRE_CALL(device->createBufferView(numbersBuffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ComPtr<IShaderObject> transformer;
+    REQUIRE_CALL(device->createMutableShaderObject(
+        slangReflection->findTypeByName("AddTransformer"),
+        ShaderObjectContainerType::None,
+        transformer.writeRef()
+    ));
+
+    const int versionCount = 1100;
+    const int maxRecycledCount = 1024;
+    // Versions of the previous frame are kept alive, so new versions can't be allocated at their addresses.
+    std::vector<ComPtr<IShaderObject>> previousVersions;
+    float added = 0.0f;
+    for (int frame = 0; frame < 3; frame++)
+    {
+        REQUIRE_CALL(transientHeap->synchronizeAndReset());
+
+        std::vector<ComPtr<IShaderObject>> versions(versionCount);
+        for (int i = 0; i < versionCount; i++)
+        {
+            float c = float(frame + i);
+            ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+            REQUIRE_CALL(transformer->getCurrentVersion(transientHeap, versions[i].writeRef()));
+        }
+
+        std::set<IShaderObject*> versionSet;
+        for (auto& version : versions)
+            versionSet.insert(version.get());
+        CHECK_EQ(versionSet.size(), size_t(versionCount));
+        if (frame > 0)
+        {
+            size_t recycledCount = 0;
+            for (auto& version : previousVersions)
+                recycledCount += versionSet.count(version.get());
+            CHECK_EQ(recycledCount, size_t(maxRecycledCount));
+        }
+
+        // Recycled and newly created versions hold the data of this frame.
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+        for (int i : {0, maxRecycledCount / 2, maxRecycledCount - 1, maxRecycledCount, versionCount - 1})
+        {
+            auto rootObject = encoder->bindPipeline(pipeline);
+            ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+            entryPointCursor.getPath("buffer").setResource(bufferView);
+            entryPointCursor.getPath("transformer").setObject(versions[i]);
+            encoder->dispatchCompute(1, 1, 1);
+            encoder->bufferBarrier(numbersBuffer, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess);
+            added += float(frame + i);
+        }
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+
+        compareComputeResult(
+            device,
+            numbersBuffer,
+            makeArray<float>(0.0f + added, 1.0f + added, 2.0f + added, 3.0f + added)
+        );
+
+        previousVersions = std::move(versions);
+    }
+}
+
+TEST_CASE("mutable-shader-object-version-recycling")
+{
+    runGpuTests(
+        testMutableShaderObjectVersionRecycling,
+        {
+            DeviceType::D3D11,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
+
+// Measures the cost of creating a new version of a mutable shader object, with a growing number of transient
+// heaps in flight. Run explicitly with `-tc=mutable-shader-object-benchmark`.
+void benchmarkMutableShaderObject(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-mutable-shader-object", "computeMain", slangReflection)
+    );
+    slang::TypeReflection* addTransformerType = slangReflection->findTypeByName("AddTransformer");
+
+    for (int heapCount : {1, 4, 16, 64})
+    {
+        std::vector<ComPtr<ITransientResourceHeap>> transientHeaps(heapCount);
+        for (auto& transientHeap : transientHeaps)
+        {
+            ITransientResourceHeap::Desc transientHeapDesc = {};
+            transientHeapDesc.constantBufferSize = 4096;
+            REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+        }
+
+        ComPtr<IShaderObject> transformer;
+        REQUIRE_CALL(device->createMutableShaderObject(
+            addTransformerType,
+            ShaderObjectContainerType::None,
+            transformer.writeRef()
+        ));
+
+        const int frameCount = 1000;
+        const int versionsPerFrame = 100;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            ITransientResourceHeap* transientHeap = transientHeaps[frame % heapCount];
+            transientHeap->synchronizeAndReset();
+            for (int i = 0; i < versionsPerFrame; i++)
+            {
+                float c = float(i);
+                ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+                ComPtr<IShaderObject> transformerVersion;
+                transformer->getCurrentVersion(transientHeap, transformerVersion.writeRef());
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+        MESSAGE(heapCount << " heaps: " << elapsed.count() / (frameCount * versionsPerFrame) << " ns per version");
+    }
+}
+
+TEST_CASE("mutable-shader-object-benchmark" * doctest::skip())
+{
+    runGpuTests(
+        benchmarkMutableShaderObject,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+        }
+    );
+}
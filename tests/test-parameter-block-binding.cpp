@@ -0,0 +1,187 @@
+#include "testing.h"
+
+#include <chrono>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static ComPtr<IBuffer> createBuffer(IDevice* device, uint32_t data, ResourceState defaultState)
+{
+    uint32_t initialData[] = {data, data, data, data};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(uint32_t) * 4;
+    bufferDesc.allowedStates = ResourceStateSet(
+        ResourceState::ShaderResource,
+        ResourceState::UnorderedAccess,
+        ResourceState::CopyDestination,
+        ResourceState::CopySource
+    );
+    bufferDesc.defaultState = defaultState;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+    return buffer;
+}
+
+static ComPtr<IResourceView> createBufferView(IDevice* device, IBuffer* buffer, IResourceView::Type type)
+{
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = type;
+    viewDesc.format = Format::Unknown;
+    viewDesc.bufferRange.offset = 0;
+    viewDesc.bufferRange.size = sizeof(uint32_t) * 4;
+    ComPtr<IResourceView> view;
+    REQUIRE_CALL(device->createBufferView(buffer, nullptr, viewDesc, view.writeRef()));
+    return view;
+}
+
+struct ParameterBlockBindingTest
+{
+    ComPtr<IDevice> device;
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ComPtr<ICommandQueue> queue;
+    ComPtr<IPipeline> pipeline;
+    ComPtr<IShaderObject> material;
+    std::vector<ComPtr<IResourceView>> srvs;
+
+    void init(GpuTestContext* ctx, DeviceType deviceType)
+    {
+        device = createTestingDevice(ctx, deviceType);
+
+        ITransientResourceHeap::Desc transientHeapDesc = {};
+        transientHeapDesc.constantBufferSize = 4096;
+        REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+        ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+        queue = device->createCommandQueue(queueDesc);
+
+        ComPtr<IShaderProgram> shaderProgram;
+        slang::ProgramLayout* slangReflection;
+        REQUIRE_CALL(
+            loadComputeProgram(device, shaderProgram, "test-parameter-block-binding", "computeMain", slangReflection)
+        );
+        ComputePipelineDesc pipelineDesc = {};
+        pipelineDesc.program = shaderProgram.get();
+        REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            auto buffer = createBuffer(device, i + 1, ResourceState::ShaderResource);
+            srvs.push_back(createBufferView(device, buffer, IResourceView::Type::ShaderResource));
+        }
+
+        REQUIRE_CALL(device->createShaderObject(
+            slangReflection->findTypeByName("Material"),
+            ShaderObjectContainerType::None,
+            material.writeRef()
+        ));
+        ShaderCursor cursor(material);
+        cursor["value"].setData(uint32_t(1000));
+        cursor["data0"].setResource(srvs[0]);
+        cursor["data1"].setResource(srvs[1]);
+        cursor["data2"].setResource(srvs[2]);
+        cursor["data3"].setResource(srvs[3]);
+    }
+
+    void encodeDispatch(IComputeCommandEncoder* encoder, IResourceView* resultView)
+    {
+        auto rootObject = encoder->bindPipeline(pipeline);
+        ShaderCursor cursor(rootObject);
+        cursor["material"].setObject(material);
+        cursor["resultBuffer"].setResource(resultView);
+        encoder->dispatchCompute(1, 1, 1);
+    }
+
+    void dispatchAndCheck(uint32_t expected)
+    {
+        auto resultBuffer = createBuffer(device, 0, ResourceState::UnorderedAccess);
+        auto resultView = createBufferView(device, resultBuffer, IResourceView::Type::UnorderedAccess);
+
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+        encodeDispatch(encoder, resultView);
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+
+        compareComputeResult(device, resultBuffer, makeArray<uint32_t>(expected, expected, expected, expected));
+    }
+};
+
+// A parameter block is bound again without changes, then modified and bound again, first without resetting the
+// transient heap in between and then across a reset.
+void testParameterBlockRebind(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ParameterBlockBindingTest test;
+    test.init(ctx, deviceType);
+
+    test.dispatchAndCheck(1010);
+    test.dispatchAndCheck(1010);
+
+    ShaderCursor(test.material)["data0"].setResource(test.srvs[4]);
+    test.dispatchAndCheck(1014);
+
+    ShaderCursor(test.material)["value"].setData(uint32_t(2000));
+    test.dispatchAndCheck(2014);
+
+    REQUIRE_CALL(test.transientHeap->synchronizeAndReset());
+    test.dispatchAndCheck(2014);
+
+    ShaderCursor(test.material)["data1"].setResource(test.srvs[0]);
+    test.dispatchAndCheck(2013);
+}
+
+TEST_CASE("parameter-block-rebind")
+{
+    runGpuTests(
+        testParameterBlockRebind,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+        }
+    );
+}
+
+// Measures the CPU cost of binding a parameter block for every dispatch, without executing them.
+// Run explicitly with `-tc=parameter-block-binding-benchmark`.
+void benchmarkParameterBlockBinding(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ParameterBlockBindingTest test;
+    test.init(ctx, deviceType);
+
+    auto resultBuffer = createBuffer(test.device, 0, ResourceState::UnorderedAccess);
+    auto resultView = createBufferView(test.device, resultBuffer, IResourceView::Type::UnorderedAccess);
+
+    const int commandBufferCount = 10;
+    const int dispatchCount = 10000;
+    double totalTime = 0.0;
+    for (int i = 0; i < commandBufferCount; i++)
+    {
+        REQUIRE_CALL(test.transientHeap->synchronizeAndReset());
+        auto startTime = std::chrono::high_resolution_clock::now();
+        auto commandBuffer = test.transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+        for (int j = 0; j < dispatchCount; j++)
+            test.encodeDispatch(encoder, resultView);
+        encoder->endEncoding();
+        commandBuffer->close();
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+        totalTime += elapsed.count();
+    }
+    MESSAGE("binding: " << totalTime * 1e9 / (commandBufferCount * dispatchCount) << " ns/dispatch");
+}
+
+TEST_CASE("parameter-block-binding-benchmark" * doctest::skip())
+{
+    runGpuTests(
+        benchmarkParameterBlockBinding,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+        }
+    );
+}
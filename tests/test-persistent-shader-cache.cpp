@@ -0,0 +1,406 @@
+#include "testing.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static ComPtr<IPersistentShaderCache> createCache(const std::string& path, uint64_t maxSize = 256 * 1024 * 1024)
+{
+    PersistentShaderCacheDesc desc;
+    desc.path = path.c_str();
+    desc.maxSize = maxSize;
+    ComPtr<IPersistentShaderCache> cache;
+    REQUIRE_CALL(rhiCreatePersistentShaderCache(&desc, cache.writeRef()));
+    return cache;
+}
+
+static ComPtr<ISlangBlob> makeBlob(const std::string& str)
+{
+    return OwnedBlob::create(str.data(), str.size());
+}
+
+// Returns the cached data for `key`, or an empty string on a miss.
+static std::string query(IPersistentShaderCache* cache, const std::string& key)
+{
+    ComPtr<ISlangBlob> data;
+    if (cache->queryCache(makeBlob(key), data.writeRef()) != SLANG_OK)
+        return {};
+    return std::string(static_cast<const char*>(data->getBufferPointer()), data->getBufferSize());
+}
+
+TEST_CASE("persistent-shader-cache")
+{
+    std::string path = (std::filesystem::path(getCaseTempDirectory()) / "cache.pack").string();
+    std::filesystem::remove(path);
+
+    SUBCASE("write-query")
+    {
+        ComPtr<IPersistentShaderCache> cache = createCache(path);
+        CHECK(query(cache, "a").empty());
+        REQUIRE_CALL(cache->writeCache(makeBlob("a"), makeBlob("alpha")));
+        REQUIRE_CALL(cache->writeCache(makeBlob("b"), makeBlob(std::string(5000, 'b'))));
+        CHECK_EQ(query(cache, "a"), "alpha");
+        CHECK_EQ(query(cache, "b"), std::string(5000, 'b'));
+
+        // Data is returned without copying, aligned for direct use as shader code.
+        ComPtr<ISlangBlob> data;
+        REQUIRE_CALL(cache->queryCache(makeBlob("a"), data.writeRef()));
+        CHECK_EQ(uintptr_t(data->getBufferPointer()) % 16, 0);
+    }
+
+    SUBCASE("persistence")
+    {
+        {
+            ComPtr<IPersistentShaderCache> cache = createCache(path);
+            REQUIRE_CALL(cache->writeCache(makeBlob("a"), makeBlob("alpha")));
+        }
+        ComPtr<IPersistentShaderCache> cache = createCache(path);
+        CHECK_EQ(query(cache, "a"), "alpha");
+    }
+
+    SUBCASE("shared")
+    {
+        // Two caches on the same file behave like two processes sharing it.
+        ComPtr<IPersistentShaderCache> cache0 = createCache(path);
+        ComPtr<IPersistentShaderCache> cache1 = createCache(path);
+        REQUIRE_CALL(cache0->writeCache(makeBlob("a"), makeBlob("alpha")));
+        REQUIRE_CALL(cache1->writeCache(makeBlob("b"), makeBlob("beta")));
+        CHECK_EQ(query(cache1, "a"), "alpha");
+        CHECK_EQ(query(cache0, "b"), "beta");
+    }
+
+    SUBCASE("torn-append")
+    {
+        {
+            ComPtr<IPersistentShaderCache> cache = createCache(path);
+            REQUIRE_CALL(cache->writeCache(makeBlob("a"), makeBlob("alpha")));
+        }
+        // Simulate a crash in the middle of an append, leaving garbage past the committed end.
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::app);
+            file << "partial record";
+        }
+        ComPtr<IPersistentShaderCache> cache = createCache(path);
+        CHECK_EQ(query(cache, "a"), "alpha");
+        REQUIRE_CALL(cache->writeCache(makeBlob("b"), makeBlob("beta")));
+        CHECK_EQ(query(cache, "b"), "beta");
+    }
+
+    SUBCASE("damaged-record")
+    {
+        {
+            ComPtr<IPersistentShaderCache> cache = createCache(path);
+            REQUIRE_CALL(cache->writeCache(makeBlob("a"), makeBlob("alpha")));
+            REQUIRE_CALL(cache->writeCache(makeBlob("b"), makeBlob("beta")));
+        }
+        // Damaged records fail their checksum and are treated as misses.
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            size_t pos = contents.find("beta");
+            REQUIRE(pos != std::string::npos);
+            file.seekp(pos);
+            file << "BETA";
+        }
+        ComPtr<IPersistentShaderCache> cache = createCache(path);
+        CHECK_EQ(query(cache, "a"), "alpha");
+        CHECK(query(cache, "b").empty());
+    }
+
+    SUBCASE("eviction")
+    {
+        const uint64_t maxSize = 64 * 1024;
+        ComPtr<IPersistentShaderCache> cache = createCache(path, maxSize);
+        std::string data(4000, 'x');
+        for (int i = 0; i < 40; i++)
+        {
+            std::string key = "key" + std::to_string(i);
+            REQUIRE_CALL(cache->writeCache(makeBlob(key), makeBlob(data + key)));
+            // Keep the first entry in use, so it is not evicted.
+            CHECK_EQ(query(cache, "key0"), data + "key0");
+        }
+        CHECK_EQ(query(cache, "key39"), data + "key39");
+        CHECK(query(cache, "key1").empty());
+        CHECK_LE(std::filesystem::file_size(path), maxSize);
+
+        // Entries larger than the size cap are rejected.
+        CHECK_EQ(cache->writeCache(makeBlob("huge"), makeBlob(std::string(maxSize, 'h'))), SLANG_E_INVALID_ARG);
+    }
+
+    SUBCASE("eviction-held-blob")
+    {
+        // A blob keeps the mapping of the pack file it was read from. Windows can't replace a mapped file,
+        // so writes must keep succeeding while compaction is not possible.
+        const uint64_t maxSize = 64 * 1024;
+        ComPtr<IPersistentShaderCache> cache = createCache(path, maxSize);
+        std::string data(4000, 'x');
+        REQUIRE_CALL(cache->writeCache(makeBlob("held"), makeBlob(data + "held")));
+        ComPtr<ISlangBlob> heldBlob;
+        REQUIRE_CALL(cache->queryCache(makeBlob("held"), heldBlob.writeRef()));
+
+        for (int i = 0; i < 40; i++)
+        {
+            std::string key = "key" + std::to_string(i);
+            REQUIRE_CALL(cache->writeCache(makeBlob(key), makeBlob(data + key)));
+            CHECK_EQ(query(cache, key), data + key);
+        }
+        CHECK_EQ(
+            std::string(static_cast<const char*>(heldBlob->getBufferPointer()), heldBlob->getBufferSize()),
+            data + "held"
+        );
+
+        // Once the blob is released, compaction brings the pack file back under the size cap.
+        heldBlob = nullptr;
+        for (int i = 40; i < 80; i++)
+        {
+            std::string key = "key" + std::to_string(i);
+            REQUIRE_CALL(cache->writeCache(makeBlob(key), makeBlob(data + key)));
+        }
+        CHECK_EQ(query(cache, "key79"), data + "key79");
+        CHECK_LE(std::filesystem::file_size(path), maxSize);
+    }
+}
+
+// Measures lookup latency with a warm cache.
+// Run explicitly with `-tc=persistent-shader-cache-benchmark`.
+TEST_CASE("persistent-shader-cache-benchmark" * doctest::skip())
+{
+    std::string path = (std::filesystem::path(getCaseTempDirectory()) / "cache.pack").string();
+    std::filesystem::remove(path);
+    ComPtr<IPersistentShaderCache> cache = createCache(path);
+
+    const int entryCount = 1000;
+    std::vector<ComPtr<ISlangBlob>> keys;
+    for (int i = 0; i < entryCount; i++)
+    {
+        // Keys are hashes of the shader inputs in practice.
+        keys.push_back(makeBlob("0123456789abcdef0123" + std::to_string(i)));
+        REQUIRE_CALL(cache->writeCache(keys.back(), makeBlob(std::string(16 * 1024, char(i)))));
+    }
+
+    const int queryCount = 1000000;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queryCount; i++)
+    {
+        ComPtr<ISlangBlob> data;
+        cache->queryCache(keys[i % entryCount], data.writeRef());
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    MESSAGE("lookup: " << elapsed.count() / queryCount << " ns");
+}
+
+static ComPtr<IDevice> createDeviceWithCache(
+    GpuTestContext* ctx,
+    DeviceType deviceType,
+    IPersistentShaderCache* cache,
+    bool persistentPipelineCache = true
+)
+{
+    DeviceDescOverrides overrides;
+    overrides.persistentShaderCache = cache;
+    overrides.persistentPipelineCache = persistentPipelineCache;
+    return createTestingDevice(ctx, deviceType, overrides);
+}
+
+// Runs `test-compute-trivial` once on a new buffer and returns the buffer.
+static ComPtr<IBuffer> runTrivialDispatch(IDevice* device)
+{
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-trivial", "computeMain", slangReflection));
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::UnorderedAccess, ResourceState::CopySource);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, initialData, buffer.writeRef()));
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    REQUIRE_CALL(device->createBufferView(buffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto encoder = commandBuffer->encodeComputeCommands();
+    auto rootObject = encoder->bindPipeline(pipeline);
+    ShaderCursor(rootObject).getPath("buffer").setResource(bufferView);
+    encoder->dispatchCompute(1, 1, 1);
+    encoder->endEncoding();
+    commandBuffer->close();
+    queue->executeCommandBuffer(commandBuffer);
+    queue->waitOnHost();
+    return buffer;
+}
+
+// Forwards to another cache and records the driver pipeline cache data found by devices on creation.
+class PipelineCacheQueryRecorder : public IPersistentShaderCache
+{
+public:
+    ComPtr<IPersistentShaderCache> cache;
+    std::vector<std::string> foundPipelineCacheData;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL writeCache(ISlangBlob* key, ISlangBlob* data) override
+    {
+        return cache->writeCache(key, data);
+    }
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL queryCache(ISlangBlob* key, ISlangBlob** outData) override
+    {
+        Result result = cache->queryCache(key, outData);
+        std::string keyString(static_cast<const char*>(key->getBufferPointer()), key->getBufferSize());
+        if (result == SLANG_OK && keyString.rfind("VkPipelineCache", 0) == 0)
+        {
+            foundPipelineCacheData.push_back(
+                std::string(static_cast<const char*>((*outData)->getBufferPointer()), (*outData)->getBufferSize())
+            );
+        }
+        return result;
+    }
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL queryInterface(SlangUUID const& uuid, void** outObject) override
+    {
+        if (uuid == IPersistentShaderCache::getTypeGuid())
+        {
+            *outObject = static_cast<IPersistentShaderCache*>(this);
+            return SLANG_OK;
+        }
+        return SLANG_E_NO_INTERFACE;
+    }
+
+    // The lifetime of this object is tied to the test, see `ShaderCache`.
+    virtual SLANG_NO_THROW uint32_t SLANG_MCALL addRef() override { return 2; }
+    virtual SLANG_NO_THROW uint32_t SLANG_MCALL release() override { return 2; }
+};
+
+// The driver pipeline cache is stored in the persistent shader cache and used by devices created later.
+// Devices that don't enable `persistentPipelineCache` leave it alone.
+void testPipelineCache(GpuTestContext* ctx, DeviceType deviceType)
+{
+    std::string path = (std::filesystem::path(getCaseTempDirectory()) / "cache.pack").string();
+    std::filesystem::remove(path);
+    PipelineCacheQueryRecorder cache;
+    cache.cache = createCache(path);
+
+    {
+        ComPtr<IDevice> device = createDeviceWithCache(ctx, deviceType, nullptr);
+        CHECK_EQ(device->savePipelineCache(), SLANG_E_NOT_AVAILABLE);
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        ComPtr<IDevice> device = createDeviceWithCache(ctx, deviceType, &cache);
+
+        // The second device starts from the data saved by the first one.
+        if (deviceType == DeviceType::Vulkan)
+        {
+            REQUIRE_EQ(cache.foundPipelineCacheData.size(), size_t(i));
+            if (i == 1)
+            {
+                // The data starts with a VkPipelineCacheHeaderVersionOne header.
+                const std::string& data = cache.foundPipelineCacheData[0];
+                REQUIRE_GE(data.size(), size_t(32));
+                uint32_t header[2];
+                ::memcpy(header, data.data(), sizeof(header));
+                CHECK_GE(header[0], 32u);
+                CHECK_EQ(header[1], 1u);
+            }
+        }
+        else
+        {
+            CHECK(cache.foundPipelineCacheData.empty());
+        }
+
+        ComPtr<IBuffer> buffer = runTrivialDispatch(device);
+        compareComputeResult(device, buffer, makeArray<float>(1.0f, 2.0f, 3.0f, 4.0f));
+        if (deviceType == DeviceType::Vulkan)
+            CHECK_EQ(device->savePipelineCache(), SLANG_OK);
+        else
+            CHECK_EQ(device->savePipelineCache(), SLANG_E_NOT_AVAILABLE);
+    }
+
+    {
+        size_t foundCount = cache.foundPipelineCacheData.size();
+        ComPtr<IDevice> device = createDeviceWithCache(ctx, deviceType, &cache, false);
+        CHECK_EQ(cache.foundPipelineCacheData.size(), foundCount);
+        CHECK_EQ(device->savePipelineCache(), SLANG_E_NOT_AVAILABLE);
+    }
+}
+
+TEST_CASE("persistent-shader-cache-pipeline-cache")
+{
+    runGpuTests(
+        testPipelineCache,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+        }
+    );
+}
+
+// Measures the time from creating a device to the first dispatch, with an empty and with a warm cache.
+// Pipeline creation time is reported separately, it is reduced by the driver pipeline cache on Vulkan.
+// Run explicitly with `-tc=persistent-shader-cache-startup-benchmark`.
+void benchmarkPersistentShaderCacheStartup(GpuTestContext* ctx, DeviceType deviceType)
+{
+    std::string path = (std::filesystem::path(getCaseTempDirectory()) / "cache.pack").string();
+    std::filesystem::remove(path);
+
+    double pipelineCreationTime = 0.0;
+    auto runFirstDispatch = [&]()
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        ComPtr<IPersistentShaderCache> cache = createCache(path);
+        ComPtr<IDevice> device = createDeviceWithCache(ctx, deviceType, cache);
+        runTrivialDispatch(device);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+        ShaderCompilationStats stats;
+        REQUIRE_CALL(device->getShaderCompilationStats(&stats));
+        pipelineCreationTime = stats.pipelineCreation.totalTime / 1e6;
+        device->savePipelineCache();
+        return elapsed.count();
+    };
+
+    double coldTime = runFirstDispatch();
+    double coldPipelineCreationTime = pipelineCreationTime;
+    double warmTime = runFirstDispatch();
+    double warmPipelineCreationTime = pipelineCreationTime;
+    MESSAGE("cold start: " << coldTime << " ms, warm start: " << warmTime << " ms");
+    MESSAGE(
+        "pipeline creation: cold " << coldPipelineCreationTime << " ms, warm " << warmPipelineCreationTime << " ms"
+    );
+}
+
+TEST_CASE("persistent-shader-cache-startup-benchmark" * doctest::skip())
+{
+    runGpuTests(
+        benchmarkPersistentShaderCacheStartup,
+        {
+            DeviceType::D3D11,
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::Metal,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
@@ -0,0 +1,169 @@
+#include "testing.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Specializations recorded on one device are re-created on a new device from the exported manifest.
+
+static ComPtr<IPipeline> createPipeline(IDevice* device, slang::ProgramLayout*& outSlangReflection)
+{
+    ComPtr<IShaderProgram> shaderProgram;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-smoke", "computeMain", outSlangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+    return pipeline;
+}
+
+static Result dispatchTransformer(
+    IDevice* device,
+    IPipeline* pipeline,
+    slang::ProgramLayout* slangReflection,
+    const char* transformerTypeName
+)
+{
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::ShaderResource, ResourceState::UnorderedAccess);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::Unknown;
+    REQUIRE_CALL(device->createBufferView(buffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ComPtr<IShaderObject> transformer;
+    REQUIRE_CALL(device->createShaderObject(
+        slangReflection->findTypeByName(transformerTypeName),
+        ShaderObjectContainerType::None,
+        transformer.writeRef()
+    ));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+    return dispatchWithTransformer(transientHeap, queue, pipeline, bufferView, transformer);
+}
+
+// Returns the lines of a manifest sorted, specializations are exported in no particular order.
+static std::vector<std::string> getSortedLines(ISlangBlob* manifest)
+{
+    std::istringstream stream(std::string((const char*)manifest->getBufferPointer(), manifest->getBufferSize()));
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(stream, line))
+        lines.push_back(line);
+    std::sort(lines.begin(), lines.end());
+    return lines;
+}
+
+static ComPtr<ISlangBlob> exportManifest(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType, false);
+    slang::ProgramLayout* slangReflection;
+    ComPtr<IPipeline> pipeline = createPipeline(device, slangReflection);
+    dispatchTransformer(device, pipeline, slangReflection, "AddTransformer");
+    dispatchTransformer(device, pipeline, slangReflection, "MulTransformer");
+    ComPtr<ISlangBlob> manifest;
+    REQUIRE_CALL(device->exportPipelineSpecializations(pipeline, manifest.writeRef()));
+    return manifest;
+}
+
+// Dispatches with the prewarmed types find their specialized pipelines in the cache.
+static void checkPrewarmedDispatches(IDevice* device, IPipeline* pipeline, slang::ProgramLayout* slangReflection)
+{
+    REQUIRE_CALL(device->resetShaderCompilationStats());
+    CHECK_EQ(dispatchTransformer(device, pipeline, slangReflection, "AddTransformer"), SLANG_OK);
+    CHECK_EQ(dispatchTransformer(device, pipeline, slangReflection, "MulTransformer"), SLANG_OK);
+    ShaderCompilationStats stats;
+    REQUIRE_CALL(device->getShaderCompilationStats(&stats));
+    CHECK_EQ(stats.specializedPipelineCacheHitCount, 2u);
+    CHECK_EQ(stats.specializedPipelineCacheMissCount, 0u);
+}
+
+void testPipelineSpecializationManifest(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<ISlangBlob> manifest = exportManifest(ctx, deviceType);
+    std::string manifestText((const char*)manifest->getBufferPointer(), manifest->getBufferSize());
+    CHECK(manifestText.find("AddTransformer\n") != std::string::npos);
+    CHECK(manifestText.find("MulTransformer\n") != std::string::npos);
+
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType, false);
+    slang::ProgramLayout* slangReflection;
+    ComPtr<IPipeline> pipeline = createPipeline(device, slangReflection);
+    REQUIRE_CALL(
+        device->prewarmPipelineSpecializations(pipeline, manifest->getBufferPointer(), manifest->getBufferSize())
+    );
+
+    ComPtr<ISlangBlob> prewarmedManifest;
+    REQUIRE_CALL(device->exportPipelineSpecializations(pipeline, prewarmedManifest.writeRef()));
+    CHECK(getSortedLines(prewarmedManifest) == getSortedLines(manifest));
+
+    checkPrewarmedDispatches(device, pipeline, slangReflection);
+
+    const char invalidManifest[] = "not a manifest\n";
+    CHECK_EQ(
+        device->prewarmPipelineSpecializations(pipeline, invalidManifest, sizeof(invalidManifest) - 1),
+        SLANG_E_INVALID_ARG
+    );
+}
+
+// With async pipeline specialization, prewarmed specializations are created on the background thread.
+void testPipelineSpecializationManifestAsync(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<ISlangBlob> manifest = exportManifest(ctx, deviceType);
+
+    DeviceDescOverrides overrides;
+    overrides.asyncPipelineSpecialization = true;
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType, overrides);
+    slang::ProgramLayout* slangReflection;
+    ComPtr<IPipeline> pipeline = createPipeline(device, slangReflection);
+    REQUIRE_CALL(
+        device->prewarmPipelineSpecializations(pipeline, manifest->getBufferPointer(), manifest->getBufferSize())
+    );
+    REQUIRE_CALL(device->waitForPipelineSpecializations(kTimeoutInfinite));
+
+    checkPrewarmedDispatches(device, pipeline, slangReflection);
+}
+
+TEST_CASE("pipeline-specialization-manifest")
+{
+    runGpuTests(
+        testPipelineSpecializationManifest,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("pipeline-specialization-manifest-async")
+{
+    runGpuTests(
+        testPipelineSpecializationManifestAsync,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CPU,
+        }
+    );
+}
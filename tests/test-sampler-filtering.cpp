@@ -0,0 +1,137 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static ComPtr<ISampler> createSampler(
+    IDevice* device,
+    TextureFilteringMode filter,
+    TextureAddressingMode addressingMode
+)
+{
+    SamplerDesc desc = {};
+    desc.minFilter = filter;
+    desc.magFilter = filter;
+    desc.mipFilter = TextureFilteringMode::Point;
+    desc.addressU = addressingMode;
+    desc.addressV = addressingMode;
+    desc.addressW = addressingMode;
+    for (int i = 0; i < 4; i++)
+        desc.borderColor[i] = 0.f;
+    ComPtr<ISampler> sampler;
+    REQUIRE_CALL(device->createSampler(desc, sampler.writeRef()));
+    return sampler;
+}
+
+void testSamplerFiltering(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-sampler-filtering", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    // 2x2 texture with the red channel holding the texel index.
+    ComPtr<ITexture> texture;
+    {
+        TextureDesc textureDesc = {};
+        textureDesc.type = TextureType::Texture2D;
+        textureDesc.format = Format::R32G32B32A32_FLOAT;
+        textureDesc.size.width = 2;
+        textureDesc.size.height = 2;
+        textureDesc.size.depth = 1;
+        textureDesc.numMipLevels = 1;
+        textureDesc.memoryType = MemoryType::DeviceLocal;
+        textureDesc.defaultState = ResourceState::ShaderResource;
+        textureDesc.allowedStates.add(ResourceState::CopyDestination);
+        float data[] = {0.f, 0.f, 0.f, 1.f, 1.f, 0.f, 0.f, 1.f, 2.f, 0.f, 0.f, 1.f, 3.f, 0.f, 0.f, 1.f};
+        SubresourceData subResourceData = {data, 32, 64};
+        REQUIRE_CALL(device->createTexture(textureDesc, &subResourceData, texture.writeRef()));
+    }
+    ComPtr<IResourceView> srv;
+    {
+        IResourceView::Desc viewDesc = {};
+        viewDesc.type = IResourceView::Type::ShaderResource;
+        viewDesc.format = Format::R32G32B32A32_FLOAT;
+        REQUIRE_CALL(device->createTextureView(texture, viewDesc, srv.writeRef()));
+    }
+
+    ComPtr<IBuffer> buffer;
+    {
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = 3 * sizeof(float);
+        bufferDesc.format = Format::Unknown;
+        bufferDesc.elementSize = sizeof(float);
+        bufferDesc.allowedStates = ResourceStateSet(
+            ResourceState::ShaderResource,
+            ResourceState::UnorderedAccess,
+            ResourceState::CopyDestination,
+            ResourceState::CopySource
+        );
+        bufferDesc.defaultState = ResourceState::UnorderedAccess;
+        bufferDesc.memoryType = MemoryType::DeviceLocal;
+        REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, buffer.writeRef()));
+    }
+    ComPtr<IResourceView> uav;
+    {
+        IResourceView::Desc viewDesc = {};
+        viewDesc.type = IResourceView::Type::UnorderedAccess;
+        viewDesc.format = Format::Unknown;
+        REQUIRE_CALL(device->createBufferView(buffer, nullptr, viewDesc, uav.writeRef()));
+    }
+
+    ComPtr<ISampler> linearClamp =
+        createSampler(device, TextureFilteringMode::Linear, TextureAddressingMode::ClampToEdge);
+    ComPtr<ISampler> pointWrap = createSampler(device, TextureFilteringMode::Point, TextureAddressingMode::Wrap);
+    ComPtr<ISampler> linearBorder =
+        createSampler(device, TextureFilteringMode::Linear, TextureAddressingMode::ClampToBorder);
+
+    {
+        ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+        auto queue = device->createCommandQueue(queueDesc);
+
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        {
+            auto encoder = commandBuffer->encodeComputeCommands();
+            auto rootObject = encoder->bindPipeline(pipeline);
+            ShaderCursor cursor(rootObject);
+            cursor["tex"].setResource(srv);
+            cursor["linearClamp"].setSampler(linearClamp);
+            cursor["pointWrap"].setSampler(pointWrap);
+            cursor["linearBorder"].setSampler(linearBorder);
+            cursor["buffer"].setResource(uav);
+            encoder->dispatchCompute(1, 1, 1);
+            encoder->endEncoding();
+        }
+
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    // Bilinear average of all four texels, texel (1, 0) with wrapping, and half of texel (0, 1)
+    // blended with a black border.
+    compareComputeResult(device, buffer, makeArray<float>(1.5f, 1.0f, 1.0f));
+}
+
+TEST_CASE("sampler-filtering")
+{
+    runGpuTests(
+        testSamplerFiltering,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CPU,
+        }
+    );
+}
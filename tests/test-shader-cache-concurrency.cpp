@@ -0,0 +1,267 @@
+#include "testing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Shader object layouts and component IDs are cached on the device.
+// Create shader objects of the same set of types from many threads at once, starting
+// with a cold cache so that threads race to insert the same entries.
+
+static const char* kTypeNames[] = {"ScalarValue", "PairValue", "ScaledValue", "Composite"};
+
+static std::vector<slang::TypeLayoutReflection*> getTypeLayouts(IDevice* device)
+{
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(
+        loadComputeProgram(device, shaderProgram, "test-shader-cache-concurrency", "computeMain", slangReflection)
+    );
+
+    // The Slang session is not thread-safe, so type layouts are resolved upfront.
+    std::vector<slang::TypeLayoutReflection*> typeLayouts;
+    for (const char* typeName : kTypeNames)
+    {
+        slang::TypeReflection* type = slangReflection->findTypeByName(typeName);
+        REQUIRE(type != nullptr);
+        typeLayouts.push_back(slangReflection->getTypeLayout(type));
+    }
+    return typeLayouts;
+}
+
+// Create `iterationCount` shader objects on each of `threadCount` threads.
+// Returns the number of failed creations.
+static uint32_t createShaderObjectsConcurrently(
+    IDevice* device,
+    const std::vector<slang::TypeLayoutReflection*>& typeLayouts,
+    uint32_t threadCount,
+    uint32_t iterationCount
+)
+{
+    std::atomic<uint32_t> failureCount = 0;
+    std::atomic<bool> start = false;
+    std::vector<std::thread> threads;
+    for (uint32_t threadIndex = 0; threadIndex < threadCount; threadIndex++)
+    {
+        threads.emplace_back(
+            [&, threadIndex]()
+            {
+                while (!start.load())
+                    std::this_thread::yield();
+                for (uint32_t i = 0; i < iterationCount; i++)
+                {
+                    slang::TypeLayoutReflection* typeLayout = typeLayouts[(threadIndex + i) % typeLayouts.size()];
+                    ComPtr<IShaderObject> object;
+                    if (SLANG_FAILED(device->createShaderObjectFromTypeLayout(typeLayout, object.writeRef())) ||
+                        object->getElementTypeLayout() != typeLayout)
+                        failureCount++;
+                }
+            }
+        );
+    }
+    start = true;
+    for (auto& thread : threads)
+        thread.join();
+    return failureCount;
+}
+
+void testShaderCacheConcurrency(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    auto typeLayouts = getTypeLayouts(device);
+
+    CHECK_EQ(createShaderObjectsConcurrently(device, typeLayouts, 8, 500), 0);
+}
+
+// Record dispatches that specialize the same pipeline from many threads at once, starting with a cold
+// cache so that threads race to specialize the pipeline and insert it into the cache. Only the
+// recording is concurrent, command buffers are submitted from the main thread.
+void testSpecializedDispatchConcurrency(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType, false);
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-smoke", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    // Every thread binds its own transient heap, buffers and transformers, one per transformer type.
+    const uint32_t threadCount = 8;
+    const char* transformerTypeNames[] = {"AddTransformer", "MulTransformer"};
+    const float transformerConstants[] = {1.0f, 2.0f};
+    struct ThreadResources
+    {
+        ComPtr<ITransientResourceHeap> transientHeap;
+        ComPtr<IBuffer> buffers[2];
+        ComPtr<IResourceView> bufferViews[2];
+        ComPtr<IShaderObject> transformers[2];
+        ComPtr<ICommandBuffer> commandBuffer;
+    };
+    std::vector<ThreadResources> resources(threadCount);
+    for (ThreadResources& threadResources : resources)
+    {
+        ITransientResourceHeap::Desc transientHeapDesc = {};
+        transientHeapDesc.constantBufferSize = 4096;
+        REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, threadResources.transientHeap.writeRef()));
+
+        for (int kind = 0; kind < 2; kind++)
+        {
+            float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+            BufferDesc bufferDesc = {};
+            bufferDesc.size = sizeof(initialData);
+            bufferDesc.format = Format::Unknown;
+            bufferDesc.elementSize = sizeof(float);
+            bufferDesc.allowedStates = ResourceStateSet(
+                ResourceState::ShaderResource,
+                ResourceState::UnorderedAccess,
+                ResourceState::CopySource
+            );
+            bufferDesc.defaultState = ResourceState::UnorderedAccess;
+            bufferDesc.memoryType = MemoryType::DeviceLocal;
+            REQUIRE_CALL(
+                device->createBuffer(bufferDesc, (void*)initialData, threadResources.buffers[kind].writeRef())
+            );
+
+            IResourceView::Desc viewDesc = {};
+            viewDesc.type = IResourceView::Type::UnorderedAccess;
+            viewDesc.format = Format::Unknown;
+            REQUIRE_CALL(device->createBufferView(
+                threadResources.buffers[kind],
+                nullptr,
+                viewDesc,
+                threadResources.bufferViews[kind].writeRef()
+            ));
+
+            REQUIRE_CALL(device->createShaderObject(
+                slangReflection->findTypeByName(transformerTypeNames[kind]),
+                ShaderObjectContainerType::None,
+                threadResources.transformers[kind].writeRef()
+            ));
+            ShaderCursor transformerCursor(threadResources.transformers[kind]);
+            transformerCursor.getPath("c").setData(&transformerConstants[kind], sizeof(float));
+        }
+    }
+
+    // Threads bind the transformer types in different orders.
+    std::atomic<uint32_t> failureCount = 0;
+    std::atomic<bool> start = false;
+    std::vector<std::thread> threads;
+    for (uint32_t threadIndex = 0; threadIndex < threadCount; threadIndex++)
+    {
+        threads.emplace_back(
+            [&, threadIndex]()
+            {
+                ThreadResources& threadResources = resources[threadIndex];
+                while (!start.load())
+                    std::this_thread::yield();
+                auto commandBuffer = threadResources.transientHeap->createCommandBuffer();
+                auto encoder = commandBuffer->encodeComputeCommands();
+                for (uint32_t i = 0; i < 2; i++)
+                {
+                    uint32_t kind = (threadIndex + i) % 2;
+                    auto rootObject = encoder->bindPipeline(pipeline);
+                    ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+                    entryPointCursor.getPath("buffer").setResource(threadResources.bufferViews[kind]);
+                    entryPointCursor.getPath("transformer").setObject(threadResources.transformers[kind]);
+                    if (SLANG_FAILED(encoder->dispatchCompute(1, 1, 1)))
+                        failureCount++;
+                }
+                encoder->endEncoding();
+                commandBuffer->close();
+                threadResources.commandBuffer = commandBuffer;
+            }
+        );
+    }
+    start = true;
+    for (auto& thread : threads)
+        thread.join();
+    CHECK_EQ(failureCount.load(), 0);
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+    for (ThreadResources& threadResources : resources)
+        queue->executeCommandBuffer(threadResources.commandBuffer);
+    queue->waitOnHost();
+
+    for (ThreadResources& threadResources : resources)
+    {
+        compareComputeResult(device, threadResources.buffers[0], makeArray<float>(11.0f, 12.0f, 13.0f, 14.0f));
+        compareComputeResult(device, threadResources.buffers[1], makeArray<float>(0.0f, 2.0f, 4.0f, 6.0f));
+    }
+
+    // Threads that specialized the pipeline concurrently share a single cache entry per type.
+    ComPtr<ISlangBlob> manifest;
+    REQUIRE_CALL(device->exportPipelineSpecializations(pipeline, manifest.writeRef()));
+    std::string manifestText((const char*)manifest->getBufferPointer(), manifest->getBufferSize());
+    for (const char* typeName : transformerTypeNames)
+    {
+        std::string line = std::string(typeName) + "\n";
+        size_t first = manifestText.find(line);
+        CHECK(first != std::string::npos);
+        CHECK(manifestText.find(line, first + 1) == std::string::npos);
+    }
+}
+
+// Measures shader object creation throughput with a warm cache for an increasing number of threads.
+// Run explicitly with `-tc=shader-cache-concurrency-benchmark`.
+void benchmarkShaderCacheConcurrency(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    auto typeLayouts = getTypeLayouts(device);
+
+    const uint32_t iterationCount = 20000;
+    createShaderObjectsConcurrently(device, typeLayouts, 1, uint32_t(typeLayouts.size()));
+    uint32_t maxThreadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        CHECK_EQ(createShaderObjectsConcurrently(device, typeLayouts, threadCount, iterationCount), 0);
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+        double objectsPerSecond = threadCount * iterationCount / elapsed.count();
+        MESSAGE(threadCount << " threads: " << uint64_t(objectsPerSecond) << " shader objects/s");
+    }
+}
+
+// Other devices allocate descriptors when creating shader objects, which is not thread-safe.
+TEST_CASE("shader-cache-concurrency")
+{
+    runGpuTests(
+        testShaderCacheConcurrency,
+        {
+            DeviceType::CPU,
+        }
+    );
+}
+
+// Devices with immediate command execution specialize pipelines when command buffers are submitted,
+// which is serialized by the device.
+TEST_CASE("shader-cache-concurrency-specialization")
+{
+    runGpuTests(
+        testSpecializedDispatchConcurrency,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+        }
+    );
+}
+
+TEST_CASE("shader-cache-concurrency-benchmark" * doctest::skip())
+{
+    runGpuTests(
+        benchmarkShaderCacheConcurrency,
+        {
+            DeviceType::CPU,
+        }
+    );
+}
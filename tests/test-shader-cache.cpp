@@ -119,6 +119,8 @@ struct ShaderCacheTest
     GpuTestContext* ctx;
     DeviceType deviceType;
     std::filesystem::path tempDirectory;
+    // Kernel cache directory used by the CPU device. Not used if empty.
+    std::filesystem::path kernelCachePath;
 
     ComPtr<IDevice> device;
     ComPtr<IPipeline> pipeline;
@@ -200,8 +202,13 @@ struct ShaderCacheTest
         slangExtDesc.compilerOptionEntries = entries.data();
         slangExtDesc.compilerOptionEntryCount = entries.size();
 
-        deviceDesc.extendedDescCount = 2;
-        void* extDescPtrs[2] = {&extDesc, &slangExtDesc};
+        CPUDeviceExtendedDesc cpuExtDesc = {};
+        std::string kernelCachePathStr = kernelCachePath.string();
+        if (!kernelCachePath.empty())
+            cpuExtDesc.kernelCachePath = kernelCachePathStr.c_str();
+
+        deviceDesc.extendedDescCount = 3;
+        void* extDescPtrs[3] = {&extDesc, &slangExtDesc, &cpuExtDesc};
         deviceDesc.extendedDescs = extDescPtrs;
 
         // TODO: We should also set the debug callback
@@ -683,6 +690,54 @@ struct ShaderCacheTestEviction : ShaderCacheTest
     }
 };
 
+// Test caching of CPU kernels in the kernel cache directory.
+// The compiled libraries are stored both in the directory and in the persistent shader cache.
+struct ShaderCacheTestCPUKernel : ShaderCacheTest
+{
+    size_t getKernelCount()
+    {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(kernelCachePath))
+            count += entry.is_regular_file() ? 1 : 0;
+        return count;
+    }
+
+    void runTests()
+    {
+        kernelCachePath = tempDirectory / "kernels";
+
+        // Cache is cold and we expect 3 misses.
+        createDevice();
+        runComputePipeline(computeShaderA, {1.f, 2.f, 3.f, 4.f});
+        runComputePipeline(computeShaderB, {2.f, 3.f, 4.f, 5.f});
+        runComputePipeline(computeShaderC, {3.f, 4.f, 5.f, 6.f});
+        CHECK_EQ(getStats().missCount, 3);
+        CHECK_EQ(getStats().hitCount, 0);
+        CHECK_EQ(getStats().entryCount, 3);
+        CHECK_EQ(getKernelCount(), 3);
+
+        // Kernels are loaded from the kernel cache directory without querying the shader cache.
+        createDevice();
+        runComputePipeline(computeShaderA, {1.f, 2.f, 3.f, 4.f});
+        runComputePipeline(computeShaderB, {2.f, 3.f, 4.f, 5.f});
+        runComputePipeline(computeShaderC, {3.f, 4.f, 5.f, 6.f});
+        CHECK_EQ(getStats().missCount, 3);
+        CHECK_EQ(getStats().hitCount, 0);
+        CHECK_EQ(getKernelCount(), 3);
+
+        // Kernel cache directory is cleared, kernels are restored from the shader cache.
+        device = nullptr;
+        std::filesystem::remove_all(kernelCachePath);
+        createDevice();
+        runComputePipeline(computeShaderA, {1.f, 2.f, 3.f, 4.f});
+        runComputePipeline(computeShaderB, {2.f, 3.f, 4.f, 5.f});
+        runComputePipeline(computeShaderC, {3.f, 4.f, 5.f, 6.f});
+        CHECK_EQ(getStats().missCount, 3);
+        CHECK_EQ(getStats().hitCount, 3);
+        CHECK_EQ(getKernelCount(), 3);
+    }
+};
+
 // Similar to ShaderCacheTestEntryPoint but with a source file containing a vertex and fragment shader.
 struct ShaderCacheTestGraphics : ShaderCacheTest
 {
@@ -1022,6 +1077,16 @@ TEST_CASE("shader-cache-specialization")
     );
 }
 
+TEST_CASE("shader-cache-cpu-kernel")
+{
+    runGpuTests(
+        runTest<ShaderCacheTestCPUKernel>,
+        {
+            DeviceType::CPU,
+        }
+    );
+}
+
 TEST_CASE("shader-cache-eviction")
 {
     runGpuTests(
@@ -0,0 +1,181 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static void checkStat(const ShaderCompilationStat& stat)
+{
+    CHECK_GE(stat.totalTime, stat.maxTime);
+    if (stat.count == 0)
+        CHECK_EQ(stat.totalTime, 0);
+}
+
+void testShaderCompilationStats(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType, false);
+    REQUIRE_CALL(device->resetShaderCompilationStats());
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-mutable-shader-object", "computeMain", slangReflection)
+    );
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::UnorderedAccess, ResourceState::CopySource);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    REQUIRE_CALL(device->createBufferView(buffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    slang::TypeReflection* transformerType = slangReflection->findTypeByName("AddTransformer");
+    ComPtr<IShaderObject> transformer;
+    REQUIRE_CALL(
+        device->createShaderObject(transformerType, ShaderObjectContainerType::None, transformer.writeRef())
+    );
+    float c = 1.0f;
+    ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+
+    // The first dispatch specializes the pipeline, the second one finds it in the cache.
+    dispatchWithTransformer(transientHeap, queue, pipeline, bufferView, transformer);
+    dispatchWithTransformer(transientHeap, queue, pipeline, bufferView, transformer);
+    compareComputeResult(device, buffer, makeArray<float>(2.0f, 3.0f, 4.0f, 5.0f));
+
+    ShaderCompilationStats stats;
+    REQUIRE_CALL(device->getShaderCompilationStats(&stats));
+    CHECK_GE(stats.programLinking.count, 1);
+    CHECK_EQ(stats.pipelineSpecialization.count, 1);
+    CHECK_EQ(stats.specializedPipelineCacheMissCount, 1);
+    CHECK_GE(stats.specializedPipelineCacheHitCount, 1);
+    // Code is only generated for entry points that were not found in the persistent shader cache, if there is one.
+    CHECK_GE(stats.entryPointCodeGeneration.count + stats.persistentCacheHits.count, 1);
+    CHECK_EQ(stats.persistentCacheWrites.count, stats.persistentCacheMisses.count);
+    if (stats.persistentCacheHits.count + stats.persistentCacheMisses.count > 0)
+        CHECK_EQ(stats.entryPointCodeGeneration.count, stats.persistentCacheMisses.count);
+    checkStat(stats.programLinking);
+    checkStat(stats.entryPointCodeGeneration);
+    checkStat(stats.pipelineSpecialization);
+    checkStat(stats.pipelineCreation);
+
+    REQUIRE_CALL(device->resetShaderCompilationStats());
+    REQUIRE_CALL(device->getShaderCompilationStats(&stats));
+    CHECK_EQ(stats.programLinking.count, 0);
+    CHECK_EQ(stats.programLinking.totalTime, 0);
+    CHECK_EQ(stats.programLinking.maxTime, 0);
+    CHECK_EQ(stats.entryPointCodeGeneration.count, 0);
+    CHECK_EQ(stats.persistentCacheHits.count, 0);
+    CHECK_EQ(stats.persistentCacheMisses.count, 0);
+    CHECK_EQ(stats.pipelineSpecialization.count, 0);
+    CHECK_EQ(stats.pipelineCreation.count, 0);
+    CHECK_EQ(stats.specializedPipelineCacheMissCount, 0);
+    CHECK_EQ(stats.specializedPipelineCacheHitCount, 0);
+}
+
+// With async pipeline specialization, dispatches are retried while the specialization is pending.
+// The cache miss is counted once, when the specialization is queued.
+void testShaderCompilationStatsAsync(GpuTestContext* ctx, DeviceType deviceType)
+{
+    DeviceDescOverrides overrides;
+    overrides.asyncPipelineSpecialization = true;
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType, overrides);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-mutable-shader-object", "computeMain", slangReflection)
+    );
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::UnorderedAccess, ResourceState::CopySource);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    REQUIRE_CALL(device->createBufferView(buffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    slang::TypeReflection* transformerType = slangReflection->findTypeByName("AddTransformer");
+    ComPtr<IShaderObject> transformer;
+    REQUIRE_CALL(
+        device->createShaderObject(transformerType, ShaderObjectContainerType::None, transformer.writeRef())
+    );
+    float c = 1.0f;
+    ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+
+    REQUIRE_CALL(device->resetShaderCompilationStats());
+    for (int i = 0; i < 3; i++)
+        dispatchWithTransformer(transientHeap, queue, pipeline, bufferView, transformer);
+    REQUIRE_CALL(device->waitForPipelineSpecializations(kTimeoutInfinite));
+    ShaderCompilationStats backgroundStats;
+    REQUIRE_CALL(device->getShaderCompilationStats(&backgroundStats));
+    CHECK_GE(backgroundStats.pipelineCreation.count, 1);
+    CHECK_EQ(dispatchWithTransformer(transientHeap, queue, pipeline, bufferView, transformer), SLANG_OK);
+
+    ShaderCompilationStats stats;
+    REQUIRE_CALL(device->getShaderCompilationStats(&stats));
+    CHECK_EQ(stats.specializedPipelineCacheMissCount, 1);
+    CHECK_GE(stats.specializedPipelineCacheHitCount, 1);
+    CHECK_EQ(stats.pipelineSpecialization.count, 1);
+    // The specialized pipeline was compiled and created on the background thread, not by the dispatch.
+    CHECK_EQ(stats.entryPointCodeGeneration.count, backgroundStats.entryPointCodeGeneration.count);
+    CHECK_EQ(stats.pipelineCreation.count, backgroundStats.pipelineCreation.count);
+}
+
+TEST_CASE("shader-compilation-stats")
+{
+    runGpuTests(
+        testShaderCompilationStats,
+        {
+            DeviceType::D3D11,
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("shader-compilation-stats-async")
+{
+    runGpuTests(
+        testShaderCompilationStatsAsync,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+        }
+    );
+}
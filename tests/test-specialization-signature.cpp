@@ -0,0 +1,302 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Shader objects cache their specialization signature between dispatches.
+// Binding transformers of different types must still select a matching specialized pipeline.
+
+static ComPtr<IShaderObject> createTransformer(
+    IDevice* device,
+    slang::ProgramLayout* slangReflection,
+    const char* typeName,
+    float c
+)
+{
+    slang::TypeReflection* type = slangReflection->findTypeByName(typeName);
+    ComPtr<IShaderObject> transformer;
+    REQUIRE_CALL(device->createShaderObject(type, ShaderObjectContainerType::None, transformer.writeRef()));
+    ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+    return transformer;
+}
+
+void testSpecializationSignature(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-mutable-shader-object", "computeMain", slangReflection)
+    );
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(
+        ResourceState::ShaderResource,
+        ResourceState::UnorderedAccess,
+        ResourceState::CopyDestination,
+        ResourceState::CopySource
+    );
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    ComPtr<IBuffer> numbersBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, numbersBuffer.writeRef()));
+
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::Unknown;
+    REQUIRE_CALL(device->createBufferView(numbersBuffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    ComPtr<IShaderObject> addTransformer = createTransformer(device, slangReflection, "AddTransformer", 1.0f);
+    ComPtr<IShaderObject> mulTransformer = createTransformer(device, slangReflection, "MulTransformer", 2.0f);
+
+    dispatchWithTransformer(transientHeap, queue, pipeline, bufferView, addTransformer);
+    compareComputeResult(device, numbersBuffer, makeArray<float>(1.0f, 2.0f, 3.0f, 4.0f));
+
+    dispatchWithTransformer(transientHeap, queue, pipeline, bufferView, mulTransformer);
+    compareComputeResult(device, numbersBuffer, makeArray<float>(2.0f, 4.0f, 6.0f, 8.0f));
+
+    // Bind the first transformer again, which reuses the pipeline specialized for it.
+    dispatchWithTransformer(transientHeap, queue, pipeline, bufferView, addTransformer);
+    compareComputeResult(device, numbersBuffer, makeArray<float>(3.0f, 5.0f, 7.0f, 9.0f));
+}
+
+// Dispatching repeatedly with one bound root object reuses its cached specialization key.
+void testSpecializationSignatureRepeatedDispatch(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-mutable-shader-object", "computeMain", slangReflection)
+    );
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(
+        ResourceState::ShaderResource,
+        ResourceState::UnorderedAccess,
+        ResourceState::CopyDestination,
+        ResourceState::CopySource
+    );
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    ComPtr<IBuffer> numbersBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, numbersBuffer.writeRef()));
+
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::Unknown;
+    REQUIRE_CALL(device->createBufferView(numbersBuffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    ComPtr<IShaderObject> addTransformer = createTransformer(device, slangReflection, "AddTransformer", 1.0f);
+
+    // Create the specialized pipeline once, so every dispatch below finds it in the cache.
+    dispatchWithTransformer(transientHeap, queue, pipeline, bufferView, addTransformer);
+    compareComputeResult(device, numbersBuffer, makeArray<float>(1.0f, 2.0f, 3.0f, 4.0f));
+
+    REQUIRE_CALL(device->resetShaderCompilationStats());
+    const int dispatchCount = 3;
+    {
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+
+        auto rootObject = encoder->bindPipeline(pipeline);
+        ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+        entryPointCursor.getPath("buffer").setResource(bufferView);
+        entryPointCursor.getPath("transformer").setObject(addTransformer);
+
+        for (int i = 0; i < dispatchCount; i++)
+        {
+            if (i > 0)
+            {
+                encoder->bufferBarrier(numbersBuffer, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess);
+            }
+            REQUIRE_CALL(encoder->dispatchCompute(1, 1, 1));
+        }
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    }
+    compareComputeResult(device, numbersBuffer, makeArray<float>(4.0f, 5.0f, 6.0f, 7.0f));
+
+    ShaderCompilationStats stats;
+    REQUIRE_CALL(device->getShaderCompilationStats(&stats));
+    CHECK_EQ(stats.specializedPipelineCacheHitCount, uint64_t(dispatchCount));
+    CHECK_EQ(stats.specializedPipelineCacheMissCount, 0u);
+}
+
+// Rebinding the transformer of a nested parameter block invalidates the arguments cached by every enclosing object.
+void testSpecializationSignatureNestedObject(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(
+        loadComputeProgram(device, shaderProgram, "test-specialization-signature", "computeMain", slangReflection)
+    );
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(
+        ResourceState::ShaderResource,
+        ResourceState::UnorderedAccess,
+        ResourceState::CopyDestination,
+        ResourceState::CopySource
+    );
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    ComPtr<IBuffer> numbersBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, numbersBuffer.writeRef()));
+
+    ComPtr<IResourceView> bufferView;
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::Unknown;
+    REQUIRE_CALL(device->createBufferView(numbersBuffer, nullptr, viewDesc, bufferView.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    ComPtr<IShaderObject> addTransformer = createTransformer(device, slangReflection, "AddTransformer", 1.0f);
+    ComPtr<IShaderObject> mulTransformer = createTransformer(device, slangReflection, "MulTransformer", 2.0f);
+
+    ComPtr<IShaderObject> innerObject;
+    REQUIRE_CALL(device->createShaderObject(
+        slangReflection->findTypeByName("InnerParams"),
+        ShaderObjectContainerType::None,
+        innerObject.writeRef()
+    ));
+    ComPtr<IShaderObject> outerObject;
+    REQUIRE_CALL(device->createShaderObject(
+        slangReflection->findTypeByName("OuterParams"),
+        ShaderObjectContainerType::None,
+        outerObject.writeRef()
+    ));
+    ShaderCursor(outerObject).getPath("inner").setObject(innerObject);
+
+    auto dispatch = [&]()
+    {
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+
+        auto rootObject = encoder->bindPipeline(pipeline);
+        ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+        entryPointCursor.getPath("buffer").setResource(bufferView);
+        entryPointCursor.getPath("outer").setObject(outerObject);
+
+        Result result = encoder->dispatchCompute(1, 1, 1);
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+        return result;
+    };
+
+    ShaderCursor(innerObject).getPath("transformer").setObject(addTransformer);
+    REQUIRE_CALL(dispatch());
+    compareComputeResult(device, numbersBuffer, makeArray<float>(1.0f, 2.0f, 3.0f, 4.0f));
+
+    // Only the innermost object changes, the outer block still caches the arguments of the previous dispatch.
+    ShaderCursor(innerObject).getPath("transformer").setObject(mulTransformer);
+    REQUIRE_CALL(dispatch());
+    compareComputeResult(device, numbersBuffer, makeArray<float>(2.0f, 4.0f, 6.0f, 8.0f));
+
+    ShaderCursor(innerObject).getPath("transformer").setObject(addTransformer);
+    REQUIRE_CALL(dispatch());
+    compareComputeResult(device, numbersBuffer, makeArray<float>(3.0f, 5.0f, 7.0f, 9.0f));
+}
+
+TEST_CASE("specialization-signature")
+{
+    runGpuTests(
+        testSpecializationSignature,
+        {
+            DeviceType::D3D11,
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("specialization-signature-repeated-dispatch")
+{
+    runGpuTests(
+        testSpecializationSignatureRepeatedDispatch,
+        {
+            DeviceType::D3D11,
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("specialization-signature-nested-object")
+{
+    runGpuTests(
+        testSpecializationSignatureNestedObject,
+        {
+            DeviceType::D3D11,
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+            DeviceType::CUDA,
+            DeviceType::CPU,
+        }
+    );
+}
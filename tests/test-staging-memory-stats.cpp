@@ -0,0 +1,151 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Staging buffers used by a transient heap are returned to the device on reset and reused afterwards.
+
+void testStagingMemoryStats(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType, false);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    transientHeapDesc.stagingBufferPageSize = 1024 * 1024;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    // The small upload is placed in a staging page, the large one gets a dedicated staging buffer.
+    const size_t smallSize = 16 * 1024;
+    const size_t largeSize = 4 * 1024 * 1024;
+    std::vector<float> data(largeSize / sizeof(float));
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = float(i);
+
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = largeSize;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::CopySource, ResourceState::CopyDestination);
+    bufferDesc.defaultState = ResourceState::CopyDestination;
+    ComPtr<IBuffer> smallBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, smallBuffer.writeRef()));
+    ComPtr<IBuffer> largeBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, largeBuffer.writeRef()));
+
+    auto uploadFrame = [&]()
+    {
+        REQUIRE_CALL(transientHeap->synchronizeAndReset());
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeResourceCommands();
+        encoder->uploadBufferData(smallBuffer, 0, smallSize, data.data());
+        encoder->uploadBufferData(largeBuffer, 0, largeSize, data.data());
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        REQUIRE_CALL(transientHeap->finish());
+        queue->waitOnHost();
+    };
+
+    uploadFrame();
+    REQUIRE_CALL(transientHeap->synchronizeAndReset());
+
+    StagingMemoryStats stats;
+    REQUIRE_CALL(device->getStagingMemoryStats(&stats));
+    CHECK_GE(stats.bufferCreationCount, 2);
+    CHECK_GE(stats.bytesInUsePeak, smallSize + largeSize);
+    CHECK_GE(stats.bytesPerResetPeak, smallSize + largeSize);
+    CHECK_GE(stats.bytesPooled, smallSize + largeSize);
+    CHECK_GE(stats.bytesInUsePeak, stats.bytesInUse);
+
+    // Later frames reuse the staging buffers of the first one.
+    for (int i = 0; i < 3; i++)
+        uploadFrame();
+    StagingMemoryStats reuseStats;
+    REQUIRE_CALL(device->getStagingMemoryStats(&reuseStats));
+    CHECK_EQ(reuseStats.bufferCreationCount, stats.bufferCreationCount);
+    CHECK_GE(reuseStats.bufferReuseCount, stats.bufferReuseCount + 6);
+
+    compareComputeResult(device, smallBuffer, makeArray<float>(0.0f, 1.0f, 2.0f, 3.0f));
+    compareComputeResult(device, largeBuffer, makeArray<float>(0.0f, 1.0f, 2.0f, 3.0f));
+    compareComputeResult(device, largeBuffer, largeSize - 4 * sizeof(float), &data[data.size() - 4], 4 * sizeof(float));
+}
+
+TEST_CASE("staging-memory-stats")
+{
+    runGpuTests(
+        testStagingMemoryStats,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+        }
+    );
+}
+
+// Staging pages grow for a frame that needs more than one page, and shrink again after frames with low usage.
+void testStagingPageSizeShrink(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType, false);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    transientHeapDesc.stagingBufferPageSize = 1024 * 1024;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    // Smaller than a quarter of the initial page size, so uploads are placed in pages.
+    const size_t uploadSize = 192 * 1024;
+    std::vector<uint8_t> data(uploadSize, 1);
+
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = uploadSize;
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::CopySource, ResourceState::CopyDestination);
+    bufferDesc.defaultState = ResourceState::CopyDestination;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, buffer.writeRef()));
+
+    // Returns the staging memory in use by the heap at the end of the frame.
+    auto uploadFrame = [&](int uploadCount)
+    {
+        REQUIRE_CALL(transientHeap->synchronizeAndReset());
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeResourceCommands();
+        for (int i = 0; i < uploadCount; i++)
+            encoder->uploadBufferData(buffer, 0, uploadSize, data.data());
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        REQUIRE_CALL(transientHeap->finish());
+        queue->waitOnHost();
+        StagingMemoryStats stats;
+        REQUIRE_CALL(device->getStagingMemoryStats(&stats));
+        return stats.bytesInUse;
+    };
+
+    uint64_t initialBytesInUse = uploadFrame(1);
+    // Needs two pages, later frames use larger pages.
+    uploadFrame(8);
+    uint64_t grownBytesInUse = uploadFrame(1);
+    CHECK_GT(grownBytesInUse, initialBytesInUse);
+
+    uint64_t bytesInUse = grownBytesInUse;
+    for (int i = 0; i < 32; i++)
+        bytesInUse = uploadFrame(1);
+    CHECK_EQ(bytesInUse, initialBytesInUse);
+}
+
+TEST_CASE("staging-page-size-shrink")
+{
+    runGpuTests(
+        testStagingPageSizeShrink,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+        }
+    );
+}
@@ -0,0 +1,77 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// The CPU device stores block compressed textures decoded.
+// Reading them back returns the decoded texels.
+
+static ComPtr<ISlangBlob> createAndReadTexture(
+    IDevice* device,
+    Format format,
+    const void* blockData,
+    Size blockSize,
+    Size* outRowPitch
+)
+{
+    TextureDesc desc = {};
+    desc.type = TextureType::Texture2D;
+    desc.format = format;
+    desc.size.width = 4;
+    desc.size.height = 4;
+    desc.size.depth = 1;
+    desc.numMipLevels = 1;
+    desc.defaultState = ResourceState::ShaderResource;
+    desc.allowedStates = ResourceStateSet(ResourceState::ShaderResource, ResourceState::CopySource);
+
+    SubresourceData subData = {blockData, blockSize, 0};
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(desc, &subData, texture.writeRef()));
+
+    ComPtr<ISlangBlob> blob;
+    Size pixelSize;
+    REQUIRE_CALL(device->readTexture(texture, ResourceState::CopySource, blob.writeRef(), outRowPitch, &pixelSize));
+    return blob;
+}
+
+void testTextureBlockDecode(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    // BC1: red and blue endpoints, all texels select the blue endpoint.
+    {
+        uint8_t block[] = {0x00, 0xf8, 0x1f, 0x00, 0x55, 0x55, 0x55, 0x55};
+        Size rowPitch;
+        auto blob = createAndReadTexture(device, Format::BC1_UNORM, block, sizeof(block), &rowPitch);
+        CHECK_EQ(rowPitch, Size(16));
+        const uint8_t* texels = (const uint8_t*)blob->getBufferPointer();
+        for (int i = 0; i < 16; i++)
+        {
+            CHECK_EQ(texels[i * 4 + 0], 0);
+            CHECK_EQ(texels[i * 4 + 1], 0);
+            CHECK_EQ(texels[i * 4 + 2], 255);
+            CHECK_EQ(texels[i * 4 + 3], 255);
+        }
+    }
+
+    // BC4: endpoints 1.0 and 0.0 in 8 value mode, all texels select the last interpolated value.
+    {
+        uint8_t block[] = {0xff, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+        Size rowPitch;
+        auto blob = createAndReadTexture(device, Format::BC4_UNORM, block, sizeof(block), &rowPitch);
+        CHECK_EQ(rowPitch, Size(16));
+        const float* texels = (const float*)blob->getBufferPointer();
+        for (int i = 0; i < 16; i++)
+            CHECK_EQ(texels[i], doctest::Approx(1.0f / 7.0f));
+    }
+}
+
+TEST_CASE("texture-block-decode")
+{
+    runGpuTests(
+        testTextureBlockDecode,
+        {
+            DeviceType::CPU,
+        }
+    );
+}
@@ -0,0 +1,258 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// The CPU device stores textures that kernels write to in a 32-bit per component format.
+// Texels are converted when the texture is initialized and packed back into the texture format when read back.
+
+static const Format kRoundTripFormats[] = {
+    Format::R32G32B32A32_TYPELESS,
+    Format::R16G16B16A16_TYPELESS,
+    Format::R8G8B8A8_TYPELESS,
+    Format::R32G32B32A32_FLOAT,
+    Format::R32G32_FLOAT,
+    Format::R32_FLOAT,
+    Format::R16G16B16A16_FLOAT,
+    Format::R16G16_FLOAT,
+    Format::R16_FLOAT,
+    Format::R32G32B32A32_UINT,
+    Format::R16G16B16A16_UINT,
+    Format::R16G16_UINT,
+    Format::R16_UINT,
+    Format::R8G8B8A8_UINT,
+    Format::R8G8_UINT,
+    Format::R8_UINT,
+    Format::R32G32B32A32_SINT,
+    Format::R16G16B16A16_SINT,
+    Format::R16G16_SINT,
+    Format::R16_SINT,
+    Format::R8G8B8A8_SINT,
+    Format::R8G8_SINT,
+    Format::R8_SINT,
+    Format::R16G16B16A16_UNORM,
+    Format::R16G16_UNORM,
+    Format::R16_UNORM,
+    Format::R8G8B8A8_UNORM,
+    Format::R8G8B8A8_UNORM_SRGB,
+    Format::R8G8_UNORM,
+    Format::R8_UNORM,
+    Format::B8G8R8A8_UNORM,
+    Format::B8G8R8A8_UNORM_SRGB,
+    Format::B8G8R8X8_UNORM,
+    Format::B8G8R8X8_UNORM_SRGB,
+    Format::R16G16B16A16_SNORM,
+    Format::R16G16_SNORM,
+    Format::R16_SNORM,
+    Format::R8G8B8A8_SNORM,
+    Format::R8G8_SNORM,
+    Format::R8_SNORM,
+    Format::D32_FLOAT,
+    Format::D16_UNORM,
+    Format::D32_FLOAT_S8_UINT,
+    Format::B4G4R4A4_UNORM,
+    Format::B5G6R5_UNORM,
+    Format::B5G5R5A1_UNORM,
+    Format::R9G9B9E5_SHAREDEXP,
+    Format::R10G10B10A2_TYPELESS,
+    Format::R10G10B10A2_UNORM,
+    Format::R10G10B10A2_UINT,
+    Format::R11G11B10_FLOAT,
+};
+
+// Fills `texels` with varied texel data that is preserved when unpacked and packed again.
+// Bit patterns that have no exact unpacked value (NaNs, the most negative snorm value, unused bits,
+// non-normalized shared exponents) are adjusted.
+static void makeTexels(Format format, uint32_t texelSize, std::vector<uint8_t>& texels)
+{
+    for (size_t i = 0; i < texels.size(); i++)
+        texels[i] = uint8_t((i * 73 + 19) ^ ((i >> 8) * 151));
+
+    for (size_t offset = 0; offset < texels.size(); offset += texelSize)
+    {
+        uint8_t* texel = texels.data() + offset;
+        uint32_t bits;
+        switch (format)
+        {
+        case Format::R16G16B16A16_FLOAT:
+        case Format::R16G16_FLOAT:
+        case Format::R16_FLOAT:
+            for (uint32_t i = 0; i < texelSize; i += 2)
+                texel[i + 1] &= ~0x40;
+            break;
+        case Format::R16G16B16A16_SNORM:
+        case Format::R16G16_SNORM:
+        case Format::R16_SNORM:
+            for (uint32_t i = 0; i < texelSize; i += 2)
+                if (texel[i] == 0x00 && texel[i + 1] == 0x80)
+                    texel[i] = 0x01;
+            break;
+        case Format::R8G8B8A8_SNORM:
+        case Format::R8G8_SNORM:
+        case Format::R8_SNORM:
+            for (uint32_t i = 0; i < texelSize; i++)
+                if (texel[i] == 0x80)
+                    texel[i] = 0x81;
+            break;
+        case Format::B8G8R8X8_UNORM:
+        case Format::B8G8R8X8_UNORM_SRGB:
+            texel[3] = 0xff;
+            break;
+        case Format::D32_FLOAT_S8_UINT:
+            memset(texel + 4, 0, 4);
+            break;
+        case Format::R9G9B9E5_SHAREDEXP:
+            memcpy(&bits, texel, 4);
+            bits |= (1u << 8) | (1u << 17) | (1u << 26);
+            memcpy(texel, &bits, 4);
+            break;
+        case Format::R11G11B10_FLOAT:
+            memcpy(&bits, texel, 4);
+            bits &= ~((1u << 10) | (1u << 21) | (1u << 31));
+            memcpy(texel, &bits, 4);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void checkFormatRoundTrip(IDevice* device, Format format, bool isWritable)
+{
+    FormatInfo formatInfo;
+    rhiGetFormatInfo(format, &formatInfo);
+    uint32_t texelSize = uint32_t(formatInfo.blockSizeInBytes);
+    const uint32_t width = 13;
+    const uint32_t height = 5;
+
+    TextureDesc desc = {};
+    desc.type = TextureType::Texture2D;
+    desc.format = format;
+    desc.size.width = width;
+    desc.size.height = height;
+    desc.size.depth = 1;
+    desc.numMipLevels = 1;
+    desc.defaultState = ResourceState::ShaderResource;
+    desc.allowedStates = ResourceStateSet(ResourceState::ShaderResource, ResourceState::CopySource);
+    if (isWritable)
+        desc.allowedStates.add(ResourceState::UnorderedAccess);
+
+    std::vector<uint8_t> texels(width * height * texelSize);
+    makeTexels(format, texelSize, texels);
+
+    SubresourceData subData = {texels.data(), width * texelSize, 0};
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(desc, &subData, texture.writeRef()));
+
+    ComPtr<ISlangBlob> blob;
+    Size rowPitch;
+    Size pixelSize;
+    REQUIRE_CALL(device->readTexture(texture, ResourceState::CopySource, blob.writeRef(), &rowPitch, &pixelSize));
+    CHECK_EQ(rowPitch, width * texelSize);
+    CHECK_EQ(pixelSize, texelSize);
+    REQUIRE_EQ(blob->getBufferSize(), texels.size());
+    CHECK(memcmp(blob->getBufferPointer(), texels.data(), texels.size()) == 0);
+}
+
+void testTextureFormatRoundTrip(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    for (Format format : kRoundTripFormats)
+    {
+        FormatInfo formatInfo;
+        rhiGetFormatInfo(format, &formatInfo);
+        CAPTURE(formatInfo.name);
+        checkFormatRoundTrip(device, format, false);
+        checkFormatRoundTrip(device, format, true);
+    }
+}
+
+// Kernel writes to a texture with 8-bit components are packed when the texture is read back.
+void testTextureFormatKernelWrite(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(
+        loadComputeProgram(device, shaderProgram, "test-texture-format-conversion", "writeTexture", slangReflection)
+    );
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    TextureDesc textureDesc = {};
+    textureDesc.type = TextureType::Texture2D;
+    textureDesc.format = Format::R8G8B8A8_UNORM;
+    textureDesc.size.width = 4;
+    textureDesc.size.height = 4;
+    textureDesc.size.depth = 1;
+    textureDesc.numMipLevels = 1;
+    textureDesc.defaultState = ResourceState::UnorderedAccess;
+    textureDesc.allowedStates = ResourceStateSet(ResourceState::UnorderedAccess, ResourceState::CopySource);
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(textureDesc, nullptr, texture.writeRef()));
+
+    IResourceView::Desc viewDesc = {};
+    viewDesc.type = IResourceView::Type::UnorderedAccess;
+    viewDesc.format = Format::R8G8B8A8_UNORM;
+    ComPtr<IResourceView> textureView;
+    REQUIRE_CALL(device->createTextureView(texture, viewDesc, textureView.writeRef()));
+
+    {
+        ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+        auto queue = device->createCommandQueue(queueDesc);
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+        auto rootObject = encoder->bindPipeline(pipeline);
+        ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+        entryPointCursor.getPath("texture").setResource(textureView);
+        encoder->dispatchCompute(1, 1, 1);
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    const uint8_t kValues[] = {0, 85, 170, 255};
+    uint8_t expected[4][4][4];
+    for (int y = 0; y < 4; y++)
+    {
+        for (int x = 0; x < 4; x++)
+        {
+            expected[y][x][0] = kValues[x];
+            expected[y][x][1] = kValues[y];
+            expected[y][x][2] = 128;
+            expected[y][x][3] = 255;
+        }
+    }
+    compareComputeResult(device, texture, ResourceState::CopySource, expected, 4 * 4, 4);
+}
+
+TEST_CASE("texture-format-round-trip")
+{
+    runGpuTests(
+        testTextureFormatRoundTrip,
+        {
+            DeviceType::CPU,
+        }
+    );
+}
+
+TEST_CASE("texture-format-kernel-write")
+{
+    runGpuTests(
+        testTextureFormatKernelWrite,
+        {
+            DeviceType::CPU,
+        }
+    );
+}
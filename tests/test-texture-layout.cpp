@@ -0,0 +1,161 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Textures stored in the tiled layout are detiled transparently when read back.
+// The extents are not a multiple of the tile size to cover partial tiles.
+
+static ComPtr<IDevice> createDeviceWithTextureLayout(GpuTestContext* ctx, CPUTextureLayout layout)
+{
+    CPUDeviceExtendedDesc cpuExtDesc = {};
+    cpuExtDesc.textureLayout = layout;
+    DeviceDescOverrides overrides;
+    overrides.extendedDescs.push_back(&cpuExtDesc);
+    return createTestingDevice(ctx, DeviceType::CPU, overrides);
+}
+
+static void checkTextureRoundTrip(IDevice* device, TextureType type, uint32_t width, uint32_t height, uint32_t depth)
+{
+    TextureDesc desc = {};
+    desc.type = type;
+    desc.format = Format::R32_UINT;
+    desc.size.width = width;
+    desc.size.height = height;
+    desc.size.depth = depth;
+    desc.numMipLevels = 1;
+    desc.defaultState = ResourceState::ShaderResource;
+    desc.allowedStates = ResourceStateSet(ResourceState::ShaderResource, ResourceState::CopySource);
+
+    std::vector<uint32_t> texels(width * height * depth);
+    for (size_t i = 0; i < texels.size(); i++)
+        texels[i] = uint32_t(i);
+
+    SubresourceData subData = {texels.data(), width * sizeof(uint32_t), width * height * sizeof(uint32_t)};
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(desc, &subData, texture.writeRef()));
+
+    ComPtr<ISlangBlob> blob;
+    Size rowPitch;
+    Size pixelSize;
+    REQUIRE_CALL(device->readTexture(texture, ResourceState::CopySource, blob.writeRef(), &rowPitch, &pixelSize));
+    CHECK_EQ(rowPitch, width * sizeof(uint32_t));
+    CHECK_EQ(pixelSize, sizeof(uint32_t));
+    REQUIRE_EQ(blob->getBufferSize(), texels.size() * sizeof(uint32_t));
+    CHECK(memcmp(blob->getBufferPointer(), texels.data(), blob->getBufferSize()) == 0);
+}
+
+// Kernels address texels through the layout when reading with Load and SampleLevel.
+static void checkKernelRead(IDevice* device)
+{
+    const uint32_t width = 13;
+    const uint32_t height = 11;
+    const uint32_t texelCount = width * height;
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-texture-layout", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    std::vector<float> texels(texelCount);
+    for (uint32_t i = 0; i < texelCount; i++)
+        texels[i] = float(i);
+
+    TextureDesc textureDesc = {};
+    textureDesc.type = TextureType::Texture2D;
+    textureDesc.format = Format::R32_FLOAT;
+    textureDesc.size.width = width;
+    textureDesc.size.height = height;
+    textureDesc.size.depth = 1;
+    textureDesc.numMipLevels = 1;
+    textureDesc.defaultState = ResourceState::ShaderResource;
+    textureDesc.allowedStates = ResourceStateSet(ResourceState::ShaderResource);
+    SubresourceData subData = {texels.data(), width * sizeof(float), texelCount * sizeof(float)};
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(textureDesc, &subData, texture.writeRef()));
+
+    ComPtr<IResourceView> srv;
+    IResourceView::Desc srvDesc = {};
+    srvDesc.type = IResourceView::Type::ShaderResource;
+    srvDesc.format = Format::R32_FLOAT;
+    REQUIRE_CALL(device->createTextureView(texture, srvDesc, srv.writeRef()));
+
+    SamplerDesc samplerDesc = {};
+    samplerDesc.minFilter = TextureFilteringMode::Point;
+    samplerDesc.magFilter = TextureFilteringMode::Point;
+    samplerDesc.mipFilter = TextureFilteringMode::Point;
+    ComPtr<ISampler> sampler;
+    REQUIRE_CALL(device->createSampler(samplerDesc, sampler.writeRef()));
+
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = 2 * texelCount * sizeof(float);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::UnorderedAccess, ResourceState::CopySource);
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, buffer.writeRef()));
+
+    ComPtr<IResourceView> uav;
+    IResourceView::Desc uavDesc = {};
+    uavDesc.type = IResourceView::Type::UnorderedAccess;
+    uavDesc.format = Format::Unknown;
+    REQUIRE_CALL(device->createBufferView(buffer, nullptr, uavDesc, uav.writeRef()));
+
+    {
+        ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+        auto queue = device->createCommandQueue(queueDesc);
+
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeComputeCommands();
+        auto rootObject = encoder->bindPipeline(pipeline);
+        ShaderCursor cursor(rootObject);
+        cursor["tex"].setResource(srv);
+        cursor["pointSampler"].setSampler(sampler);
+        cursor["buffer"].setResource(uav);
+        encoder->dispatchCompute((width + 3) / 4, (height + 3) / 4, 1);
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    // Both reads return the texels in row-major order.
+    std::vector<float> expected(texels);
+    expected.insert(expected.end(), texels.begin(), texels.end());
+    compareComputeResult(device, buffer, 0, expected.data(), expected.size() * sizeof(float));
+}
+
+void testTextureLayout(GpuTestContext* ctx, DeviceType deviceType)
+{
+    SLANG_UNUSED(deviceType);
+
+    for (CPUTextureLayout layout : {CPUTextureLayout::Linear, CPUTextureLayout::Tiled})
+    {
+        ComPtr<IDevice> device = createDeviceWithTextureLayout(ctx, layout);
+        checkTextureRoundTrip(device, TextureType::Texture1D, 37, 1, 1);
+        checkTextureRoundTrip(device, TextureType::Texture2D, 13, 11, 1);
+        checkTextureRoundTrip(device, TextureType::Texture3D, 9, 17, 3);
+        checkKernelRead(device);
+    }
+}
+
+TEST_CASE("texture-layout")
+{
+    runGpuTests(
+        testTextureLayout,
+        {
+            DeviceType::CPU,
+        }
+    );
+}
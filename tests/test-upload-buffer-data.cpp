@@ -0,0 +1,71 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Many small uploads to one buffer, including uploads that overwrite earlier ones in the same encoder.
+
+void testUploadBufferData(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType, false);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ICommandQueue::Desc queueDesc = {ICommandQueue::QueueType::Graphics};
+    auto queue = device->createCommandQueue(queueDesc);
+
+    const int elementCount = 256;
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = elementCount * sizeof(uint32_t);
+    bufferDesc.elementSize = sizeof(uint32_t);
+    bufferDesc.allowedStates = ResourceStateSet(ResourceState::CopySource, ResourceState::CopyDestination);
+    bufferDesc.defaultState = ResourceState::CopyDestination;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, buffer.writeRef()));
+
+    std::vector<uint32_t> expected(elementCount);
+    {
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto encoder = commandBuffer->encodeResourceCommands();
+        // Upload the buffer in reverse order, one element at a time.
+        for (int i = elementCount - 1; i >= 0; i--)
+        {
+            uint32_t value = i;
+            encoder->uploadBufferData(buffer, i * sizeof(uint32_t), sizeof(uint32_t), &value);
+            expected[i] = value;
+        }
+        // Overwrite a range that was already uploaded, the later upload must win.
+        for (int i = 16; i < 32; i++)
+        {
+            uint32_t value = 1000 + i;
+            encoder->uploadBufferData(buffer, i * sizeof(uint32_t), sizeof(uint32_t), &value);
+            expected[i] = value;
+        }
+        // Overwrite one element several times in a row.
+        for (uint32_t value = 2000; value < 2004; value++)
+        {
+            encoder->uploadBufferData(buffer, 0, sizeof(uint32_t), &value);
+            expected[0] = value;
+        }
+        encoder->endEncoding();
+        commandBuffer->close();
+        queue->executeCommandBuffer(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    compareComputeResult(device, buffer, 0, expected.data(), expected.size() * sizeof(uint32_t));
+}
+
+TEST_CASE("upload-buffer-data")
+{
+    runGpuTests(
+        testUploadBufferData,
+        {
+            DeviceType::D3D12,
+            DeviceType::Vulkan,
+        }
+    );
+}
@@ -311,34 +311,22 @@ void compareComputeResultFuzzy(IDevice* device, IBuffer* buffer, float* expected
     compareComputeResultFuzzy(result, expectedResult, expectedBufferSize);
 }
 
-ComPtr<IDevice> createTestingDevice(
-    GpuTestContext* ctx,
-    DeviceType deviceType,
-    bool useCachedDevice,
-    std::vector<const char*> additionalSearchPaths
-)
+static ComPtr<IDevice> createDevice(GpuTestContext* ctx, DeviceType deviceType, const DeviceDescOverrides& overrides)
 {
-    if (useCachedDevice)
-    {
-        auto it = gCachedDevices.find(deviceType);
-        if (it != gCachedDevices.end())
-        {
-            return it->second;
-        }
-    }
-
     ComPtr<IDevice> device;
     IDevice::Desc deviceDesc = {};
     deviceDesc.deviceType = deviceType;
     deviceDesc.slang.slangGlobalSession = ctx->slangGlobalSession;
     auto searchPaths = getSlangSearchPaths();
-    for (const char* path : searchPaths)
-        additionalSearchPaths.push_back(path);
     deviceDesc.slang.searchPaths = searchPaths.data();
     deviceDesc.slang.searchPathCount = searchPaths.size();
 #if ENABLE_SHADER_CACHE
     deviceDesc.persistentShaderCache = &gShaderCache;
 #endif
+    if (overrides.persistentShaderCache)
+        deviceDesc.persistentShaderCache = overrides.persistentShaderCache;
+    deviceDesc.asyncPipelineSpecialization = overrides.asyncPipelineSpecialization;
+    deviceDesc.persistentPipelineCache = overrides.persistentPipelineCache;
 
     D3D12DeviceExtendedDesc extDesc = {};
     extDesc.rootParameterShaderAttributeName = "root";
@@ -358,9 +346,10 @@ ComPtr<IDevice> createTestingDevice(
     slangExtDesc.compilerOptionEntries = entries.data();
     slangExtDesc.compilerOptionEntryCount = entries.size();
 
-    deviceDesc.extendedDescCount = 2;
-    void* extDescPtrs[2] = {&extDesc, &slangExtDesc};
-    deviceDesc.extendedDescs = extDescPtrs;
+    std::vector<void*> extDescPtrs = {&extDesc, &slangExtDesc};
+    extDescPtrs.insert(extDescPtrs.end(), overrides.extendedDescs.begin(), overrides.extendedDescs.end());
+    deviceDesc.extendedDescCount = extDescPtrs.size();
+    deviceDesc.extendedDescs = extDescPtrs.data();
 
     // TODO: We should also set the debug callback
     // (And in general reduce the differences (and duplication) between
@@ -370,6 +359,26 @@ ComPtr<IDevice> createTestingDevice(
 #endif
 
     REQUIRE_CALL(rhiCreateDevice(&deviceDesc, device.writeRef()));
+    return device;
+}
+
+ComPtr<IDevice> createTestingDevice(
+    GpuTestContext* ctx,
+    DeviceType deviceType,
+    bool useCachedDevice,
+    std::vector<const char*> additionalSearchPaths
+)
+{
+    if (useCachedDevice)
+    {
+        auto it = gCachedDevices.find(deviceType);
+        if (it != gCachedDevices.end())
+        {
+            return it->second;
+        }
+    }
+
+    ComPtr<IDevice> device = createDevice(ctx, deviceType, DeviceDescOverrides());
 
     if (useCachedDevice)
     {
@@ -379,6 +388,35 @@ ComPtr<IDevice> createTestingDevice(
     return device;
 }
 
+ComPtr<IDevice> createTestingDevice(GpuTestContext* ctx, DeviceType deviceType, const DeviceDescOverrides& overrides)
+{
+    return createDevice(ctx, deviceType, overrides);
+}
+
+Result dispatchWithTransformer(
+    ITransientResourceHeap* transientHeap,
+    ICommandQueue* queue,
+    IPipeline* pipeline,
+    IResourceView* bufferView,
+    IShaderObject* transformer
+)
+{
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto encoder = commandBuffer->encodeComputeCommands();
+
+    auto rootObject = encoder->bindPipeline(pipeline);
+    ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+    entryPointCursor.getPath("buffer").setResource(bufferView);
+    entryPointCursor.getPath("transformer").setObject(transformer);
+
+    Result result = encoder->dispatchCompute(1, 1, 1);
+    encoder->endEncoding();
+    commandBuffer->close();
+    queue->executeCommandBuffer(commandBuffer);
+    queue->waitOnHost();
+    return result;
+}
+
 ComPtr<slang::ISession> createTestingSession(
     GpuTestContext* ctx,
     DeviceType deviceType,
@@ -108,6 +108,29 @@ ComPtr<IDevice> createTestingDevice(
     std::vector<const char*> additionalSearchPaths = {}
 );
 
+/// Device desc settings that differ from the defaults used by `createTestingDevice`.
+struct DeviceDescOverrides
+{
+    bool asyncPipelineSpecialization = false;
+    IPersistentShaderCache* persistentShaderCache = nullptr;
+    bool persistentPipelineCache = false;
+    /// Extended descs passed in addition to the default ones.
+    std::vector<void*> extendedDescs;
+};
+
+/// Creates a device that is not shared with other tests, with `overrides` applied to the default desc.
+ComPtr<IDevice> createTestingDevice(GpuTestContext* ctx, DeviceType deviceType, const DeviceDescOverrides& overrides);
+
+/// Binds `transformer` and `bufferView` to the entry point of `pipeline`, dispatches a single group and waits for it
+/// to complete. Returns the result of the dispatch.
+Result dispatchWithTransformer(
+    ITransientResourceHeap* transientHeap,
+    ICommandQueue* queue,
+    IPipeline* pipeline,
+    IResourceView* bufferView,
+    IShaderObject* transformer
+);
+
 ComPtr<slang::ISession> createTestingSession(
     GpuTestContext* ctx,
     DeviceType deviceType,